@@ -9,7 +9,26 @@
 /// Matan Nassau <matan.nassau@gmail.com>
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <wtl/algorithm_iseq.hh>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <wtl/flat_hash.hh>
+#include <wtl/iseq.hh>
+#include <wtl/parallel.hh>
+#include <wtl/random.hh>
+#include <wtl/simd.hh>
+#include <wtl/sink.hh>
+#include <wtl/traits.hh>
 
 namespace wt {
 
@@ -37,8 +56,8 @@ namespace wt {
 template<typename In, typename Out, typename Pred>
 Out copy_until(In first, In last, Out res, Pred cond)
 {
-    while( first != last && !cond(*first) )
-        *res++ = first++;
+    for( ; first != last && !cond(*first); ++first )
+        *res++ = *first;
     return res;
 }
 
@@ -63,8 +82,50 @@ Out copy_until(In first, In last, Out res, Pred cond)
 template<typename In, typename Out, typename Pred>
 Out copy_while(In first, In last, Out res, Pred cond)
 {
-    while( first != last && cond(*first) )
-        *res++ = first++;
+    for( ; first != last && cond(*first); ++first )
+        *res++ = *first;
+    return res;
+}
+
+/// Move elements from one container into another until a predicate is
+/// satisfied.  The moved-from elements are left valid but unspecified, as
+/// with std::move().
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param result An _output iterator_ pointing to the container into which the
+/// elements should be moved.
+///
+/// \param op A predicate which elements to be moved must satisfy.  When the
+/// predicate is satisfied the move procedure stops.  It is called on each
+/// element before the element is moved.
+///
+/// \return An iterator pointing to one-past-the-last element of the output
+/// container.
+///
+/// \see copy_until()
+template<typename In, typename Out, typename Pred>
+Out move_until(In first, In last, Out res, Pred cond)
+{
+    for( ; first != last && !cond(*first); ++first )
+        *res++ = std::move(*first);
+    return res;
+}
+
+/// Move elements from one container into another while a predicate is
+/// satisfied.
+///
+/// \see move_until()
+/// \see copy_while()
+template<typename In, typename Out, typename Pred>
+Out move_while(In first, In last, Out res, Pred cond)
+{
+    for( ; first != last && cond(*first); ++first )
+        *res++ = std::move(*first);
     return res;
 }
 
@@ -84,7 +145,9 @@ Out copy_while(In first, In last, Out res, Pred cond)
 /// The first iterator points to an element in the first sequence, and the
 /// second iterator points to an element in the second sequence.
 template <typename In1, typename In2>
-std::pair<In1,In2> match(In1 first1, In1 last1, In2 first2)
+typename std::enable_if<!is_input_sequence_range<In1>::value,
+                        std::pair<In1,In2> >::type
+match(In1 first1, In1 last1, In2 first2)
 {
     while( first1 != last1 && !(*first1 == *first2) ) {
         ++first1;
@@ -121,6 +184,50 @@ std::pair<In1,In2> match(In1 first1, In1 last1, In2 first2, BinPred op)
     return std::make_pair(first1, first2);
 }
 
+/// Find the first pair of elements that compare equal, in two sequences of
+/// possibly different lengths.
+///
+/// \param first1 an _input iterator_ pointing to the first element of the
+/// first input sequence.
+///
+/// \param last1 an _input iterator_ pointing to the last element of the first
+/// input sequence.
+///
+/// \param first2 an _input iterator_ pointing to the first element of the
+/// second input sequence.
+///
+/// \param last2 an _input iterator_ pointing to the last element of the
+/// second input sequence.
+///
+/// \return A pair of iterators pointing to the two elements that are equal, or
+/// to the end of the shorter sequence and the corresponding position in the
+/// other if there is no such pair.
+template <typename In1, typename In2>
+std::pair<In1,In2> match(In1 first1, In1 last1, In2 first2, In2 last2)
+{
+    while( first1 != last1 && first2 != last2 && !(*first1 == *first2) ) {
+        ++first1;
+        ++first2;
+    }
+    return std::make_pair(first1, first2);
+}
+
+/// Find the first pair of elements that satisfy a predicate, in two sequences
+/// of possibly different lengths.
+///
+/// \see match(In1, In1, In2, In2)
+template <typename In1, typename In2, typename BinPred>
+std::pair<In1,In2> match(In1 first1, In1 last1,
+                         In2 first2, In2 last2,
+                         BinPred op)
+{
+    while( first1 != last1 && first2 != last2 && !op(*first1, *first2) ) {
+        ++first1;
+        ++first2;
+    }
+    return std::make_pair(first1, first2);
+}
+
 /// Find the first element in sequence a that doesn't exist in sequence b.
 ///
 /// \param first1 an _input iterator_ pointing to the first element of the
@@ -179,6 +286,2743 @@ In find_first_not_of(In first1, In last1, Fwd first2, Fwd last2, BinPred op)
     }
     return last1;
 }
+
+namespace detail {
+
+/// Invert a comparator, so that a heap built with it keeps the smallest
+/// element at its top.
+template<typename Cmp>
+struct inverted_compare {
+    explicit inverted_compare(Cmp c) : cmp(c) { }
+    template<typename T, typename U>
+    bool operator()(const T& a, const U& b) const { return cmp(b, a); }
+    Cmp cmp;
+};
+
+/// Restore the heap property of [first, first + n) after its top element was
+/// replaced.  This is half the work of a std::pop_heap() followed by a
+/// std::push_heap().
+template<typename Ran, typename Cmp>
+void sift_down_top(Ran first,
+                   typename std::iterator_traits<Ran>::difference_type n,
+                   Cmp c)
+{
+    typedef typename std::iterator_traits<Ran>::difference_type diff_t;
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    value_t val(std::move(*first));
+    diff_t hole = 0;
+    for( diff_t child = 1; child < n; child = 2 * hole + 1 ) {
+        if( child + 1 < n && c(first[child], first[child + 1]) ) ++child;
+        if( !c(val, first[child]) ) break;
+        first[hole] = std::move(first[child]);
+        hole = child;
+    }
+    first[hole] = std::move(val);
+}
+
+/// Draw a double uniformly from the open interval (0, 1).
+template<typename Gen>
+double uniform_open(Gen& g)
+{
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    double u;
+    do { u = dist(g); } while( u == 0.0 );
+    return u;
+}
+
+} // namespace detail
+
+/// Copy the k greatest elements of a sequence, in descending order.
+///
+/// The sequence is traversed exactly once, so it may be a single-pass source
+/// such as an istream_iterator range.  Only k elements are held in memory at
+/// any time, in a bounded heap whose top is the smallest element kept so far;
+/// once the heap is full an element that doesn't beat the top is rejected
+/// with a single comparison.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param k The number of elements to select.
+///
+/// \param res An _output iterator_ into which the selected elements are
+/// copied, greatest first.
+///
+/// \param c A comparator defining the order of elements, as in std::sort().
+///
+/// \return An iterator pointing to one-past-the-last element copied into the
+/// output.  At most k elements are copied.
+template<typename In, typename Size, typename Out, typename Cmp>
+Out top_k(In first, In last, Size k, Out res, Cmp c)
+{
+    typedef typename std::iterator_traits<In>::value_type value_t;
+    typedef detail::inverted_compare<Cmp> heap_cmp;
+    if( k <= 0 ) return res;
+    std::vector<value_t> heap;
+    heap.reserve(static_cast<std::size_t>(k));
+    for( ; first != last && heap.size() < static_cast<std::size_t>(k); ++first )
+        heap.push_back(*first);
+    std::make_heap(heap.begin(), heap.end(), heap_cmp(c));
+    const typename std::vector<value_t>::difference_type n = heap.size();
+    for( ; first != last; ++first ) {
+        if( !c(heap.front(), *first) ) continue;
+        heap.front() = *first;
+        detail::sift_down_top(heap.begin(), n, heap_cmp(c));
+    }
+    std::sort_heap(heap.begin(), heap.end(), heap_cmp(c));
+    return std::copy(heap.begin(), heap.end(), res);
+}
+
+/// Copy the k greatest elements of a sequence, in descending order.
+///
+/// \see top_k(In, In, Size, Out, Cmp)
+template<typename In, typename Size, typename Out>
+Out top_k(In first, In last, Size k, Out res)
+{
+    typedef typename std::iterator_traits<In>::value_type value_t;
+    return top_k(first, last, k, res, std::less<value_t>());
+}
+
+/// Copy a uniformly random sample of k elements of a sequence.
+///
+/// The sequence is traversed exactly once, so it may be a single-pass source
+/// of unknown length such as an istream_iterator range.  The algorithm is
+/// Li's "Algorithm L" reservoir sampling:  rather than drawing a random
+/// number per element, it draws the length of the geometrically distributed
+/// gap to the next element that enters the reservoir, so elements in between
+/// are only stepped over.  Memory use is k elements.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param k The number of elements to sample.  If the sequence holds fewer
+/// than k elements then all of them are copied.
+///
+/// \param res An _output iterator_ into which the sampled elements are
+/// copied.  The order of the sampled elements is unspecified.
+///
+/// \param g A uniform random bit generator, such as std::mt19937.
+///
+/// \return An iterator pointing to one-past-the-last element copied into the
+/// output.
+template<typename In, typename Size, typename Out, typename Gen>
+Out sample(In first, In last, Size k, Out res, Gen& g)
+{
+    typedef typename std::iterator_traits<In>::value_type value_t;
+    if( k <= 0 ) return res;
+    const std::size_t n = static_cast<std::size_t>(k);
+    std::vector<value_t> reservoir;
+    reservoir.reserve(n);
+    for( ; first != last && reservoir.size() < n; ++first )
+        reservoir.push_back(*first);
+    std::uniform_int_distribution<std::size_t> slot(0, n - 1);
+    double w = std::exp(std::log(detail::uniform_open(g)) / k);
+    while( first != last ) {
+        const double skip = std::floor(std::log(detail::uniform_open(g)) /
+                                       std::log1p(-w));
+        // skip may exceed any integer type on a long tail;  stepping stops at
+        // the end of the sequence anyway.
+        for( double i = 0; i < skip && first != last; ++i ) ++first;
+        if( first == last ) break;
+        reservoir[slot(g)] = *first;
+        ++first;
+        w *= std::exp(std::log(detail::uniform_open(g)) / k);
+    }
+    return std::copy(reservoir.begin(), reservoir.end(), res);
+}
+
+/// Copy the distinct elements of a sequence, in the order of their first
+/// occurrence.
+///
+/// Unlike unique(), equal elements need not be adjacent, so the input needn't
+/// be sorted.  The sequence is traversed once, so it may be a single-pass
+/// source;  the elements seen so far are kept in a flat_hash_set.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param res An _output iterator_ into which the distinct elements are
+/// copied.
+///
+/// \param expected The number of distinct elements expected, to size the
+/// hash set up front.
+///
+/// \return An iterator pointing to one-past-the-last element copied into the
+/// output.
+template<typename In, typename Out>
+Out distinct(In first, In last, Out res, std::size_t expected)
+{
+    typedef typename std::iterator_traits<In>::value_type value_t;
+    flat_hash_set<value_t> seen(expected);
+    for( ; first != last; ++first ) {
+        const value_t& v = *first;
+        if( seen.insert(v).second ) *res++ = v;
+    }
+    return res;
+}
+
+/// Copy the distinct elements of a sequence, in the order of their first
+/// occurrence.
+///
+/// \see distinct(In, In, Out, std::size_t)
+template<typename In, typename Out>
+Out distinct(In first, In last, Out res)
+{
+    return wt::distinct(first, last, res, 0);
+}
+
+/// Count the distinct elements of a sequence.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param expected The number of distinct elements expected, to size the
+/// hash set up front.
+///
+/// \return The number of distinct elements.
+template<typename In>
+std::size_t count_distinct(In first, In last, std::size_t expected)
+{
+    typedef typename std::iterator_traits<In>::value_type value_t;
+    flat_hash_set<value_t> seen(expected);
+    for( ; first != last; ++first ) seen.insert(*first);
+    return seen.size();
+}
+
+/// Count the distinct elements of a sequence.
+///
+/// \see count_distinct(In, In, std::size_t)
+template<typename In>
+std::size_t count_distinct(In first, In last)
+{
+    return wt::count_distinct(first, last, 0);
+}
+
+/// Count the elements of a sequence by key.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param key A function computing the key of an element.  It is called once
+/// per element.
+///
+/// \param expected The number of distinct keys expected, to size the hash map
+/// up front.
+///
+/// \return A map from each key to the number of elements with that key,
+/// iterating in the order in which the keys first occurred.
+template<typename In, typename KeyFn>
+flat_hash_map<typename detail::key_of<In,KeyFn>::type, std::size_t>
+count_by(In first, In last, KeyFn key, std::size_t expected)
+{
+    flat_hash_map<typename detail::key_of<In,KeyFn>::type, std::size_t>
+        counts(expected);
+    for( ; first != last; ++first ) ++counts[key(*first)];
+    return counts;
+}
+
+/// Count the elements of a sequence by key.
+///
+/// \see count_by(In, In, KeyFn, std::size_t)
+template<typename In, typename KeyFn>
+flat_hash_map<typename detail::key_of<In,KeyFn>::type, std::size_t>
+count_by(In first, In last, KeyFn key)
+{
+    return wt::count_by(first, last, key, 0);
+}
+
+namespace detail {
+
+/// Merge [first, middle) and [middle, last), of n1 and n2 elements, through a
+/// buffer that holds the shorter of the two.  The shorter range is moved into
+/// the buffer, then merged back from the end it shares with the other range.
+template<typename Bi, typename Ran, typename Cmp>
+void merge_through_buffer(Bi first, Bi middle, Bi last,
+                          std::size_t n1, std::size_t n2, Ran buf, Cmp c)
+{
+    if( n1 <= n2 ) {
+        const Ran buf_last = std::move(first, middle, buf);
+        Ran b = buf;
+        while( b != buf_last && middle != last ) {
+            if( c(*middle, *b) ) *first++ = std::move(*middle++);
+            else *first++ = std::move(*b++);
+        }
+        std::move(b, buf_last, first);
+    } else {
+        Ran b = std::move(middle, last, buf);
+        while( b != buf && middle != first ) {
+            Bi a = std::prev(middle);
+            if( c(*(b - 1), *a) ) {
+                *--last = std::move(*a);
+                middle = a;
+            } else {
+                *--last = std::move(*--b);
+            }
+        }
+        std::move_backward(buf, b, last);
+    }
+}
+
+/// Merge [first, middle) and [middle, last), of n1 and n2 elements, with a
+/// buffer of buf_n elements.  While the shorter range doesn't fit in the
+/// buffer, the longer one is cut in half and the other at the position of
+/// the cut element, and the two middle pieces are rotated into place, which
+/// leaves two smaller independent merges.
+template<typename Bi, typename Ran, typename Cmp>
+void merge_adaptive(Bi first, Bi middle, Bi last,
+                    std::size_t n1, std::size_t n2,
+                    Ran buf, std::size_t buf_n, Cmp c)
+{
+    if( n1 == 0 || n2 == 0 ) return;
+    if( std::min(n1, n2) <= buf_n ) {
+        detail::merge_through_buffer(first, middle, last, n1, n2, buf, c);
+        return;
+    }
+    if( n1 + n2 == 2 ) {
+        if( c(*middle, *first) ) std::iter_swap(first, middle);
+        return;
+    }
+    Bi cut1 = first, cut2 = middle;
+    std::size_t k1, k2;
+    if( n1 >= n2 ) {
+        k1 = n1 / 2;
+        std::advance(cut1, k1);
+        cut2 = std::lower_bound(middle, last, *cut1, c);
+        k2 = static_cast<std::size_t>(std::distance(middle, cut2));
+    } else {
+        k2 = n2 / 2;
+        std::advance(cut2, k2);
+        cut1 = std::upper_bound(first, middle, *cut2, c);
+        k1 = static_cast<std::size_t>(std::distance(first, cut1));
+    }
+    const Bi split = std::rotate(cut1, middle, cut2);
+    detail::merge_adaptive(first, cut1, split, k1, k2, buf, buf_n, c);
+    detail::merge_adaptive(split, cut2, last, n1 - k1, n2 - k2,
+                           buf, buf_n, c);
+}
+
+} // namespace detail
+
+/// Merge two consecutive sorted ranges in place, using a caller-supplied
+/// buffer.
+///
+/// Unlike std::inplace_merge(), which allocates a buffer of its own and
+/// silently falls back to an O(n log n) merge when the allocation fails, this
+/// uses exactly the memory it's given.  A buffer of min(n1, n2) elements
+/// makes the merge a single linear pass;  a smaller one costs rotations in
+/// proportion to how much smaller it is, and an empty one gives the
+/// O(n log n) rotation merge.  The merge is stable.
+///
+/// \param first A _bidirectional iterator_ pointing to the first element of
+/// the first sorted range.
+///
+/// \param middle A _bidirectional iterator_ pointing to the first element of
+/// the second sorted range, one-past-the-last of the first.
+///
+/// \param last A _bidirectional iterator_ pointing to one-past-the-last
+/// element of the second sorted range.
+///
+/// \param buf_first A _random access iterator_ pointing to the first element
+/// of the buffer.  The buffer holds constructed elements, which the merge
+/// overwrites by move assignment and leaves in a valid but unspecified state.
+///
+/// \param buf_last A _random access iterator_ pointing to one-past-the-last
+/// element of the buffer.
+///
+/// \param c A strict weak ordering by which both ranges are sorted.
+template<typename Bi, typename Ran, typename Cmp>
+void inplace_merge(Bi first, Bi middle, Bi last,
+                   Ran buf_first, Ran buf_last, Cmp c)
+{
+    detail::merge_adaptive(
+        first, middle, last,
+        static_cast<std::size_t>(std::distance(first, middle)),
+        static_cast<std::size_t>(std::distance(middle, last)),
+        buf_first, static_cast<std::size_t>(buf_last - buf_first), c);
+}
+
+/// Merge two consecutive sorted ranges in place, using a caller-supplied
+/// buffer.
+///
+/// \see inplace_merge(Bi, Bi, Bi, Ran, Ran, Cmp)
+template<typename Bi, typename Ran>
+void inplace_merge(Bi first, Bi middle, Bi last, Ran buf_first, Ran buf_last)
+{
+    typedef typename std::iterator_traits<Bi>::value_type value_t;
+    wt::inplace_merge(first, middle, last, buf_first, buf_last,
+                      std::less<value_t>());
+}
+
+namespace detail {
+
+/// Group the keys of [first, last) into hash shards, in parallel.  Each thread
+/// scans a block of the input and files the positions of its elements by the
+/// shard of their key's hash;  then each thread takes a shard and runs
+/// visit(shard, i) for the positions filed under it, in increasing order.
+/// Equal keys fall in the same shard, so the shards can be processed without
+/// sharing state.
+template<typename Ran, typename KeyFn, typename Visit>
+void for_each_sharded(const parallel_policy& pol, Ran first, Ran last,
+                      KeyFn key, unsigned shards, Visit visit)
+{
+    typedef typename key_of<Ran,KeyFn>::type key_t;
+    const std::size_t n = last - first;
+    const unsigned k = thread_count(pol, n);
+    std::vector<std::vector<std::vector<std::size_t> > > filed(k,
+        std::vector<std::vector<std::size_t> >(shards));
+    parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t end = block_begin(n, k, b + 1);
+        std::hash<key_t> hash;
+        for( std::size_t i = block_begin(n, k, b); i != end; ++i ) {
+            const std::uint64_t h = hash_mix(hash(key(first[i])));
+            filed[b][static_cast<std::size_t>((h >> 32) * shards >> 32)]
+                .push_back(i);
+        }
+    });
+    parallel_for(shards, k, [&](std::size_t s) {
+        for( std::size_t b = 0; b < k; ++b )
+            for( std::size_t j = 0; j < filed[b][s].size(); ++j )
+                visit(s, filed[b][s][j]);
+    });
+}
+
+template<typename T>
+struct identity {
+    const T& operator()(const T& v) const { return v; }
+};
+
+/// The position of the first occurrence of each distinct element of
+/// [first, last), in increasing order.
+template<typename Ran>
+std::vector<std::size_t> first_occurrences(const parallel_policy& pol,
+                                           Ran first, Ran last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    const unsigned shards = thread_count(pol, last - first);
+    std::vector<flat_hash_set<value_t> > seen(shards);
+    std::vector<std::vector<std::size_t> > found(shards);
+    for_each_sharded(pol, first, last, identity<value_t>(), shards,
+        [&](std::size_t s, std::size_t i) {
+            if( seen[s].insert(first[i]).second ) found[s].push_back(i);
+        });
+    std::vector<std::size_t> all;
+    for( std::size_t s = 0; s < shards; ++s )
+        all.insert(all.end(), found[s].begin(), found[s].end());
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+} // namespace detail
+
+/// Copy the distinct elements of a range in the order of their first
+/// occurrence, in parallel.
+///
+/// The elements are partitioned by hash into one shard per thread;  each
+/// thread then deduplicates its shard in a hash set of its own.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param res An _output iterator_ into which the distinct elements are
+/// copied.
+///
+/// \return An iterator pointing to one-past-the-last element copied into the
+/// output.
+template<typename Ran, typename Out>
+Out distinct(const parallel_policy& pol, Ran first, Ran last, Out res)
+{
+    if( detail::thread_count(pol, last - first) == 1 )
+        return wt::distinct(first, last, res);
+    const std::vector<std::size_t> at =
+        detail::first_occurrences(pol, first, last);
+    for( std::size_t j = 0; j < at.size(); ++j ) *res++ = first[at[j]];
+    return res;
+}
+
+/// Count the distinct elements of a range, in parallel.
+///
+/// \see distinct(const parallel_policy&, Ran, Ran, Out)
+template<typename Ran>
+std::size_t count_distinct(const parallel_policy& pol, Ran first, Ran last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    const unsigned shards = detail::thread_count(pol, last - first);
+    if( shards == 1 ) return wt::count_distinct(first, last);
+    std::vector<flat_hash_set<value_t> > seen(shards);
+    detail::for_each_sharded(pol, first, last, detail::identity<value_t>(),
+        shards, [&](std::size_t s, std::size_t i) { seen[s].insert(first[i]); });
+    std::size_t n = 0;
+    for( std::size_t s = 0; s < shards; ++s ) n += seen[s].size();
+    return n;
+}
+
+/// Count the elements of a range by key, in parallel.
+///
+/// The keys are partitioned by hash into one shard per thread, and each
+/// thread tallies its shard in a hash map of its own.  The key function is
+/// therefore called twice per element, concurrently.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param key A function computing the key of an element.
+///
+/// \return A map from each key to the number of elements with that key,
+/// iterating in the order in which the keys first occurred.
+template<typename Ran, typename KeyFn>
+flat_hash_map<typename detail::key_of<Ran,KeyFn>::type, std::size_t>
+count_by(const parallel_policy& pol, Ran first, Ran last, KeyFn key)
+{
+    typedef typename detail::key_of<Ran,KeyFn>::type key_t;
+    typedef flat_hash_map<key_t, std::pair<std::size_t,std::size_t> > tally;
+    const unsigned shards = detail::thread_count(pol, last - first);
+    if( shards == 1 ) return wt::count_by(first, last, key);
+    // Tally (first position, count) per key in each shard, then merge the
+    // shards ordered by first position.
+    std::vector<tally> tallies(shards);
+    detail::for_each_sharded(pol, first, last, key, shards,
+        [&](std::size_t s, std::size_t i) {
+            std::pair<std::size_t,std::size_t>& t = tallies[s][key(first[i])];
+            if( t.second++ == 0 ) t.first = i;
+        });
+    std::vector<typename tally::const_iterator> order;
+    for( std::size_t s = 0; s < shards; ++s )
+        for( typename tally::const_iterator it = tallies[s].begin();
+             it != tallies[s].end(); ++it )
+            order.push_back(it);
+    std::sort(order.begin(), order.end(),
+        [](typename tally::const_iterator a, typename tally::const_iterator b) {
+            return a->second.first < b->second.first;
+        });
+    flat_hash_map<key_t, std::size_t> counts(order.size());
+    for( std::size_t j = 0; j < order.size(); ++j )
+        counts.insert(std::make_pair(order[j]->first, order[j]->second.second));
+    return counts;
+}
+
+namespace detail {
+
+/// Number of bins up to which tally() spreads counts over several
+/// sub-histograms.
+const std::size_t sub_histogram_bins = std::size_t(1) << 12;
+
+/// Bin of an integral value:  the value itself, or bins if it falls outside
+/// [0, bins).
+struct value_bin {
+    explicit value_bin(std::size_t n) : bins(n) { }
+    template<typename V>
+    std::size_t operator()(const V& v) const
+    {
+        // Negative values wrap around to huge ones, and so fall out too.
+        const std::size_t b = static_cast<std::size_t>(v);
+        return b < bins ? b : bins;
+    }
+    std::size_t bins;
+};
+
+/// Bin of a value among bins of equal width over [lo, hi], or bins if it falls
+/// outside.  The last bin is closed, so hi falls in it.  If lo == hi, every
+/// value equal to them falls in the first bin.
+struct width_bin {
+    width_bin(double l, double h, std::size_t n)
+        : lo(l), hi(h), scale(h > l ? n / (h - l) : 0), bins(n) { }
+    template<typename V>
+    std::size_t operator()(const V& v) const
+    {
+        const double x = static_cast<double>(v);
+        if( !(x >= lo && x <= hi) ) return bins;
+        const std::size_t b = static_cast<std::size_t>((x - lo) * scale);
+        return b < bins ? b : bins - 1;
+    }
+    double lo, hi, scale;
+    std::size_t bins;
+};
+
+/// Add the elements of [first, last) to counts by bin(element).
+template<typename In, typename Bin>
+void tally(In first, In last, Bin bin, std::size_t* counts, std::size_t bins,
+           std::input_iterator_tag)
+{
+    for( ; first != last; ++first ) {
+        const std::size_t b = bin(*first);
+        if( b < bins ) ++counts[b];
+    }
+}
+
+template<typename Ran, typename Bin>
+void tally(Ran first, Ran last, Bin bin, std::size_t* counts, std::size_t bins,
+           std::random_access_iterator_tag)
+{
+    if( bins > sub_histogram_bins || last - first < 1024 ) {
+        tally(first, last, bin, counts, bins, std::input_iterator_tag());
+        return;
+    }
+    // Runs of equal keys would increment one counter over and over, each
+    // increment waiting on the store of the one before.  Four interleaved
+    // sub-histograms let four increments proceed independently.  Each has an
+    // extra bin that swallows out-of-range elements without a branch.
+    const std::size_t stride = bins + 1;
+    std::vector<std::size_t> sub(4 * stride, 0);
+    std::size_t* const c0 = &sub[0];
+    std::size_t* const c1 = c0 + stride;
+    std::size_t* const c2 = c1 + stride;
+    std::size_t* const c3 = c2 + stride;
+    for( ; last - first >= 4; first += 4 ) {
+        ++c0[bin(first[0])];
+        ++c1[bin(first[1])];
+        ++c2[bin(first[2])];
+        ++c3[bin(first[3])];
+    }
+    for( ; first != last; ++first ) ++c0[bin(*first)];
+    for( std::size_t b = 0; b < bins; ++b )
+        counts[b] += c0[b] + c1[b] + c2[b] + c3[b];
+}
+
+template<typename In, typename Bin>
+std::vector<std::size_t> histogram(In first, In last, Bin bin, std::size_t bins)
+{
+    std::vector<std::size_t> counts(bins, 0);
+    if( bins != 0 )
+        tally(first, last, bin, &counts[0], bins,
+              typename std::iterator_traits<In>::iterator_category());
+    return counts;
+}
+
+/// Per-block histograms of [first, last) computed in parallel, k blocks of
+/// bins counts each.
+template<typename Ran, typename Bin>
+std::vector<std::size_t> block_histograms(Ran first, Ran last, Bin bin,
+                                          std::size_t bins, unsigned k)
+{
+    const std::size_t n = last - first;
+    std::vector<std::size_t> counts(k * bins, 0);
+    if( bins == 0 ) return counts;
+    parallel_for(k, k, [&](std::size_t b) {
+        tally(first + block_begin(n, k, b), first + block_begin(n, k, b + 1),
+              bin, &counts[b * bins], bins, std::random_access_iterator_tag());
+    });
+    return counts;
+}
+
+template<typename Ran, typename Bin>
+std::vector<std::size_t> histogram(const parallel_policy& pol,
+                                   Ran first, Ran last,
+                                   Bin bin, std::size_t bins)
+{
+    const unsigned k = thread_count(pol, last - first);
+    if( k == 1 ) return histogram(first, last, bin, bins);
+    std::vector<std::size_t> counts = block_histograms(first, last, bin,
+                                                       bins, k);
+    for( std::size_t b = 1; b < k; ++b )
+        for( std::size_t i = 0; i < bins; ++i )
+            counts[i] += counts[b * bins + i];
+    counts.resize(bins);
+    return counts;
+}
+
+/// Bin of an element given by a key function, for counting_sort().
+template<typename KeyFn>
+struct key_bin {
+    key_bin(KeyFn k, std::size_t n) : key(k), bins(n) { }
+    template<typename V>
+    std::size_t operator()(const V& v) const { return bins(key(v)); }
+    KeyFn key;
+    value_bin bins;
+};
+
+} // namespace detail
+
+/// Count the integral elements of a sequence by value.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param bins The number of bins.  Elements outside [0, bins) are not
+/// counted.
+///
+/// \return A vector of bins counts, where the count at index v is the number
+/// of elements equal to v.
+template<typename In>
+std::vector<std::size_t> histogram(In first, In last, std::size_t bins)
+{
+    return detail::histogram(first, last, detail::value_bin(bins), bins);
+}
+
+/// Count the elements of a sequence by fixed-width bins.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param lo The lower bound of the first bin.
+///
+/// \param hi The upper bound of the last bin, which includes hi itself.
+/// Elements outside [lo, hi], and NaNs, are not counted.  If hi == lo, the
+/// elements equal to them are counted in the first bin.
+///
+/// \param bins The number of bins, each (hi - lo) / bins wide.
+///
+/// \return A vector of bins counts.
+template<typename In>
+std::vector<std::size_t> histogram(In first, In last,
+                                   double lo, double hi, std::size_t bins)
+{
+    return detail::histogram(first, last, detail::width_bin(lo, hi, bins),
+                             bins);
 }
 
+/// Count the integral elements of a range by value, in parallel.
+///
+/// Each thread counts a block of the range into a histogram of its own;  the
+/// histograms are summed at the end.
+///
+/// \see histogram(In, In, std::size_t)
+template<typename Ran>
+std::vector<std::size_t> histogram(const parallel_policy& pol,
+                                   Ran first, Ran last, std::size_t bins)
+{
+    return detail::histogram(pol, first, last, detail::value_bin(bins), bins);
+}
+
+/// Count the elements of a range by fixed-width bins, in parallel.
+///
+/// \see histogram(In, In, double, double, std::size_t)
+template<typename Ran>
+std::vector<std::size_t> histogram(const parallel_policy& pol,
+                                   Ran first, Ran last,
+                                   double lo, double hi, std::size_t bins)
+{
+    return detail::histogram(pol, first, last,
+                             detail::width_bin(lo, hi, bins), bins);
+}
+
+/// Sort a range of small integral values by counting them.
+///
+/// The elements are counted into a histogram, then the range is rewritten
+/// from the counts.  This takes two linear passes, however many elements
+/// there are, and beats comparison sorts for eight- and sixteen-bit values
+/// and other keys with a small known domain.
+///
+/// \param first A _forward iterator_ pointing to the first element of the
+/// range.
+///
+/// \param last A _forward iterator_ pointing to the last element of the range.
+///
+/// \param key_range The number of values the elements range over.  Every
+/// element must lie in [0, key_range).
+template<typename Fwd>
+void counting_sort(Fwd first, Fwd last, std::size_t key_range)
+{
+    typedef typename std::iterator_traits<Fwd>::value_type value_t;
+    const std::vector<std::size_t> counts = wt::histogram(first, last,
+                                                          key_range);
+    for( std::size_t v = 0; v < key_range; ++v )
+        first = std::fill_n(first, counts[v], static_cast<value_t>(v));
+}
+
+/// Partition a range stably into numbered buckets.
+///
+/// The bucket ids are counted into a histogram, whose prefix sums give every
+/// bucket its offset in the output;  the elements are then moved to their
+/// offsets through a buffer.  The bucket function is called twice per
+/// element.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param buckets The number of buckets.  Every bucket id must lie in
+/// [0, buckets).
+///
+/// \param bucket A function computing the integral bucket id of an element.
+///
+/// \return A vector of buckets + 1 offsets, where bucket b holds the elements
+/// in [first + r[b], first + r[b + 1]).
+template<typename Ran, typename BucketFn>
+std::vector<std::size_t> multiway_partition(Ran first, Ran last,
+                                            std::size_t buckets,
+                                            BucketFn bucket)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    const detail::key_bin<BucketFn> bin(bucket, buckets);
+    std::vector<std::size_t> offsets = detail::histogram(first, last, bin,
+                                                         buckets);
+    std::vector<std::size_t> starts(buckets + 1);
+    std::size_t sum = 0;
+    for( std::size_t v = 0; v < buckets; ++v ) {
+        const std::size_t c = offsets[v];
+        offsets[v] = starts[v] = sum;
+        sum += c;
+    }
+    starts[buckets] = sum;
+    std::vector<value_t> buf(std::make_move_iterator(first),
+                             std::make_move_iterator(last));
+    for( std::size_t i = 0; i < buf.size(); ++i )
+        first[offsets[bin(buf[i])]++] = std::move(buf[i]);
+    return starts;
+}
+
+/// Stable-sort a range by a small integral key, by counting the keys.
+///
+/// The keys are counted into a histogram, whose prefix sums give every key
+/// its offset in the output;  the elements are then moved to their offsets
+/// through a buffer.  The key function is called twice per element.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param key_range The number of values keys range over.  Every key must lie
+/// in [0, key_range).
+///
+/// \param key A function computing the integral key of an element.
+///
+/// \see multiway_partition(Ran, Ran, std::size_t, BucketFn)
+template<typename Ran, typename KeyFn>
+void counting_sort(Ran first, Ran last, std::size_t key_range, KeyFn key)
+{
+    wt::multiway_partition(first, last, key_range, key);
+}
+
+/// Sort a range of small integral values by counting them, in parallel.
+///
+/// Threads count blocks of the range into histograms of their own, then
+/// rewrite blocks of the output from the summed counts.
+///
+/// \see counting_sort(Fwd, Fwd, std::size_t)
+template<typename Ran>
+void counting_sort(const parallel_policy& pol,
+                   Ran first, Ran last, std::size_t key_range)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    const std::size_t n = last - first;
+    const unsigned k = detail::thread_count(pol, n);
+    if( k == 1 ) return wt::counting_sort(first, last, key_range);
+    std::vector<std::size_t> ends = wt::histogram(pol, first, last, key_range);
+    std::partial_sum(ends.begin(), ends.end(), ends.begin());
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        std::size_t i = detail::block_begin(n, k, b);
+        const std::size_t stop = detail::block_begin(n, k, b + 1);
+        std::size_t v = std::upper_bound(ends.begin(), ends.end(), i)
+                      - ends.begin();
+        while( i != stop ) {
+            const std::size_t run = std::min(ends[v], stop) - i;
+            std::fill_n(first + i, run, static_cast<value_t>(v));
+            i += run;
+            ++v;
+        }
+    });
+}
+
+/// Partition a range stably into numbered buckets, in parallel.
+///
+/// Each thread counts the bucket ids of a block of the range.  The per-block
+/// counts give every (bucket, block) pair its own offset in the output, so
+/// the threads then move their blocks' elements to place concurrently.
+///
+/// \param pol The parallel policy.
+///
+/// \see multiway_partition(Ran, Ran, std::size_t, BucketFn)
+template<typename Ran, typename BucketFn>
+std::vector<std::size_t> multiway_partition(const parallel_policy& pol,
+                                            Ran first, Ran last,
+                                            std::size_t buckets,
+                                            BucketFn bucket)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    const std::size_t n = last - first;
+    const unsigned k = detail::thread_count(pol, n);
+    if( k == 1 ) return wt::multiway_partition(first, last, buckets, bucket);
+    const detail::key_bin<BucketFn> bin(bucket, buckets);
+    std::vector<std::size_t> offsets =
+        detail::block_histograms(first, last, bin, buckets, k);
+    std::vector<std::size_t> starts(buckets + 1);
+    std::size_t sum = 0;
+    for( std::size_t v = 0; v < buckets; ++v ) {
+        starts[v] = sum;
+        for( std::size_t b = 0; b < k; ++b ) {
+            const std::size_t c = offsets[b * buckets + v];
+            offsets[b * buckets + v] = sum;
+            sum += c;
+        }
+    }
+    starts[buckets] = sum;
+    std::vector<value_t> buf(std::make_move_iterator(first),
+                             std::make_move_iterator(last));
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        std::size_t* const at = &offsets[b * buckets];
+        const std::size_t stop = detail::block_begin(n, k, b + 1);
+        for( std::size_t i = detail::block_begin(n, k, b); i != stop; ++i )
+            first[at[bin(buf[i])]++] = std::move(buf[i]);
+    });
+    return starts;
+}
+
+/// Stable-sort a range by a small integral key, by counting the keys, in
+/// parallel.
+///
+/// \see multiway_partition(const parallel_policy&, Ran, Ran, std::size_t,
+/// BucketFn)
+/// \see counting_sort(Ran, Ran, std::size_t, KeyFn)
+template<typename Ran, typename KeyFn>
+void counting_sort(const parallel_policy& pol, Ran first, Ran last,
+                   std::size_t key_range, KeyFn key)
+{
+    wt::multiway_partition(pol, first, last, key_range, key);
+}
+
+/// Copy the elements of a sequence that satisfy a predicate.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param res An _output iterator_ pointing to the container into which the
+/// elements should be copied.
+///
+/// \param op A predicate which elements to be copied must satisfy.
+///
+/// \return An iterator pointing to one-past-the-last element of the output
+/// container.
+template<typename In, typename Out, typename Pred>
+Out copy_if(In first, In last, Out res, Pred op)
+{
+    for( ; first != last; ++first )
+        if( op(*first) ) *res++ = *first;
+    return res;
+}
+
+/// Move the elements of a sequence that satisfy a predicate.  The
+/// moved-from elements stay in the sequence, valid but unspecified, as with
+/// std::move().
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param res An _output iterator_ pointing to the container into which the
+/// elements should be moved.
+///
+/// \param op A predicate which elements to be moved must satisfy.  It is
+/// called on each element before the element is moved.
+///
+/// \return An iterator pointing to one-past-the-last element of the output
+/// container.
+template<typename In, typename Out, typename Pred>
+Out move_if(In first, In last, Out res, Pred op)
+{
+    for( ; first != last; ++first )
+        if( op(*first) ) *res++ = std::move(*first);
+    return res;
+}
+
+namespace detail {
+
+// Stream compaction.  The iseq wrappers of remove_if(), remove_copy_if(),
+// copy_if(), unique() and unique_copy() route contiguous ranges of arithmetic
+// values to detail::compact(), which evaluates the predicate into a bit mask
+// and moves the kept elements with vector compress-stores, without a branch
+// per element.  Other ranges take the standard algorithms.  partition() and
+// stable_partition() take the predicate as a bit mask the same way, for a
+// branch-free pass and for compress-stores respectively.
+
+template<typename T, typename Pred>
+struct keep_if {
+    keep_if(const T* s, Pred p) : src(s), op(p) { }
+    bool operator()(std::size_t i) { return op(src[i]) ? true : false; }
+    const T* src;
+    Pred op;
+};
+
+template<typename T, typename Pred>
+struct keep_unless {
+    keep_unless(const T* s, Pred p) : src(s), op(p) { }
+    bool operator()(std::size_t i) { return op(src[i]) ? false : true; }
+    const T* src;
+    Pred op;
+};
+
+template<typename T, typename V>
+struct keep_unequal {
+    keep_unequal(const T* s, const V& v) : src(s), val(v) { }
+    bool operator()(std::size_t i) { return !(src[i] == val); }
+    const T* src;
+    const V& val;
+};
+
+/// Keep the first element of each group of consecutive equivalent elements.
+/// If before isn't null it is the element preceding the range.
+template<typename T, typename BinPred>
+struct keep_distinct {
+    keep_distinct(const T* s, const T* b, BinPred p)
+        : src(s), before(b), op(p) { }
+    bool operator()(std::size_t i)
+    {
+        if( i != 0 ) return !op(src[i - 1], src[i]);
+        return before == 0 || !op(*before, src[0]);
+    }
+    const T* src;
+    const T* before;
+    BinPred op;
+};
+
+template<typename In, typename Out>
+struct is_compactable_copy
+    : std::integral_constant<bool,
+        is_contiguous_arithmetic<In>::value &&
+        is_contiguous_iterator<Out>::value &&
+        std::is_same<typename std::iterator_traits<In>::value_type,
+                     typename std::iterator_traits<Out>::value_type>::value &&
+        !std::is_const<typename std::remove_pointer<
+            typename std::iterator_traits<Out>::pointer>::type>::value> { };
+
+/// Compact [first, last) in place, keeping the elements keep selects.  keep
+/// is constructed from the address of the range and the given argument.
+template<template<typename, typename> class Keep, typename Fwd, typename A>
+Fwd compact_in_place(Fwd first, Fwd last, A arg)
+{
+    typedef typename std::iterator_traits<Fwd>::value_type T;
+    if( first == last ) return last;
+    T* const p = address_of(first);
+    T* const e = compact(p, last - first, p, Keep<T,A>(p, arg));
+    return first + (e - p);
+}
+
+/// Compact [first, last) into res, keeping the elements keep selects.
+template<template<typename, typename> class Keep,
+         typename In, typename Out, typename A>
+Out compact_copy(In first, In last, Out res, A arg)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    if( first == last ) return res;
+    const T* const p = address_of(first);
+    T* const d = address_of(res);
+    return res + (compact(p, last - first, d, Keep<T,A>(p, arg)) - d);
+}
+
+template<typename Fwd, typename Pred>
+Fwd remove_if(Fwd first, Fwd last, Pred op, std::false_type)
+{
+    return std::remove_if(first, last, op);
+}
+
+template<typename Fwd, typename Pred>
+Fwd remove_if(Fwd first, Fwd last, Pred op, std::true_type)
+{
+    return compact_in_place<keep_unless>(first, last, op);
+}
+
+template<typename Fwd, typename V>
+Fwd remove(Fwd first, Fwd last, const V& val, std::false_type)
+{
+    return std::remove(first, last, val);
+}
+
+template<typename Fwd, typename V>
+Fwd remove(Fwd first, Fwd last, const V& val, std::true_type)
+{
+    typedef typename std::iterator_traits<Fwd>::value_type T;
+    if( first == last ) return last;
+    T* const p = address_of(first);
+    T* const e = compact(p, last - first, p, keep_unequal<T,V>(p, val));
+    return first + (e - p);
+}
+
+template<typename In, typename Out, typename Pred>
+Out remove_copy_if(In first, In last, Out res, Pred op, std::false_type)
+{
+    return std::remove_copy_if(first, last, res, op);
+}
+
+template<typename In, typename Out, typename Pred>
+Out remove_copy_if(In first, In last, Out res, Pred op, std::true_type)
+{
+    return compact_copy<keep_unless>(first, last, res, op);
+}
+
+template<typename In, typename Out, typename V>
+Out remove_copy(In first, In last, Out res, const V& val, std::false_type)
+{
+    return std::remove_copy(first, last, res, val);
+}
+
+template<typename In, typename Out, typename V>
+Out remove_copy(In first, In last, Out res, const V& val, std::true_type)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    if( first == last ) return res;
+    const T* const p = address_of(first);
+    T* const d = address_of(res);
+    return res + (compact(p, last - first, d, keep_unequal<T,V>(p, val)) - d);
+}
+
+template<typename In, typename Out, typename Pred>
+Out copy_if(In first, In last, Out res, Pred op, std::false_type)
+{
+    return wt::copy_if(first, last, res, op);
+}
+
+template<typename In, typename Out, typename Pred>
+Out copy_if(In first, In last, Out res, Pred op, std::true_type)
+{
+    return compact_copy<keep_if>(first, last, res, op);
+}
+
+/// Remove consecutive duplicates from [first, last), also dropping leading
+/// elements equivalent to *before if before isn't null.
+template<typename Fwd, typename BinPred>
+Fwd unique(Fwd first, Fwd last,
+           const typename std::iterator_traits<Fwd>::value_type* before,
+           BinPred op, std::false_type)
+{
+    if( before == 0 ) return std::unique(first, last, op);
+    Fwd head = first;
+    while( head != last && op(*before, *head) ) ++head;
+    if( head == first ) return std::unique(first, last, op);
+    return std::move(head, std::unique(head, last, op), first);
+}
+
+template<typename Fwd, typename BinPred>
+Fwd unique(Fwd first, Fwd last,
+           const typename std::iterator_traits<Fwd>::value_type* before,
+           BinPred op, std::true_type)
+{
+    typedef typename std::iterator_traits<Fwd>::value_type T;
+    if( first == last ) return last;
+    T* const p = address_of(first);
+    T* const e = compact(p, last - first, p,
+                         keep_distinct<T,BinPred>(p, before, op));
+    return first + (e - p);
+}
+
+/// Copy [first, last) without consecutive duplicates, also skipping leading
+/// elements equivalent to *before if before isn't null.
+template<typename In, typename Out, typename BinPred>
+Out unique_copy(In first, In last,
+                const typename std::iterator_traits<In>::value_type* before,
+                Out res, BinPred op, std::false_type)
+{
+    if( before != 0 )
+        while( first != last && op(*before, *first) ) ++first;
+    return std::unique_copy(first, last, res, op);
+}
+
+template<typename In, typename Out, typename BinPred>
+Out unique_copy(In first, In last,
+                const typename std::iterator_traits<In>::value_type* before,
+                Out res, BinPred op, std::true_type)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    if( first == last ) return res;
+    const T* const p = address_of(first);
+    T* const d = address_of(res);
+    return res + (compact(p, last - first, d,
+                          keep_distinct<T,BinPred>(p, before, op)) - d);
+}
+
+// The filtering copies as writers for append_at_most(), which calls them on
+// blocks of the input with either a contiguous iterator into the container
+// appended to or an into_iterator.
+
+/// Whether the output of a filtering copy of In may be compacted into the
+/// storage of a C.
+template<typename In, typename C>
+struct is_compactable_into
+    : std::integral_constant<bool,
+        is_compactable_copy<In, typename C::iterator>::value> { };
+
+template<typename In, typename Pred>
+struct copy_if_writer {
+    explicit copy_if_writer(Pred p) : op(p) { }
+
+    template<typename Out>
+    Out operator()(In first, In last, Out res) const
+    {
+        return detail::copy_if(first, last, res, op,
+                               is_compactable_copy<In,Out>());
+    }
+
+    Pred op;
+};
+
+template<typename In, typename Pred>
+struct remove_copy_if_writer {
+    explicit remove_copy_if_writer(Pred p) : op(p) { }
+
+    template<typename Out>
+    Out operator()(In first, In last, Out res) const
+    {
+        return detail::remove_copy_if(first, last, res, op,
+                                      is_compactable_copy<In,Out>());
+    }
+
+    Pred op;
+};
+
+template<typename In, typename V>
+struct remove_copy_writer {
+    explicit remove_copy_writer(const V& v) : val(v) { }
+
+    template<typename Out>
+    Out operator()(In first, In last, Out res) const
+    {
+        return detail::remove_copy(first, last, res, val,
+                                   is_compactable_copy<In,Out>());
+    }
+
+    const V& val;
+};
+
+/// A block after the first of the input begun at start skips the duplicates
+/// of the element before it.  Only contiguous inputs are split in blocks.
+template<typename In, typename BinPred>
+struct unique_copy_writer {
+    typedef typename std::iterator_traits<In>::value_type value_t;
+
+    unique_copy_writer(In s, BinPred p) : start(s), op(p) { }
+
+    template<typename Out>
+    Out operator()(In first, In last, Out res) const
+    {
+        return detail::unique_copy(first, last,
+                                   before(first, is_contiguous_iterator<In>()),
+                                   res, op, is_compactable_copy<In,Out>());
+    }
+
+    const value_t* before(In first, std::true_type) const
+    {
+        return first == start ? 0 : address_of(start) + (first - start) - 1;
+    }
+
+    const value_t* before(In, std::false_type) const { return 0; }
+
+    In start;
+    BinPred op;
+};
+
+/// Evaluate a predicate on the n elements at first into a bit mask, bit
+/// i % 64 of word i / 64 for element i, and count the elements satisfying
+/// it.  Each word is gathered without a branch, a loop compilers vectorize
+/// when the predicate is simple arithmetic on the elements.
+template<typename Ran, typename Pred>
+std::size_t predicate_bits(Ran first, std::size_t n, Pred op,
+                           std::uint64_t* bits)
+{
+    std::size_t count = 0;
+    for( std::size_t i = 0; i < n; i += 64 ) {
+        const std::size_t m = std::min<std::size_t>(64, n - i);
+        std::uint64_t w = 0;
+        for( std::size_t j = 0; j < m; ++j )
+            w |= std::uint64_t(op(first[i + j]) ? 1 : 0) << j;
+        bits[i / 64] = w;
+        count += popcount64(w);
+    }
+    return count;
+}
+
+/// Move the n elements at src to consecutive positions from trues if their
+/// bit is set, and from falses otherwise, preserving their order.  ntrue is
+/// the number of bits set.
+template<typename T, typename Ran>
+void partition_scatter(T* src, std::size_t n, const std::uint64_t* bits,
+                       std::size_t, Ran trues, Ran falses, std::false_type)
+{
+    for( std::size_t i = 0; i < n; ++i ) {
+        if( bits[i / 64] >> (i % 64) & 1 ) *trues++ = std::move(src[i]);
+        else *falses++ = std::move(src[i]);
+    }
+}
+
+template<typename T, typename Ran>
+void partition_scatter(T* src, std::size_t n, const std::uint64_t* bits,
+                       std::size_t ntrue, Ran trues, Ran falses,
+                       std::true_type)
+{
+    if( ntrue != 0 ) compact_bits(src, n, address_of(trues), bits, 0);
+    if( ntrue != n ) compact_bits(src, n, address_of(falses), bits,
+                                     ~std::uint64_t(0));
+}
+
+template<typename Bi, typename Pred>
+Bi partition(Bi first, Bi last, Pred op, std::false_type)
+{
+    return std::partition(first, last, op);
+}
+
+/// Partition contiguous arithmetic values with a branch-free Lomuto pass.
+/// Every element is swapped to the end of the prefix that satisfies the
+/// predicate, and the prefix grows by the element's bit, so a random
+/// predicate costs no mispredicted branches.
+template<typename Ran, typename Pred>
+Ran partition(Ran first, Ran last, Pred op, std::true_type)
+{
+    typedef typename std::iterator_traits<Ran>::value_type T;
+    if( first == last ) return last;
+    T* const p = address_of(first);
+    const std::size_t n = last - first;
+    std::size_t out = 0;
+    for( std::size_t i = 0; i < n; i += 64 ) {
+        const std::size_t m = std::min<std::size_t>(64, n - i);
+        std::uint64_t bits;
+        predicate_bits(p + i, m, op, &bits);
+        for( std::size_t j = 0; j < m; ++j ) {
+            const T v = p[i + j];
+            p[i + j] = p[out];
+            p[out] = v;
+            out += bits >> j & 1;
+        }
+    }
+    return first + out;
+}
+
+template<typename Bi, typename Pred>
+Bi stable_partition(Bi first, Bi last, Pred op, std::false_type)
+{
+    return std::stable_partition(first, last, op);
+}
+
+/// Partition contiguous arithmetic values stably.  The predicate is taken
+/// as a bit mask first, which sizes the buffer for the elements that fail
+/// it;  those are then compacted onto the buffer, the ones that satisfy it
+/// compacted in place, and the buffer copied after them.
+template<typename Ran, typename Pred>
+Ran stable_partition(Ran first, Ran last, Pred op, std::true_type)
+{
+    typedef typename std::iterator_traits<Ran>::value_type T;
+    if( first == last ) return last;
+    T* const p = address_of(first);
+    const std::size_t n = last - first;
+    std::vector<std::uint64_t> bits((n + 63) / 64);
+    const std::size_t ntrue = predicate_bits(p, n, op, &bits[0]);
+    if( ntrue == 0 || ntrue == n ) return first + ntrue;
+    std::unique_ptr<T[]> rest(new T[n - ntrue]);
+    compact_bits(p, n, rest.get(), &bits[0], ~std::uint64_t(0));
+    compact_bits(p, n, p, &bits[0], 0);
+    std::copy(rest.get(), rest.get() + (n - ntrue), p + ntrue);
+    return first + ntrue;
+}
+
+/// Compact each of a number of blocks of [first, last) in place in parallel
+/// with block(block_first, block_last, b), which returns the block's new end,
+/// then close the gaps between blocks.
+template<typename Ran, typename Block>
+Ran compact_blocks(const parallel_policy& pol, Ran first, Ran last, Block block)
+{
+    const std::size_t n = last - first;
+    const unsigned k = thread_count(pol, n);
+    if( k == 1 ) return block(first, last, std::size_t(0));
+    std::vector<Ran> ends(k, first);
+    parallel_for(k, k, [&](std::size_t b) {
+        ends[b] = block(first + block_begin(n, k, b),
+                        first + block_begin(n, k, b + 1), b);
+    });
+    Ran res = ends[0];
+    for( std::size_t b = 1; b < k; ++b )
+        res = std::move(first + block_begin(n, k, b), ends[b], res);
+    return res;
+}
+
+/// Compact [first, last) into res in parallel, in two passes.  The first
+/// counts the elements kept in each block with count(block_first, block_last,
+/// b);  the second copies each block to its offset in the output with
+/// block(block_first, block_last, block_res, b).
+template<typename Ran, typename Out, typename Count, typename Block>
+Out compact_blocks_copy(const parallel_policy& pol, Ran first, Ran last,
+                        Out res, Count count, Block block)
+{
+    const std::size_t n = last - first;
+    const unsigned k = thread_count(pol, n);
+    if( k == 1 ) return block(first, last, res, std::size_t(0));
+    std::vector<std::size_t> offsets(k + 1, 0);
+    parallel_for(k, k, [&](std::size_t b) {
+        offsets[b + 1] = count(first + block_begin(n, k, b),
+                               first + block_begin(n, k, b + 1), b);
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    parallel_for(k, k, [&](std::size_t b) {
+        block(first + block_begin(n, k, b), first + block_begin(n, k, b + 1),
+              res + offsets[b], b);
+    });
+    return res + offsets[k];
+}
+
+/// The elements preceding each block of [first, last) split for
+/// compact_blocks(), taken before any block is modified.
+template<typename Ran>
+std::vector<typename std::iterator_traits<Ran>::value_type>
+block_boundaries(const parallel_policy& pol, Ran first, Ran last)
+{
+    std::vector<typename std::iterator_traits<Ran>::value_type> before;
+    const std::size_t n = last - first;
+    const unsigned k = thread_count(pol, n);
+    before.reserve(k);
+    for( std::size_t b = 0; b < k; ++b )
+        before.push_back(b == 0 ? *first : first[block_begin(n, k, b) - 1]);
+    return before;
+}
+
+} // namespace detail
+
+namespace detail {
+
+// Comparison of two sequences.  The iseq wrappers of equal(), mismatch(),
+// match() and lexicographical_compare() route pairs of contiguous ranges of
+// the same arithmetic type to detail::find_equality(), which compares whole
+// vectors of elements at a time, or to memcmp() where byte order and element
+// order agree.
+
+template<typename In, typename In2>
+struct is_comparable_contiguous
+    : std::integral_constant<bool,
+        is_contiguous_arithmetic<In>::value &&
+        is_contiguous_arithmetic<In2>::value &&
+        std::is_same<typename std::iterator_traits<In>::value_type,
+                     typename std::iterator_traits<In2>::value_type>::value> { };
+
+/// The offset of the first position at which two contiguous ranges of n
+/// elements each compare (un)equal, or n.
+template<typename In, typename In2>
+std::size_t equality_offset(In first1, In2 first2, std::size_t n, bool equal)
+{
+    if( n == 0 ) return 0;
+    return find_equality(address_of(first1), address_of(first2), n, equal);
+}
+
+template<typename In, typename In2>
+bool equal(In first1, In last1, In2 first2, In2 last2, std::false_type)
+{
+    for( ; first1 != last1 && first2 != last2; ++first1, ++first2 )
+        if( !(*first1 == *first2) ) return false;
+    return first1 == last1 && first2 == last2;
+}
+
+template<typename In, typename In2>
+bool equal(In first1, In last1, In2 first2, In2 last2, std::true_type)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    const std::size_t n = last1 - first1;
+    if( n != static_cast<std::size_t>(last2 - first2) ) return false;
+    if( n == 0 ) return true;
+    // Integers are equal exactly when their bytes are.
+    if( std::is_integral<T>::value )
+        return std::memcmp(address_of(first1), address_of(first2),
+                           n * sizeof(T)) == 0;
+    return equality_offset(first1, first2, n, false) == n;
+}
+
+template<typename In, typename In2>
+std::pair<In,In2> mismatch(In first1, In last1, In2 first2, std::false_type)
+{
+    return std::mismatch(first1, last1, first2);
+}
+
+template<typename In, typename In2>
+std::pair<In,In2> mismatch(In first1, In last1, In2 first2, std::true_type)
+{
+    const std::size_t i = equality_offset(first1, first2, last1 - first1,
+                                          false);
+    return std::make_pair(first1 + i, first2 + i);
+}
+
+template<typename In, typename In2>
+std::pair<In,In2> match(In first1, In last1, In2 first2, In2 last2,
+                        std::false_type)
+{
+    return wt::match(first1, last1, first2, last2);
+}
+
+template<typename In, typename In2>
+std::pair<In,In2> match(In first1, In last1, In2 first2, In2 last2,
+                        std::true_type)
+{
+    const std::size_t i = equality_offset(first1, first2,
+        std::min<std::size_t>(last1 - first1, last2 - first2), true);
+    return std::make_pair(first1 + i, first2 + i);
+}
+
+template<typename In, typename In2>
+bool lexicographical_compare(In first1, In last1, In2 first2, In2 last2,
+                             std::false_type)
+{
+    return std::lexicographical_compare(first1, last1, first2, last2);
+}
+
+template<typename In, typename In2>
+bool lexicographical_compare(In first1, In last1, In2 first2, In2 last2,
+                             std::true_type)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    const std::size_t n1 = last1 - first1;
+    const std::size_t n2 = last2 - first2;
+    const std::size_t n = std::min(n1, n2);
+    if( n != 0 && sizeof(T) == 1 && !std::numeric_limits<T>::is_signed ) {
+        const int c = std::memcmp(address_of(first1), address_of(first2), n);
+        return c != 0 ? c < 0 : n1 < n2;
+    }
+    // Skip equal prefixes a vector at a time.  Elements that differ yet are
+    // unordered, such as NaNs, are equivalent to std::lexicographical_compare.
+    for( std::size_t i = 0; ; ++i ) {
+        i += equality_offset(first1 + i, first2 + i, n - i, false);
+        if( i == n ) return n1 < n2;
+        if( first1[i] < first2[i] ) return true;
+        if( first2[i] < first1[i] ) return false;
+    }
+}
+
+} // namespace detail
+
+/// Remove the elements of a range that satisfy a predicate, in parallel.
+///
+/// Each thread compacts a block of the range in place, then the kept elements
+/// of every block are moved to close the gaps.  The relative order of kept
+/// elements is preserved, as with std::remove_if().
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param op A predicate which elements to be removed satisfy.  It is called
+/// concurrently from several threads.
+///
+/// \return The new end of the range.
+template<typename Ran, typename Pred>
+Ran remove_if(const parallel_policy& pol, Ran first, Ran last, Pred op)
+{
+    return detail::compact_blocks(pol, first, last,
+        [&op](Ran f, Ran l, std::size_t) {
+            return detail::remove_if(f, l, op,
+                                     detail::is_contiguous_arithmetic<Ran>());
+        });
+}
+
+/// Copy the elements of a range that don't satisfy a predicate, in parallel.
+///
+/// The copy takes two passes over the input:  the first counts the elements
+/// to copy in each block, which gives every block its offset in the output;
+/// the second copies the blocks concurrently.  The predicate is therefore
+/// applied twice to each element, and must be free of side effects.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param res A _random access iterator_ pointing to the output, which must
+/// not overlap the input.
+///
+/// \param op A predicate which elements not to be copied satisfy.
+///
+/// \return An iterator pointing to one-past-the-last element of the output.
+template<typename Ran, typename Out, typename Pred>
+Out remove_copy_if(const parallel_policy& pol,
+                   Ran first, Ran last, Out res, Pred op)
+{
+    return detail::compact_blocks_copy(pol, first, last, res,
+        [&op](Ran f, Ran l, std::size_t) {
+            std::size_t n = 0;
+            for( ; f != l; ++f ) n += op(*f) ? 0 : 1;
+            return n;
+        },
+        [&op](Ran f, Ran l, Out r, std::size_t) {
+            return detail::remove_copy_if(f, l, r, op,
+                detail::is_compactable_copy<Ran,Out>());
+        });
+}
+
+/// Copy the elements of a range that satisfy a predicate, in parallel.
+///
+/// \see remove_copy_if(const parallel_policy&, Ran, Ran, Out, Pred)
+template<typename Ran, typename Out, typename Pred>
+Out copy_if(const parallel_policy& pol, Ran first, Ran last, Out res, Pred op)
+{
+    return detail::compact_blocks_copy(pol, first, last, res,
+        [&op](Ran f, Ran l, std::size_t) {
+            std::size_t n = 0;
+            for( ; f != l; ++f ) n += op(*f) ? 1 : 0;
+            return n;
+        },
+        [&op](Ran f, Ran l, Out r, std::size_t) {
+            return detail::copy_if(f, l, r, op,
+                detail::is_compactable_copy<Ran,Out>());
+        });
+}
+
+/// Remove consecutive duplicate elements of a range, in parallel.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param op An equivalence relation.  It is called concurrently from several
+/// threads.
+///
+/// \return The new end of the range.
+template<typename Ran, typename BinPred>
+Ran unique(const parallel_policy& pol, Ran first, Ran last, BinPred op)
+{
+    typedef typename std::iterator_traits<Ran>::value_type T;
+    if( first == last ) return last;
+    const std::vector<T> before = detail::block_boundaries(pol, first, last);
+    return detail::compact_blocks(pol, first, last,
+        [&](Ran f, Ran l, std::size_t b) {
+            return detail::unique(f, l, b == 0 ? 0 : &before[b], op,
+                                  detail::is_contiguous_arithmetic<Ran>());
+        });
+}
+
+/// Remove consecutive duplicate elements of a range, in parallel.
+///
+/// \see unique(const parallel_policy&, Ran, Ran, BinPred)
+template<typename Ran>
+Ran unique(const parallel_policy& pol, Ran first, Ran last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type T;
+    return wt::unique(pol, first, last, std::equal_to<T>());
+}
+
+/// Copy a range without consecutive duplicate elements, in parallel.
+///
+/// Like remove_copy_if(const parallel_policy&, Ran, Ran, Out, Pred) this
+/// counts the elements to copy per block in a first pass, then copies the
+/// blocks concurrently in a second.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param res A _random access iterator_ pointing to the output, which must
+/// not overlap the input.
+///
+/// \param op An equivalence relation, free of side effects.
+///
+/// \return An iterator pointing to one-past-the-last element of the output.
+template<typename Ran, typename Out, typename BinPred>
+Out unique_copy(const parallel_policy& pol,
+                Ran first, Ran last, Out res, BinPred op)
+{
+    typedef typename std::iterator_traits<Ran>::value_type T;
+    if( first == last ) return res;
+    const std::vector<T> before = detail::block_boundaries(pol, first, last);
+    return detail::compact_blocks_copy(pol, first, last, res,
+        [&](Ran f, Ran l, std::size_t b) {
+            std::size_t n = 0;
+            for( Ran i = f; i != l; ++i ) {
+                const T& prev = i != f ? *(i - 1) : before[b];
+                n += (i == first || !op(prev, *i)) ? 1 : 0;
+            }
+            return n;
+        },
+        [&](Ran f, Ran l, Out r, std::size_t b) {
+            return detail::unique_copy(f, l, b == 0 ? 0 : &before[b], r, op,
+                detail::is_compactable_copy<Ran,Out>());
+        });
+}
+
+/// Copy a range without consecutive duplicate elements, in parallel.
+///
+/// \see unique_copy(const parallel_policy&, Ran, Ran, Out, BinPred)
+template<typename Ran, typename Out>
+Out unique_copy(const parallel_policy& pol, Ran first, Ran last, Out res)
+{
+    typedef typename std::iterator_traits<Ran>::value_type T;
+    return wt::unique_copy(pol, first, last, res, std::equal_to<T>());
+}
+
+namespace detail {
+
+/// The number of elements a stable merge of a[0, n1) and b[0, n2) takes from a
+/// among its first d outputs:  the co-rank of d.  It's found by binary search
+/// along the diagonal d of the merge path, so a merge can be cut at any
+/// output position and both halves done independently.
+template<typename Ran1, typename Ran2, typename Cmp>
+std::size_t co_rank(std::size_t d, Ran1 a, std::size_t n1,
+                    Ran2 b, std::size_t n2, Cmp c)
+{
+    std::size_t lo = d > n2 ? d - n2 : 0;
+    std::size_t hi = std::min(d, n1);
+    while( lo < hi ) {
+        const std::size_t i = lo + (hi - lo) / 2;
+        // Ties go to a, so a[i] precedes b[d - i - 1] unless it's greater.
+        if( !c(b[d - i - 1], a[i]) ) lo = i + 1;
+        else hi = i;
+    }
+    return lo;
+}
+
+/// Cut the merge of [first, middle) and [middle, last) into parts
+/// independent merges of consecutive ranges.  Each round halves every merge
+/// at the co-rank of its midpoint and rotates the two inner pieces past each
+/// other;  the merges of a round are cut concurrently.  parts is a power of
+/// two.  Returns the (first, middle) of each merge;  the last of one is the
+/// first of the next.
+template<typename Ran, typename Cmp>
+std::vector<std::pair<Ran,Ran> > split_merge(unsigned threads,
+                                             Ran first, Ran middle, Ran last,
+                                             std::size_t parts, Cmp c)
+{
+    std::vector<std::pair<Ran,Ran> > cuts(1, std::make_pair(first, middle));
+    std::vector<Ran> ends(1, last);
+    while( cuts.size() < parts ) {
+        std::vector<std::pair<Ran,Ran> > next(cuts.size() * 2);
+        std::vector<Ran> next_ends(cuts.size() * 2);
+        detail::parallel_for(cuts.size(), threads, [&](std::size_t s) {
+            const Ran f = cuts[s].first, m = cuts[s].second, l = ends[s];
+            const std::size_t n1 = static_cast<std::size_t>(m - f);
+            const std::size_t n2 = static_cast<std::size_t>(l - m);
+            const std::size_t d = (n1 + n2) / 2;
+            const std::size_t i = detail::co_rank(d, f, n1, m, n2, c);
+            const Ran cut1 = f + i, cut2 = m + (d - i);
+            const Ran split = std::rotate(cut1, m, cut2);
+            next[2 * s] = std::make_pair(f, cut1);
+            next_ends[2 * s] = split;
+            next[2 * s + 1] = std::make_pair(split, cut2);
+            next_ends[2 * s + 1] = l;
+        });
+        cuts.swap(next);
+        ends.swap(next_ends);
+    }
+    return cuts;
+}
+
+} // namespace detail
+
+/// Merge two sorted ranges, in parallel.
+///
+/// The output is cut into one block per thread, and the co-rank of each
+/// block's first position, found by binary search, tells how many elements
+/// of each input precede it.  The threads then merge their blocks
+/// independently with no further coordination.  The merge is stable.
+///
+/// \param pol The parallel policy.
+///
+/// \param first1 A _random access iterator_ pointing to the first element of
+/// the first sorted range.
+///
+/// \param last1 A _random access iterator_ pointing to one-past-the-last
+/// element of the first sorted range.
+///
+/// \param first2 A _random access iterator_ pointing to the first element of
+/// the second sorted range.
+///
+/// \param last2 A _random access iterator_ pointing to one-past-the-last
+/// element of the second sorted range.
+///
+/// \param res A _random access iterator_ pointing to the output, which must
+/// not overlap the inputs.
+///
+/// \param c A strict weak ordering by which both ranges are sorted.  It is
+/// called concurrently from several threads.
+///
+/// \return An iterator pointing to one-past-the-last element of the output.
+template<typename Ran1, typename Ran2, typename Out, typename Cmp>
+Out merge(const parallel_policy& pol, Ran1 first1, Ran1 last1,
+          Ran2 first2, Ran2 last2, Out res, Cmp c)
+{
+    const std::size_t n1 = static_cast<std::size_t>(last1 - first1);
+    const std::size_t n2 = static_cast<std::size_t>(last2 - first2);
+    const std::size_t n = n1 + n2;
+    const unsigned k = detail::thread_count(pol, n);
+    if( k == 1 ) return std::merge(first1, last1, first2, last2, res, c);
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t d0 = detail::block_begin(n, k, b);
+        const std::size_t d1 = detail::block_begin(n, k, b + 1);
+        const std::size_t i0 = detail::co_rank(d0, first1, n1, first2, n2, c);
+        const std::size_t i1 = detail::co_rank(d1, first1, n1, first2, n2, c);
+        std::merge(first1 + i0, first1 + i1,
+                   first2 + (d0 - i0), first2 + (d1 - i1), res + d0, c);
+    });
+    return res + n;
+}
+
+/// Merge two sorted ranges, in parallel.
+///
+/// \see merge(const parallel_policy&, Ran1, Ran1, Ran2, Ran2, Out, Cmp)
+template<typename Ran1, typename Ran2, typename Out>
+Out merge(const parallel_policy& pol, Ran1 first1, Ran1 last1,
+          Ran2 first2, Ran2 last2, Out res)
+{
+    typedef typename std::iterator_traits<Ran1>::value_type value_t;
+    return wt::merge(pol, first1, last1, first2, last2, res,
+                     std::less<value_t>());
+}
+
+/// Merge two consecutive sorted ranges in place, in parallel, using a
+/// caller-supplied buffer.
+///
+/// With a buffer as large as both ranges, the ranges are merged into the
+/// buffer with merge(const parallel_policy&, Ran1, Ran1, Ran2, Ran2, Out, Cmp)
+/// and moved back, both steps concurrently.  With a smaller buffer, the merge
+/// is first cut into independent merges at the co-ranks of evenly spaced
+/// positions, rotating the pieces between cuts into place, and then each
+/// thread merges its part through its own share of the buffer with
+/// inplace_merge(Bi, Bi, Bi, Ran, Ran, Cmp).  The merge is stable.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the first sorted range.
+///
+/// \param middle A _random access iterator_ pointing to the first element of
+/// the second sorted range, one-past-the-last of the first.
+///
+/// \param last A _random access iterator_ pointing to one-past-the-last
+/// element of the second sorted range.
+///
+/// \param buf_first A _random access iterator_ pointing to the first element
+/// of the buffer.  The buffer holds constructed elements, which the merge
+/// overwrites by move assignment and leaves in a valid but unspecified state.
+///
+/// \param buf_last A _random access iterator_ pointing to one-past-the-last
+/// element of the buffer.
+///
+/// \param c A strict weak ordering by which both ranges are sorted.  It is
+/// called concurrently from several threads.
+template<typename Ran, typename Ran2, typename Cmp>
+void inplace_merge(const parallel_policy& pol, Ran first, Ran middle, Ran last,
+                   Ran2 buf_first, Ran2 buf_last, Cmp c)
+{
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const std::size_t buf_n = static_cast<std::size_t>(buf_last - buf_first);
+    const unsigned k = detail::thread_count(pol, n);
+    if( k == 1 ) {
+        wt::inplace_merge(first, middle, last, buf_first, buf_last, c);
+    } else if( buf_n >= n ) {
+        wt::merge(pol, std::make_move_iterator(first),
+                  std::make_move_iterator(middle),
+                  std::make_move_iterator(middle),
+                  std::make_move_iterator(last), buf_first, c);
+        detail::parallel_for(k, k, [&](std::size_t b) {
+            std::move(buf_first + detail::block_begin(n, k, b),
+                      buf_first + detail::block_begin(n, k, b + 1),
+                      first + detail::block_begin(n, k, b));
+        });
+    } else {
+        std::size_t parts = 1;
+        while( parts < k ) parts *= 2;
+        const std::vector<std::pair<Ran,Ran> > cuts =
+            detail::split_merge(k, first, middle, last, parts, c);
+        const std::size_t share = buf_n / parts;
+        detail::parallel_for(parts, k, [&](std::size_t s) {
+            const Ran l = s + 1 < parts ? cuts[s + 1].first : last;
+            wt::inplace_merge(cuts[s].first, cuts[s].second, l,
+                              buf_first + s * share,
+                              buf_first + (s + 1) * share, c);
+        });
+    }
+}
+
+/// Merge two consecutive sorted ranges in place, in parallel, using a
+/// caller-supplied buffer.
+///
+/// \see inplace_merge(const parallel_policy&, Ran, Ran, Ran, Ran2, Ran2, Cmp)
+template<typename Ran, typename Ran2>
+void inplace_merge(const parallel_policy& pol, Ran first, Ran middle, Ran last,
+                   Ran2 buf_first, Ran2 buf_last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    wt::inplace_merge(pol, first, middle, last, buf_first, buf_last,
+                      std::less<value_t>());
+}
+
+/// Merge two consecutive sorted ranges in place, in parallel.
+///
+/// This allocates a buffer as large as both ranges, so the value type must
+/// be default constructible;  to bound the memory used, supply a buffer.
+///
+/// \see inplace_merge(const parallel_policy&, Ran, Ran, Ran, Ran2, Ran2, Cmp)
+template<typename Ran, typename Cmp>
+void inplace_merge(const parallel_policy& pol, Ran first, Ran middle, Ran last,
+                   Cmp c)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    std::vector<value_t> buf(static_cast<std::size_t>(last - first));
+    wt::inplace_merge(pol, first, middle, last, buf.begin(), buf.end(), c);
+}
+
+/// Merge two consecutive sorted ranges in place, in parallel.
+///
+/// \see inplace_merge(const parallel_policy&, Ran, Ran, Ran, Cmp)
+template<typename Ran>
+void inplace_merge(const parallel_policy& pol, Ran first, Ran middle, Ran last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    wt::inplace_merge(pol, first, middle, last, std::less<value_t>());
+}
+
+namespace detail {
+
+/// Intervals of a range, as (offset, length) pairs, with the running total
+/// of their lengths.
+struct interval_list {
+    void add(std::size_t lo, std::size_t hi)
+    {
+        if( lo >= hi ) return;
+        offsets.push_back(lo);
+        lengths.push_back(hi - lo);
+        ends.push_back((ends.empty() ? 0 : ends.back()) + hi - lo);
+    }
+
+    /// The interval holding the element of rank r among all intervals.
+    std::size_t find(std::size_t r) const
+    {
+        return std::upper_bound(ends.begin(), ends.end(), r) - ends.begin();
+    }
+
+    std::vector<std::size_t> offsets;
+    std::vector<std::size_t> lengths;
+    std::vector<std::size_t> ends;
+};
+
+/// Swap the elements of ranks [lo, hi) in the intervals of a with those of
+/// the same ranks in the intervals of b.
+template<typename Ran>
+void swap_intervals(Ran first, const interval_list& a, const interval_list& b,
+                    std::size_t lo, std::size_t hi)
+{
+    std::size_t i = a.find(lo), j = b.find(lo);
+    while( lo != hi ) {
+        const std::size_t ia = lo - (a.ends[i] - a.lengths[i]);
+        const std::size_t jb = lo - (b.ends[j] - b.lengths[j]);
+        const std::size_t run = std::min(std::min(a.lengths[i] - ia,
+                                                  b.lengths[j] - jb),
+                                         hi - lo);
+        std::swap_ranges(first + a.offsets[i] + ia,
+                         first + a.offsets[i] + ia + run,
+                         first + b.offsets[j] + jb);
+        lo += run;
+        if( ia + run == a.lengths[i] ) ++i;
+        if( jb + run == b.lengths[j] ) ++j;
+    }
+}
+
+} // namespace detail
+
+/// Partition a range by a predicate, in parallel.
+///
+/// Each thread partitions a block of the range in place.  That leaves the
+/// elements that satisfy the predicate in one run per block;  the ones that
+/// fall beyond the final partition point are then swapped, concurrently,
+/// with the ones that don't satisfy the predicate before it.  The relative
+/// order of the elements is not preserved.  Contiguous ranges of arithmetic
+/// values are partitioned within the blocks without a branch per element.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param op A predicate, which is called exactly once per element.  It is
+/// called concurrently from several threads.
+///
+/// \return An iterator pointing to the first element that doesn't satisfy the
+/// predicate, or last.
+template<typename Ran, typename Pred>
+Ran partition(const parallel_policy& pol, Ran first, Ran last, Pred op)
+{
+    typedef detail::is_contiguous_arithmetic<Ran> simd;
+    const std::size_t n = last - first;
+    const unsigned k = detail::thread_count(pol, n);
+    if( k == 1 ) return detail::partition(first, last, op, simd());
+    std::vector<std::size_t> mids(k);
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const Ran f = first + detail::block_begin(n, k, b);
+        const Ran l = first + detail::block_begin(n, k, b + 1);
+        mids[b] = detail::partition(f, l, op, simd()) - first;
+    });
+    std::size_t split = 0;
+    for( std::size_t b = 0; b < k; ++b )
+        split += mids[b] - detail::block_begin(n, k, b);
+    // Failing elements before the split and satisfying ones after it come
+    // in equal numbers.
+    detail::interval_list misplaced_false, misplaced_true;
+    for( std::size_t b = 0; b < k; ++b ) {
+        const std::size_t lo = detail::block_begin(n, k, b);
+        const std::size_t hi = detail::block_begin(n, k, b + 1);
+        misplaced_false.add(mids[b], std::min(hi, split));
+        misplaced_true.add(std::max(lo, split), mids[b]);
+    }
+    const std::size_t m = misplaced_false.ends.empty()
+                        ? 0 : misplaced_false.ends.back();
+    const unsigned t = detail::thread_count(pol, m);
+    detail::parallel_for(t, t, [&](std::size_t b) {
+        detail::swap_intervals(first, misplaced_false, misplaced_true,
+                               detail::block_begin(m, t, b),
+                               detail::block_begin(m, t, b + 1));
+    });
+    return first + split;
+}
+
+/// Partition a range by a predicate, in parallel, preserving the relative
+/// order of the elements.
+///
+/// Each thread evaluates the predicate on a block of the range into a bit
+/// mask and counts the elements that satisfy it.  The prefix sums of the
+/// counts give every block its offsets among the satisfying and the failing
+/// elements, so once the range is moved to a scratch buffer the threads
+/// scatter their blocks back concurrently.  Contiguous ranges of arithmetic
+/// values are scattered with vector compress-stores.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param op A predicate, which is called exactly once per element.  It is
+/// called concurrently from several threads.
+///
+/// \return An iterator pointing to the first element that doesn't satisfy the
+/// predicate, or last.
+template<typename Ran, typename Pred>
+Ran stable_partition(const parallel_policy& pol, Ran first, Ran last, Pred op)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    typedef detail::is_contiguous_arithmetic<Ran> simd;
+    const std::size_t n = last - first;
+    const unsigned k = detail::thread_count(pol, n);
+    if( k == 1 ) return detail::stable_partition(first, last, op, simd());
+    // Blocks are whole words of the mask.
+    const std::size_t words = (n + 63) / 64;
+    std::vector<std::uint64_t> bits(words);
+    std::vector<std::size_t> trues(k + 1, 0);
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = 64 * detail::block_begin(words, k, b);
+        const std::size_t hi = std::min(n,
+                                   64 * detail::block_begin(words, k, b + 1));
+        if( lo < hi )
+            trues[b + 1] = detail::predicate_bits(first + lo, hi - lo, op,
+                                                  &bits[lo / 64]);
+    });
+    std::partial_sum(trues.begin(), trues.end(), trues.begin());
+    const std::size_t split = trues[k];
+    std::vector<value_t> buf(std::make_move_iterator(first),
+                             std::make_move_iterator(last));
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = 64 * detail::block_begin(words, k, b);
+        const std::size_t hi = std::min(n,
+                                   64 * detail::block_begin(words, k, b + 1));
+        if( lo < hi )
+            detail::partition_scatter(&buf[lo], hi - lo, &bits[lo / 64],
+                                      trues[b + 1] - trues[b],
+                                      first + trues[b],
+                                      first + split + (lo - trues[b]),
+                                      simd());
+    });
+    return first + split;
+}
+
+namespace detail {
+
+// Random shuffles and fills.  shuffle() is Fisher-Yates with Lemire's
+// bounded integers;  on contiguous storage it draws its swap positions some
+// steps ahead and prefetches them, since on an array larger than the cache
+// every swap is otherwise a miss.  The parallel shuffle is MergeShuffle
+// (Bacher, Bodini, Hollender and Lumbroso):  blocks are shuffled
+// independently, then merged pairwise by random interleaving.
+
+/// How many swaps ahead shuffle() draws and prefetches on contiguous storage.
+const std::size_t shuffle_prefetch_distance = 16;
+
+/// The engine of shuffle() when none is given:  one per thread, seeded from
+/// std::random_device.
+inline wyrand& thread_engine()
+{
+    static thread_local wyrand g(
+        static_cast<std::uint64_t>(std::random_device()()) << 32 ^
+        std::random_device()());
+    return g;
+}
+
+template<typename Ran, typename Gen>
+void shuffle(Ran first, Ran last, Gen& g, std::false_type)
+{
+    typedef typename std::iterator_traits<Ran>::difference_type diff_t;
+    for( diff_t i = (last - first) - 1; i > 0; --i )
+        std::iter_swap(first + i,
+                       first + static_cast<diff_t>(
+                                   wt::bounded(g, std::uint64_t(i) + 1)));
+}
+
+template<typename Ran, typename Gen>
+void shuffle(Ran first, Ran last, Gen& g, std::true_type)
+{
+    const std::size_t n = last - first;
+    const std::size_t d = shuffle_prefetch_distance;
+    if( n <= d ) {
+        shuffle(first, last, g, std::false_type());
+        return;
+    }
+    typename std::iterator_traits<Ran>::pointer p = address_of(first);
+    // Swap positions are drawn in the order the plain loop draws them, so
+    // the result is the same for the same engine state.
+    std::size_t ahead[shuffle_prefetch_distance];
+    for( std::size_t i = n - 1; i > n - 1 - d; --i ) {
+        ahead[i % d] = static_cast<std::size_t>(wt::bounded(g, i + 1));
+        prefetch_write(p + ahead[i % d]);
+    }
+    for( std::size_t i = n - 1; i > 0; --i ) {
+        const std::size_t j = ahead[i % d];
+        if( i > d ) {
+            ahead[i % d] = static_cast<std::size_t>(wt::bounded(g, i - d + 1));
+            prefetch_write(p + ahead[i % d]);
+        }
+        std::iter_swap(p + i, p + j);
+    }
+}
+
+template<typename Ran, typename Gen>
+void merge_shuffle_steps(Ran&, Ran&, Ran, Gen&, std::uint64_t&, unsigned&,
+                         std::false_type)
+{
+}
+
+/// The steps of merge_shuffle() that can't reach the end of either range,
+/// with the coin flips selecting values rather than branching.
+template<typename Ran, typename Gen>
+void merge_shuffle_steps(Ran& u, Ran& v, Ran last, Gen& g,
+                         std::uint64_t& bits, unsigned& left, std::true_type)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    while( u != v && v != last ) {
+        if( left == 0 ) {
+            bits = g();
+            left = 64;
+        }
+        const std::size_t steps = std::min<std::size_t>(
+            left, std::min<std::size_t>(v - u, last - v));
+        for( std::size_t s = 0; s < steps; ++s ) {
+            const unsigned flip = static_cast<unsigned>(bits & 1);
+            bits >>= 1;
+            const value_t pair[2] = { *u, *v };
+            *u = pair[flip];
+            *v = pair[flip ^ 1];
+            v += flip;
+            ++u;
+        }
+        left -= static_cast<unsigned>(steps);
+    }
+}
+
+/// Shuffle the concatenation of two shuffled ranges [first, middle) and
+/// [middle, last) into one.  A coin flip per step takes the next element
+/// from either range, until one runs out;  the rest are inserted at random
+/// positions, Fisher-Yates style.
+template<typename Ran, typename Gen>
+void merge_shuffle(Ran first, Ran middle, Ran last, Gen& g)
+{
+    Ran u = first, v = middle;
+    std::uint64_t bits = 0;
+    unsigned left = 0;
+    merge_shuffle_steps(u, v, last, g, bits, left,
+                        is_contiguous_arithmetic<Ran>());
+    for( ;; ) {
+        if( left == 0 ) {
+            bits = g();
+            left = 64;
+        }
+        const bool flip = bits & 1;
+        bits >>= 1;
+        --left;
+        if( flip ) {
+            if( v == last ) break;
+            std::iter_swap(u, v);
+            ++v;
+        } else if( u == v ) {
+            break;
+        }
+        ++u;
+    }
+    for( ; u != last; ++u )
+        std::iter_swap(first + static_cast<std::ptrdiff_t>(
+                                   wt::bounded(g, std::uint64_t(u - first) + 1)),
+                       u);
+}
+
+/// The seed of the engine of task t of step s of a parallel shuffle or fill.
+inline std::uint64_t task_seed(std::uint64_t seed, std::uint64_t s,
+                               std::uint64_t t)
+{
+    std::uint64_t state = seed ^ (s << 40 | t) * 0xd1342543de82ef95ull;
+    return splitmix64(state);
+}
+
+} // namespace detail
+
+/// Shuffle a range uniformly at random.
+///
+/// This is the Fisher-Yates shuffle, as std::shuffle(), with Lemire's
+/// unbiased bounded integers, which cost a multiplication where the usual
+/// method costs a division.  On contiguous storage the swap positions are
+/// drawn a few steps ahead and prefetched.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param g A uniform random bit generator, such as wt::wyrand.  Generators
+/// with 64-bit outputs take the fast path.
+template<typename Ran, typename Gen>
+void shuffle(Ran first, Ran last, Gen& g)
+{
+    detail::shuffle(first, last, g, detail::is_contiguous_iterator<Ran>());
+}
+
+/// Shuffle a range uniformly at random, with a wt::wyrand per thread seeded
+/// from std::random_device.
+///
+/// \see shuffle(Ran, Ran, Gen&)
+template<typename Ran>
+void shuffle(Ran first, Ran last)
+{
+    wt::shuffle(first, last, detail::thread_engine());
+}
+
+/// Fill a range with random values of a distribution, reproducibly.
+///
+/// Element i is drawn from a fresh copy of dist with a wt::philox4x32 engine
+/// of the given seed and stream number i.  Its value thus depends only on the
+/// seed, the distribution and i:  the parallel generate_random() writes the
+/// same values whatever its number of threads, and filling a part of a range
+/// writes what filling the whole would have written there, given the
+/// iterator to its first element.
+///
+/// \param first A _forward iterator_ pointing to the first element of the
+/// range.
+///
+/// \param last A _forward iterator_ pointing to the last element of the range.
+///
+/// \param seed The seed.
+///
+/// \param dist A random number distribution, such as
+/// std::normal_distribution<double>.
+template<typename Fwd, typename Dist>
+void generate_random(Fwd first, Fwd last, std::uint64_t seed, Dist dist)
+{
+    for( std::uint64_t i = 0; first != last; ++first, ++i ) {
+        philox4x32 g(seed, i);
+        Dist d(dist);
+        *first = d(g);
+    }
+}
+
+/// Shuffle a range uniformly at random, in parallel.
+///
+/// This is MergeShuffle:  the range is split into a power-of-two number of
+/// blocks which are shuffled concurrently, then adjacent shuffled blocks are
+/// merged by random interleaving, level by level, the merges of a level
+/// running concurrently.  A merge streams through its blocks, so even the
+/// final, single-threaded merge is faster than the random accesses of a
+/// serial shuffle of an array larger than the cache.  Every block and merge
+/// draws from its own wt::wyrand, seeded from one draw of g.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param g A uniform random bit generator.
+template<typename Ran, typename Gen>
+void shuffle(const parallel_policy& pol, Ran first, Ran last, Gen& g)
+{
+    const std::size_t n = last - first;
+    const unsigned threads = detail::thread_count(pol, n);
+    if( threads <= 1 ) {
+        wt::shuffle(first, last, g);
+        return;
+    }
+    // Two statements, so the draws are made in a specified order.
+    const std::uint64_t high = static_cast<std::uint64_t>(g());
+    const std::uint64_t seed = high << 32 ^ static_cast<std::uint64_t>(g());
+    // Twice as many blocks as threads, to balance the blocks' cache misses.
+    std::size_t k = 1;
+    while( k < 2 * std::size_t(threads) ) k *= 2;
+    detail::parallel_for(k, threads, [&](std::size_t b) {
+        wyrand r(detail::task_seed(seed, 0, b));
+        wt::shuffle(first + detail::block_begin(n, k, b),
+                    first + detail::block_begin(n, k, b + 1), r);
+    });
+    for( std::size_t width = 1, step = 1; width < k; width *= 2, ++step ) {
+        detail::parallel_for(k / (2 * width), threads, [&](std::size_t m) {
+            wyrand r(detail::task_seed(seed, step, m));
+            detail::merge_shuffle(
+                first + detail::block_begin(n, k, 2 * m * width),
+                first + detail::block_begin(n, k, (2 * m + 1) * width),
+                first + detail::block_begin(n, k, (2 * m + 2) * width), r);
+        });
+    }
+}
+
+/// Shuffle a range uniformly at random, in parallel, seeded from
+/// std::random_device.
+///
+/// \see shuffle(const parallel_policy&, Ran, Ran, Gen&)
+template<typename Ran>
+void shuffle(const parallel_policy& pol, Ran first, Ran last)
+{
+    wt::shuffle(pol, first, last, detail::thread_engine());
+}
+
+/// Fill a range with random values of a distribution, reproducibly, in
+/// parallel.  The values are those the serial generate_random() writes.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param seed The seed.
+///
+/// \param dist A random number distribution.  Each thread draws from copies
+/// of it.
+///
+/// \see generate_random(Fwd, Fwd, std::uint64_t, Dist)
+template<typename Ran, typename Dist>
+void generate_random(const parallel_policy& pol, Ran first, Ran last,
+                     std::uint64_t seed, Dist dist)
+{
+    const std::size_t n = last - first;
+    const unsigned k = detail::thread_count(pol, n, detail::parallel_grain / 8);
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = detail::block_begin(n, k, b);
+        const std::size_t hi = detail::block_begin(n, k, b + 1);
+        for( std::size_t i = lo; i < hi; ++i ) {
+            philox4x32 g(seed, i);
+            Dist d(dist);
+            first[i] = d(g);
+        }
+    });
+}
+
+namespace detail {
+
+// Moves of trivially copyable elements.  The iseq wrappers of copy(),
+// copy_backward(), move(), move_backward(), reverse(), reverse_copy(),
+// rotate(), rotate_copy() and swap_ranges() route contiguous ranges of the
+// same trivially copyable type here.  Copies go to memmove(), or above
+// nontemporal_threshold bytes to non-temporal stores;  reversals permute
+// whole vectors;  rotate() swaps blocks as Gries and Mills do, finishing
+// through a bounded buffer, in place of the cycles of std::rotate(), which
+// visit memory in strides.
+
+/// Whether the elements of In may be transferred to Out as raw memory.
+template<typename In, typename Out>
+struct is_trivial_transfer
+    : std::integral_constant<bool,
+        is_contiguous_trivial<In>::value &&
+        is_contiguous_trivial<Out>::value &&
+        std::is_same<typename std::iterator_traits<In>::value_type,
+                     typename std::iterator_traits<Out>::value_type>::value>
+{ };
+
+/// Bytes above which copies use non-temporal stores.  Past the private
+/// caches, writing around the cache beats reading each destination line in
+/// before overwriting it.
+const std::size_t nontemporal_threshold = std::size_t(1) << 22;
+
+/// Bytes of the shorter side of a rotation that go through a buffer.
+const std::size_t rotate_buffer_bytes = std::size_t(1) << 12;
+
+/// Copy n bytes from src to dst, which may overlap as for memmove().
+inline void move_bytes(void* dst, const void* src, std::size_t n)
+{
+    const std::uintptr_t d = reinterpret_cast<std::uintptr_t>(dst);
+    const std::uintptr_t s = reinterpret_cast<std::uintptr_t>(src);
+    if( n >= nontemporal_threshold && (d <= s || d >= s + n) )
+        stream_copy(dst, src, n);
+    else
+        std::memmove(dst, src, n);
+}
+
+template<typename In, typename Out>
+Out copy(In first, In last, Out result, std::false_type)
+{
+    return std::copy(first, last, result);
+}
+
+template<typename In, typename Out>
+Out copy(In first, In last, Out result, std::true_type)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    const std::size_t n = last - first;
+    if( n == 0 ) return result;
+    move_bytes(address_of(result), address_of(first), n * sizeof(T));
+    return result + n;
+}
+
+template<typename Bi, typename Bi2>
+Bi2 copy_backward(Bi first, Bi last, Bi2 result, std::false_type)
+{
+    return std::copy_backward(first, last, result);
+}
+
+template<typename Bi, typename Bi2>
+Bi2 copy_backward(Bi first, Bi last, Bi2 result, std::true_type)
+{
+    typedef typename std::iterator_traits<Bi>::value_type T;
+    const std::size_t n = last - first;
+    if( n == 0 ) return result;
+    result -= n;
+    move_bytes(address_of(result), address_of(first), n * sizeof(T));
+    return result;
+}
+
+template<typename In, typename Out>
+Out move(In first, In last, Out result, std::false_type)
+{
+    return std::move(first, last, result);
+}
+
+template<typename In, typename Out>
+Out move(In first, In last, Out result, std::true_type)
+{
+    return detail::copy(first, last, result, std::true_type());
+}
+
+template<typename Bi, typename Bi2>
+Bi2 move_backward(Bi first, Bi last, Bi2 result, std::false_type)
+{
+    return std::move_backward(first, last, result);
+}
+
+template<typename Bi, typename Bi2>
+Bi2 move_backward(Bi first, Bi last, Bi2 result, std::true_type)
+{
+    return detail::copy_backward(first, last, result, std::true_type());
+}
+
+template<typename Bi>
+void reverse(Bi first, Bi last, std::false_type)
+{
+    std::reverse(first, last);
+}
+
+template<typename Bi>
+void reverse(Bi first, Bi last, std::true_type)
+{
+    if( last - first < 2 ) return;
+    reverse_elements(address_of(first), address_of(first) + (last - first));
+}
+
+/// Swap elements lo to hi of a range of n elements with their mirror images,
+/// a part of reversing it.
+template<typename Ran>
+void reverse_blocks(Ran first, std::size_t n, std::size_t lo, std::size_t hi,
+                    std::false_type)
+{
+    for( std::size_t i = lo; i < hi; ++i )
+        std::iter_swap(first + i, first + (n - 1 - i));
+}
+
+template<typename Ran>
+void reverse_blocks(Ran first, std::size_t n, std::size_t lo, std::size_t hi,
+                    std::true_type)
+{
+    reverse_swap_elements(address_of(first) + lo, address_of(first) + (n - lo),
+                          hi - lo);
+}
+
+template<typename Bi, typename Out>
+Out reverse_copy(Bi first, Bi last, Out result, std::false_type)
+{
+    return std::reverse_copy(first, last, result);
+}
+
+template<typename Bi, typename Out>
+Out reverse_copy(Bi first, Bi last, Out result, std::true_type)
+{
+    const std::size_t n = last - first;
+    if( n == 0 ) return result;
+    reverse_copy_elements(address_of(first), address_of(first) + n,
+                          address_of(result));
+    return result + n;
+}
+
+template<typename Fwd, typename Fwd2>
+Fwd2 swap_ranges(Fwd first1, Fwd last1, Fwd2 first2, std::false_type)
+{
+    return std::swap_ranges(first1, last1, first2);
+}
+
+template<typename Fwd, typename Fwd2>
+Fwd2 swap_ranges(Fwd first1, Fwd last1, Fwd2 first2, std::true_type)
+{
+    typedef typename std::iterator_traits<Fwd>::value_type T;
+    const std::size_t n = last1 - first1;
+    if( n == 0 ) return first2;
+    swap_bytes(address_of(first1), address_of(first2), n * sizeof(T));
+    return first2 + n;
+}
+
+/// Rotate [first, last) so that middle becomes its first element.
+template<typename T>
+void rotate_elements(T* first, T* middle, T* last)
+{
+    std::size_t l = middle - first;
+    std::size_t r = last - middle;
+    // Swapping the shorter side with the near end of the longer side puts
+    // one of them in place;  what is left is a smaller rotation.
+    while( l != 0 && r != 0 && std::min(l, r) * sizeof(T) >
+                               rotate_buffer_bytes ) {
+        if( l <= r ) {
+            swap_bytes(first, middle, l * sizeof(T));
+            first += l;
+            middle += l;
+            r -= l;
+        } else {
+            swap_bytes(first, middle, r * sizeof(T));
+            first += r;
+            l -= r;
+        }
+    }
+    if( l == 0 || r == 0 ) return;
+    unsigned char buf[rotate_buffer_bytes];
+    if( l <= r ) {
+        std::memcpy(buf, first, l * sizeof(T));
+        std::memmove(first, middle, r * sizeof(T));
+        std::memcpy(first + r, buf, l * sizeof(T));
+    } else {
+        std::memcpy(buf, middle, r * sizeof(T));
+        std::memmove(first + r, first, l * sizeof(T));
+        std::memcpy(first, buf, r * sizeof(T));
+    }
+}
+
+template<typename Fwd>
+void rotate(Fwd first, Fwd middle, Fwd last, std::false_type)
+{
+    std::rotate(first, middle, last);
+}
+
+template<typename Fwd>
+void rotate(Fwd first, Fwd middle, Fwd last, std::true_type)
+{
+    if( first == middle || middle == last ) return;
+    rotate_elements(address_of(first), address_of(middle),
+                    address_of(first) + (last - first));
+}
+
+template<typename Fwd, typename Out>
+Out rotate_copy(Fwd first, Fwd middle, Fwd last, Out result,
+                std::false_type)
+{
+    return std::rotate_copy(first, middle, last, result);
+}
+
+template<typename Fwd, typename Out>
+Out rotate_copy(Fwd first, Fwd middle, Fwd last, Out result,
+                std::true_type)
+{
+    result = detail::copy(middle, last, result, std::true_type());
+    return detail::copy(first, middle, result, std::true_type());
+}
+
+/// Whether the n elements at a and at b may overlap.
+template<typename It, typename It2>
+bool may_overlap(It a, It2 b, std::size_t n, std::true_type)
+{
+    typedef typename std::iterator_traits<It>::value_type T;
+    const std::uintptr_t p = reinterpret_cast<std::uintptr_t>(address_of(a));
+    const std::uintptr_t q = reinterpret_cast<std::uintptr_t>(address_of(b));
+    return n != 0 && p < q + n * sizeof(T) && q < p + n * sizeof(T);
+}
+
+template<typename It, typename It2>
+bool may_overlap(It, It2, std::size_t, std::false_type)
+{
+    return false;
+}
+
+} // namespace detail
+
+/// Copy a range, in parallel.
+///
+/// Contiguous ranges of a trivially copyable type are copied as raw memory
+/// in blocks, one per thread, large blocks with non-temporal stores.  A
+/// single thread rarely saturates the memory bandwidth of a large machine,
+/// which is why this can be faster than std::copy() at all.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param result A _random access iterator_ pointing to the first element of
+/// the destination, which must not overlap the range.
+///
+/// \return The end of the destination.
+template<typename Ran, typename Ran2>
+Ran2 copy(const parallel_policy& pol, Ran first, Ran last, Ran2 result)
+{
+    typedef detail::is_trivial_transfer<Ran,Ran2> trivial;
+    const std::size_t n = last - first;
+    const unsigned k = detail::thread_count(pol, n, 8 * detail::parallel_grain);
+    if( k <= 1 || detail::may_overlap(first, result, n, trivial()) )
+        return detail::copy(first, last, result, trivial());
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = detail::block_begin(n, k, b);
+        const std::size_t hi = detail::block_begin(n, k, b + 1);
+        detail::copy(first + lo, first + hi, result + lo, trivial());
+    });
+    return result + n;
+}
+
+/// Reverse a range, in parallel.  The front half is split into blocks, each
+/// of which a thread swaps with its mirror image in the back half.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+template<typename Ran>
+void reverse(const parallel_policy& pol, Ran first, Ran last)
+{
+    typedef detail::is_contiguous_trivial<Ran> trivial;
+    const std::size_t n = last - first;
+    const std::size_t h = n / 2;
+    const unsigned k = detail::thread_count(pol, h, 4 * detail::parallel_grain);
+    if( k <= 1 ) {
+        detail::reverse(first, last, trivial());
+        return;
+    }
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        detail::reverse_blocks(first, n, detail::block_begin(h, k, b),
+                               detail::block_begin(h, k, b + 1), trivial());
+    });
+}
+
+/// Copy a range in reverse order, in parallel.
+///
+/// \param pol The parallel policy.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param result A _random access iterator_ pointing to the first element of
+/// the destination, which must not overlap the range.
+///
+/// \return The end of the destination.
+template<typename Ran, typename Ran2>
+Ran2 reverse_copy(const parallel_policy& pol, Ran first, Ran last,
+                  Ran2 result)
+{
+    typedef detail::is_trivial_transfer<Ran,Ran2> trivial;
+    const std::size_t n = last - first;
+    const unsigned k = detail::thread_count(pol, n, 4 * detail::parallel_grain);
+    if( k <= 1 ) return detail::reverse_copy(first, last, result, trivial());
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = detail::block_begin(n, k, b);
+        const std::size_t hi = detail::block_begin(n, k, b + 1);
+        detail::reverse_copy(last - hi, last - lo, result + lo, trivial());
+    });
+    return result + n;
+}
+
+/// Swap the elements of two ranges, in parallel.
+///
+/// \param pol The parallel policy.
+///
+/// \param first1 A _random access iterator_ pointing to the first element of
+/// the first range.
+///
+/// \param last1 A _random access iterator_ pointing to the last element of
+/// the first range.
+///
+/// \param first2 A _random access iterator_ pointing to the first element of
+/// the second range, which must not overlap the first.
+///
+/// \return The end of the second range.
+template<typename Ran, typename Ran2>
+Ran2 swap_ranges(const parallel_policy& pol, Ran first1, Ran last1,
+                 Ran2 first2)
+{
+    typedef detail::is_trivial_transfer<Ran,Ran2> trivial;
+    const std::size_t n = last1 - first1;
+    const unsigned k = detail::thread_count(pol, n, 4 * detail::parallel_grain);
+    if( k <= 1 ) return detail::swap_ranges(first1, last1, first2, trivial());
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = detail::block_begin(n, k, b);
+        const std::size_t hi = detail::block_begin(n, k, b + 1);
+        detail::swap_ranges(first1 + lo, first1 + hi, first2 + lo, trivial());
+    });
+    return first2 + n;
+}
+} // namespace wt
+
+#include <wtl/algorithm_iseq.hh>
+
 #endif // WTSTL_ALGORITHM_HH_
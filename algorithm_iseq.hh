@@ -21,8 +21,15 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
 #include <wtl/iseq.hh>
 #include <wtl/algorithm.hh>
+#include <wtl/heap.hh>
+#include <wtl/parallel.hh>
+#include <wtl/sink.hh>
+#include <wtl/sort.hh>
 
 namespace wt {
 
@@ -31,30 +38,35 @@ namespace wt {
 template <typename Fwd>
 Fwd adjacent_find(input_sequence_range<Fwd> range)
 {
+    WT_TRACE_ISEQ("adjacent_find", range);
     return std::adjacent_find(range.first, range.second);
 }
 
 template <typename Fwd, typename BinPred>
 Fwd adjacent_find(input_sequence_range<Fwd> range, BinPred op)
 {
+    WT_TRACE_ISEQ("adjacent_find", range);
     return std::adjacent_find(range.first, range.second, op);
 }
 
 template <typename In, typename Op>
 Op for_each(input_sequence_range<In> range, Op op)
 {
+    WT_TRACE_ISEQ("for_each", range);
     return std::for_each(range.first, range.second, op);
 }
 
 template <typename In, typename V>
 In find(input_sequence_range<In> range, const V& val)
 {
+    WT_TRACE_ISEQ("find", range);
     return std::find(range.first, range.second, val);
 }
 
 template <typename In, typename Pred>
 In find_if(input_sequence_range<In> range, Pred op)
 {
+    WT_TRACE_ISEQ("find_if", range);
     return std::find_if(range.first, range.second, op);
 }
 
@@ -62,6 +74,7 @@ template <typename Fwd, typename Fwd2>
 Fwd find_first_of(input_sequence_range<Fwd> range,
                   input_sequence_range<Fwd2> range2)
 {
+    WT_TRACE_ISEQ("find_first_of", range);
     return std::find_first_of(range.first, range.second,
                               range2.first, range2.second);
 }
@@ -71,6 +84,7 @@ Fwd find_first_of(input_sequence_range<Fwd> range,
                   input_sequence_range<Fwd2> range2,
                   BinPred op)
 {
+    WT_TRACE_ISEQ("find_first_of", range);
     return std::find_first_of(range.first, range.second,
                               range2.first, range2.second,
                               op);
@@ -80,20 +94,25 @@ template <typename In, typename V>
 typename std::iterator_traits<In>::difference_type
 count(input_sequence_range<In> range, const V& val)
 {
+    WT_TRACE_ISEQ("count", range);
     return std::count(range.first, range.second, val);
 }
 
-template <typename In, typename V, typename BinPred>
+template <typename In, typename Pred>
 typename std::iterator_traits<In>::difference_type
-count_if(input_sequence_range<In> range, const V& val, BinPred op)
+count_if(input_sequence_range<In> range, Pred op)
 {
-    return std::count(range.first, range.second, val, op);
+    WT_TRACE_ISEQ("count_if", range);
+    return std::count_if(range.first, range.second, op);
 }
 
 template <typename In, typename In2>
 bool equal(input_sequence_range<In> range, input_sequence_range<In2> range2)
 {
-    return std::equal(range.first, range.second, range2.first, range2.second);
+    WT_TRACE_ISEQ("equal", range);
+    return detail::equal(range.first, range.second,
+                         range2.first, range2.second,
+                         detail::is_comparable_contiguous<In,In2>());
 }
 
 template <typename In, typename In2, typename BinPred>
@@ -101,15 +120,21 @@ bool equal(input_sequence_range<In> range,
            input_sequence_range<In2> range2,
            BinPred op)
 {
-    return std::equal(range.first, range.second,
-                      range2.first, range2.second,
-                      op);
+    WT_TRACE_ISEQ("equal", range);
+    In first1 = range.first;
+    In2 first2 = range2.first;
+    for( ; first1 != range.second && first2 != range2.second;
+         ++first1, ++first2 )
+        if( !op(*first1, *first2) ) return false;
+    return first1 == range.second && first2 == range2.second;
 }
 
 template <typename In, typename In2>
 std::pair<In,In2> mismatch(input_sequence_range<In> range, In2 first2)
 {
-    return std::mismatch(range.first, range.second, first2);
+    WT_TRACE_ISEQ("mismatch", range);
+    return detail::mismatch(range.first, range.second, first2,
+                            detail::is_comparable_contiguous<In,In2>());
 }
 
 template <typename In, typename In2, typename BinPred>
@@ -117,12 +142,14 @@ std::pair<In,In2> mismatch(input_sequence_range<In> range,
                            In2 first2,
                            BinPred op)
 {
+    WT_TRACE_ISEQ("mismatch", range);
     return std::mismatch(range.first, range.second, first2, op);
 }
 
 template <typename Fwd, typename Fwd2>
 Fwd search(input_sequence_range<Fwd> range, input_sequence_range<Fwd2> range2)
 {
+    WT_TRACE_ISEQ("search", range);
     return std::search(range.first, range.second, range2.first, range2.second);
 }
 
@@ -131,6 +158,7 @@ Fwd search(input_sequence_range<Fwd> range,
            input_sequence_range<Fwd2> range2,
            BinPred op)
 {
+    WT_TRACE_ISEQ("search", range);
     return std::search(range.first, range.second,
                        range2.first, range2.second,
                        op);
@@ -140,6 +168,7 @@ template <typename Fwd, typename Fwd2>
 Fwd find_end(input_sequence_range<Fwd> range,
              input_sequence_range<Fwd2> range2)
 {
+    WT_TRACE_ISEQ("find_end", range);
     return std::find_end(range.first, range.second,
                          range2.first, range2.second);
 }
@@ -149,6 +178,7 @@ Fwd find_end(input_sequence_range<Fwd> range,
              input_sequence_range<Fwd2> range2,
              BinPred op)
 {
+    WT_TRACE_ISEQ("find_end", range);
     return std::find_end(range.first, range.second,
                          range2.first, range2.second,
                          op);
@@ -157,30 +187,81 @@ Fwd find_end(input_sequence_range<Fwd> range,
 template <typename Fwd, typename Size, typename V>
 Fwd search_n(input_sequence_range<Fwd> range, Size n, const V& val)
 {
+    WT_TRACE_ISEQ("search_n", range);
     return std::search_n(range.first, range.second, n, val);
 }
 
 template <typename Fwd, typename Size, typename V, typename BinPred>
 Fwd search_n(input_sequence_range<Fwd> range, Size n, const V& val, BinPred op)
 {
+    WT_TRACE_ISEQ("search_n", range);
     return std::search(range.first, range.second, n, val, op);
 }
 
 template <typename In, typename Out>
 Out copy(input_sequence_range<In> range, Out result)
 {
-    return std::copy(range.first, range.second, result);
+    WT_TRACE_ISEQ("copy", range);
+    return detail::copy(range.first, range.second, result,
+                        detail::is_trivial_transfer<In,Out>());
+}
+
+template <typename In, typename C>
+into_iterator<C> copy(input_sequence_range<In> range, into_iterator<C> result)
+{
+    WT_TRACE_ISEQ("copy", range);
+    detail::append(result.container(), range.first, range.second);
+    return result;
 }
 
 template <typename Bi, typename Bi2>
 Bi2 copy_backward(input_sequence_range<Bi> range, Bi2 result)
 {
-    return std::copy_backward(range.first, range.second, result);
+    WT_TRACE_ISEQ("copy_backward", range);
+    return detail::copy_backward(range.first, range.second, result,
+                                 detail::is_trivial_transfer<Bi,Bi2>());
+}
+
+template <typename In, typename Out>
+Out move(input_sequence_range<In> range, Out result)
+{
+    WT_TRACE_ISEQ("move", range);
+    return detail::move(range.first, range.second, result,
+                        detail::is_trivial_transfer<In,Out>());
+}
+
+template <typename In, typename C>
+into_iterator<C> move(input_sequence_range<In> range, into_iterator<C> result)
+{
+    WT_TRACE_ISEQ("move", range);
+    detail::append(result.container(), std::make_move_iterator(range.first),
+                   std::make_move_iterator(range.second));
+    return result;
+}
+
+template <typename Bi, typename Bi2>
+Bi2 move_backward(input_sequence_range<Bi> range, Bi2 result)
+{
+    WT_TRACE_ISEQ("move_backward", range);
+    return detail::move_backward(range.first, range.second, result,
+                                 detail::is_trivial_transfer<Bi,Bi2>());
 }
 
 template <typename In, typename Out, typename Op>
 Out transform(input_sequence_range<In> range, Out res, Op op)
 {
+    WT_TRACE_ISEQ("transform", range);
+    return std::transform(range.first, range.second, res, op);
+}
+
+template <typename In, typename C, typename Op>
+into_iterator<C> transform(input_sequence_range<In> range,
+                           into_iterator<C> res,
+                           Op op)
+{
+    WT_TRACE_ISEQ("transform", range);
+    detail::reserve_more(res.container(),
+                         detail::size_hint(range.first, range.second));
     return std::transform(range.first, range.second, res, op);
 }
 
@@ -190,6 +271,7 @@ Out transform(input_sequence_range<In> range,
               Out res,
               Op op)
 {
+    WT_TRACE_ISEQ("transform", range);
     return std::transform(range.first, range.second,
                           range2.first, range2.second,
                           res, op);
@@ -198,166 +280,276 @@ Out transform(input_sequence_range<In> range,
 template <typename Fwd>
 Fwd unique(input_sequence_range<Fwd> range)
 {
-    return std::unique(range.first, range.second);
+    WT_TRACE_ISEQ("unique", range);
+    typedef typename std::iterator_traits<Fwd>::value_type T;
+    return detail::unique(range.first, range.second, 0, std::equal_to<T>(),
+                          detail::is_contiguous_arithmetic<Fwd>());
 }
 
 template <typename Fwd, typename BinPred>
 Fwd unique(input_sequence_range<Fwd> range, BinPred op)
 {
-    return std::unique(range.first, range.second, op);
+    WT_TRACE_ISEQ("unique", range);
+    return detail::unique(range.first, range.second, 0, op,
+                          detail::is_contiguous_arithmetic<Fwd>());
 }
 
 template <typename Fwd, typename Out>
 Out unique_copy(input_sequence_range<Fwd> range, Out res)
 {
-    return std::unique_copy(range.first, range.second, res);
+    WT_TRACE_ISEQ("unique_copy", range);
+    typedef typename std::iterator_traits<Fwd>::value_type T;
+    return detail::unique_copy(range.first, range.second, 0, res,
+                               std::equal_to<T>(),
+                               detail::is_compactable_copy<Fwd,Out>());
+}
+
+template <typename Fwd, typename C>
+into_iterator<C> unique_copy(input_sequence_range<Fwd> range,
+                             into_iterator<C> res)
+{
+    WT_TRACE_ISEQ("unique_copy", range);
+    typedef typename std::iterator_traits<Fwd>::value_type T;
+    detail::append_at_most(res.container(), range.first, range.second,
+        detail::unique_copy_writer<Fwd,std::equal_to<T> >(
+            range.first, std::equal_to<T>()),
+        detail::is_compactable_into<Fwd,C>());
+    return res;
 }
 
 template <typename Fwd, typename Out, typename BinPred>
 Out unique_copy(input_sequence_range<Fwd> range, Out res, BinPred op)
 {
-    return std::unique_copy(range.first, range.second, res, op);
+    WT_TRACE_ISEQ("unique_copy", range);
+    return detail::unique_copy(range.first, range.second, 0, res, op,
+                               detail::is_compactable_copy<Fwd,Out>());
+}
+
+template <typename Fwd, typename C, typename BinPred>
+into_iterator<C> unique_copy(input_sequence_range<Fwd> range,
+                             into_iterator<C> res,
+                             BinPred op)
+{
+    WT_TRACE_ISEQ("unique_copy", range);
+    detail::append_at_most(res.container(), range.first, range.second,
+        detail::unique_copy_writer<Fwd,BinPred>(range.first, op),
+        detail::is_compactable_into<Fwd,C>());
+    return res;
 }
 
 template <typename Fwd, typename V>
 void replace(input_sequence_range<Fwd> range, const V& val, const V& new_val)
 {
+    WT_TRACE_ISEQ("replace", range);
     std::replace(range.first, range.second, val, new_val);
 }
 
 template <typename Fwd, typename Pred, typename V>
 void replace_if(input_sequence_range<Fwd> range, Pred op, const V& new_val)
 {
+    WT_TRACE_ISEQ("replace_if", range);
     std::replace_if(range.first, range.second, op, new_val);
 }
 
 template <typename Fwd, typename Out, typename V>
-void replace_copy(input_sequence_range<Fwd> range,
-                  Out res,
-                  const V& val, const V& new_val)
+Out replace_copy(input_sequence_range<Fwd> range,
+                 Out res,
+                 const V& val, const V& new_val)
 {
-    std::replace_copy(range.first, range.second, res, val, new_val);
+    WT_TRACE_ISEQ("replace_copy", range);
+    return std::replace_copy(range.first, range.second, res, val, new_val);
 }
 
 template <typename Fwd, typename Out, typename Pred, typename V>
-void replace_copy_if(input_sequence_range<Fwd> range,
-                Out res,
-                Pred op, const V& new_val)
+Out replace_copy_if(input_sequence_range<Fwd> range,
+                    Out res,
+                    Pred op, const V& new_val)
 {
-    std::replace_copy_if(range.first, range.second, res, op, new_val);
+    WT_TRACE_ISEQ("replace_copy_if", range);
+    return std::replace_copy_if(range.first, range.second, res, op, new_val);
 }
 
 template <typename Fwd, typename V>
 Fwd remove(input_sequence_range<Fwd> range, const V& val)
 {
-    return std::remove(range.first, range.second, val);
+    WT_TRACE_ISEQ("remove", range);
+    return detail::remove(range.first, range.second, val,
+                          detail::is_contiguous_arithmetic<Fwd>());
 }
 
 template <typename Fwd, typename Pred>
 Fwd remove_if(input_sequence_range<Fwd> range, Pred op)
 {
-    return std::remove_if(range.first, range.second, op);
+    WT_TRACE_ISEQ("remove_if", range);
+    return detail::remove_if(range.first, range.second, op,
+                             detail::is_contiguous_arithmetic<Fwd>());
 }
 
 template <typename In, typename Out, typename V>
 Out remove_copy(input_sequence_range<In> range, Out res, const V& val)
 {
-    return std::remove_copy(range.first, range.second, res, val);
+    WT_TRACE_ISEQ("remove_copy", range);
+    return detail::remove_copy(range.first, range.second, res, val,
+                               detail::is_compactable_copy<In,Out>());
+}
+
+template <typename In, typename C, typename V>
+into_iterator<C> remove_copy(input_sequence_range<In> range,
+                             into_iterator<C> res,
+                             const V& val)
+{
+    WT_TRACE_ISEQ("remove_copy", range);
+    detail::append_at_most(res.container(), range.first, range.second,
+        detail::remove_copy_writer<In,V>(val),
+        detail::is_compactable_into<In,C>());
+    return res;
 }
 
 template <typename In, typename Out, typename Pred>
 Out remove_copy_if(input_sequence_range<In> range, Out res, Pred op)
 {
-    return std::remove_copy_if(range.first, range.second, res, op);
+    WT_TRACE_ISEQ("remove_copy_if", range);
+    return detail::remove_copy_if(range.first, range.second, res, op,
+                                  detail::is_compactable_copy<In,Out>());
+}
+
+template <typename In, typename C, typename Pred>
+into_iterator<C> remove_copy_if(input_sequence_range<In> range,
+                                into_iterator<C> res,
+                                Pred op)
+{
+    WT_TRACE_ISEQ("remove_copy_if", range);
+    detail::append_at_most(res.container(), range.first, range.second,
+        detail::remove_copy_if_writer<In,Pred>(op),
+        detail::is_compactable_into<In,C>());
+    return res;
 }
 
 template <typename Fwd, typename V>
 void fill(input_sequence_range<Fwd> range, const V& val)
 {
+    WT_TRACE_ISEQ("fill", range);
     std::fill(range.first, range.second, val);
 }
 
 template <typename Fwd, typename Gen>
 void generate(input_sequence_range<Fwd> range, Gen g)
 {
+    WT_TRACE_ISEQ("generate", range);
     std::generate(range.first, range.second, g);
 }
 
 template <typename Bi>
 void reverse(input_sequence_range<Bi> range)
 {
-    std::reverse(range.first, range.second);
+    WT_TRACE_ISEQ("reverse", range);
+    detail::reverse(range.first, range.second,
+                    detail::is_contiguous_trivial<Bi>());
 }
 
 template <typename Bi, typename Out>
 Out reverse_copy(input_sequence_range<Bi> range, Out res)
 {
-    return std::reverse_copy(range.first, range.second, res);
+    WT_TRACE_ISEQ("reverse_copy", range);
+    return detail::reverse_copy(range.first, range.second, res,
+                                detail::is_trivial_transfer<Bi,Out>());
 }
 
 template <typename Fwd>
 void rotate(input_sequence_range<Fwd> range, Fwd middle)
 {
-    std::rotate(range.first, middle, range.second);
+    WT_TRACE_ISEQ("rotate", range);
+    detail::rotate(range.first, middle, range.second,
+                   detail::is_contiguous_trivial<Fwd>());
 }
 
 template <typename Fwd, typename Out>
 Out rotate_copy(input_sequence_range<Fwd> range, Fwd middle, Out res)
 {
-    return std::rotate_copy(range.first, middle, range.second, res);
+    WT_TRACE_ISEQ("rotate_copy", range);
+    return detail::rotate_copy(range.first, middle, range.second, res,
+                               detail::is_trivial_transfer<Fwd,Out>());
 }
 
 template <typename Ran>
 void random_shuffle(input_sequence_range<Ran> range)
 {
-    std::random_shuffle(range.first, range.second);
+    WT_TRACE_ISEQ("random_shuffle", range);
+    wt::shuffle(range.first, range.second);
 }
 
 template <typename Ran, typename Gen>
 void random_shuffle(input_sequence_range<Ran> range, Gen& g)
 {
-    std::random_shuffle(range.first, range.second, g);
+    WT_TRACE_ISEQ("random_shuffle", range);
+    // std::random_shuffle() is gone from C++17;  this is its algorithm.
+    if( range.first == range.second ) return;
+    for( Ran i = range.first + 1; i != range.second; ++i ) {
+        const Ran j = range.first + g((i - range.first) + 1);
+        if( i != j ) std::iter_swap(i, j);
+    }
+}
+
+template <typename Ran, typename Gen>
+void shuffle(input_sequence_range<Ran> range, Gen& g)
+{
+    WT_TRACE_ISEQ("shuffle", range);
+    wt::shuffle(range.first, range.second, g);
 }
 
 template <typename Fwd, typename Fwd2>
 Fwd2 swap_ranges(input_sequence_range<Fwd> range, Fwd2 first2)
 {
-    return std::swap_ranges(range.first, range.second, first2);
+    WT_TRACE_ISEQ("swap_ranges", range);
+    return detail::swap_ranges(range.first, range.second, first2,
+                               detail::is_trivial_transfer<Fwd,Fwd2>());
 }
 
+/// Unlike std::sort(), a range of strings is sorted by string_sort().  This
+/// includes ranges of char* and const char*, which are ordered by the strings
+/// they point to rather than by address;  a null pointer sorts as the empty
+/// string.  Pass std::less<const char*>() to order them by address.
 template <typename Ran>
 void sort(input_sequence_range<Ran> range)
 {
-    std::sort(range.first, range.second);
+    WT_TRACE_ISEQ("sort", range);
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    detail::sort(range.first, range.second,
+                 detail::is_string_like<value_t>());
 }
 
 template <typename Ran, typename Cmp>
 void sort(input_sequence_range<Ran> range, Cmp c)
 {
+    WT_TRACE_ISEQ("sort", range);
     std::sort(range.first, range.second, c);
 }
 
 template <typename Ran>
 void stable_sort(input_sequence_range<Ran> range)
 {
+    WT_TRACE_ISEQ("stable_sort", range);
     std::sort(range.first, range.second);
 }
 
 template <typename Ran, typename Cmp>
 void stable_sort(input_sequence_range<Ran> range, Cmp c)
 {
+    WT_TRACE_ISEQ("stable_sort", range);
     std::sort(range.first, range.second, c);
 }
 
 template <typename Ran>
 void partial_sort(input_sequence_range<Ran> range, Ran middle)
 {
+    WT_TRACE_ISEQ("partial_sort", range);
     std::partial_sort(range.first, middle, range.second);
 }
 
 template <typename Ran, typename Cmp>
 void partial_sort(input_sequence_range<Ran> range, Ran middle, Cmp c)
 {
+    WT_TRACE_ISEQ("partial_sort", range);
     std::partial_sort(range.first, middle, range.second, c);
 }
 
@@ -365,6 +557,7 @@ template <typename In, typename Ran>
 Ran partial_sort_copy(input_sequence_range<In> range,
                       input_sequence_range<Ran> range2)
 {
+    WT_TRACE_ISEQ("partial_sort_copy", range);
     return std::partial_sort(range.first, range.second,
                              range2.first, range2.second);
 }
@@ -374,6 +567,7 @@ Ran partial_sort_copy(input_sequence_range<In> range,
                       input_sequence_range<Ran> range2,
                       Cmp c)
 {
+    WT_TRACE_ISEQ("partial_sort_copy", range);
     return std::partial_sort(range.first, range.second,
                              range2.first, range2.second,
                              c);
@@ -382,54 +576,63 @@ Ran partial_sort_copy(input_sequence_range<In> range,
 template <typename Ran>
 void nth_element(input_sequence_range<Ran> range, Ran nth)
 {
+    WT_TRACE_ISEQ("nth_element", range);
     std::nth_element(range.first, nth, range.second);
 }
 
 template <typename Ran, typename Cmp>
 void nth_element(input_sequence_range<Ran> range, Ran nth, Cmp c)
 {
+    WT_TRACE_ISEQ("nth_element", range);
     std::nth_element(range.first, nth, range.second, c);
 }
 
 template <typename Ran, typename V>
 bool binary_search(input_sequence_range<Ran> range, const V& val)
 {
+    WT_TRACE_ISEQ("binary_search", range);
     return std::binary_search(range.first, range.second, val);
 }
 
 template <typename Ran, typename V, typename Cmp>
 bool binary_search(input_sequence_range<Ran> range, const V& val, Cmp c)
 {
+    WT_TRACE_ISEQ("binary_search", range);
     return std::binary_search(range.first, range.second, val, c);
 }
 
 template <typename Fwd, typename V>
 Fwd lower_bound(input_sequence_range<Fwd> range, const V& val)
 {
+    WT_TRACE_ISEQ("lower_bound", range);
     return std::lower_bound(range.first, range.second, val);
 }
 
 template <typename Fwd, typename V, typename Cmp>
 Fwd lower_bound(input_sequence_range<Fwd> range, const V& val, Cmp c)
 {
+    WT_TRACE_ISEQ("lower_bound", range);
     return std::lower_bound(range.first, range.second, val, c);
 }
 
 template <typename Fwd, typename V>
 Fwd upper_bound(input_sequence_range<Fwd> range, const V& val)
 {
+    WT_TRACE_ISEQ("upper_bound", range);
     return std::upper_bound(range.first, range.second, val);
 }
 
 template <typename Fwd, typename V, typename Cmp>
 Fwd upper_bound(input_sequence_range<Fwd> range, const V& val, Cmp c)
 {
+    WT_TRACE_ISEQ("upper_bound", range);
     return std::upper_bound(range.first, range.second, val, c);
 }
 
 template <typename Fwd, typename V>
 std::pair<Fwd,Fwd> equal_range(input_sequence_range<Fwd> range, const V& val)
 {
+    WT_TRACE_ISEQ("equal_range", range);
     return std::equal_range(range.first, range.second, val);
 }
 
@@ -437,6 +640,7 @@ template <typename Fwd, typename V, typename Cmp>
 std::pair<Fwd,Fwd> equal_range(input_sequence_range<Fwd> range,
                                const V& val, Cmp c)
 {
+    WT_TRACE_ISEQ("equal_range", range);
     return std::equal_range(range.first, range.second, val, c);
 }
 
@@ -445,6 +649,7 @@ Out merge(input_sequence_range<In> range,
           input_sequence_range<In2> range2,
           Out res)
 {
+    WT_TRACE_ISEQ("merge", range);
     return std::merge(range.first, range.second,
                       range2.first, range2.second,
                       res);
@@ -456,6 +661,7 @@ Out merge(input_sequence_range<In> range,
           Out res,
           Cmp c)
 {
+    WT_TRACE_ISEQ("merge", range);
     return std::merge(range.first, range.second,
                       range2.first, range2.second,
                       res, c);
@@ -464,30 +670,37 @@ Out merge(input_sequence_range<In> range,
 template <typename Bi>
 void inplace_merge(input_sequence_range<Bi> range, Bi middle)
 {
+    WT_TRACE_ISEQ("inplace_merge", range);
     std::inplace_merge(range.first, middle, range.second);
 }
 
 template <typename Bi, typename Cmp>
 void inplace_merge(input_sequence_range<Bi> range, Bi middle, Cmp c)
 {
+    WT_TRACE_ISEQ("inplace_merge", range);
     std::inplace_merge(range.first, middle, range.second, c);
 }
 
 template <typename Bi, typename Pred>
 Bi partition(input_sequence_range<Bi> range, Pred op)
 {
-    return std::partition(range.first, range.second, op);
+    WT_TRACE_ISEQ("partition", range);
+    return detail::partition(range.first, range.second, op,
+                             detail::is_contiguous_arithmetic<Bi>());
 }
 
 template <typename Bi, typename Pred>
 Bi stable_partition(input_sequence_range<Bi> range, Pred op)
 {
-    return std::stable_partition(range.first, range.second, op);
+    WT_TRACE_ISEQ("stable_partition", range);
+    return detail::stable_partition(range.first, range.second, op,
+                                    detail::is_contiguous_arithmetic<Bi>());
 }
 
 template <typename In, typename In2>
 bool includes(input_sequence_range<In> range, input_sequence_range<In2> range2)
 {
+    WT_TRACE_ISEQ("includes", range);
     return std::includes(range.first, range.second,
                          range2.first, range2.second);
 }
@@ -497,6 +710,7 @@ bool includes(input_sequence_range<In> range,
               input_sequence_range<In2> range2,
               Cmp c)
 {
+    WT_TRACE_ISEQ("includes", range);
     return std::includes(range.first, range.second,
                          range2.first, range2.second,
                          c);
@@ -507,8 +721,9 @@ Out set_union(input_sequence_range<In> range,
               input_sequence_range<In2> range2,
               Out res)
 {
+    WT_TRACE_ISEQ("set_union", range);
     return std::set_union(range.first, range.second,
-                          range.first, range.second,
+                          range2.first, range2.second,
                           res);
 }
 
@@ -517,8 +732,9 @@ Out set_union(input_sequence_range<In> range,
               input_sequence_range<In2> range2,
               Out res, Cmp c)
 {
+    WT_TRACE_ISEQ("set_union", range);
     return std::set_union(range.first, range.second,
-                          range.first, range.second,
+                          range2.first, range2.second,
                           res, c);
 }
 
@@ -527,8 +743,9 @@ Out set_intersection(input_sequence_range<In> range,
                      input_sequence_range<In2> range2,
                      Out res)
 {
+    WT_TRACE_ISEQ("set_intersection", range);
     return std::set_intersection(range.first, range.second,
-                                 range.first, range.second,
+                                 range2.first, range2.second,
                                  res);
 }
 
@@ -537,8 +754,9 @@ Out set_intersection(input_sequence_range<In> range,
                      input_sequence_range<In2> range2,
                      Out res, Cmp c)
 {
+    WT_TRACE_ISEQ("set_intersection", range);
     return std::set_intersection(range.first, range.second,
-                                 range.first, range.second,
+                                 range2.first, range2.second,
                                  res, c);
 }
 
@@ -547,8 +765,9 @@ Out set_difference(input_sequence_range<In> range,
                    input_sequence_range<In2> range2,
                    Out res)
 {
+    WT_TRACE_ISEQ("set_difference", range);
     return std::set_difference(range.first, range.second,
-                               range.first, range.second,
+                               range2.first, range2.second,
                                res);
 }
 
@@ -557,8 +776,9 @@ Out set_difference(input_sequence_range<In> range,
                    input_sequence_range<In2> range2,
                    Out res, Cmp c)
 {
+    WT_TRACE_ISEQ("set_difference", range);
     return std::set_difference(range.first, range.second,
-                               range.first, range.second,
+                               range2.first, range2.second,
                                res, c);
 }
 
@@ -567,8 +787,9 @@ Out set_symmetric_difference(input_sequence_range<In> range,
                              input_sequence_range<In2> range2,
                              Out res)
 {
+    WT_TRACE_ISEQ("set_symmetric_difference", range);
     return std::set_symmetric_difference(range.first, range.second,
-                                         range.first, range.second,
+                                         range2.first, range2.second,
                                          res);
 }
 
@@ -577,80 +798,93 @@ Out set_symmetric_difference(input_sequence_range<In> range,
                              input_sequence_range<In2> range2,
                              Out res, Cmp c)
 {
+    WT_TRACE_ISEQ("set_symmetric_difference", range);
     return std::set_symmetric_difference(range.first, range.second,
-                                         range.first, range.second,
+                                         range2.first, range2.second,
                                          res, c);
 }
 
 template <typename Ran>
 void push_heap(input_sequence_range<Ran> range)
 {
+    WT_TRACE_ISEQ("push_heap", range);
     std::push_heap(range.first, range.second);
 }
 
 template <typename Ran, typename Cmp>
 void push_heap(input_sequence_range<Ran> range, Cmp c)
 {
+    WT_TRACE_ISEQ("push_heap", range);
     std::push_heap(range.first, range.second, c);
 }
 
 template <typename Ran>
 void pop_heap(input_sequence_range<Ran> range)
 {
+    WT_TRACE_ISEQ("pop_heap", range);
     std::pop_heap(range.first, range.second);
 }
 
 template <typename Ran, typename Cmp>
 void pop_heap(input_sequence_range<Ran> range, Cmp c)
 {
+    WT_TRACE_ISEQ("pop_heap", range);
     std::pop_heap(range.first, range.second, c);
 }
 
 template <typename Ran>
 void make_heap(input_sequence_range<Ran> range)
 {
-    std::make_heap(range.first, range.second);
+    WT_TRACE_ISEQ("make_heap", range);
+    wt::make_heap(range.first, range.second);
 }
 
 template <typename Ran, typename Cmp>
 void make_heap(input_sequence_range<Ran> range, Cmp c)
 {
-    std::make_heap(range.first, range.second, c);
+    WT_TRACE_ISEQ("make_heap", range);
+    wt::make_heap(range.first, range.second, c);
 }
 
 template <typename Ran>
 void sort_heap(input_sequence_range<Ran> range)
 {
+    WT_TRACE_ISEQ("sort_heap", range);
     std::sort_heap(range.first, range.second);
 }
 
 template <typename Ran, typename Cmp>
 void sort_heap(input_sequence_range<Ran> range, Cmp c)
 {
+    WT_TRACE_ISEQ("sort_heap", range);
     std::sort_heap(range.first, range.second, c);
 }
 
 template <typename Fwd>
 Fwd min_element(input_sequence_range<Fwd> range)
 {
+    WT_TRACE_ISEQ("min_element", range);
     return std::min_element(range.first, range.second);
 }
 
 template <typename Fwd, typename Cmp>
 Fwd min_element(input_sequence_range<Fwd> range, Cmp c)
 {
+    WT_TRACE_ISEQ("min_element", range);
     return std::min_element(range.first, range.second, c);
 }
 
 template <typename Fwd>
 Fwd max_element(input_sequence_range<Fwd> range)
 {
+    WT_TRACE_ISEQ("max_element", range);
     return std::max_element(range.first, range.second);
 }
 
 template <typename Fwd, typename Cmp>
 Fwd max_element(input_sequence_range<Fwd> range, Cmp c)
 {
+    WT_TRACE_ISEQ("max_element", range);
     return std::max_element(range.first, range.second, c);
 }
 
@@ -658,8 +892,10 @@ template <typename In, typename In2>
 bool lexicographical_compare(input_sequence_range<In> range,
                              input_sequence_range<In2> range2)
 {
-    return std::lexicographical_compare(range.first, range.second,
-                                        range2.first, range2.second);
+    WT_TRACE_ISEQ("lexicographical_compare", range);
+    return detail::lexicographical_compare(range.first, range.second,
+        range2.first, range2.second,
+        detail::is_comparable_contiguous<In,In2>());
 }
 
 template <typename In, typename In2, typename Cmp>
@@ -667,6 +903,7 @@ bool lexicographical_compare(input_sequence_range<In> range,
                              input_sequence_range<In2> range2,
                              Cmp c)
 {
+    WT_TRACE_ISEQ("lexicographical_compare", range);
     return std::lexicographical_compare(range.first, range.second,
                                         range2.first, range2.second,
                                         c);
@@ -675,24 +912,28 @@ bool lexicographical_compare(input_sequence_range<In> range,
 template <typename Bi>
 bool next_permutation(input_sequence_range<Bi> range)
 {
+    WT_TRACE_ISEQ("next_permutation", range);
     return std::next_permutation(range.first, range.second);
 }
 
 template <typename Bi, typename Cmp>
 bool next_permutation(input_sequence_range<Bi> range, Cmp c)
 {
+    WT_TRACE_ISEQ("next_permutation", range);
     return std::next_permutation(range.first, range.second, c);
 }
 
 template <typename Bi>
 bool prev_permutation(input_sequence_range<Bi> range)
 {
+    WT_TRACE_ISEQ("prev_permutation", range);
     return std::prev_permutation(range.first, range.second);
 }
 
 template <typename Bi, typename Cmp>
 bool prev_permutation(input_sequence_range<Bi> range, Cmp c)
 {
+    WT_TRACE_ISEQ("prev_permutation", range);
     return std::prev_permutation(range.first, range.second, c);
 }
 
@@ -702,15 +943,121 @@ bool prev_permutation(input_sequence_range<Bi> range, Cmp c)
 template<typename In, typename Out, typename Pred>
 Out copy_if(input_sequence_range<In> range, Out res, Pred op)
 {
-    return copy_if(range.first, range.second, res, op);
+    WT_TRACE_ISEQ("copy_if", range);
+    return detail::copy_if(range.first, range.second, res, op,
+                           detail::is_compactable_copy<In,Out>());
+}
+
+template<typename In, typename C, typename Pred>
+into_iterator<C> copy_if(input_sequence_range<In> range,
+                         into_iterator<C> res,
+                         Pred op)
+{
+    WT_TRACE_ISEQ("copy_if", range);
+    detail::append_at_most(res.container(), range.first, range.second,
+        detail::copy_if_writer<In,Pred>(op),
+        detail::is_compactable_into<In,C>());
+    return res;
+}
+
+template<typename In, typename Out, typename Pred>
+Out move_if(input_sequence_range<In> range, Out res, Pred op)
+{
+    WT_TRACE_ISEQ("move_if", range);
+    return wt::move_if(range.first, range.second, res, op);
+}
+
+template<typename In, typename C, typename Pred>
+into_iterator<C> move_if(input_sequence_range<In> range,
+                         into_iterator<C> res,
+                         Pred op)
+{
+    WT_TRACE_ISEQ("move_if", range);
+    detail::reserve_more(res.container(),
+                         detail::size_hint(range.first, range.second));
+    return wt::move_if(range.first, range.second, res, op);
+}
+
+template<typename In, typename Out, typename Pred>
+Out copy_until(input_sequence_range<In> range, Out res, Pred cond)
+{
+    WT_TRACE_ISEQ("copy_until", range);
+    return wt::copy_until(range.first, range.second, res, cond);
+}
+
+template<typename In, typename C, typename Pred>
+into_iterator<C> copy_until(input_sequence_range<In> range,
+                            into_iterator<C> res,
+                            Pred cond)
+{
+    WT_TRACE_ISEQ("copy_until", range);
+    detail::append_until(res.container(), range.first, range.second, cond,
+                         true, std::false_type());
+    return res;
+}
+
+template<typename In, typename Out, typename Pred>
+Out copy_while(input_sequence_range<In> range, Out res, Pred cond)
+{
+    WT_TRACE_ISEQ("copy_while", range);
+    return wt::copy_while(range.first, range.second, res, cond);
+}
+
+template<typename In, typename C, typename Pred>
+into_iterator<C> copy_while(input_sequence_range<In> range,
+                            into_iterator<C> res,
+                            Pred cond)
+{
+    WT_TRACE_ISEQ("copy_while", range);
+    detail::append_until(res.container(), range.first, range.second, cond,
+                         false, std::false_type());
+    return res;
+}
+
+template<typename In, typename Out, typename Pred>
+Out move_until(input_sequence_range<In> range, Out res, Pred cond)
+{
+    WT_TRACE_ISEQ("move_until", range);
+    return wt::move_until(range.first, range.second, res, cond);
+}
+
+template<typename In, typename C, typename Pred>
+into_iterator<C> move_until(input_sequence_range<In> range,
+                            into_iterator<C> res,
+                            Pred cond)
+{
+    WT_TRACE_ISEQ("move_until", range);
+    detail::append_until(res.container(), range.first, range.second, cond,
+                         true, std::true_type());
+    return res;
+}
+
+template<typename In, typename Out, typename Pred>
+Out move_while(input_sequence_range<In> range, Out res, Pred cond)
+{
+    WT_TRACE_ISEQ("move_while", range);
+    return wt::move_while(range.first, range.second, res, cond);
+}
+
+template<typename In, typename C, typename Pred>
+into_iterator<C> move_while(input_sequence_range<In> range,
+                            into_iterator<C> res,
+                            Pred cond)
+{
+    WT_TRACE_ISEQ("move_while", range);
+    detail::append_until(res.container(), range.first, range.second, cond,
+                         false, std::true_type());
+    return res;
 }
 
 template <typename In, typename In2>
 std::pair<In,In2> match(input_sequence_range<In> range,
                         input_sequence_range<In2> range2)
 {
-    return match(range.first, range.second,
-                 range2.first, range2.second);
+    WT_TRACE_ISEQ("match", range);
+    return detail::match(range.first, range.second,
+                         range2.first, range2.second,
+                         detail::is_comparable_contiguous<In,In2>());
 }
 
 template <typename In, typename In2, typename BinPred>
@@ -718,15 +1065,17 @@ std::pair<In,In2> match(input_sequence_range<In> range,
                         input_sequence_range<In2> range2,
                         BinPred op)
 {
-    return match(range.first, range.second,
-                 range2.first, range2.second,
-                 op);
+    WT_TRACE_ISEQ("match", range);
+    return wt::match(range.first, range.second,
+                     range2.first, range2.second,
+                     op);
 }
 
 template<typename In, typename Fwd>
 In find_first_not_of(input_sequence_range<In> range,
                      input_sequence_range<Fwd> range2)
 {
+    WT_TRACE_ISEQ("find_first_not_of", range);
     return find_first_not_of(range.first, range.second,
                              range2.first, range2.second);
 }
@@ -736,11 +1085,425 @@ In find_first_not_of(input_sequence_range<In> range,
                      input_sequence_range<Fwd> range2,
                      BinPred op)
 {
+    WT_TRACE_ISEQ("find_first_not_of", range);
     return find_first_not_of(range.first, range.second,
                              range2.first, range2.second,
                              op);
 }
 
+template<typename In, typename Size, typename Out>
+Out top_k(input_sequence_range<In> range, Size k, Out res)
+{
+    WT_TRACE_ISEQ("top_k", range);
+    return wt::top_k(range.first, range.second, k, res);
+}
+
+template<typename In, typename Size, typename Out, typename Cmp>
+Out top_k(input_sequence_range<In> range, Size k, Out res, Cmp c)
+{
+    WT_TRACE_ISEQ("top_k", range);
+    return wt::top_k(range.first, range.second, k, res, c);
+}
+
+template<typename In, typename Size, typename Out, typename Gen>
+Out sample(input_sequence_range<In> range, Size k, Out res, Gen& g)
+{
+    WT_TRACE_ISEQ("sample", range);
+    return wt::sample(range.first, range.second, k, res, g);
+}
+
+template<typename In, typename Out>
+Out distinct(input_sequence_range<In> range, Out res)
+{
+    WT_TRACE_ISEQ("distinct", range);
+    return wt::distinct(range.first, range.second, res);
+}
+
+template<typename In, typename Out>
+Out distinct(input_sequence_range<In> range, Out res, std::size_t expected)
+{
+    WT_TRACE_ISEQ("distinct", range);
+    return wt::distinct(range.first, range.second, res, expected);
+}
+
+template<typename In>
+std::size_t count_distinct(input_sequence_range<In> range)
+{
+    WT_TRACE_ISEQ("count_distinct", range);
+    return wt::count_distinct(range.first, range.second);
+}
+
+template<typename In>
+std::size_t count_distinct(input_sequence_range<In> range,
+                           std::size_t expected)
+{
+    WT_TRACE_ISEQ("count_distinct", range);
+    return wt::count_distinct(range.first, range.second, expected);
+}
+
+template<typename In, typename KeyFn>
+flat_hash_map<typename detail::key_of<In,KeyFn>::type, std::size_t>
+count_by(input_sequence_range<In> range, KeyFn key)
+{
+    WT_TRACE_ISEQ("count_by", range);
+    return wt::count_by(range.first, range.second, key);
+}
+
+template<typename In, typename KeyFn>
+flat_hash_map<typename detail::key_of<In,KeyFn>::type, std::size_t>
+count_by(input_sequence_range<In> range, KeyFn key, std::size_t expected)
+{
+    WT_TRACE_ISEQ("count_by", range);
+    return wt::count_by(range.first, range.second, key, expected);
+}
+
+template<typename In>
+std::vector<std::size_t> histogram(input_sequence_range<In> range,
+                                   std::size_t bins)
+{
+    WT_TRACE_ISEQ("histogram", range);
+    return wt::histogram(range.first, range.second, bins);
+}
+
+template<typename In>
+std::vector<std::size_t> histogram(input_sequence_range<In> range,
+                                   double lo, double hi, std::size_t bins)
+{
+    WT_TRACE_ISEQ("histogram", range);
+    return wt::histogram(range.first, range.second, lo, hi, bins);
+}
+
+template<typename Fwd>
+void counting_sort(input_sequence_range<Fwd> range, std::size_t key_range)
+{
+    WT_TRACE_ISEQ("counting_sort", range);
+    wt::counting_sort(range.first, range.second, key_range);
+}
+
+template<typename Ran, typename KeyFn>
+void counting_sort(input_sequence_range<Ran> range,
+                   std::size_t key_range,
+                   KeyFn key)
+{
+    WT_TRACE_ISEQ("counting_sort", range);
+    wt::counting_sort(range.first, range.second, key_range, key);
+}
+
+template<typename Ran, typename BucketFn>
+std::vector<std::size_t> multiway_partition(input_sequence_range<Ran> range,
+                                            std::size_t buckets,
+                                            BucketFn bucket)
+{
+    WT_TRACE_ISEQ("multiway_partition", range);
+    return wt::multiway_partition(range.first, range.second, buckets, bucket);
+}
+
+template<typename Bi, typename Ran>
+void inplace_merge(input_sequence_range<Bi> range, Bi middle,
+                   input_sequence_range<Ran> buffer)
+{
+    WT_TRACE_ISEQ("inplace_merge", range);
+    wt::inplace_merge(range.first, middle, range.second,
+                      buffer.first, buffer.second);
+}
+
+template<typename Bi, typename Ran, typename Cmp>
+void inplace_merge(input_sequence_range<Bi> range, Bi middle,
+                   input_sequence_range<Ran> buffer, Cmp c)
+{
+    WT_TRACE_ISEQ("inplace_merge", range);
+    wt::inplace_merge(range.first, middle, range.second,
+                      buffer.first, buffer.second, c);
+}
+
+template<typename Ran>
+void shuffle(input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("shuffle", range);
+    wt::shuffle(range.first, range.second);
+}
+
+template<typename Fwd, typename Dist>
+void generate_random(input_sequence_range<Fwd> range,
+                     std::uint64_t seed,
+                     Dist dist)
+{
+    WT_TRACE_ISEQ("generate_random", range);
+    wt::generate_random(range.first, range.second, seed, dist);
+}
+
+// WRAPPERS FOR PARALLEL ALGORITHMS
+
+template <typename Ran, typename Pred>
+Ran remove_if(const parallel_policy& pol,
+              input_sequence_range<Ran> range,
+              Pred op)
+{
+    WT_TRACE_ISEQ("remove_if", range);
+    return wt::remove_if(pol, range.first, range.second, op);
+}
+
+template <typename Ran, typename Out, typename Pred>
+Out remove_copy_if(const parallel_policy& pol,
+                   input_sequence_range<Ran> range,
+                   Out res, Pred op)
+{
+    WT_TRACE_ISEQ("remove_copy_if", range);
+    return wt::remove_copy_if(pol, range.first, range.second, res, op);
+}
+
+template <typename Ran, typename Out, typename Pred>
+Out copy_if(const parallel_policy& pol,
+            input_sequence_range<Ran> range,
+            Out res, Pred op)
+{
+    WT_TRACE_ISEQ("copy_if", range);
+    return wt::copy_if(pol, range.first, range.second, res, op);
+}
+
+template <typename Ran>
+Ran unique(const parallel_policy& pol, input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("unique", range);
+    return wt::unique(pol, range.first, range.second);
+}
+
+template <typename Ran, typename BinPred>
+Ran unique(const parallel_policy& pol,
+           input_sequence_range<Ran> range,
+           BinPred op)
+{
+    WT_TRACE_ISEQ("unique", range);
+    return wt::unique(pol, range.first, range.second, op);
+}
+
+template <typename Ran, typename Out>
+Out unique_copy(const parallel_policy& pol,
+                input_sequence_range<Ran> range,
+                Out res)
+{
+    WT_TRACE_ISEQ("unique_copy", range);
+    return wt::unique_copy(pol, range.first, range.second, res);
+}
+
+template <typename Ran, typename Out, typename BinPred>
+Out unique_copy(const parallel_policy& pol,
+                input_sequence_range<Ran> range,
+                Out res, BinPred op)
+{
+    WT_TRACE_ISEQ("unique_copy", range);
+    return wt::unique_copy(pol, range.first, range.second, res, op);
+}
+
+template<typename Ran, typename Out>
+Out distinct(const parallel_policy& pol,
+             input_sequence_range<Ran> range,
+             Out res)
+{
+    WT_TRACE_ISEQ("distinct", range);
+    return wt::distinct(pol, range.first, range.second, res);
+}
+
+template<typename Ran>
+std::size_t count_distinct(const parallel_policy& pol,
+                           input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("count_distinct", range);
+    return wt::count_distinct(pol, range.first, range.second);
+}
+
+template<typename Ran, typename KeyFn>
+flat_hash_map<typename detail::key_of<Ran,KeyFn>::type, std::size_t>
+count_by(const parallel_policy& pol,
+         input_sequence_range<Ran> range,
+         KeyFn key)
+{
+    WT_TRACE_ISEQ("count_by", range);
+    return wt::count_by(pol, range.first, range.second, key);
+}
+
+template<typename Ran>
+std::vector<std::size_t> histogram(const parallel_policy& pol,
+                                   input_sequence_range<Ran> range,
+                                   std::size_t bins)
+{
+    WT_TRACE_ISEQ("histogram", range);
+    return wt::histogram(pol, range.first, range.second, bins);
+}
+
+template<typename Ran>
+std::vector<std::size_t> histogram(const parallel_policy& pol,
+                                   input_sequence_range<Ran> range,
+                                   double lo, double hi, std::size_t bins)
+{
+    WT_TRACE_ISEQ("histogram", range);
+    return wt::histogram(pol, range.first, range.second, lo, hi, bins);
+}
+
+template<typename Ran>
+void counting_sort(const parallel_policy& pol,
+                   input_sequence_range<Ran> range,
+                   std::size_t key_range)
+{
+    WT_TRACE_ISEQ("counting_sort", range);
+    wt::counting_sort(pol, range.first, range.second, key_range);
+}
+
+template<typename Ran, typename KeyFn>
+void counting_sort(const parallel_policy& pol,
+                   input_sequence_range<Ran> range,
+                   std::size_t key_range,
+                   KeyFn key)
+{
+    WT_TRACE_ISEQ("counting_sort", range);
+    wt::counting_sort(pol, range.first, range.second, key_range, key);
+}
+
+template<typename Ran, typename BucketFn>
+std::vector<std::size_t> multiway_partition(const parallel_policy& pol,
+                                            input_sequence_range<Ran> range,
+                                            std::size_t buckets,
+                                            BucketFn bucket)
+{
+    WT_TRACE_ISEQ("multiway_partition", range);
+    return wt::multiway_partition(pol, range.first, range.second,
+                                  buckets, bucket);
+}
+
+template <typename Ran1, typename Ran2, typename Out>
+Out merge(const parallel_policy& pol,
+          input_sequence_range<Ran1> range,
+          input_sequence_range<Ran2> range2,
+          Out res)
+{
+    WT_TRACE_ISEQ("merge", range);
+    return wt::merge(pol, range.first, range.second,
+                     range2.first, range2.second, res);
+}
+
+template <typename Ran1, typename Ran2, typename Out, typename Cmp>
+Out merge(const parallel_policy& pol,
+          input_sequence_range<Ran1> range,
+          input_sequence_range<Ran2> range2,
+          Out res, Cmp c)
+{
+    WT_TRACE_ISEQ("merge", range);
+    return wt::merge(pol, range.first, range.second,
+                     range2.first, range2.second, res, c);
+}
+
+template <typename Ran>
+void inplace_merge(const parallel_policy& pol,
+                   input_sequence_range<Ran> range, Ran middle)
+{
+    WT_TRACE_ISEQ("inplace_merge", range);
+    wt::inplace_merge(pol, range.first, middle, range.second);
+}
+
+template <typename Ran, typename Cmp>
+void inplace_merge(const parallel_policy& pol,
+                   input_sequence_range<Ran> range, Ran middle, Cmp c)
+{
+    WT_TRACE_ISEQ("inplace_merge", range);
+    wt::inplace_merge(pol, range.first, middle, range.second, c);
+}
+
+template <typename Ran, typename Ran2>
+void inplace_merge(const parallel_policy& pol,
+                   input_sequence_range<Ran> range, Ran middle,
+                   input_sequence_range<Ran2> buffer)
+{
+    WT_TRACE_ISEQ("inplace_merge", range);
+    wt::inplace_merge(pol, range.first, middle, range.second,
+                      buffer.first, buffer.second);
+}
+
+template <typename Ran, typename Ran2, typename Cmp>
+void inplace_merge(const parallel_policy& pol,
+                   input_sequence_range<Ran> range, Ran middle,
+                   input_sequence_range<Ran2> buffer, Cmp c)
+{
+    WT_TRACE_ISEQ("inplace_merge", range);
+    wt::inplace_merge(pol, range.first, middle, range.second,
+                      buffer.first, buffer.second, c);
+}
+
+template <typename Ran, typename Pred>
+Ran partition(const parallel_policy& pol,
+              input_sequence_range<Ran> range,
+              Pred op)
+{
+    WT_TRACE_ISEQ("partition", range);
+    return wt::partition(pol, range.first, range.second, op);
+}
+
+template <typename Ran, typename Pred>
+Ran stable_partition(const parallel_policy& pol,
+                     input_sequence_range<Ran> range,
+                     Pred op)
+{
+    WT_TRACE_ISEQ("stable_partition", range);
+    return wt::stable_partition(pol, range.first, range.second, op);
+}
+
+template <typename Ran>
+void shuffle(const parallel_policy& pol, input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("shuffle", range);
+    wt::shuffle(pol, range.first, range.second);
+}
+
+template <typename Ran, typename Gen>
+void shuffle(const parallel_policy& pol, input_sequence_range<Ran> range,
+             Gen& g)
+{
+    WT_TRACE_ISEQ("shuffle", range);
+    wt::shuffle(pol, range.first, range.second, g);
+}
+
+template <typename Ran, typename Dist>
+void generate_random(const parallel_policy& pol,
+                     input_sequence_range<Ran> range,
+                     std::uint64_t seed,
+                     Dist dist)
+{
+    WT_TRACE_ISEQ("generate_random", range);
+    wt::generate_random(pol, range.first, range.second, seed, dist);
+}
+
+template <typename Ran, typename Ran2>
+Ran2 copy(const parallel_policy& pol, input_sequence_range<Ran> range,
+          Ran2 result)
+{
+    WT_TRACE_ISEQ("copy", range);
+    return wt::copy(pol, range.first, range.second, result);
+}
+
+template <typename Ran>
+void reverse(const parallel_policy& pol, input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("reverse", range);
+    wt::reverse(pol, range.first, range.second);
+}
+
+template <typename Ran, typename Ran2>
+Ran2 reverse_copy(const parallel_policy& pol,
+                  input_sequence_range<Ran> range,
+                  Ran2 result)
+{
+    WT_TRACE_ISEQ("reverse_copy", range);
+    return wt::reverse_copy(pol, range.first, range.second, result);
+}
+
+template <typename Ran, typename Ran2>
+Ran2 swap_ranges(const parallel_policy& pol,
+                 input_sequence_range<Ran> range,
+                 Ran2 first2)
+{
+    WT_TRACE_ISEQ("swap_ranges", range);
+    return wt::swap_ranges(pol, range.first, range.second, first2);
+}
+
 } // namespace wt
 
 #endif // ALGORITHM_ISEQ_HH_
@@ -0,0 +1,806 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Cases for the wrappers of algorithm_iseq.hh and sort_iseq.hh
+///////////////////////////////////////////////////////////////////////////////
+
+#include "harness.hh"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <wtl/algorithm.hh>
+#include <wtl/heap.hh>
+
+namespace {
+
+template<typename T>
+struct less_than {
+    explicit less_than(T v) : t(v) { }
+    bool operator()(const T& x) const { return x < t; }
+    T t;
+};
+
+template<typename T>
+struct equal_to_value {
+    explicit equal_to_value(T v) : t(v) { }
+    bool operator()(const T& x) const { return x == t; }
+    T t;
+};
+
+template<typename T>
+struct twice {
+    T operator()(const T& x) const { return x + x; }
+};
+
+/// Agreement for partition():  the same number of elements satisfy the
+/// predicate in both, and both hold the same elements.
+template<typename T>
+struct same_partition {
+    explicit same_partition(less_than<T> p) : op(p) { }
+    bool operator()(std::vector<T> a, std::vector<T> b) const
+    {
+        if( !std::is_partitioned(a.begin(), a.end(), op) ||
+            !std::is_partitioned(b.begin(), b.end(), op) )
+            return false;
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        return a == b;
+    }
+    less_than<T> op;
+};
+
+/// Agreement for shuffle():  both hold the same elements.
+struct same_elements {
+    template<typename V>
+    bool operator()(V a, V b) const
+    {
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        return a == b;
+    }
+};
+
+/// Agreement for nth_element():  the same element lands at position k.
+template<typename T>
+struct same_nth {
+    explicit same_nth(std::size_t i) : k(i) { }
+    bool operator()(const std::vector<T>& a, const std::vector<T>& b) const
+    {
+        return a[k] == b[k];
+    }
+    std::size_t k;
+};
+
+/// Agreement for partial_sort():  the same k smallest elements, in order.
+template<typename T>
+struct same_prefix {
+    explicit same_prefix(std::size_t i) : k(i) { }
+    bool operator()(const std::vector<T>& a, const std::vector<T>& b) const
+    {
+        return std::equal(a.begin(), a.begin() + k, b.begin());
+    }
+    std::size_t k;
+};
+
+struct same_heap {
+    template<typename V>
+    bool operator()(const V& a, const V& b) const
+    {
+        return std::is_heap(a.begin(), a.end()) &&
+               std::is_heap(b.begin(), b.end());
+    }
+};
+
+template<typename T>
+void searches(bench::runner& r, const std::vector<T>& in)
+{
+    const T last = in.back();
+    const std::vector<T> copy(in);
+    std::vector<T> differ(in);
+    differ.back() = differ.front();
+    const std::vector<T> needle(in.end() - std::min<std::size_t>(8, in.size()),
+                                in.end());
+    const less_than<T> below(in.front());
+
+    if( r.wants("find") )
+        bench::compare(r, "find",
+            [&]() { return std::find(in.begin(), in.end(), last); },
+            [&]() { return wt::find(wt::iseq(in), last); });
+    if( r.wants("find_if") )
+        bench::compare(r, "find_if",
+            [&]() { return std::find_if(in.begin(), in.end(),
+                                        equal_to_value<T>(last)); },
+            [&]() { return wt::find_if(wt::iseq(in),
+                                       equal_to_value<T>(last)); });
+    if( r.wants("count") )
+        bench::compare(r, "count",
+            [&]() { return std::count(in.begin(), in.end(), last); },
+            [&]() { return wt::count(wt::iseq(in), last); });
+    if( r.wants("count_if") )
+        bench::compare(r, "count_if",
+            [&]() { return std::count_if(in.begin(), in.end(), below); },
+            [&]() { return wt::count_if(wt::iseq(in), below); });
+    if( r.wants_any_order("adjacent_find") )
+        bench::compare(r, "adjacent_find",
+            [&]() { return std::adjacent_find(in.begin(), in.end()); },
+            [&]() { return wt::adjacent_find(wt::iseq(in)); });
+    if( r.wants("min_element") )
+        bench::compare(r, "min_element",
+            [&]() { return std::min_element(in.begin(), in.end()); },
+            [&]() { return wt::min_element(wt::iseq(in)); });
+    if( r.wants("max_element") )
+        bench::compare(r, "max_element",
+            [&]() { return std::max_element(in.begin(), in.end()); },
+            [&]() { return wt::max_element(wt::iseq(in)); });
+    if( r.wants("equal") )
+        bench::compare(r, "equal",
+            [&]() { return std::equal(in.begin(), in.end(), copy.begin()); },
+            [&]() { return wt::equal(wt::iseq(in), wt::iseq(copy)); });
+    if( r.wants("mismatch") )
+        bench::compare(r, "mismatch",
+            [&]() { return std::mismatch(in.begin(), in.end(),
+                                         differ.begin()).first; },
+            [&]() { return wt::mismatch(wt::iseq(in),
+                                        differ.begin()).first; });
+    if( r.wants("lexicographical_compare") )
+        bench::compare(r, "lexicographical_compare",
+            [&]() { return std::lexicographical_compare(
+                        in.begin(), in.end(), differ.begin(), differ.end()); },
+            [&]() { return wt::lexicographical_compare(
+                        wt::iseq(in), wt::iseq(differ)); });
+    if( r.wants("search") )
+        bench::compare(r, "search",
+            [&]() { return std::search(in.begin(), in.end(),
+                                       needle.begin(), needle.end()); },
+            [&]() { return wt::search(wt::iseq(in), wt::iseq(needle)); });
+    if( r.wants("find_first_of") )
+        bench::compare(r, "find_first_of",
+            [&]() { return std::find_first_of(in.begin(), in.end(),
+                                              needle.end() - 1,
+                                              needle.end()); },
+            [&]() { return wt::find_first_of(
+                        wt::iseq(in), wt::iseq(needle.end() - 1,
+                                               needle.end())); });
+}
+
+template<typename T>
+void sorted_searches(bench::runner& r, const std::vector<T>& in)
+{
+    if( !r.wants("lower_bound") && !r.wants("binary_search") &&
+        !r.wants("includes") )
+        return;
+    std::vector<T> sorted(in);
+    std::sort(sorted.begin(), sorted.end());
+    // A thousand lookups per call.
+    std::vector<T> keys;
+    for( std::size_t i = 0; i < 1000; ++i )
+        keys.push_back(in[i * 7919 % in.size()]);
+    const std::vector<T> half(sorted.begin(),
+                              sorted.begin() + sorted.size() / 2);
+
+    if( r.wants("lower_bound") )
+        bench::compare(r, "lower_bound",
+            [&]() -> std::size_t {
+                std::size_t sum = 0;
+                for( std::size_t i = 0; i < keys.size(); ++i )
+                    sum += std::lower_bound(sorted.begin(), sorted.end(),
+                                            keys[i]) - sorted.begin();
+                return sum;
+            },
+            [&]() -> std::size_t {
+                std::size_t sum = 0;
+                for( std::size_t i = 0; i < keys.size(); ++i )
+                    sum += wt::lower_bound(wt::iseq(sorted), keys[i]) -
+                           sorted.begin();
+                return sum;
+            });
+    if( r.wants("binary_search") )
+        bench::compare(r, "binary_search",
+            [&]() -> std::size_t {
+                std::size_t found = 0;
+                for( std::size_t i = 0; i < keys.size(); ++i )
+                    found += std::binary_search(sorted.begin(), sorted.end(),
+                                                keys[i]);
+                return found;
+            },
+            [&]() -> std::size_t {
+                std::size_t found = 0;
+                for( std::size_t i = 0; i < keys.size(); ++i )
+                    found += wt::binary_search(wt::iseq(sorted), keys[i]);
+                return found;
+            });
+    if( r.wants("includes") )
+        bench::compare(r, "includes",
+            [&]() { return std::includes(sorted.begin(), sorted.end(),
+                                         half.begin(), half.end()); },
+            [&]() { return wt::includes(wt::iseq(sorted), wt::iseq(half)); });
+}
+
+template<typename T>
+void copies(bench::runner& r, const std::vector<T>& in)
+{
+    typedef std::vector<T> V;
+    const std::size_t n = in.size();
+    std::vector<T> sorted(in);
+    std::sort(sorted.begin(), sorted.end());
+    const less_than<T> below(sorted[n / 2]);
+    const T last = in.back();
+
+    if( r.wants("copy") )
+        bench::compare_output<T>(r, "copy", n,
+            [&](V& out) -> std::size_t {
+                return std::copy(in.begin(), in.end(), out.begin()) -
+                       out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::copy(wt::iseq(in), out.begin()) - out.begin();
+            });
+    if( r.wants("copy_if") )
+        bench::compare_output<T>(r, "copy_if", n,
+            [&](V& out) -> std::size_t {
+                return std::copy_if(in.begin(), in.end(), out.begin(),
+                                    below) - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::copy_if(wt::iseq(in), out.begin(), below) -
+                       out.begin();
+            });
+    if( r.wants("remove_copy_if") )
+        bench::compare_output<T>(r, "remove_copy_if", n,
+            [&](V& out) -> std::size_t {
+                return std::remove_copy_if(in.begin(), in.end(), out.begin(),
+                                           below) - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::remove_copy_if(wt::iseq(in), out.begin(), below) -
+                       out.begin();
+            });
+    if( r.wants("remove_copy") )
+        bench::compare_output<T>(r, "remove_copy", n,
+            [&](V& out) -> std::size_t {
+                return std::remove_copy(in.begin(), in.end(), out.begin(),
+                                        last) - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::remove_copy(wt::iseq(in), out.begin(), last) -
+                       out.begin();
+            });
+    if( r.wants_any_order("unique_copy") )
+        bench::compare_output<T>(r, "unique_copy", n,
+            [&](V& out) -> std::size_t {
+                return std::unique_copy(in.begin(), in.end(), out.begin()) -
+                       out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::unique_copy(wt::iseq(in), out.begin()) -
+                       out.begin();
+            });
+    if( r.wants("transform") )
+        bench::compare_output<T>(r, "transform", n,
+            [&](V& out) -> std::size_t {
+                return std::transform(in.begin(), in.end(), out.begin(),
+                                      twice<T>()) - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::transform(wt::iseq(in), out.begin(), twice<T>()) -
+                       out.begin();
+            });
+    if( r.wants("replace_copy") )
+        bench::compare_output<T>(r, "replace_copy", n,
+            [&](V& out) -> std::size_t {
+                return std::replace_copy(in.begin(), in.end(), out.begin(),
+                                         last, T()) - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::replace_copy(wt::iseq(in), out.begin(), last,
+                                        T()) - out.begin();
+            });
+    if( r.wants("reverse_copy") )
+        bench::compare_output<T>(r, "reverse_copy", n,
+            [&](V& out) -> std::size_t {
+                return std::reverse_copy(in.begin(), in.end(), out.begin()) -
+                       out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::reverse_copy(wt::iseq(in), out.begin()) -
+                       out.begin();
+            });
+    if( r.wants("rotate_copy") )
+        bench::compare_output<T>(r, "rotate_copy", n,
+            [&](V& out) -> std::size_t {
+                return std::rotate_copy(in.begin(), in.begin() + n / 3,
+                                        in.end(), out.begin()) - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::rotate_copy(wt::iseq(in), in.begin() + n / 3,
+                                       out.begin()) - out.begin();
+            });
+}
+
+template<typename T>
+void sorted_copies(bench::runner& r, const std::vector<T>& in)
+{
+    typedef std::vector<T> V;
+    if( !r.wants("merge") && !r.wants("set_union") &&
+        !r.wants("set_intersection") && !r.wants("set_difference") )
+        return;
+    const std::size_t n = in.size();
+    V a(in.begin(), in.begin() + n / 2), b(in.begin() + n / 2, in.end());
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+
+    if( r.wants("merge") )
+        bench::compare_output<T>(r, "merge", n,
+            [&](V& out) -> std::size_t {
+                return std::merge(a.begin(), a.end(), b.begin(), b.end(),
+                                  out.begin()) - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::merge(wt::iseq(a), wt::iseq(b), out.begin()) -
+                       out.begin();
+            });
+    if( r.wants("set_union") )
+        bench::compare_output<T>(r, "set_union", n,
+            [&](V& out) -> std::size_t {
+                return std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                                      out.begin()) - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::set_union(wt::iseq(a), wt::iseq(b),
+                                     out.begin()) - out.begin();
+            });
+    if( r.wants("set_intersection") )
+        bench::compare_output<T>(r, "set_intersection", n,
+            [&](V& out) -> std::size_t {
+                return std::set_intersection(a.begin(), a.end(), b.begin(),
+                                             b.end(), out.begin()) -
+                       out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::set_intersection(wt::iseq(a), wt::iseq(b),
+                                            out.begin()) - out.begin();
+            });
+    if( r.wants("set_difference") )
+        bench::compare_output<T>(r, "set_difference", n,
+            [&](V& out) -> std::size_t {
+                return std::set_difference(a.begin(), a.end(), b.begin(),
+                                           b.end(), out.begin()) -
+                       out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::set_difference(wt::iseq(a), wt::iseq(b),
+                                          out.begin()) - out.begin();
+            });
+}
+
+template<typename T>
+void modifiers(bench::runner& r, const std::vector<T>& in)
+{
+    typedef std::vector<T> V;
+    const std::size_t n = in.size();
+    std::vector<T> sorted(in);
+    std::sort(sorted.begin(), sorted.end());
+    const less_than<T> below(sorted[n / 2]);
+    const T last = in.back();
+    const bench::equal_results equal;
+
+    if( r.wants("fill") )
+        bench::compare_in_place(r, "fill", in,
+            [&](V& v) -> std::size_t { std::fill(v.begin(), v.end(), last);
+                                       return 0; },
+            [&](V& v) -> std::size_t { wt::fill(wt::iseq(v), last);
+                                       return 0; },
+            equal);
+    if( r.wants("replace") )
+        bench::compare_in_place(r, "replace", in,
+            [&](V& v) -> std::size_t {
+                std::replace(v.begin(), v.end(), last, T());
+                return 0;
+            },
+            [&](V& v) -> std::size_t {
+                wt::replace(wt::iseq(v), last, T());
+                return 0;
+            },
+            equal);
+    if( r.wants("reverse") )
+        bench::compare_in_place(r, "reverse", in,
+            [&](V& v) -> std::size_t { std::reverse(v.begin(), v.end());
+                                       return 0; },
+            [&](V& v) -> std::size_t { wt::reverse(wt::iseq(v));
+                                       return 0; },
+            equal);
+    if( r.wants("rotate") )
+        bench::compare_in_place(r, "rotate", in,
+            [&](V& v) -> std::size_t {
+                std::rotate(v.begin(), v.begin() + n / 3, v.end());
+                return 0;
+            },
+            [&](V& v) -> std::size_t {
+                wt::rotate(wt::iseq(v), v.begin() + n / 3);
+                return 0;
+            },
+            equal);
+    if( r.wants("swap_ranges") )
+        bench::compare_in_place(r, "swap_ranges", in,
+            [&](V& v) -> std::size_t {
+                std::swap_ranges(v.begin(), v.begin() + n / 2,
+                                 v.end() - n / 2);
+                return 0;
+            },
+            [&](V& v) -> std::size_t {
+                wt::swap_ranges(wt::iseq(v.begin(), v.begin() + n / 2),
+                                v.end() - n / 2);
+                return 0;
+            },
+            equal);
+    if( r.wants("remove_if") )
+        bench::compare_in_place(r, "remove_if", in,
+            [&](V& v) -> std::size_t {
+                return std::remove_if(v.begin(), v.end(), below) - v.begin();
+            },
+            [&](V& v) -> std::size_t {
+                return wt::remove_if(wt::iseq(v), below) - v.begin();
+            },
+            same_prefix<T>(0));
+    if( r.wants("remove") )
+        bench::compare_in_place(r, "remove", in,
+            [&](V& v) -> std::size_t {
+                return std::remove(v.begin(), v.end(), last) - v.begin();
+            },
+            [&](V& v) -> std::size_t {
+                return wt::remove(wt::iseq(v), last) - v.begin();
+            },
+            same_prefix<T>(0));
+    if( r.wants_any_order("unique") )
+        bench::compare_in_place(r, "unique", in,
+            [&](V& v) -> std::size_t {
+                return std::unique(v.begin(), v.end()) - v.begin();
+            },
+            [&](V& v) -> std::size_t {
+                return wt::unique(wt::iseq(v)) - v.begin();
+            },
+            same_prefix<T>(0));
+    if( r.wants("partition") )
+        bench::compare_in_place(r, "partition", in,
+            [&](V& v) -> std::size_t {
+                return std::partition(v.begin(), v.end(), below) - v.begin();
+            },
+            [&](V& v) -> std::size_t {
+                return wt::partition(wt::iseq(v), below) - v.begin();
+            },
+            same_partition<T>(below));
+    if( r.wants("stable_partition") )
+        bench::compare_in_place(r, "stable_partition", in,
+            [&](V& v) -> std::size_t {
+                return std::stable_partition(v.begin(), v.end(), below) -
+                       v.begin();
+            },
+            [&](V& v) -> std::size_t {
+                return wt::stable_partition(wt::iseq(v), below) - v.begin();
+            },
+            equal);
+    if( r.wants("shuffle") ) {
+        std::mt19937_64 mt(n);
+        wt::wyrand wy(n);
+        bench::compare_in_place(r, "shuffle", in,
+            [&](V& v) -> std::size_t {
+                std::shuffle(v.begin(), v.end(), mt);
+                return 0;
+            },
+            [&](V& v) -> std::size_t {
+                wt::shuffle(wt::iseq(v), wy);
+                return 0;
+            },
+            same_elements());
+    }
+}
+
+template<typename T>
+void sorts(bench::runner& r, const std::vector<T>& in)
+{
+    typedef std::vector<T> V;
+    const std::size_t n = in.size();
+    const std::size_t k = std::min<std::size_t>(n, 1000);
+    const bench::equal_results equal;
+
+    if( r.wants_any_order("sort") )
+        bench::compare_in_place(r, "sort", in,
+            [&](V& v) -> std::size_t { std::sort(v.begin(), v.end());
+                                       return 0; },
+            [&](V& v) -> std::size_t { wt::sort(wt::iseq(v));
+                                       return 0; },
+            equal);
+    if( r.wants_any_order("stable_sort") )
+        bench::compare_in_place(r, "stable_sort", in,
+            [&](V& v) -> std::size_t { std::stable_sort(v.begin(), v.end());
+                                       return 0; },
+            [&](V& v) -> std::size_t { wt::stable_sort(wt::iseq(v));
+                                       return 0; },
+            equal);
+    if( r.wants_any_order("partial_sort") )
+        bench::compare_in_place(r, "partial_sort", in,
+            [&](V& v) -> std::size_t {
+                std::partial_sort(v.begin(), v.begin() + k, v.end());
+                return 0;
+            },
+            [&](V& v) -> std::size_t {
+                wt::partial_sort(wt::iseq(v), v.begin() + k);
+                return 0;
+            },
+            same_prefix<T>(k));
+    if( r.wants_any_order("nth_element") )
+        bench::compare_in_place(r, "nth_element", in,
+            [&](V& v) -> std::size_t {
+                std::nth_element(v.begin(), v.begin() + n / 2, v.end());
+                return 0;
+            },
+            [&](V& v) -> std::size_t {
+                wt::nth_element(wt::iseq(v), v.begin() + n / 2);
+                return 0;
+            },
+            same_nth<T>(n / 2));
+    if( r.wants_any_order("make_heap") )
+        bench::compare_in_place(r, "make_heap", in,
+            [&](V& v) -> std::size_t { std::make_heap(v.begin(), v.end());
+                                       return 0; },
+            [&](V& v) -> std::size_t { wt::make_heap(wt::iseq(v));
+                                       return 0; },
+            same_heap());
+    if( r.wants_any_order("priority_queue") )
+        bench::compare_output<T>(r, "priority_queue", n,
+            [&](V& out) -> std::size_t {
+                std::priority_queue<T> q;
+                for( std::size_t i = 0; i < n; ++i ) q.push(in[i]);
+                for( std::size_t i = 0; i < n; ++i ) {
+                    out[i] = q.top();
+                    q.pop();
+                }
+                return n;
+            },
+            [&](V& out) -> std::size_t {
+                wt::priority_queue<T> q;
+                for( std::size_t i = 0; i < n; ++i ) q.push(in[i]);
+                q.pop(n, out.begin());
+                return n;
+            });
+    if( r.wants_any_order("priority_queue_bulk_push") ) {
+        // Half the input is queued, the other half pushed at once, and the
+        // greatest few popped.
+        const std::size_t top = std::min<std::size_t>(n, 64);
+        bench::compare_output<T>(r, "priority_queue_bulk_push", top,
+            [&](V& out) -> std::size_t {
+                std::priority_queue<T> q(in.begin(), in.begin() + n / 2);
+                for( std::size_t i = n / 2; i < n; ++i ) q.push(in[i]);
+                for( std::size_t i = 0; i < top; ++i ) {
+                    out[i] = q.top();
+                    q.pop();
+                }
+                return top;
+            },
+            [&](V& out) -> std::size_t {
+                wt::priority_queue<T> q(in.begin(), in.begin() + n / 2);
+                q.push(in.begin() + n / 2, in.end());
+                q.pop(top, out.begin());
+                return top;
+            });
+    }
+    if( r.wants_any_order("indexed_priority_queue") ) {
+        // Every element is queued by its index, then popped greatest first;
+        // each pop raises the priority of another queued element to its
+        // own, as a shortest-path search lowers distances.  Ties are broken
+        // by index, so both queues pop the same elements.  std:: queues an
+        // entry per update and skips the stale ones as they surface.
+        typedef std::pair<T,std::size_t> key;
+        bench::compare_output<T>(r, "indexed_priority_queue", n,
+            [&](V& out) -> std::size_t {
+                std::priority_queue<key> q;
+                std::vector<key> current(n);
+                std::vector<char> done(n, 0);
+                for( std::size_t i = 0; i < n; ++i ) {
+                    current[i] = key(in[i], i);
+                    q.push(current[i]);
+                }
+                std::size_t m = 0;
+                while( !q.empty() ) {
+                    const key e = q.top();
+                    q.pop();
+                    if( done[e.second] || e != current[e.second] ) continue;
+                    done[e.second] = 1;
+                    out[m++] = e.first;
+                    const std::size_t u = m * 7919 % n;
+                    if( !done[u] && current[u].first < e.first ) {
+                        current[u].first = e.first;
+                        q.push(current[u]);
+                    }
+                }
+                return m;
+            },
+            [&](V& out) -> std::size_t {
+                wt::indexed_priority_queue<key> q(n);
+                for( std::size_t i = 0; i < n; ++i ) q.push(i, key(in[i], i));
+                std::size_t m = 0;
+                while( !q.empty() ) {
+                    const key e = q.top_priority();
+                    q.pop();
+                    out[m++] = e.first;
+                    const std::size_t u = m * 7919 % n;
+                    if( q.contains(u) && q.priority(u).first < e.first )
+                        q.update(u, key(e.first, u));
+                }
+                return m;
+            });
+    }
+    if( r.wants("inplace_merge") ) {
+        V halves(in);
+        std::sort(halves.begin(), halves.begin() + n / 2);
+        std::sort(halves.begin() + n / 2, halves.end());
+        bench::compare_in_place(r, "inplace_merge", halves,
+            [&](V& v) -> std::size_t {
+                std::inplace_merge(v.begin(), v.begin() + n / 2, v.end());
+                return 0;
+            },
+            [&](V& v) -> std::size_t {
+                wt::inplace_merge(wt::iseq(v), v.begin() + n / 2);
+                return 0;
+            },
+            equal);
+    }
+    if( r.wants_any_order("top_k") )
+        bench::compare_output<T>(r, "top_k", k,
+            [&](V& out) -> std::size_t {
+                return std::partial_sort_copy(in.begin(), in.end(),
+                                              out.begin(), out.end(),
+                                              std::greater<T>()) -
+                       out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::top_k(wt::iseq(in), k, out.begin()) - out.begin();
+            });
+    if( r.wants_any_order("argsort") ) {
+        typedef std::vector<std::size_t> I;
+        bench::compare_output<std::size_t>(r, "argsort", n,
+            [&](I& out) -> std::size_t {
+                for( std::size_t i = 0; i < n; ++i ) out[i] = i;
+                std::stable_sort(out.begin(), out.end(),
+                                 [&](std::size_t a, std::size_t b) {
+                                     return in[a] < in[b];
+                                 });
+                return n;
+            },
+            [&](I& out) -> std::size_t {
+                wt::argsort(wt::iseq(in), out.begin());
+                return n;
+            });
+    }
+}
+
+template<typename T>
+void distinct_values(bench::runner& r, const std::vector<T>& in)
+{
+    typedef std::vector<T> V;
+    const std::size_t n = in.size();
+
+    if( r.wants_any_order("count_distinct") )
+        bench::compare(r, "count_distinct",
+            [&]() -> std::size_t {
+                std::unordered_set<T> seen(in.begin(), in.end());
+                return seen.size();
+            },
+            [&]() { return wt::count_distinct(wt::iseq(in)); });
+    if( r.wants_any_order("distinct") )
+        bench::compare_output<T>(r, "distinct", n,
+            [&](V& out) -> std::size_t {
+                std::unordered_set<T> seen;
+                typename V::iterator o = out.begin();
+                for( std::size_t i = 0; i < n; ++i )
+                    if( seen.insert(in[i]).second ) *o++ = in[i];
+                return o - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::distinct(wt::iseq(in), out.begin()) - out.begin();
+            });
+    if( r.wants("histogram") ) {
+        const double lo = static_cast<double>(
+            *std::min_element(in.begin(), in.end()));
+        const double hi = static_cast<double>(
+            *std::max_element(in.begin(), in.end()));
+        bench::compare(r, "histogram",
+            [&]() -> std::vector<std::size_t> {
+                std::vector<std::size_t> counts(64, 0);
+                const double scale = 64 / (hi - lo);
+                for( std::size_t i = 0; i < n; ++i ) {
+                    const std::size_t b = static_cast<std::size_t>(
+                        (static_cast<double>(in[i]) - lo) * scale);
+                    ++counts[std::min<std::size_t>(b, 63)];
+                }
+                return counts;
+            },
+            [&]() { return wt::histogram(wt::iseq(in), lo, hi, 64); });
+    }
+}
+
+/// The parallel merges, at every thread count from one to the hardware's,
+/// each against the serial std:: merge.  A case is named for its thread
+/// count, as in par_merge/4.
+template<typename T>
+void parallel_merges(bench::runner& r, const std::vector<T>& in)
+{
+    typedef std::vector<T> V;
+    if( !r.wants_any_order("par_merge") &&
+        !r.wants_any_order("par_inplace_merge") )
+        return;
+    const std::size_t n = in.size();
+    V halves(in);
+    std::sort(halves.begin(), halves.begin() + n / 2);
+    std::sort(halves.begin() + n / 2, halves.end());
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for( unsigned t = 1; t <= threads; ++t ) {
+        const std::string merge = "par_merge/" + std::to_string(t);
+        if( r.wants_any_order(merge.c_str()) )
+            bench::compare_output<T>(r, merge.c_str(), n,
+                [&](V& out) -> std::size_t {
+                    return std::merge(halves.begin(), halves.begin() + n / 2,
+                                      halves.begin() + n / 2, halves.end(),
+                                      out.begin()) - out.begin();
+                },
+                [&](V& out) -> std::size_t {
+                    return wt::merge(wt::par(t),
+                                     halves.begin(), halves.begin() + n / 2,
+                                     halves.begin() + n / 2, halves.end(),
+                                     out.begin()) - out.begin();
+                });
+        const std::string inplace = "par_inplace_merge/" + std::to_string(t);
+        if( r.wants_any_order(inplace.c_str()) )
+            bench::compare_in_place(r, inplace.c_str(), halves,
+                [&](V& v) -> std::size_t {
+                    std::inplace_merge(v.begin(), v.begin() + n / 2, v.end());
+                    return 0;
+                },
+                [&](V& v) -> std::size_t {
+                    wt::inplace_merge(wt::par(t), v.begin(), v.begin() + n / 2,
+                                      v.end());
+                    return 0;
+                },
+                bench::equal_results());
+    }
+}
+
+template<typename T>
+void run(bench::runner& r, const std::vector<T>& in)
+{
+    searches(r, in);
+    sorted_searches(r, in);
+    copies(r, in);
+    sorted_copies(r, in);
+    modifiers(r, in);
+    sorts(r, in);
+    distinct_values(r, in);
+    parallel_merges(r, in);
+}
+
+} // namespace
+
+namespace bench {
+
+void algorithm_benchmarks(runner& r, const std::vector<std::int32_t>& in)
+{
+    run(r, in);
+}
+
+void algorithm_benchmarks(runner& r, const std::vector<std::uint64_t>& in)
+{
+    run(r, in);
+}
+
+void algorithm_benchmarks(runner& r, const std::vector<double>& in)
+{
+    run(r, in);
+}
+
+} // namespace bench
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Compare wtl_bench results.
+
+    compare.py BASELINE.json CURRENT.json [--threshold 0.05]
+        Flag every case that got slower than in the baseline by more than
+        the threshold, a fraction.  Exits with status 1 if any did.
+
+    compare.py --overhead CURRENT.json [--threshold 0.05]
+        Flag every case whose wt:: call is slower than the std:: call it is
+        measured against by more than the threshold.  Exits with status 1 if
+        any is.
+
+Timings are the median nanoseconds per element;  --metric min uses the
+fastest sample instead, which is steadier on a noisy machine.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path, metric):
+    with open(path) as f:
+        doc = json.load(f)
+    key = "ns_per_element_min" if metric == "min" else "ns_per_element"
+    return {(r["name"], r["impl"]): r[key] for r in doc["results"]}
+
+
+def report(rows, threshold, label):
+    flagged = 0
+    for name, before, after in sorted(rows):
+        if before <= 0:
+            continue
+        change = after / before - 1
+        mark = ""
+        if change > threshold:
+            mark = label
+            flagged += 1
+        elif change < -threshold:
+            mark = "faster"
+        print("%-60s %10.3f %10.3f %+8.1f%%  %s"
+              % (name, before, after, 100 * change, mark))
+    return flagged
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("files", nargs="+")
+    parser.add_argument("--threshold", type=float, default=0.05)
+    parser.add_argument("--metric", choices=["median", "min"],
+                        default="median")
+    parser.add_argument("--overhead", action="store_true")
+    args = parser.parse_args()
+
+    if args.overhead:
+        if len(args.files) != 1:
+            parser.error("--overhead takes one results file")
+        res = load(args.files[0], args.metric)
+        rows = [(name, ns, res[(name, "wt")])
+                for (name, impl), ns in res.items()
+                if impl == "std" and (name, "wt") in res]
+        print("%-60s %10s %10s %9s" % ("case", "std", "wt", "change"))
+        flagged = report(rows, args.threshold, "OVERHEAD")
+        print("%d of %d cases slower than std by more than %.0f%%"
+              % (flagged, len(rows), 100 * args.threshold))
+    else:
+        if len(args.files) != 2:
+            parser.error("expected a baseline and a current results file")
+        old = load(args.files[0], args.metric)
+        new = load(args.files[1], args.metric)
+        rows = [("%s [%s]" % key, old[key], new[key])
+                for key in new if key in old]
+        print("%-60s %10s %10s %9s" % ("case", "baseline", "current",
+                                       "change"))
+        flagged = report(rows, args.threshold, "REGRESSION")
+        print("%d of %d cases regressed by more than %.0f%%"
+              % (flagged, len(rows), 100 * args.threshold))
+    return 1 if flagged else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,207 @@
+#ifndef BENCH_HARNESS_HH_
+#define BENCH_HARNESS_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// Benchmark harness
+///
+/// Every case measures a wt:: call against the std:: call, or the plain
+/// composition of std:: calls, that it replaces, on the same input.  The
+/// inputs cover a grid of element types, distributions and sizes, from
+/// arrays that fit in L1 to arrays that only fit in DRAM.  After both calls
+/// of a case have run, their results are compared, so the suite doubles as
+/// a check that the fast paths compute what the standard algorithms do.
+///
+/// Results are printed as they come and can be written as JSON, which
+/// bench/compare.py compares against an earlier run or checks for wrapper
+/// overhead.  Where the hardware counters are available, the JSON also has
+/// the cycles, instructions, branch misses and cache misses per element.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <wtl/perf.hh>
+
+namespace bench {
+
+/// The order of the values of an input.
+enum distribution {
+    random_values,
+    sorted_values,
+    reversed_values,
+    few_unique          // Random values among 16 distinct ones.
+};
+
+const char* name_of(distribution d);
+
+/// Keep the compiler from discarding v or the computation that produced it.
+template<typename T>
+inline void do_not_optimize(const T& v)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(v) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &v;
+#endif
+}
+
+/// Whether two results of a case agree.  Floating-point sums may be
+/// reassociated by vectorized code, so they need only agree closely.
+template<typename T>
+bool same(const T& a, const T& b) { return a == b; }
+
+inline bool same(double a, double b)
+{
+    return a == b || std::fabs(a - b) <= 1e-6 * std::max(std::fabs(a),
+                                                         std::fabs(b));
+}
+
+inline bool same(float a, float b)
+{
+    return bench::same(static_cast<double>(a), static_cast<double>(b));
+}
+
+struct options {
+    options() : min_time(0.05), quick(false) { }
+
+    double min_time;                        // Seconds per measurement.
+    std::vector<std::size_t> sizes;         // Input sizes, in bytes.
+    std::vector<distribution> dists;
+    std::vector<std::string> types;
+    std::string filter;                     // Substring of case names.
+    std::string json;                       // Output file, if any.
+    bool quick;
+};
+
+struct result {
+    std::string op;
+    std::string impl;                       // "std" or "wt".
+    std::string type;
+    std::string dist;
+    std::size_t n;                          // Elements.
+    std::size_t bytes;
+    std::size_t samples;
+    double ns;                              // Median per element.
+    double ns_min;                          // Fastest per element.
+    wt::perf_counts counts;                 // Over all samples.
+    std::size_t calls;                      // Calls the counts cover.
+};
+
+/// Runs the cases of one input at a time and collects their results.
+class runner {
+public:
+    explicit runner(const options& opts);
+
+    /// Set the input the following cases run on.
+    void input(const char* type, distribution d, std::size_t n,
+               std::size_t bytes);
+
+    distribution dist() const { return dist_; }
+
+    /// Whether to run a case that only depends on the size of its input,
+    /// which is the case for most scans;  those run on random values only.
+    bool wants(const char* op) const;
+
+    /// Whether to run a case whose cost depends on the order of its input,
+    /// such as a sort;  those run on every distribution.
+    bool wants_any_order(const char* op) const;
+
+    /// Time run() until the minimum time has elapsed.  Cases that modify
+    /// their input pass prepare(), which restores it untimed before every
+    /// call of run();  other cases are timed in batches of calls.
+    void measure(const char* op, const char* impl,
+                 const std::function<void()>& run);
+    void measure(const char* op, const char* impl,
+                 const std::function<void()>& run,
+                 const std::function<void()>& prepare);
+
+    /// Record whether the wt:: and std:: results of a case agree.
+    void check(const char* op, bool agree);
+
+    const std::vector<result>& results() const { return results_; }
+    std::size_t failures() const { return failures_; }
+
+private:
+    void record(const char* op, const char* impl,
+                std::vector<double>& samples, const wt::perf_counts& counts,
+                std::size_t calls);
+
+    options opts_;
+    std::string type_;
+    distribution dist_;
+    std::size_t n_;
+    std::size_t bytes_;
+    std::vector<result> results_;
+    std::size_t failures_;
+};
+
+/// Measure a case that returns a value, as std:: and wt::, and check that
+/// both return the same.
+template<typename StdFn, typename WtFn>
+void compare(runner& r, const char* op, StdFn s, WtFn w)
+{
+    typedef decltype(s()) R;
+    R rs = R(), rw = R();
+    r.measure(op, "std", [&]() { rs = s(); do_not_optimize(rs); });
+    r.measure(op, "wt", [&]() { rw = w(); do_not_optimize(rw); });
+    r.check(op, bench::same(rs, rw));
+}
+
+/// Measure a case that writes into a buffer of out_n elements and returns
+/// how many it wrote, as std:: and wt::, and check that both write the same.
+template<typename T, typename StdFn, typename WtFn>
+void compare_output(runner& r, const char* op, std::size_t out_n,
+                    StdFn s, WtFn w)
+{
+    std::vector<T> out_s(out_n), out_w(out_n);
+    std::size_t ns = 0, nw = 0;
+    r.measure(op, "std", [&]() { ns = s(out_s); do_not_optimize(out_s[0]); });
+    r.measure(op, "wt", [&]() { nw = w(out_w); do_not_optimize(out_w[0]); });
+    bool agree = ns == nw;
+    for( std::size_t i = 0; agree && i < ns; ++i )
+        agree = bench::same(out_s[i], out_w[i]);
+    r.check(op, agree);
+}
+
+/// Measure a case that modifies a copy of its input and returns a position
+/// or count, as std:: and wt::.  agree(std_result, wt_result) checks the
+/// modified copies, which for unstable algorithms may legitimately differ.
+template<typename T, typename StdFn, typename WtFn, typename Agree>
+void compare_in_place(runner& r, const char* op, const std::vector<T>& in,
+                      StdFn s, WtFn w, Agree agree)
+{
+    std::vector<T> a(in), b(in);
+    std::size_t ns = 0, nw = 0;
+    r.measure(op, "std", [&]() { ns = s(a); do_not_optimize(a[0]); },
+              [&]() { a = in; });
+    r.measure(op, "wt", [&]() { nw = w(b); do_not_optimize(b[0]); },
+              [&]() { b = in; });
+    r.check(op, ns == nw && agree(a, b));
+}
+
+/// Case agreement for algorithms whose output is fully determined.
+struct equal_results {
+    template<typename V>
+    bool operator()(const V& a, const V& b) const { return a == b; }
+};
+
+void algorithm_benchmarks(runner& r, const std::vector<std::int32_t>& in);
+void algorithm_benchmarks(runner& r, const std::vector<std::uint64_t>& in);
+void algorithm_benchmarks(runner& r, const std::vector<double>& in);
+
+void numeric_benchmarks(runner& r, const std::vector<std::int32_t>& in);
+void numeric_benchmarks(runner& r, const std::vector<std::uint64_t>& in);
+void numeric_benchmarks(runner& r, const std::vector<double>& in);
+
+void memory_benchmarks(runner& r, const std::vector<std::int32_t>& in);
+void memory_benchmarks(runner& r, const std::vector<std::uint64_t>& in);
+void memory_benchmarks(runner& r, const std::vector<double>& in);
+
+} // namespace bench
+
+#endif // BENCH_HARNESS_HH_
@@ -0,0 +1,367 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Benchmark driver
+///
+///  wtl_bench [--quick] [--min-time S] [--sizes 16K,256K,8M,128M]
+///            [--dists random,sorted,reversed,few_unique]
+///            [--types int32,uint64,double] [--filter SUBSTRING]
+///            [--json FILE]
+///
+/// The default sizes are meant to land in L1, L2, the last-level cache and
+/// DRAM respectively.  --quick runs every case once at L1 size, for a smoke
+/// test.  The exit status is nonzero if any wt:: call disagreed with the
+/// std:: call it was measured against.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "harness.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <wtl/perf.hh>
+#include <wtl/simd.hh>
+
+namespace bench {
+
+const char* name_of(distribution d)
+{
+    switch( d ) {
+    case random_values: return "random";
+    case sorted_values: return "sorted";
+    case reversed_values: return "reversed";
+    case few_unique: return "few_unique";
+    }
+    return "?";
+}
+
+runner::runner(const options& opts)
+    : opts_(opts), dist_(random_values), n_(0), bytes_(0), failures_(0)
+{
+}
+
+void runner::input(const char* type, distribution d, std::size_t n,
+                   std::size_t bytes)
+{
+    type_ = type;
+    dist_ = d;
+    n_ = n;
+    bytes_ = bytes;
+}
+
+bool runner::wants(const char* op) const
+{
+    return dist_ == random_values && wants_any_order(op);
+}
+
+bool runner::wants_any_order(const char* op) const
+{
+    return opts_.filter.empty() ||
+           std::string(op).find(opts_.filter) != std::string::npos;
+}
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+double seconds_since(clock_type::time_point t0)
+{
+    return std::chrono::duration<double>(clock_type::now() - t0).count();
+}
+
+} // namespace
+
+void runner::measure(const char* op, const char* impl,
+                     const std::function<void()>& run)
+{
+    // Calls too short for the clock are timed in batches.
+    clock_type::time_point t0 = clock_type::now();
+    run();
+    const double once = seconds_since(t0);
+    const std::size_t batch = once >= 20e-6 ? 1
+                            : static_cast<std::size_t>(20e-6 / (once + 1e-9)) + 1;
+    std::vector<double> samples;
+    wt::perf_scope counters;
+    const clock_type::time_point start = clock_type::now();
+    do {
+        t0 = clock_type::now();
+        for( std::size_t i = 0; i < batch; ++i ) run();
+        samples.push_back(seconds_since(t0) / batch);
+    } while( !opts_.quick && samples.size() < 10000 &&
+             (samples.size() < 3 || seconds_since(start) < opts_.min_time) );
+    record(op, impl, samples, counters.read(), samples.size() * batch);
+}
+
+void runner::measure(const char* op, const char* impl,
+                     const std::function<void()>& run,
+                     const std::function<void()>& prepare)
+{
+    std::vector<double> samples;
+    double timed = 0;
+    // The counters run only around the timed calls, not the preparation.
+    wt::perf_scope counters;
+    counters.pause();
+    counters.reset();
+    do {
+        prepare();
+        counters.resume();
+        const clock_type::time_point t0 = clock_type::now();
+        run();
+        samples.push_back(seconds_since(t0));
+        counters.pause();
+        timed += samples.back();
+    } while( !opts_.quick && samples.size() < 10000 &&
+             (samples.size() < 3 || timed < opts_.min_time) );
+    record(op, impl, samples, counters.read(), samples.size());
+}
+
+void runner::record(const char* op, const char* impl,
+                    std::vector<double>& samples,
+                    const wt::perf_counts& counts, std::size_t calls)
+{
+    std::sort(samples.begin(), samples.end());
+    result r;
+    r.op = op;
+    r.impl = impl;
+    r.type = type_;
+    r.dist = name_of(dist_);
+    r.n = n_;
+    r.bytes = bytes_;
+    r.samples = samples.size();
+    r.ns = samples[samples.size() / 2] * 1e9 / n_;
+    r.ns_min = samples[0] * 1e9 / n_;
+    r.counts = counts;
+    r.calls = calls;
+    results_.push_back(r);
+    std::printf("%-28s %-7s %-11s %10zu  %-4s %9.3f ns/elem\n",
+                op, type_.c_str(), r.dist.c_str(), n_, impl, r.ns);
+    std::fflush(stdout);
+}
+
+void runner::check(const char* op, bool agree)
+{
+    if( agree ) return;
+    ++failures_;
+    std::printf("MISMATCH: %s on %s %s, n = %zu\n",
+                op, type_.c_str(), name_of(dist_), n_);
+}
+
+} // namespace bench
+
+namespace {
+
+template<typename T>
+T random_value(std::mt19937_64& g)
+{
+    return static_cast<T>(g());
+}
+
+template<>
+double random_value<double>(std::mt19937_64& g)
+{
+    return std::uniform_real_distribution<double>(0, 1)(g);
+}
+
+/// Input of n elements of a given distribution.
+template<typename T>
+std::vector<T> make_input(std::size_t n, bench::distribution d)
+{
+    std::mt19937_64 g(n * 4 + d);
+    std::vector<T> v(n);
+    if( d == bench::few_unique ) {
+        std::vector<T> values(16);
+        for( std::size_t i = 0; i < values.size(); ++i )
+            values[i] = random_value<T>(g);
+        for( std::size_t i = 0; i < n; ++i ) v[i] = values[g() % 16];
+        return v;
+    }
+    for( std::size_t i = 0; i < n; ++i ) v[i] = random_value<T>(g);
+    if( d == bench::sorted_values ) std::sort(v.begin(), v.end());
+    if( d == bench::reversed_values ) std::sort(v.rbegin(), v.rend());
+    return v;
+}
+
+template<typename T>
+void run_type(bench::runner& r, const bench::options& opts, const char* type)
+{
+    if( !opts.types.empty() &&
+        std::find(opts.types.begin(), opts.types.end(), type) ==
+        opts.types.end() )
+        return;
+    for( std::size_t s = 0; s < opts.sizes.size(); ++s ) {
+        const std::size_t n = std::max<std::size_t>(opts.sizes[s] / sizeof(T),
+                                                    64);
+        for( std::size_t d = 0; d < opts.dists.size(); ++d ) {
+            const std::vector<T> in = make_input<T>(n, opts.dists[d]);
+            r.input(type, opts.dists[d], n, n * sizeof(T));
+            bench::algorithm_benchmarks(r, in);
+            bench::numeric_benchmarks(r, in);
+            bench::memory_benchmarks(r, in);
+        }
+    }
+}
+
+std::vector<std::string> split(const std::string& s)
+{
+    std::vector<std::string> parts;
+    std::size_t b = 0;
+    for( std::size_t e; (e = s.find(',', b)) != std::string::npos; b = e + 1 )
+        parts.push_back(s.substr(b, e - b));
+    parts.push_back(s.substr(b));
+    return parts;
+}
+
+std::size_t parse_size(const std::string& s)
+{
+    char* end = 0;
+    double v = std::strtod(s.c_str(), &end);
+    switch( *end ) {
+    case 'k': case 'K': v *= 1 << 10; break;
+    case 'm': case 'M': v *= 1 << 20; break;
+    case 'g': case 'G': v *= 1 << 30; break;
+    case '\0': break;
+    default: throw std::invalid_argument("bad size: " + s);
+    }
+    return static_cast<std::size_t>(v);
+}
+
+bench::distribution parse_dist(const std::string& s)
+{
+    for( int d = bench::random_values; d <= bench::few_unique; ++d )
+        if( s == bench::name_of(bench::distribution(d)) )
+            return bench::distribution(d);
+    throw std::invalid_argument("bad distribution: " + s);
+}
+
+bench::options parse_options(int argc, char* argv[])
+{
+    bench::options opts;
+    std::string sizes = "16K,256K,8M,128M";
+    std::string dists = "random,sorted,reversed,few_unique";
+    for( int i = 1; i < argc; ++i ) {
+        const std::string arg = argv[i];
+        if( arg == "--quick" ) {
+            opts.quick = true;
+            sizes = "16K";
+            continue;
+        }
+        if( i + 1 == argc ) throw std::invalid_argument("missing value: " + arg);
+        const std::string val = argv[++i];
+        if( arg == "--min-time" ) opts.min_time = std::atof(val.c_str());
+        else if( arg == "--sizes" ) sizes = val;
+        else if( arg == "--dists" ) dists = val;
+        else if( arg == "--types" ) opts.types = split(val);
+        else if( arg == "--filter" ) opts.filter = val;
+        else if( arg == "--json" ) opts.json = val;
+        else throw std::invalid_argument("unknown option: " + arg);
+    }
+    const std::vector<std::string> s = split(sizes), d = split(dists);
+    for( std::size_t i = 0; i < s.size(); ++i )
+        opts.sizes.push_back(parse_size(s[i]));
+    for( std::size_t i = 0; i < d.size(); ++i )
+        opts.dists.push_back(parse_dist(d[i]));
+    return opts;
+}
+
+const char* simd_level()
+{
+#if defined(WT_SIMD_AVX512_VBMI2)
+    return "avx512vbmi2";
+#elif defined(WT_SIMD_AVX512)
+    return "avx512";
+#elif defined(WT_SIMD_AVX2)
+    return "avx2";
+#elif defined(WT_SIMD_SSSE3)
+    return "ssse3";
+#elif defined(WT_SIMD_SSE2)
+    return "sse2";
+#else
+    return "none";
+#endif
+}
+
+std::string json_string(const std::string& s)
+{
+    std::string out = "\"";
+    for( std::size_t i = 0; i < s.size(); ++i ) {
+        if( s[i] == '"' || s[i] == '\\' ) out += '\\';
+        out += s[i];
+    }
+    return out + "\"";
+}
+
+void write_json(const std::string& path, const bench::runner& r)
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if( f == 0 ) throw std::runtime_error("can't write " + path);
+    char date[32];
+    const std::time_t now = std::time(0);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+                  std::localtime(&now));
+    std::fprintf(f, "{\n  \"context\": {\n");
+    std::fprintf(f, "    \"date\": %s,\n", json_string(date).c_str());
+#if defined(__VERSION__)
+    std::fprintf(f, "    \"compiler\": %s,\n",
+                 json_string(__VERSION__).c_str());
+#endif
+    std::fprintf(f, "    \"simd\": %s\n  },\n", json_string(simd_level()).c_str());
+    std::fprintf(f, "  \"results\": [");
+    const std::vector<bench::result>& res = r.results();
+    for( std::size_t i = 0; i < res.size(); ++i ) {
+        const bench::result& x = res[i];
+        std::fprintf(f, "%s\n    {\"name\": %s, \"op\": %s, \"impl\": %s, "
+                        "\"type\": %s, \"dist\": %s, \"n\": %zu, "
+                        "\"bytes\": %zu, \"samples\": %zu, "
+                        "\"ns_per_element\": %.6g, "
+                        "\"ns_per_element_min\": %.6g",
+                     i == 0 ? "" : ",",
+                     json_string(x.op + "/" + x.type + "/" + x.dist + "/" +
+                                 std::to_string(x.bytes)).c_str(),
+                     json_string(x.op).c_str(), json_string(x.impl).c_str(),
+                     json_string(x.type).c_str(), json_string(x.dist).c_str(),
+                     x.n, x.bytes, x.samples, x.ns, x.ns_min);
+        // Hardware events per element, where they were counted.
+        const double elements = static_cast<double>(x.calls) *
+                                static_cast<double>(x.n);
+        bool counted = false;
+        for( int e = 0; e < wt::perf_events_n; ++e ) {
+            if( !x.counts.available[e] ) continue;
+            std::fprintf(f, "%s%s: %.6g",
+                         counted ? ", " : ", \"per_element\": {",
+                         json_string(wt::name_of(wt::perf_event(e))).c_str(),
+                         static_cast<double>(x.counts.value[e]) / elements);
+            counted = true;
+        }
+        std::fprintf(f, counted ? "}}" : "}");
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+    std::fclose(f);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        const bench::options opts = parse_options(argc, argv);
+        bench::runner r(opts);
+        run_type<std::int32_t>(r, opts, "int32");
+        run_type<std::uint64_t>(r, opts, "uint64");
+        run_type<double>(r, opts, "double");
+        if( !opts.json.empty() ) write_json(opts.json, r);
+        if( r.failures() != 0 ) {
+            std::printf("%zu mismatches\n", r.failures());
+            return 1;
+        }
+    } catch( const std::exception& e ) {
+        std::fprintf(stderr, "wtl_bench: %s\n", e.what());
+        return 2;
+    }
+    return 0;
+}
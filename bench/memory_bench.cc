@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Cases for the wrappers of memory_iseq.hh
+///////////////////////////////////////////////////////////////////////////////
+
+#include "harness.hh"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <wtl/memory.hh>
+
+namespace {
+
+template<typename T>
+void run(bench::runner& r, const std::vector<T>& in)
+{
+    typedef std::vector<T> V;
+    const std::size_t n = in.size();
+    const T last = in.back();
+
+    // The elements are trivial, so constructing them over the existing
+    // elements of the output vector is well defined.
+    if( r.wants("uninitialized_copy") )
+        bench::compare_output<T>(r, "uninitialized_copy", n,
+            [&](V& out) -> std::size_t {
+                return std::uninitialized_copy(in.begin(), in.end(),
+                                               out.begin()) - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::uninitialized_copy(wt::iseq(in), out.begin()) -
+                       out.begin();
+            });
+    if( r.wants("uninitialized_fill") )
+        bench::compare_output<T>(r, "uninitialized_fill", n,
+            [&](V& out) -> std::size_t {
+                std::uninitialized_fill(out.begin(), out.end(), last);
+                return n;
+            },
+            [&](V& out) -> std::size_t {
+                wt::uninitialized_fill(wt::iseq(out), last);
+                return n;
+            });
+}
+
+} // namespace
+
+namespace bench {
+
+void memory_benchmarks(runner& r, const std::vector<std::int32_t>& in)
+{
+    run(r, in);
+}
+
+void memory_benchmarks(runner& r, const std::vector<std::uint64_t>& in)
+{
+    run(r, in);
+}
+
+void memory_benchmarks(runner& r, const std::vector<double>& in)
+{
+    run(r, in);
+}
+
+} // namespace bench
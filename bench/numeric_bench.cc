@@ -0,0 +1,157 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Cases for the wrappers of numeric_iseq.hh
+///
+/// Signed overflow is undefined, so random int32 inputs are only summed into
+/// a wider unsigned accumulator;  the cases that add or multiply elements
+/// among themselves run on the unsigned and floating-point inputs.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "harness.hh"
+
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+#include <wtl/numeric.hh>
+
+namespace {
+
+template<typename T>
+struct wraps
+    : std::integral_constant<bool, std::is_floating_point<T>::value ||
+                                   std::is_unsigned<T>::value> { };
+
+template<typename T>
+struct accumulator {
+    typedef typename std::conditional<std::is_floating_point<T>::value,
+                                      double, std::uint64_t>::type type;
+};
+
+template<typename T>
+void sums(bench::runner& r, const std::vector<T>& in)
+{
+    typedef typename accumulator<T>::type A;
+
+    if( r.wants("accumulate") )
+        bench::compare(r, "accumulate",
+            [&]() { return std::accumulate(in.begin(), in.end(), A()); },
+            [&]() { return wt::accumulate(wt::iseq(in), A()); });
+    if( r.wants("accumulate_op") )
+        bench::compare(r, "accumulate_op",
+            [&]() { return std::accumulate(in.begin(), in.end(), A(),
+                                           std::plus<A>()); },
+            [&]() { return wt::accumulate(wt::iseq(in), A(),
+                                          std::plus<A>()); });
+}
+
+template<typename T>
+void arithmetic(bench::runner& r, const std::vector<T>& in, std::false_type)
+{
+    (void)r;
+    (void)in;
+}
+
+template<typename T>
+void arithmetic(bench::runner& r, const std::vector<T>& in, std::true_type)
+{
+    typedef std::vector<T> V;
+    const std::size_t n = in.size();
+    const V other(in.rbegin(), in.rend());
+    // Runs of 16 equal keys.
+    std::vector<std::uint32_t> keys(n);
+    for( std::size_t i = 0; i < n; ++i )
+        keys[i] = static_cast<std::uint32_t>(i / 16);
+    std::vector<std::uint32_t> keys_out(n);
+
+    if( r.wants("inner_product") )
+        bench::compare(r, "inner_product",
+            [&]() { return std::inner_product(in.begin(), in.end(),
+                                              other.begin(), T()); },
+            [&]() { return wt::inner_product(wt::iseq(in), other.begin(),
+                                             T()); });
+    if( r.wants("inner_product_unseq") )
+        bench::compare(r, "inner_product_unseq",
+            [&]() { return std::inner_product(in.begin(), in.end(),
+                                              other.begin(), T()); },
+            [&]() { return wt::inner_product(wt::unseq, wt::iseq(in),
+                                             other.begin(), T()); });
+    if( r.wants("partial_sum") )
+        bench::compare_output<T>(r, "partial_sum", n,
+            [&](V& out) -> std::size_t {
+                return std::partial_sum(in.begin(), in.end(), out.begin()) -
+                       out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::partial_sum(wt::iseq(in), out.begin()) -
+                       out.begin();
+            });
+    if( r.wants("adjacent_difference") )
+        bench::compare_output<T>(r, "adjacent_difference", n,
+            [&](V& out) -> std::size_t {
+                return std::adjacent_difference(in.begin(), in.end(),
+                                                out.begin()) - out.begin();
+            },
+            [&](V& out) -> std::size_t {
+                return wt::adjacent_difference(wt::iseq(in), out.begin()) -
+                       out.begin();
+            });
+    if( r.wants("reduce_by_key") )
+        bench::compare_output<T>(r, "reduce_by_key", n,
+            [&](V& out) -> std::size_t {
+                std::size_t runs = 0;
+                for( std::size_t i = 0; i < n; ++runs ) {
+                    T sum = in[i];
+                    std::size_t j = i + 1;
+                    for( ; j < n && keys[j] == keys[i]; ++j ) sum += in[j];
+                    out[runs] = sum;
+                    i = j;
+                }
+                return runs;
+            },
+            [&](V& out) -> std::size_t {
+                return wt::reduce_by_key(wt::iseq(keys), in.begin(),
+                                         keys_out.begin(),
+                                         out.begin()).second - out.begin();
+            });
+    if( r.wants("scan_by_key") )
+        bench::compare_output<T>(r, "scan_by_key", n,
+            [&](V& out) -> std::size_t {
+                for( std::size_t i = 0; i < n; ++i )
+                    out[i] = i != 0 && keys[i] == keys[i - 1]
+                           ? out[i - 1] + in[i] : in[i];
+                return n;
+            },
+            [&](V& out) -> std::size_t {
+                return wt::scan_by_key(wt::iseq(keys), in.begin(),
+                                       out.begin()) - out.begin();
+            });
+}
+
+template<typename T>
+void run(bench::runner& r, const std::vector<T>& in)
+{
+    sums(r, in);
+    arithmetic(r, in, wraps<T>());
+}
+
+} // namespace
+
+namespace bench {
+
+void numeric_benchmarks(runner& r, const std::vector<std::int32_t>& in)
+{
+    run(r, in);
+}
+
+void numeric_benchmarks(runner& r, const std::vector<std::uint64_t>& in)
+{
+    run(r, in);
+}
+
+void numeric_benchmarks(runner& r, const std::vector<double>& in)
+{
+    run(r, in);
+}
+
+} // namespace bench
@@ -0,0 +1,665 @@
+#ifndef CODEC_HH_
+#define CODEC_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Integer compression:  delta and zigzag transforms, varints, Stream VByte,
+/// frame-of-reference bit packing and run-length encoding.  Encoders read any
+/// input sequence and write bytes to an output iterator;  decoders read those
+/// bytes back and write the integers to any output iterator, a block at a
+/// time, so that a decoded sequence need never be held in memory as a whole.
+///
+/// The codecs compose.  Sorted IDs and timestamps compress best as deltas,
+/// which are small:
+///
+///  wt::delta_encode(wt::iseq(ids), deltas.begin());
+///  wt::bitpack_encode(wt::iseq(deltas), std::back_inserter(bytes));
+///
+/// and come back with
+///
+///  wt::bitpack_decode(wt::iseq(bytes), deltas.begin());
+///  wt::delta_decode(wt::iseq(deltas), ids.begin());
+///
+/// Signed values that may be negative should be zigzag-encoded before they
+/// are varint-encoded, so that small negative numbers take few bytes.
+///
+/// Decoders throw std::invalid_argument on truncated or malformed input.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <wtl/iseq.hh>
+#include <wtl/simd.hh>
+#include <wtl/traits.hh>
+
+namespace wt {
+
+/// NOTE that none of the algorithms perform a range check;  the iterators
+/// given are all assumed to be valid.
+
+/// Map a signed integer to an unsigned one so that numbers of small magnitude,
+/// negative or not, map to small numbers:  0, -1, 1, -2, 2 ... map to 0, 1, 2,
+/// 3, 4 ...
+template<typename T>
+typename std::make_unsigned<T>::type zigzag_encode(T v)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    return static_cast<U>(static_cast<U>(static_cast<U>(v) << 1) ^
+                          (v < 0 ? static_cast<U>(~U(0)) : U(0)));
+}
+
+/// Invert zigzag_encode().
+template<typename U>
+typename std::make_signed<U>::type zigzag_decode(U v)
+{
+    typedef typename std::make_signed<U>::type T;
+    return static_cast<T>(static_cast<U>(v >> 1) ^
+                          static_cast<U>(U(0) - static_cast<U>(v & 1)));
+}
+
+/// Zigzag-encode a sequence of signed integers.
+///
+/// \return The end of the output.
+template<typename In, typename Out>
+Out zigzag_encode(In first, In last, Out res)
+{
+    for( ; first != last; ++first ) *res++ = wt::zigzag_encode(*first);
+    return res;
+}
+
+/// Zigzag-decode a sequence of unsigned integers.
+///
+/// \return The end of the output.
+template<typename In, typename Out>
+Out zigzag_decode(In first, In last, Out res)
+{
+    for( ; first != last; ++first ) *res++ = wt::zigzag_decode(*first);
+    return res;
+}
+
+/// Replace each integer of a sequence with its difference from the previous
+/// one, with wrap-around arithmetic;  the first is kept as it is.  This is
+/// adjacent_difference() without the risk of signed overflow.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param res An _output iterator_ receiving the differences.  It may be
+/// first.
+///
+/// \return The end of the output.
+template<typename In, typename Out>
+Out delta_encode(In first, In last, Out res)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    typedef typename std::make_unsigned<T>::type U;
+    U prev = 0;
+    for( ; first != last; ++first ) {
+        const U cur = static_cast<U>(*first);
+        *res++ = static_cast<T>(static_cast<U>(cur - prev));
+        prev = cur;
+    }
+    return res;
+}
+
+namespace detail {
+
+/// Whether the running sums of a range of integers can run on the vector
+/// prefix-sum kernel.
+template<typename In>
+struct is_prefix_summable
+    : std::integral_constant<bool,
+        is_contiguous_iterator<In>::value &&
+        std::is_integral<typename std::iterator_traits<In>::value_type>::value &&
+        (sizeof(typename std::iterator_traits<In>::value_type) == 4 ||
+         sizeof(typename std::iterator_traits<In>::value_type) == 8)> { };
+
+template<typename In, typename Out>
+Out delta_decode(In first, In last, Out res, std::false_type)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    typedef typename std::make_unsigned<T>::type U;
+    U sum = 0;
+    for( ; first != last; ++first ) {
+        sum = static_cast<U>(sum + static_cast<U>(*first));
+        *res++ = static_cast<T>(sum);
+    }
+    return res;
+}
+
+template<typename In, typename Out>
+Out delta_decode(In first, In last, Out res, std::true_type)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    if( first == last ) return res;
+    const T* p = detail::address_of(first);
+    std::size_t n = last - first;
+    T buf[256];
+    T sum = 0;
+    while( n != 0 ) {
+        const std::size_t b = std::min<std::size_t>(n, 256);
+        sum = detail::prefix_sum(p, b, buf, sum);
+        res = std::copy(buf, buf + b, res);
+        p += b;
+        n -= b;
+    }
+    return res;
+}
+
+} // namespace detail
+
+/// Invert delta_encode():  replace each integer of a sequence with the running
+/// sum up to it, with wrap-around arithmetic.  Contiguous 32- and 64-bit
+/// integers are summed a vector at a time.
+///
+/// \param first An _input iterator_ pointing to the first difference.
+///
+/// \param last An _input iterator_ pointing to the last difference.
+///
+/// \param res An _output iterator_ receiving the sums.  It may be first.
+///
+/// \return The end of the output.
+template<typename In, typename Out>
+Out delta_decode(In first, In last, Out res)
+{
+    return detail::delta_decode(first, last, res,
+                                detail::is_prefix_summable<In>());
+}
+
+/// Encode unsigned integers as LEB128 varints:  seven bits per byte, least
+/// significant first, with the high bit set on every byte but the last.
+///
+/// \param first An _input iterator_ pointing to the first integer.
+///
+/// \param last An _input iterator_ pointing to the last integer.
+///
+/// \param res An _output iterator_ receiving the bytes.
+///
+/// \return The end of the output.
+template<typename In, typename Out>
+Out varint_encode(In first, In last, Out res)
+{
+    for( ; first != last; ++first ) {
+        std::uint64_t v = static_cast<std::uint64_t>(*first);
+        for( ; v >= 0x80; v >>= 7 )
+            *res++ = static_cast<std::uint8_t>(v | 0x80);
+        *res++ = static_cast<std::uint8_t>(v);
+    }
+    return res;
+}
+
+/// Decode LEB128 varints.
+///
+/// \param first An _input iterator_ pointing to the first byte.
+///
+/// \param last An _input iterator_ pointing to the last byte.
+///
+/// \param res An _output iterator_ receiving the integers, as std::uint64_t.
+///
+/// \return The end of the output.
+///
+/// \throw std::invalid_argument if the last varint is cut short, or a varint
+/// doesn't fit in 64 bits.
+template<typename In, typename Out>
+Out varint_decode(In first, In last, Out res)
+{
+    std::uint64_t v = 0;
+    unsigned shift = 0;
+    for( ; first != last; ++first ) {
+        const std::uint8_t b = static_cast<std::uint8_t>(*first);
+        // The tenth byte holds bit 63 only.
+        if( shift >= 64 || (shift == 63 && (b & 0x7f) > 1) )
+            throw std::invalid_argument("varint_decode");
+        v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+        if( b & 0x80 ) {
+            shift += 7;
+        } else {
+            *res++ = v;
+            v = 0;
+            shift = 0;
+        }
+    }
+    if( shift != 0 ) throw std::invalid_argument("varint_decode");
+    return res;
+}
+
+/// Encode integers of up to 32 bits in Stream VByte format:  first a control
+/// byte for every four integers, holding two bits per integer for its length
+/// less one, then the integers' bytes, least significant first.
+///
+/// \param first A _forward iterator_ pointing to the first integer.
+///
+/// \param last A _forward iterator_ pointing to the last integer.
+///
+/// \param res An _output iterator_ receiving the bytes.
+///
+/// \return The end of the output.
+template<typename Fwd, typename Out>
+Out stream_vbyte_encode(Fwd first, Fwd last, Out res)
+{
+    unsigned ctrl = 0;
+    unsigned k = 0;
+    for( Fwd i = first; i != last; ++i ) {
+        const std::uint32_t v = static_cast<std::uint32_t>(*i);
+        const unsigned len = v < (1u << 8) ? 0 : v < (1u << 16) ? 1
+                           : v < (1u << 24) ? 2 : 3;
+        ctrl |= len << (2 * k);
+        if( ++k == 4 ) {
+            *res++ = static_cast<std::uint8_t>(ctrl);
+            ctrl = 0;
+            k = 0;
+        }
+    }
+    if( k != 0 ) *res++ = static_cast<std::uint8_t>(ctrl);
+    for( ; first != last; ++first ) {
+        std::uint32_t v = static_cast<std::uint32_t>(*first);
+        do {
+            *res++ = static_cast<std::uint8_t>(v);
+            v >>= 8;
+        } while( v != 0 );
+    }
+    return res;
+}
+
+namespace detail {
+
+template<typename Ran>
+struct is_contiguous_bytes
+    : std::integral_constant<bool,
+        is_contiguous_iterator<Ran>::value &&
+        sizeof(typename std::iterator_traits<Ran>::value_type) == 1> { };
+
+/// The number of control bytes of count integers in Stream VByte format,
+/// checked against the size of the input.
+inline std::size_t stream_vbyte_controls(std::size_t size, std::size_t count)
+{
+    const std::size_t controls = count / 4 + (count % 4 != 0);
+    if( size < controls ) throw std::invalid_argument("stream_vbyte_decode");
+    return controls;
+}
+
+template<typename Ran, typename Out>
+Out stream_vbyte_decode(Ran first, Ran last, std::size_t count, Out res,
+                        std::false_type)
+{
+    const std::size_t size = last - first;
+    std::size_t pos = detail::stream_vbyte_controls(size, count);
+    for( std::size_t i = 0; i < count; ++i ) {
+        const unsigned ctrl = static_cast<std::uint8_t>(first[i / 4]);
+        const unsigned len = ((ctrl >> (2 * (i % 4))) & 3) + 1;
+        if( size - pos < len )
+            throw std::invalid_argument("stream_vbyte_decode");
+        std::uint32_t v = 0;
+        for( unsigned j = 0; j < len; ++j, ++pos )
+            v |= static_cast<std::uint32_t>(
+                     static_cast<std::uint8_t>(first[pos])) << (8 * j);
+        *res++ = v;
+    }
+    return res;
+}
+
+template<typename Ran, typename Out>
+Out stream_vbyte_decode(Ran first, Ran last, std::size_t count, Out res,
+                        std::true_type)
+{
+    if( count == 0 ) return res;
+    const std::size_t size = last - first;
+    const std::size_t controls = detail::stream_vbyte_controls(size, count);
+    const std::uint8_t* ctrl =
+        reinterpret_cast<const std::uint8_t*>(detail::address_of(first));
+    const std::uint8_t* const end = ctrl + size;
+    const std::uint8_t* data = ctrl + controls;
+    std::uint32_t buf[256];
+    std::size_t i = 0;
+    // A group of four is loaded as a whole vector of sixteen bytes, however
+    // long its integers are, so groups are decoded by vector only while
+    // sixteen bytes remain.  The last few are decoded one integer at a time,
+    // each checked against the end.
+    while( i + 4 <= count && end - data >= 16 ) {
+        const std::size_t b = std::min<std::size_t>((count - i) / 4, 64);
+        std::size_t g = 0;
+        for( ; g < b && end - data >= 16; ++g )
+            data = detail::stream_vbyte_decode4(ctrl[i / 4 + g], data,
+                                                buf + 4 * g);
+        res = std::copy(buf, buf + 4 * g, res);
+        i += 4 * g;
+    }
+    for( ; i < count; ++i ) {
+        const unsigned len = ((ctrl[i / 4] >> (2 * (i % 4))) & 3) + 1;
+        if( std::size_t(end - data) < len )
+            throw std::invalid_argument("stream_vbyte_decode");
+        std::uint32_t v = 0;
+        for( unsigned j = 0; j < len; ++j )
+            v |= static_cast<std::uint32_t>(data[j]) << (8 * j);
+        data += len;
+        *res++ = v;
+    }
+    return res;
+}
+
+} // namespace detail
+
+/// Decode integers in Stream VByte format.  Contiguous bytes are decoded four
+/// integers at a time with a vector shuffle.
+///
+/// \param first A _random access iterator_ pointing to the first byte.
+///
+/// \param last A _random access iterator_ pointing to the last byte.
+///
+/// \param count The number of integers encoded.
+///
+/// \param res An _output iterator_ receiving the integers, as std::uint32_t.
+///
+/// \return The end of the output.
+///
+/// \throw std::invalid_argument if the bytes end before the control bytes or
+/// the integers of count integers do.  The integers before the end have then
+/// been written.
+template<typename Ran, typename Out>
+Out stream_vbyte_decode(Ran first, Ran last, std::size_t count, Out res)
+{
+    return detail::stream_vbyte_decode(first, last, count, res,
+                                       detail::is_contiguous_bytes<Ran>());
+}
+
+namespace detail {
+
+/// The number of integers in a frame of bitpack_encode().
+const std::size_t bitpack_frame = 128;
+
+inline unsigned bit_width64(std::uint64_t v)
+{
+    return v == 0 ? 0 : 64 - count_leading_zeros64(v);
+}
+
+template<typename T, typename Out>
+Out bitpack_frame_encode(const T* v, std::size_t n, Out res)
+{
+    const T ref = *std::min_element(v, v + n);
+    const std::uint64_t base = static_cast<std::uint64_t>(ref);
+    std::uint64_t all = 0;
+    for( std::size_t i = 0; i < n; ++i )
+        all |= static_cast<std::uint64_t>(v[i]) - base;
+    const unsigned width = bit_width64(all);
+    *res++ = static_cast<std::uint8_t>(n);
+    *res++ = static_cast<std::uint8_t>(width);
+    res = wt::varint_encode(&base, &base + 1, res);
+    if( width == 0 ) return res;
+    std::uint64_t acc = 0;
+    unsigned fill = 0;
+    for( std::size_t i = 0; i < n; ++i ) {
+        const std::uint64_t d = static_cast<std::uint64_t>(v[i]) - base;
+        acc |= d << fill;
+        if( fill + width < 64 ) {
+            fill += width;
+            continue;
+        }
+        for( unsigned j = 0; j < 8; ++j )
+            *res++ = static_cast<std::uint8_t>(acc >> (8 * j));
+        acc = fill == 0 ? 0 : d >> (64 - fill);
+        fill = fill + width - 64;
+    }
+    for( unsigned j = 0; j < fill; j += 8 )
+        *res++ = static_cast<std::uint8_t>(acc >> j);
+    return res;
+}
+
+/// Unpack n integers of width bits from packed, which is padded with at
+/// least eight readable bytes.
+inline void bitpack_unpack(const std::uint8_t* packed, std::size_t n,
+                           unsigned width, std::uint64_t base,
+                           std::uint64_t* out)
+{
+    if( width == 0 ) {
+        std::fill(out, out + n, base);
+        return;
+    }
+    const std::uint64_t mask = width == 64 ? ~std::uint64_t(0)
+                                           : (std::uint64_t(1) << width) - 1;
+    for( std::size_t i = 0; i < n; ++i ) {
+        const std::size_t bit = i * width;
+        const unsigned shift = bit % 8;
+        std::uint64_t word;
+        std::memcpy(&word, packed + bit / 8, 8);
+        std::uint64_t d = word >> shift;
+        if( shift + width > 64 )
+            d |= static_cast<std::uint64_t>(packed[bit / 8 + 8]) << (64 - shift);
+        out[i] = base + (d & mask);
+    }
+}
+
+} // namespace detail
+
+/// Encode integers with frame-of-reference bit packing.  Each frame of up to
+/// 128 integers is stored as its count, the bit width w of the largest
+/// difference from its minimum, the minimum as a varint, and each integer's
+/// difference from the minimum in w bits.  Sorted integers should be
+/// delta-encoded first, so the frames hold small differences.
+///
+/// \param first An _input iterator_ pointing to the first integer.
+///
+/// \param last An _input iterator_ pointing to the last integer.
+///
+/// \param res An _output iterator_ receiving the bytes.
+///
+/// \return The end of the output.
+template<typename In, typename Out>
+Out bitpack_encode(In first, In last, Out res)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    T frame[detail::bitpack_frame];
+    std::size_t n = 0;
+    for( ; first != last; ++first ) {
+        frame[n++] = *first;
+        if( n == detail::bitpack_frame ) {
+            res = detail::bitpack_frame_encode(frame, n, res);
+            n = 0;
+        }
+    }
+    if( n != 0 ) res = detail::bitpack_frame_encode(frame, n, res);
+    return res;
+}
+
+namespace detail {
+
+/// Read a byte of bitpack_encode() output.
+template<typename In>
+std::uint8_t bitpack_byte(In& first, In last)
+{
+    if( first == last ) throw std::invalid_argument("bitpack_decode");
+    const std::uint8_t b = static_cast<std::uint8_t>(*first);
+    ++first;
+    return b;
+}
+
+/// Read the header of a frame:  its count, bit width and minimum.
+template<typename In>
+void bitpack_header(In& first, In last,
+                    std::size_t& n, unsigned& width, std::uint64_t& base)
+{
+    n = detail::bitpack_byte(first, last);
+    width = detail::bitpack_byte(first, last);
+    if( n == 0 || n > bitpack_frame || width > 64 )
+        throw std::invalid_argument("bitpack_decode");
+    base = 0;
+    for( unsigned shift = 0; ; shift += 7 ) {
+        const std::uint8_t b = detail::bitpack_byte(first, last);
+        if( shift >= 64 || (shift == 63 && (b & 0x7f) > 1) )
+            throw std::invalid_argument("bitpack_decode");
+        base |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+        if( !(b & 0x80) ) break;
+    }
+}
+
+template<typename In, typename Out>
+Out bitpack_decode(In first, In last, Out res, std::false_type)
+{
+    std::uint8_t packed[bitpack_frame * 8 + 9];
+    std::uint64_t frame[bitpack_frame];
+    while( first != last ) {
+        std::size_t n;
+        unsigned width;
+        std::uint64_t base;
+        detail::bitpack_header(first, last, n, width, base);
+        const std::size_t bytes = (n * width + 7) / 8;
+        for( std::size_t i = 0; i < bytes; ++i )
+            packed[i] = detail::bitpack_byte(first, last);
+        std::memset(packed + bytes, 0, 9);
+        detail::bitpack_unpack(packed, n, width, base, frame);
+        res = std::copy(frame, frame + n, res);
+    }
+    return res;
+}
+
+template<typename Ran, typename Out>
+Out bitpack_decode(Ran first, Ran last, Out res, std::true_type)
+{
+    if( first == last ) return res;
+    const std::uint8_t* p =
+        reinterpret_cast<const std::uint8_t*>(detail::address_of(first));
+    const std::uint8_t* const end = p + (last - first);
+    std::uint8_t packed[bitpack_frame * 8 + 9];
+    std::uint64_t frame[bitpack_frame];
+    while( p != end ) {
+        std::size_t n;
+        unsigned width;
+        std::uint64_t base;
+        detail::bitpack_header(p, end, n, width, base);
+        const std::size_t bytes = (n * width + 7) / 8;
+        if( std::size_t(end - p) < bytes )
+            throw std::invalid_argument("bitpack_decode");
+        // Unpacking reads up to nine bytes past a frame;  copy out the last
+        // frames, whose padding would lie past the end of the input.
+        if( std::size_t(end - p) >= bytes + 9 ) {
+            detail::bitpack_unpack(p, n, width, base, frame);
+        } else {
+            std::memcpy(packed, p, bytes);
+            std::memset(packed + bytes, 0, 9);
+            detail::bitpack_unpack(packed, n, width, base, frame);
+        }
+        p += bytes;
+        res = std::copy(frame, frame + n, res);
+    }
+    return res;
+}
+
+} // namespace detail
+
+/// Decode integers encoded with bitpack_encode(), a frame at a time.
+///
+/// \param first An _input iterator_ pointing to the first byte.
+///
+/// \param last An _input iterator_ pointing to the last byte.
+///
+/// \param res An _output iterator_ receiving the integers, as std::uint64_t.
+/// Assigning them to the type they were encoded from restores their values,
+/// negative ones included.
+///
+/// \return The end of the output.
+template<typename In, typename Out>
+Out bitpack_decode(In first, In last, Out res)
+{
+    return detail::bitpack_decode(first, last, res,
+                                  detail::is_contiguous_bytes<In>());
+}
+
+namespace detail {
+
+template<typename In, typename Out1, typename Out2>
+std::pair<Out1,Out2> run_length_encode(In first, In last,
+                                       Out1 values, Out2 lengths,
+                                       std::false_type)
+{
+    while( first != last ) {
+        typename std::iterator_traits<In>::value_type v = *first;
+        std::size_t n = 1;
+        for( ++first; first != last && *first == v; ++first ) ++n;
+        *values++ = v;
+        *lengths++ = n;
+    }
+    return std::make_pair(values, lengths);
+}
+
+template<typename In, typename Out1, typename Out2>
+std::pair<Out1,Out2> run_length_encode(In first, In last,
+                                       Out1 values, Out2 lengths,
+                                       std::true_type)
+{
+    if( first == last ) return std::make_pair(values, lengths);
+    const std::size_t n = last - first;
+    const typename std::iterator_traits<In>::value_type* p =
+        detail::address_of(first);
+    for( std::size_t i = 0; i < n; ) {
+        // The run ends where an element first differs from its successor.
+        const std::size_t len =
+            detail::find_equality(p + i, p + i + 1, n - i - 1, false) + 1;
+        *values++ = p[i];
+        *lengths++ = len;
+        i += len;
+    }
+    return std::make_pair(values, lengths);
+}
+
+} // namespace detail
+
+/// Run-length encode a sequence:  write each run of equal consecutive
+/// elements as the element and the length of the run.  Runs in contiguous
+/// arithmetic ranges are found with a vectorized scan.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param values An _output iterator_ receiving an element of each run.
+///
+/// \param lengths An _output iterator_ receiving the length of each run, as
+/// std::size_t.
+///
+/// \return The ends of the two outputs.
+template<typename In, typename Out1, typename Out2>
+std::pair<Out1,Out2> run_length_encode(In first, In last,
+                                       Out1 values, Out2 lengths)
+{
+    return detail::run_length_encode(first, last, values, lengths,
+                                     detail::is_contiguous_arithmetic<In>());
+}
+
+/// Invert run_length_encode():  write each value as many times as its run
+/// length says.
+///
+/// \param first An _input iterator_ pointing to the first value.
+///
+/// \param last An _input iterator_ pointing to the last value.
+///
+/// \param lengths An _input iterator_ pointing to the first run length.
+///
+/// \param res An _output iterator_ receiving the expanded sequence.
+///
+/// \return The end of the output.
+template<typename In1, typename In2, typename Out>
+Out run_length_decode(In1 first, In1 last, In2 lengths, Out res)
+{
+    for( ; first != last; ++first, ++lengths )
+        res = std::fill_n(res, *lengths, *first);
+    return res;
+}
+
+} // namespace wt
+
+#include <wtl/codec_iseq.hh>
+
+#endif // CODEC_HH_
@@ -0,0 +1,100 @@
+#ifndef CODEC_ISEQ_HH_
+#define CODEC_ISEQ_HH_
+
+#include <cstddef>
+#include <utility>
+#include <wtl/iseq.hh>
+#include <wtl/codec.hh>
+
+namespace wt {
+
+template<typename In, typename Out>
+Out zigzag_encode(input_sequence_range<In> range, Out res)
+{
+    WT_TRACE_ISEQ("zigzag_encode", range);
+    return wt::zigzag_encode(range.first, range.second, res);
+}
+
+template<typename In, typename Out>
+Out zigzag_decode(input_sequence_range<In> range, Out res)
+{
+    WT_TRACE_ISEQ("zigzag_decode", range);
+    return wt::zigzag_decode(range.first, range.second, res);
+}
+
+template<typename In, typename Out>
+Out delta_encode(input_sequence_range<In> range, Out res)
+{
+    WT_TRACE_ISEQ("delta_encode", range);
+    return wt::delta_encode(range.first, range.second, res);
+}
+
+template<typename In, typename Out>
+Out delta_decode(input_sequence_range<In> range, Out res)
+{
+    WT_TRACE_ISEQ("delta_decode", range);
+    return wt::delta_decode(range.first, range.second, res);
+}
+
+template<typename In, typename Out>
+Out varint_encode(input_sequence_range<In> range, Out res)
+{
+    WT_TRACE_ISEQ("varint_encode", range);
+    return wt::varint_encode(range.first, range.second, res);
+}
+
+template<typename In, typename Out>
+Out varint_decode(input_sequence_range<In> range, Out res)
+{
+    WT_TRACE_ISEQ("varint_decode", range);
+    return wt::varint_decode(range.first, range.second, res);
+}
+
+template<typename Fwd, typename Out>
+Out stream_vbyte_encode(input_sequence_range<Fwd> range, Out res)
+{
+    WT_TRACE_ISEQ("stream_vbyte_encode", range);
+    return wt::stream_vbyte_encode(range.first, range.second, res);
+}
+
+template<typename Ran, typename Out>
+Out stream_vbyte_decode(input_sequence_range<Ran> range,
+                        std::size_t count,
+                        Out res)
+{
+    WT_TRACE_ISEQ("stream_vbyte_decode", range);
+    return wt::stream_vbyte_decode(range.first, range.second, count, res);
+}
+
+template<typename In, typename Out>
+Out bitpack_encode(input_sequence_range<In> range, Out res)
+{
+    WT_TRACE_ISEQ("bitpack_encode", range);
+    return wt::bitpack_encode(range.first, range.second, res);
+}
+
+template<typename In, typename Out>
+Out bitpack_decode(input_sequence_range<In> range, Out res)
+{
+    WT_TRACE_ISEQ("bitpack_decode", range);
+    return wt::bitpack_decode(range.first, range.second, res);
+}
+
+template<typename In, typename Out1, typename Out2>
+std::pair<Out1,Out2> run_length_encode(input_sequence_range<In> range,
+                                       Out1 values, Out2 lengths)
+{
+    WT_TRACE_ISEQ("run_length_encode", range);
+    return wt::run_length_encode(range.first, range.second, values, lengths);
+}
+
+template<typename In1, typename In2, typename Out>
+Out run_length_decode(input_sequence_range<In1> range, In2 lengths, Out res)
+{
+    WT_TRACE_ISEQ("run_length_decode", range);
+    return wt::run_length_decode(range.first, range.second, lengths, res);
+}
+
+} // namespace wt
+
+#endif // CODEC_ISEQ_HH_
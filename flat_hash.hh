@@ -0,0 +1,343 @@
+#ifndef FLAT_HASH_HH_
+#define FLAT_HASH_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Open-addressing hash set and map in the style of Swiss tables.  Each slot
+/// of the table has a control byte holding seven bits of the element's hash,
+/// or a marker for an empty slot;  a lookup compares sixteen control bytes at
+/// once and only touches the elements whose bits match.  The elements
+/// themselves live in a dense array in insertion order, which the table
+/// indexes, so iteration visits elements in the order they were first
+/// inserted and walks contiguous memory.
+///
+/// The containers are insert-only:  there is no erase().  They back the
+/// distinct(), count_distinct() and count_by() algorithms, and are handy
+/// wherever a set or a tally is built once and then read.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <wtl/simd.hh>
+
+namespace wt {
+namespace detail {
+
+/// Scramble the bits of a hash value, so that identity hashes such as
+/// std::hash<int> spread over both the group index and the control byte.
+inline std::uint64_t hash_mix(std::uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template<typename K>
+struct identity_key {
+    typedef K key_type;
+    const K& operator()(const K& k) const { return k; }
+};
+
+template<typename P>
+struct first_key {
+    typedef typename std::remove_const<typename P::first_type>::type key_type;
+    const key_type& operator()(const P& p) const { return p.first; }
+};
+
+/// The table shared by flat_hash_set and flat_hash_map.  Entries are stored
+/// in insertion order in a vector;  the table maps keys to their positions in
+/// that vector.
+template<typename Entry, typename KeyOf, typename Hash, typename Eq>
+class flat_hash_table {
+public:
+    typedef typename KeyOf::key_type key_type;
+    typedef Entry value_type;
+    typedef Hash hasher;
+    typedef Eq key_equal;
+    typedef std::size_t size_type;
+    typedef typename std::vector<Entry>::iterator iterator;
+    typedef typename std::vector<Entry>::const_iterator const_iterator;
+
+    static const size_type npos = size_type(-1);
+
+    flat_hash_table(size_type expected, const Hash& h, const Eq& e)
+        : hash_(h), eq_(e), group_mask_(0)
+    {
+        reserve(expected);
+    }
+
+    iterator begin() { return entries_.begin(); }
+    iterator end() { return entries_.end(); }
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+
+    size_type size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    /// The number of elements the table can hold before it grows.
+    size_type capacity() const { return ctrl_.size() / 8 * 7; }
+
+    /// Make room for n elements without further growth.
+    void reserve(size_type n)
+    {
+        entries_.reserve(n);
+        if( n > capacity() ) rehash(slots_for(n));
+    }
+
+    void clear()
+    {
+        entries_.clear();
+        ctrl_.assign(ctrl_.size(), empty_ctrl);
+    }
+
+    /// The position of the entry with key k, or npos.
+    size_type find_index(const key_type& k) const
+    {
+        return ctrl_.empty() ? npos : find_index(k, hash_mix(hash_(k)));
+    }
+
+    /// The position of the entry with key k, inserting make() at the end if
+    /// there is no such entry;  and whether it was inserted.
+    template<typename Make>
+    std::pair<size_type,bool> find_or_insert(const key_type& k, Make make)
+    {
+        const std::uint64_t h = hash_mix(hash_(k));
+        if( !ctrl_.empty() ) {
+            const size_type i = find_index(k, h);
+            if( i != npos ) return std::make_pair(i, false);
+        }
+        if( entries_.size() >= capacity() ) {
+            if( entries_.size() >= std::numeric_limits<std::uint32_t>::max() )
+                throw std::length_error("flat_hash_table");
+            rehash(slots_for(entries_.size() + 1) * 2);
+        }
+        entries_.push_back(make());
+        place(h, entries_.size() - 1);
+        return std::make_pair(entries_.size() - 1, true);
+    }
+
+    hasher hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+
+protected:
+    std::vector<Entry> entries_;
+
+private:
+    static const std::int8_t empty_ctrl = -128;
+    static const size_type group = 16;
+
+    /// The smallest power-of-two table size, at least one group, that holds
+    /// n elements at a load factor of at most 7/8.
+    static size_type slots_for(size_type n)
+    {
+        size_type slots = group;
+        while( slots / 8 * 7 < n ) slots *= 2;
+        return slots;
+    }
+
+    size_type find_index(const key_type& k, std::uint64_t h) const
+    {
+        const std::int8_t tag = static_cast<std::int8_t>(h & 0x7f);
+        size_type g = static_cast<size_type>(h >> 7) & group_mask_;
+        for( size_type step = 1; ; g = (g + step++) & group_mask_ ) {
+            const std::int8_t* c = &ctrl_[g * group];
+            for( unsigned m = match_byte16(c, tag); m != 0; m &= m - 1 ) {
+                const std::uint32_t e = slots_[g * group +
+                                               count_trailing_zeros64(m)];
+                if( eq_(KeyOf()(entries_[e]), k) ) return e;
+            }
+            if( match_empty16(c) != 0 ) return npos;
+        }
+    }
+
+    /// Claim the first empty slot on the probe sequence of h for entry e.
+    void place(std::uint64_t h, size_type e)
+    {
+        size_type g = static_cast<size_type>(h >> 7) & group_mask_;
+        for( size_type step = 1; ; g = (g + step++) & group_mask_ ) {
+            const unsigned m = match_empty16(&ctrl_[g * group]);
+            if( m != 0 ) {
+                const size_type s = g * group + count_trailing_zeros64(m);
+                ctrl_[s] = static_cast<std::int8_t>(h & 0x7f);
+                slots_[s] = static_cast<std::uint32_t>(e);
+                return;
+            }
+        }
+    }
+
+    void rehash(size_type slots)
+    {
+        std::vector<std::int8_t> ctrl(slots, empty_ctrl);
+        std::vector<std::uint32_t> index(slots);
+        ctrl_.swap(ctrl);
+        slots_.swap(index);
+        group_mask_ = slots / group - 1;
+        for( size_type e = 0; e < entries_.size(); ++e )
+            place(hash_mix(hash_(KeyOf()(entries_[e]))), e);
+    }
+
+    Hash hash_;
+    Eq eq_;
+    std::vector<std::int8_t> ctrl_;
+    std::vector<std::uint32_t> slots_;
+    size_type group_mask_;
+};
+
+template<typename Entry, typename KeyOf, typename Hash, typename Eq>
+const typename flat_hash_table<Entry,KeyOf,Hash,Eq>::size_type
+flat_hash_table<Entry,KeyOf,Hash,Eq>::npos;
+
+template<typename Entry, typename KeyOf, typename Hash, typename Eq>
+const std::int8_t flat_hash_table<Entry,KeyOf,Hash,Eq>::empty_ctrl;
+
+template<typename Entry, typename KeyOf, typename Hash, typename Eq>
+const typename flat_hash_table<Entry,KeyOf,Hash,Eq>::size_type
+flat_hash_table<Entry,KeyOf,Hash,Eq>::group;
+
+} // namespace detail
+
+/// Insert-only hash set that iterates in insertion order.
+///
+/// \see flat_hash.hh
+template<typename K,
+         typename Hash = std::hash<K>,
+         typename Eq = std::equal_to<K> >
+class flat_hash_set
+    : public detail::flat_hash_table<K, detail::identity_key<K>, Hash, Eq> {
+    typedef detail::flat_hash_table<K, detail::identity_key<K>, Hash, Eq> base;
+public:
+    typedef K key_type;
+    typedef typename base::size_type size_type;
+    typedef typename base::const_iterator iterator;
+    typedef typename base::const_iterator const_iterator;
+
+    /// \param expected The number of elements expected to be inserted.  The
+    /// set won't rehash until it holds more than that.
+    explicit flat_hash_set(size_type expected = 0,
+                           const Hash& h = Hash(),
+                           const Eq& e = Eq())
+        : base(expected, h, e)
+    {
+    }
+
+    template<typename In>
+    flat_hash_set(In first, In last, size_type expected = 0,
+                  const Hash& h = Hash(), const Eq& e = Eq())
+        : base(expected, h, e)
+    {
+        insert(first, last);
+    }
+
+    const_iterator begin() const { return this->entries_.begin(); }
+    const_iterator end() const { return this->entries_.end(); }
+
+    /// Insert k unless the set already holds it.
+    ///
+    /// \return The position of k, and whether it was inserted.
+    std::pair<const_iterator,bool> insert(const K& k)
+    {
+        const std::pair<size_type,bool> r =
+            this->find_or_insert(k, [&k]() -> const K& { return k; });
+        return std::make_pair(begin() + r.first, r.second);
+    }
+
+    template<typename In>
+    void insert(In first, In last)
+    {
+        for( ; first != last; ++first ) insert(*first);
+    }
+
+    const_iterator find(const K& k) const
+    {
+        const size_type i = this->find_index(k);
+        return i == base::npos ? end() : begin() + i;
+    }
+
+    size_type count(const K& k) const
+    {
+        return this->find_index(k) == base::npos ? 0 : 1;
+    }
+};
+
+/// Insert-only hash map that iterates in insertion order.
+///
+/// \see flat_hash.hh
+template<typename K,
+         typename V,
+         typename Hash = std::hash<K>,
+         typename Eq = std::equal_to<K> >
+class flat_hash_map
+    : public detail::flat_hash_table<std::pair<const K,V>,
+                                     detail::first_key<std::pair<const K,V> >,
+                                     Hash, Eq> {
+    typedef detail::flat_hash_table<std::pair<const K,V>,
+                                    detail::first_key<std::pair<const K,V> >,
+                                    Hash, Eq> base;
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<const K,V> value_type;
+    typedef typename base::size_type size_type;
+    typedef typename base::iterator iterator;
+    typedef typename base::const_iterator const_iterator;
+
+    /// \param expected The number of keys expected to be inserted.  The map
+    /// won't rehash until it holds more than that.
+    explicit flat_hash_map(size_type expected = 0,
+                           const Hash& h = Hash(),
+                           const Eq& e = Eq())
+        : base(expected, h, e)
+    {
+    }
+
+    /// Insert v unless the map already holds its key.
+    ///
+    /// \return The position of v's key, and whether v was inserted.
+    std::pair<iterator,bool> insert(const value_type& v)
+    {
+        const std::pair<size_type,bool> r =
+            this->find_or_insert(v.first, [&v]() -> const value_type& {
+                return v;
+            });
+        return std::make_pair(this->begin() + r.first, r.second);
+    }
+
+    /// The value mapped to k, value-initialized first if k is new.
+    V& operator[](const K& k)
+    {
+        const std::pair<size_type,bool> r =
+            this->find_or_insert(k, [&k]() { return value_type(k, V()); });
+        return this->entries_[r.first].second;
+    }
+
+    iterator find(const K& k)
+    {
+        const size_type i = this->find_index(k);
+        return i == base::npos ? this->end() : this->begin() + i;
+    }
+
+    const_iterator find(const K& k) const
+    {
+        const size_type i = this->find_index(k);
+        return i == base::npos ? this->end() : this->begin() + i;
+    }
+
+    size_type count(const K& k) const
+    {
+        return this->find_index(k) == base::npos ? 0 : 1;
+    }
+};
+
+} // namespace wt
+
+#endif // FLAT_HASH_HH_
@@ -0,0 +1,208 @@
+#ifndef GENERATOR_HH_
+#define GENERATOR_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// A lazy sequence computed by a C++20 coroutine.  The coroutine co_yields
+/// its values one at a time;  the generator's iterators are _input
+/// iterators_ over them, so a generator goes wherever an input sequence
+/// does, and iseq() makes it a range for the iseq wrappers:
+///
+///  wt::generator<int> naturals()
+///  {
+///      for( int i = 0; ; ++i ) co_yield i;
+///  }
+///
+///  auto g = naturals();
+///  auto it = wt::find_if(wt::iseq(g), is_prime);
+///
+/// The coroutine runs only as far as the algorithm reads, so that infinite
+/// generators are fine with algorithms that stop early.  The header is
+/// empty before C++20.
+///////////////////////////////////////////////////////////////////////////////
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <wtl/iseq.hh>
+
+namespace wt {
+
+/// A sequence of the values of type T a coroutine co_yields.
+///
+/// The generator owns its coroutine.  It is a single-pass sequence:  begin()
+/// starts the coroutine, and advancing any iterator resumes it, so all
+/// iterators share one position.  An exception escaping the coroutine is
+/// rethrown from the begin() or increment that resumed it.
+template<typename T>
+class generator {
+public:
+    typedef std::remove_cvref_t<T> value_type;
+
+    class promise_type;
+
+private:
+    typedef std::coroutine_handle<promise_type> handle;
+
+public:
+    class promise_type {
+    public:
+        generator get_return_object()
+        {
+            return generator(handle::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // The yielded value lives in the coroutine frame, a temporary
+        // included, until the coroutine resumes.
+        std::suspend_always yield_value(const value_type& v) noexcept
+        {
+            value_ = std::addressof(v);
+            return {};
+        }
+
+        void return_void() noexcept { }
+
+        void unhandled_exception() { error_ = std::current_exception(); }
+
+        // Generators only co_yield.
+        template<typename U>
+        std::suspend_never await_transform(U&&) = delete;
+
+    private:
+        friend class generator;
+
+        const value_type* value_ = nullptr;
+        std::exception_ptr error_;
+    };
+
+    /// An _input iterator_ over the values;  the default-constructed
+    /// iterator is the end.  it++ returns a proxy holding the value it was
+    /// at, so *it++ reads that value.
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef typename generator::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef const value_type& reference;
+
+        iterator() = default;
+
+        reference operator*() const { return *h_.promise().value_; }
+        pointer operator->() const { return h_.promise().value_; }
+
+        iterator& operator++()
+        {
+            generator::resume(h_);
+            return *this;
+        }
+
+        /// The value an iterator was at before a postfix increment,
+        /// copied out of the coroutine frame the increment resumes.
+        class proxy {
+        public:
+            reference operator*() const { return v_; }
+            pointer operator->() const { return std::addressof(v_); }
+
+        private:
+            friend class iterator;
+
+            explicit proxy(const value_type& v) : v_(v) { }
+
+            value_type v_;
+        };
+
+        proxy operator++(int)
+        {
+            proxy old(**this);
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b)
+        {
+            return a.done() == b.done();
+        }
+
+        friend bool operator!=(const iterator& a, const iterator& b)
+        {
+            return !(a == b);
+        }
+
+    private:
+        friend class generator;
+
+        explicit iterator(handle h) : h_(h) { }
+
+        bool done() const { return !h_ || h_.done(); }
+
+        handle h_;
+    };
+
+    typedef iterator const_iterator;
+
+    generator() = default;
+
+    generator(generator&& other) noexcept
+        : h_(std::exchange(other.h_, nullptr)), started_(other.started_)
+    {
+    }
+
+    generator& operator=(generator&& other) noexcept
+    {
+        if( this != &other ) {
+            if( h_ ) h_.destroy();
+            h_ = std::exchange(other.h_, nullptr);
+            started_ = other.started_;
+        }
+        return *this;
+    }
+
+    ~generator()
+    {
+        if( h_ ) h_.destroy();
+    }
+
+    /// Start the coroutine, if it hasn't started, and return an iterator at
+    /// its first value.  Later calls return an iterator at the current
+    /// value.
+    iterator begin() const
+    {
+        if( h_ && !started_ ) {
+            started_ = true;
+            resume(h_);
+        }
+        return iterator(h_);
+    }
+
+    iterator end() const { return iterator(); }
+
+private:
+    explicit generator(handle h) : h_(h) { }
+
+    static void resume(handle h)
+    {
+        h.resume();
+        if( h.done() && h.promise().error_ )
+            std::rethrow_exception(std::exchange(h.promise().error_, nullptr));
+    }
+
+    handle h_ = nullptr;
+    mutable bool started_ = false;
+};
+
+} // namespace wt
+
+#endif
+
+#endif // GENERATOR_HH_
@@ -0,0 +1,787 @@
+#ifndef HEAP_HH_
+#define HEAP_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Heaps for large priority queues.  A binary heap of n elements takes
+/// log2(n) levels to sift through, and below the top few levels each is a
+/// cache miss.  A d-ary heap, each node with D children, is log2(D) times
+/// shallower;  finding the best of D children costs more comparisons, but
+/// when the children share a cache line those are cheap next to the misses
+/// saved.  With the children of node i at D * i + 1 to D * i + D, the groups
+/// of children fall on cache-line boundaries when the element after the root
+/// does, which priority_queue arranges for its storage.
+///
+/// make_heap() builds a binary heap that std::push_heap(), std::pop_heap()
+/// and std::sort_heap() accept.  It breaks ties between children the other
+/// way from libstdc++, so with equal keys the heap may differ from the one
+/// std::make_heap() builds.  It sifts down from the last parent to the root
+/// as Floyd's method does, but finishes subtrees that fit in the cache one
+/// at a time rather than a level at a time, so that the sifts of the upper
+/// levels of a large heap find their subtrees still cached.
+///
+/// priority_queue is a d-ary heap with bulk push() and pop().
+/// indexed_priority_queue adds priority updates of elements by an integer
+/// id, the decrease-key of Dijkstra's and Prim's algorithms and of
+/// schedulers.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <utility>
+#include <vector>
+#include <wtl/iseq.hh>
+#include <wtl/simd.hh>
+#include <wtl/traits.hh>
+
+namespace wt {
+namespace detail {
+
+/// Bytes of the subtrees make_heap() builds one at a time:  well inside a
+/// private L2 cache, and tuned on one.
+const std::size_t heap_block_bytes = std::size_t(1) << 16;
+
+/// A heap placement observer that does nothing.
+struct ignore_placement {
+    template<typename Diff>
+    void operator()(Diff) const { }
+};
+
+/// b if cond, else a, computed with a mask rather than a branch:  which child
+/// of a heap node wins a comparison is unpredictable.
+template<typename Diff>
+Diff select_if(bool cond, Diff b, Diff a)
+{
+    return a ^ ((a ^ b) & -Diff(cond));
+}
+
+/// The best of the children [child, end) of a node.
+template<typename Ran, typename Cmp>
+typename std::iterator_traits<Ran>::difference_type
+best_child(Ran first, typename std::iterator_traits<Ran>::difference_type child,
+           typename std::iterator_traits<Ran>::difference_type end, Cmp& c)
+{
+    typedef typename std::iterator_traits<Ran>::difference_type diff_t;
+    diff_t best = child;
+    for( diff_t j = child + 1; j < end; ++j )
+        best = detail::select_if(c(first[best], first[j]), j, best);
+    return best;
+}
+
+/// The best of K elements, by a tournament of pairs when K is even, so
+/// that the comparisons of a round are independent of each other.
+template<std::size_t K, bool Even = K % 2 == 0>
+struct best_of {
+    template<typename Ran, typename Cmp>
+    static typename std::iterator_traits<Ran>::difference_type
+    find(Ran first, typename std::iterator_traits<Ran>::difference_type i,
+         Cmp& c)
+    {
+        typedef typename std::iterator_traits<Ran>::difference_type diff_t;
+        const diff_t a = best_of<K / 2>::find(first, i, c);
+        const diff_t b = best_of<K / 2>::find(first, i + diff_t(K / 2), c);
+        return detail::select_if(c(first[a], first[b]), b, a);
+    }
+};
+
+template<std::size_t K>
+struct best_of<K, false> {
+    template<typename Ran, typename Cmp>
+    static typename std::iterator_traits<Ran>::difference_type
+    find(Ran first, typename std::iterator_traits<Ran>::difference_type i,
+         Cmp& c)
+    {
+        return detail::best_child(first, i, i + K, c);
+    }
+};
+
+template<>
+struct best_of<1, false> {
+    template<typename Ran, typename Cmp>
+    static typename std::iterator_traits<Ran>::difference_type
+    find(Ran, typename std::iterator_traits<Ran>::difference_type i, Cmp&)
+    {
+        return i;
+    }
+};
+
+/// The best of the D children from child on.
+template<std::size_t D, typename Ran, typename Cmp>
+typename std::iterator_traits<Ran>::difference_type
+best_child(Ran first, typename std::iterator_traits<Ran>::difference_type child,
+           Cmp& c)
+{
+    return best_of<D>::find(first, child, c);
+}
+
+/// Prefetch the elements [lo, hi) of the heap at first, on contiguous
+/// storage:  the grandchildren of a node, one group of which the next level
+/// of a sift down reads.  Which group is known only once the children are
+/// compared, and fetching all of them, D cache lines when D children fill
+/// one, keeps a sift through a heap larger than the cache from waiting on
+/// memory at every level.
+template<typename Ran>
+void prefetch_heap(Ran first,
+                   typename std::iterator_traits<Ran>::difference_type lo,
+                   typename std::iterator_traits<Ran>::difference_type hi,
+                   std::true_type)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    const char* const p = reinterpret_cast<const char*>(&*first);
+    for( std::size_t at = lo * sizeof(value_t); at < hi * sizeof(value_t);
+         at += 64 )
+        prefetch_read(p + at);
+}
+
+template<typename Ran>
+void prefetch_heap(Ran, typename std::iterator_traits<Ran>::difference_type,
+                   typename std::iterator_traits<Ran>::difference_type,
+                   std::false_type)
+{
+}
+
+/// Sift val down the D-ary heap of n elements at first from hole.  placed()
+/// is called with every position an element is moved to.
+template<std::size_t D, typename Ran, typename Cmp, typename Placed>
+void sift_down(Ran first, typename std::iterator_traits<Ran>::difference_type n,
+               typename std::iterator_traits<Ran>::difference_type hole,
+               typename std::iterator_traits<Ran>::value_type val,
+               Cmp& c, Placed& placed)
+{
+    typedef typename std::iterator_traits<Ran>::difference_type diff_t;
+    const diff_t d = D;
+    for( diff_t child = d * hole + 1; child < n; child = d * hole + 1 ) {
+        const diff_t best = child + d <= n
+            ? detail::best_child<D>(first, child, c)
+            : detail::best_child(first, child, n, c);
+        if( !c(val, first[best]) ) break;
+        first[hole] = std::move(first[best]);
+        placed(hole);
+        hole = best;
+    }
+    first[hole] = std::move(val);
+    placed(hole);
+}
+
+/// Sift val up the D-ary heap at first from hole.
+template<std::size_t D, typename Ran, typename Cmp, typename Placed>
+void sift_up(Ran first, typename std::iterator_traits<Ran>::difference_type hole,
+             typename std::iterator_traits<Ran>::value_type val,
+             Cmp& c, Placed& placed)
+{
+    typedef typename std::iterator_traits<Ran>::difference_type diff_t;
+    const diff_t d = D;
+    while( hole > 0 ) {
+        const diff_t parent = (hole - 1) / d;
+        if( !c(first[parent], val) ) break;
+        first[hole] = std::move(first[parent]);
+        placed(hole);
+        hole = parent;
+    }
+    first[hole] = std::move(val);
+    placed(hole);
+}
+
+/// Move the top of the D-ary heap of n elements at first to its last
+/// position and restore the heap on the other n - 1.
+///
+/// The hole the top leaves is walked down to a leaf along the best children
+/// and the last element sifted up from there, as in Wegener's bottom-up
+/// heapsort:  the last element nearly always belongs near the bottom, so
+/// this saves comparing it on every level on the way down.
+template<std::size_t D, typename Ran, typename Cmp, typename Placed>
+void pop_top(Ran first, typename std::iterator_traits<Ran>::difference_type n,
+             Cmp& c, Placed& placed)
+{
+    typedef typename std::iterator_traits<Ran>::difference_type diff_t;
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    const diff_t d = D;
+    const diff_t m = n - 1;
+    if( m == 0 ) {
+        placed(0);
+        return;
+    }
+    value_t val(std::move(first[m]));
+    first[m] = std::move(first[0]);
+    placed(m);
+    diff_t hole = 0;
+    for( diff_t child = 1; child < m; child = d * hole + 1 ) {
+        if( d * child + 1 < m )
+            detail::prefetch_heap(first, d * child + 1,
+                                  std::min(d * (child + d) + 1, m),
+                                  is_contiguous_iterator<Ran>());
+        const diff_t best = child + d <= m
+            ? detail::best_child<D>(first, child, c)
+            : detail::best_child(first, child, m, c);
+        first[hole] = std::move(first[best]);
+        placed(hole);
+        hole = best;
+    }
+    detail::sift_up<D>(first, hole, std::move(val), c, placed);
+}
+
+/// Restore the D-ary heap property on the subtrees of the nodes [lo, hi]
+/// of the heap of n elements at first and of all their ancestors, after
+/// those nodes changed.  The nodes and their ancestors are sifted down a
+/// level at a time, bottom up;  every level's range of ancestors is
+/// contiguous.
+template<std::size_t D, typename Ran, typename Cmp, typename Placed>
+void heapify_ancestors(Ran first,
+                       typename std::iterator_traits<Ran>::difference_type n,
+                       typename std::iterator_traits<Ran>::difference_type lo,
+                       typename std::iterator_traits<Ran>::difference_type hi,
+                       Cmp& c, Placed& placed)
+{
+    typedef typename std::iterator_traits<Ran>::difference_type diff_t;
+    const diff_t d = D;
+    const diff_t last_parent = (n - 2) / d;
+    for( ;; ) {
+        for( diff_t j = std::min(hi, last_parent); j >= lo; --j )
+            detail::sift_down<D>(first, n, j, std::move(first[j]), c, placed);
+        if( lo == 0 ) return;
+        // Parents from lo on were sifted with this level.
+        hi = std::min((hi - 1) / d, lo - 1);
+        lo = (lo - 1) / d;
+    }
+}
+
+/// Make the subtree rooted at root of the n elements at first a D-ary heap.
+template<std::size_t D, typename Ran, typename Cmp, typename Placed>
+void heapify_subtree(Ran first,
+                     typename std::iterator_traits<Ran>::difference_type n,
+                     typename std::iterator_traits<Ran>::difference_type root,
+                     Cmp& c, Placed& placed)
+{
+    typedef typename std::iterator_traits<Ran>::difference_type diff_t;
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    const diff_t d = D;
+    const diff_t last_parent = (n - 2) / d;
+    if( root > last_parent ) return;
+    // Level k of the subtree starts at start[k] and is width[k] wide, cut
+    // short at n.
+    diff_t start[std::numeric_limits<diff_t>::digits + 1];
+    diff_t width[std::numeric_limits<diff_t>::digits + 1];
+    int levels = 0;
+    std::size_t size = 0;
+    for( diff_t s = root, w = 1; s < n; s = d * s + 1, w *= d ) {
+        start[levels] = s;
+        width[levels] = std::min(w, n - s);
+        size += width[levels];
+        ++levels;
+        if( s > (n - 1) / d ) break;
+    }
+    if( size * sizeof(value_t) <= heap_block_bytes ) {
+        for( int k = levels - 1; k >= 0; --k ) {
+            const diff_t hi = std::min(start[k] + width[k] - 1, last_parent);
+            for( diff_t j = hi; j >= start[k]; --j )
+                detail::sift_down<D>(first, n, j, std::move(first[j]), c,
+                                     placed);
+        }
+        return;
+    }
+    const diff_t child = d * root + 1;
+    for( diff_t j = child; j < child + d && j < n; ++j )
+        detail::heapify_subtree<D>(first, n, j, c, placed);
+    detail::sift_down<D>(first, n, root, std::move(first[root]), c, placed);
+}
+
+/// Make the n elements at first a D-ary heap.
+template<std::size_t D, typename Ran, typename Cmp, typename Placed>
+void make_heap(Ran first, typename std::iterator_traits<Ran>::difference_type n,
+               Cmp& c, Placed& placed)
+{
+    if( n < 2 ) return;
+    detail::heapify_subtree<D>(first, n, 0, c, placed);
+}
+
+/// An allocator whose blocks place their second element on a cache line
+/// boundary, for the children of the root of a d-ary heap and those after
+/// them to fill whole cache lines.
+template<typename T, std::size_t Align = 64>
+class heap_allocator {
+public:
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind { typedef heap_allocator<U,Align> other; };
+
+    heap_allocator() { }
+
+    template<typename U>
+    heap_allocator(const heap_allocator<U,Align>&) { }
+
+    T* allocate(std::size_t n)
+    {
+        if( n > (std::numeric_limits<std::size_t>::max() - 2 * Align) /
+                sizeof(T) )
+            throw std::bad_alloc();
+        char* const raw = static_cast<char*>(
+            ::operator new(n * sizeof(T) + Align + sizeof(void*)));
+        std::uintptr_t second = reinterpret_cast<std::uintptr_t>(raw) +
+                                sizeof(void*) + sizeof(T);
+        second = (second + Align - 1) / Align * Align;
+        char* const p = reinterpret_cast<char*>(second) - sizeof(T);
+        std::memcpy(p - sizeof(void*), &raw, sizeof(void*));
+        return reinterpret_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+        void* raw;
+        std::memcpy(&raw, reinterpret_cast<char*>(p) - sizeof(void*),
+                    sizeof(void*));
+        ::operator delete(raw);
+    }
+
+    friend bool operator==(const heap_allocator&, const heap_allocator&)
+    {
+        return true;
+    }
+
+    friend bool operator!=(const heap_allocator&, const heap_allocator&)
+    {
+        return false;
+    }
+};
+
+} // namespace detail
+
+/// Make a range a binary max-heap, with the layout std::make_heap() uses:
+/// the result is a valid heap for std::push_heap(), std::pop_heap() and
+/// std::sort_heap().  It need not be the heap std::make_heap() builds from
+/// the same range, as equal elements may be placed differently.
+///
+/// This is Floyd's method, sifting down from the last parent to the root,
+/// but on a large range it completes cache-sized subtrees one at a time.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param c A comparator defining the order of elements, as in std::sort().
+template<typename Ran, typename Cmp>
+void make_heap(Ran first, Ran last, Cmp c)
+{
+    detail::ignore_placement placed;
+    detail::make_heap<2>(first, last - first, c, placed);
+}
+
+/// Make a range a binary max-heap.
+///
+/// \see make_heap(Ran, Ran, Cmp)
+template<typename Ran>
+void make_heap(Ran first, Ran last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    wt::make_heap(first, last, std::less<value_t>());
+}
+
+/// Make a range a D-ary max-heap:  every element compares no less than its
+/// children, the children of the element at i being those at D * i + 1 to
+/// D * i + D.
+///
+/// \param D The number of children of a node, such as 4 or 8.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param c A comparator defining the order of elements, as in std::sort().
+template<std::size_t D, typename Ran, typename Cmp>
+void make_dary_heap(Ran first, Ran last, Cmp c)
+{
+    detail::ignore_placement placed;
+    detail::make_heap<D>(first, last - first, c, placed);
+}
+
+/// Make a range a D-ary max-heap.
+///
+/// \see make_dary_heap(Ran, Ran, Cmp)
+template<std::size_t D, typename Ran>
+void make_dary_heap(Ran first, Ran last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    wt::make_dary_heap<D>(first, last, std::less<value_t>());
+}
+
+/// Add the last element of a range to the D-ary heap before it.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param c A comparator defining the order of elements, as in std::sort().
+///
+/// \see make_dary_heap()
+template<std::size_t D, typename Ran, typename Cmp>
+void push_dary_heap(Ran first, Ran last, Cmp c)
+{
+    detail::ignore_placement placed;
+    if( last - first > 1 )
+        detail::sift_up<D>(first, (last - first) - 1, std::move(*(last - 1)),
+                           c, placed);
+}
+
+/// Add the last element of a range to the D-ary heap before it.
+///
+/// \see push_dary_heap(Ran, Ran, Cmp)
+template<std::size_t D, typename Ran>
+void push_dary_heap(Ran first, Ran last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    wt::push_dary_heap<D>(first, last, std::less<value_t>());
+}
+
+/// Move the top of a D-ary heap to its end, leaving the elements before it
+/// a heap.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the heap.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// heap.
+///
+/// \param c A comparator defining the order of elements, as in std::sort().
+///
+/// \see make_dary_heap()
+template<std::size_t D, typename Ran, typename Cmp>
+void pop_dary_heap(Ran first, Ran last, Cmp c)
+{
+    detail::ignore_placement placed;
+    if( last - first > 1 )
+        detail::pop_top<D>(first, last - first, c, placed);
+}
+
+/// Move the top of a D-ary heap to its end.
+///
+/// \see pop_dary_heap(Ran, Ran, Cmp)
+template<std::size_t D, typename Ran>
+void pop_dary_heap(Ran first, Ran last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    wt::pop_dary_heap<D>(first, last, std::less<value_t>());
+}
+
+/// Whether a range is a D-ary max-heap.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param c A comparator defining the order of elements, as in std::sort().
+///
+/// \see make_dary_heap()
+template<std::size_t D, typename Ran, typename Cmp>
+bool is_dary_heap(Ran first, Ran last, Cmp c)
+{
+    typedef typename std::iterator_traits<Ran>::difference_type diff_t;
+    const diff_t n = last - first;
+    for( diff_t i = 1; i < n; ++i )
+        if( c(first[(i - 1) / diff_t(D)], first[i]) ) return false;
+    return true;
+}
+
+/// Whether a range is a D-ary max-heap.
+///
+/// \see is_dary_heap(Ran, Ran, Cmp)
+template<std::size_t D, typename Ran>
+bool is_dary_heap(Ran first, Ran last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    return wt::is_dary_heap<D>(first, last, std::less<value_t>());
+}
+
+/// A priority queue on a D-ary heap, with the interface of
+/// std::priority_queue and bulk push() and pop().
+///
+/// With the default std::less the top is the greatest element;  give
+/// std::greater for a min-queue.  The heap's storage is aligned so that each
+/// node's children share a cache line when D * sizeof(T) is a cache line:
+/// D = 8 for 8-byte elements, 4 for 16-byte ones.
+template<typename T, typename Cmp = std::less<T>, std::size_t D = 4>
+class priority_queue {
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef Cmp value_compare;
+
+    priority_queue() : c_() { }
+
+    explicit priority_queue(const Cmp& c) : c_(c) { }
+
+    /// A queue of the elements of [first, last), heapified at once.
+    template<typename In>
+    priority_queue(In first, In last, const Cmp& c = Cmp())
+        : c_(c), v_(first, last)
+    {
+        detail::ignore_placement placed;
+        detail::make_heap<D>(v_.data(), v_.size(), c_, placed);
+    }
+
+    bool empty() const { return v_.empty(); }
+    size_type size() const { return v_.size(); }
+
+    /// The greatest element.  The queue must not be empty.
+    const T& top() const { return v_.front(); }
+
+    void push(const T& v)
+    {
+        v_.push_back(v);
+        sift_up_last();
+    }
+
+    void push(T&& v)
+    {
+        v_.push_back(std::move(v));
+        sift_up_last();
+    }
+
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        v_.emplace_back(std::forward<Args>(args)...);
+        sift_up_last();
+    }
+
+    /// Add the elements of [first, last).
+    ///
+    /// The elements are appended, then their ancestors sifted down a level
+    /// at a time, bottom up, as make_heap() would for the whole heap.  The
+    /// cost is about that of heapifying the new elements, plus a sift for
+    /// each of their ancestors near the root.  Few elements are sifted up
+    /// one at a time instead.
+    template<typename In>
+    void push(In first, In last)
+    {
+        const std::ptrdiff_t old = v_.size();
+        v_.insert(v_.end(), first, last);
+        const std::ptrdiff_t n = v_.size();
+        detail::ignore_placement placed;
+        if( n - old < bulk_threshold(old) ) {
+            for( std::ptrdiff_t i = old; i < n; ++i )
+                detail::sift_up<D>(v_.data(), i, std::move(v_[i]), c_,
+                                   placed);
+        } else {
+            detail::heapify_ancestors<D>(v_.data(), n, old, n - 1, c_,
+                                         placed);
+        }
+    }
+
+    /// Remove the greatest element.  The queue must not be empty.
+    void pop()
+    {
+        detail::ignore_placement placed;
+        detail::pop_top<D>(v_.data(), v_.size(), c_, placed);
+        v_.pop_back();
+    }
+
+    /// Remove the k greatest elements, or all if there are fewer, moving
+    /// them to an output iterator, greatest first.
+    ///
+    /// \return The end of the output.
+    template<typename Out>
+    Out pop(size_type k, Out res)
+    {
+        detail::ignore_placement placed;
+        for( k = std::min(k, v_.size()); k != 0; --k ) {
+            detail::pop_top<D>(v_.data(), v_.size(), c_, placed);
+            *res++ = std::move(v_.back());
+            v_.pop_back();
+        }
+        return res;
+    }
+
+    void reserve(size_type n) { v_.reserve(n); }
+    void clear() { v_.clear(); }
+
+private:
+    /// The number of new elements below which push(first, last) sifts
+    /// each up, which costs a few comparisons apiece on random input, rather
+    /// than sifting their ancestors down.
+    static std::ptrdiff_t bulk_threshold(std::ptrdiff_t n)
+    {
+        return std::max<std::ptrdiff_t>(64, n / 8);
+    }
+
+    void sift_up_last()
+    {
+        detail::ignore_placement placed;
+        detail::sift_up<D>(v_.data(), v_.size() - 1, std::move(v_.back()),
+                           c_, placed);
+    }
+
+    Cmp c_;
+    std::vector<T, detail::heap_allocator<T> > v_;
+};
+
+/// A priority queue of elements identified by ids in [0, capacity), whose
+/// priorities can be changed in place.
+///
+/// The queue keeps the heap position of every id, so update() moves an
+/// element up or down from where it is:  the decrease-key of Dijkstra's
+/// algorithm, or a scheduler rescheduling a task, in O(log n) without
+/// searching for the element or leaving stale entries behind.
+///
+/// With the default std::less the top has the greatest priority;  give
+/// std::greater for the smallest first.
+template<typename Priority, typename Cmp = std::less<Priority>,
+         std::size_t D = 4>
+class indexed_priority_queue {
+public:
+    typedef std::size_t size_type;
+    typedef Priority priority_type;
+
+    /// A queue for ids below capacity.
+    explicit indexed_priority_queue(size_type capacity, const Cmp& c = Cmp())
+        : c_(c), pos_(capacity, npos)
+    {
+    }
+
+    bool empty() const { return heap_.empty(); }
+    size_type size() const { return heap_.size(); }
+
+    /// The number of ids the queue can hold.
+    size_type capacity() const { return pos_.size(); }
+
+    /// Whether an element of the given id is queued.
+    bool contains(size_type id) const { return pos_[id] != npos; }
+
+    /// The id of the element with the greatest priority.  The queue must not
+    /// be empty.
+    size_type top() const { return heap_.front().id; }
+
+    /// The greatest priority.  The queue must not be empty.
+    const Priority& top_priority() const { return heap_.front().priority; }
+
+    /// The priority of a queued id.
+    const Priority& priority(size_type id) const
+    {
+        return heap_[pos_[id]].priority;
+    }
+
+    /// Add an id that isn't queued, with a priority.
+    void push(size_type id, const Priority& p)
+    {
+        heap_.push_back(entry(p, id));
+        placement placed(*this);
+        detail::sift_up<D>(heap_.data(), heap_.size() - 1,
+                           std::move(heap_.back()), c_, placed);
+    }
+
+    /// Change the priority of a queued id, moving it up or down the heap.
+    void update(size_type id, const Priority& p)
+    {
+        const std::ptrdiff_t i = pos_[id];
+        const bool up = c_.c(heap_[i].priority, p);
+        placement placed(*this);
+        if( up )
+            detail::sift_up<D>(heap_.data(), i, entry(p, id), c_, placed);
+        else
+            detail::sift_down<D>(heap_.data(), heap_.size(), i,
+                                 entry(p, id), c_, placed);
+    }
+
+    /// Add an id with a priority, or change its priority if it is queued.
+    void push_or_update(size_type id, const Priority& p)
+    {
+        if( contains(id) )
+            update(id, p);
+        else
+            push(id, p);
+    }
+
+    /// Remove the element with the greatest priority.  The queue must not
+    /// be empty.
+    void pop()
+    {
+        placement placed(*this);
+        detail::pop_top<D>(heap_.data(), heap_.size(), c_, placed);
+        pos_[heap_.back().id] = npos;
+        heap_.pop_back();
+    }
+
+    /// Remove a queued id.
+    void erase(size_type id)
+    {
+        const std::ptrdiff_t i = pos_[id];
+        pos_[id] = npos;
+        entry last(std::move(heap_.back()));
+        heap_.pop_back();
+        if( i == std::ptrdiff_t(heap_.size()) ) return;
+        placement placed(*this);
+        if( c_(heap_[i], last) )
+            detail::sift_up<D>(heap_.data(), i, std::move(last), c_, placed);
+        else
+            detail::sift_down<D>(heap_.data(), heap_.size(), i,
+                                 std::move(last), c_, placed);
+    }
+
+    void clear()
+    {
+        for( std::size_t i = 0; i < heap_.size(); ++i )
+            pos_[heap_[i].id] = npos;
+        heap_.clear();
+    }
+
+private:
+    static const size_type npos = size_type(-1);
+
+    struct entry {
+        entry(const Priority& p, size_type i) : priority(p), id(i) { }
+
+        Priority priority;
+        size_type id;
+    };
+
+    struct entry_compare {
+        explicit entry_compare(const Cmp& cmp) : c(cmp) { }
+
+        bool operator()(const entry& a, const entry& b) const
+        {
+            return c(a.priority, b.priority);
+        }
+
+        Cmp c;
+    };
+
+    // Records the heap position of each entry moved.
+    struct placement {
+        explicit placement(indexed_priority_queue& q) : q_(q) { }
+
+        void operator()(std::ptrdiff_t i) const
+        {
+            q_.pos_[q_.heap_[i].id] = i;
+        }
+
+        indexed_priority_queue& q_;
+    };
+
+    entry_compare c_;
+    std::vector<size_type> pos_;
+    std::vector<entry, detail::heap_allocator<entry> > heap_;
+};
+
+template<typename Priority, typename Cmp, std::size_t D>
+const typename indexed_priority_queue<Priority,Cmp,D>::size_type
+indexed_priority_queue<Priority,Cmp,D>::npos;
+
+} // namespace wt
+
+#include <wtl/heap_iseq.hh>
+
+#endif // HEAP_HH_
@@ -0,0 +1,67 @@
+#ifndef HEAP_ISEQ_HH_
+#define HEAP_ISEQ_HH_
+
+#include <wtl/iseq.hh>
+#include <wtl/heap.hh>
+
+namespace wt {
+
+template<std::size_t D, typename Ran>
+void make_dary_heap(input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("make_dary_heap", range);
+    wt::make_dary_heap<D>(range.first, range.second);
+}
+
+template<std::size_t D, typename Ran, typename Cmp>
+void make_dary_heap(input_sequence_range<Ran> range, Cmp c)
+{
+    WT_TRACE_ISEQ("make_dary_heap", range);
+    wt::make_dary_heap<D>(range.first, range.second, c);
+}
+
+template<std::size_t D, typename Ran>
+void push_dary_heap(input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("push_dary_heap", range);
+    wt::push_dary_heap<D>(range.first, range.second);
+}
+
+template<std::size_t D, typename Ran, typename Cmp>
+void push_dary_heap(input_sequence_range<Ran> range, Cmp c)
+{
+    WT_TRACE_ISEQ("push_dary_heap", range);
+    wt::push_dary_heap<D>(range.first, range.second, c);
+}
+
+template<std::size_t D, typename Ran>
+void pop_dary_heap(input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("pop_dary_heap", range);
+    wt::pop_dary_heap<D>(range.first, range.second);
+}
+
+template<std::size_t D, typename Ran, typename Cmp>
+void pop_dary_heap(input_sequence_range<Ran> range, Cmp c)
+{
+    WT_TRACE_ISEQ("pop_dary_heap", range);
+    wt::pop_dary_heap<D>(range.first, range.second, c);
+}
+
+template<std::size_t D, typename Ran>
+bool is_dary_heap(input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("is_dary_heap", range);
+    return wt::is_dary_heap<D>(range.first, range.second);
+}
+
+template<std::size_t D, typename Ran, typename Cmp>
+bool is_dary_heap(input_sequence_range<Ran> range, Cmp c)
+{
+    WT_TRACE_ISEQ("is_dary_heap", range);
+    return wt::is_dary_heap<D>(range.first, range.second, c);
+}
+
+} // namespace wt
+
+#endif // HEAP_ISEQ_HH_
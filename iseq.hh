@@ -7,10 +7,16 @@
 /// January 2009
 ///
 /// Matan Nassau <matan.nassau@gmail.com>
+///
+/// The wrappers taking an input_sequence_range live in a header x_iseq.hh
+/// beside the x.hh that defines the algorithms they call.  Each x.hh
+/// includes its x_iseq.hh at its very end, after those algorithms, so the
+/// wrappers see them whichever header is included first.
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <utility>
 #include <iterator>
+#include <wtl/trace.hh>
 
 namespace wt {
 
@@ -22,6 +28,15 @@ struct input_sequence_range : public std::pair<In,In> {
     input_sequence_range(In first, In last) : std::pair<In,In>(first, last) { }
 };
 
+/// Whether T is an input_sequence_range.
+template<typename T>
+struct is_input_sequence_range { static const bool value = false; };
+
+template<typename In>
+struct is_input_sequence_range<input_sequence_range<In> > {
+    static const bool value = true;
+};
+
 /// Helper function to generate an input_sequence_range which expresses the
 /// range of a given const input sequence, from begin to end.
 ///
@@ -9,12 +9,14 @@ namespace wt {
 template <typename In, typename Fwd>
 Fwd uninitialized_copy(input_sequence_range<In> range, Fwd res)
 {
+    WT_TRACE_ISEQ("uninitialized_copy", range);
     return std::uninitialized_copy(range.first, range.second, res);
 }
 
 template <typename Fwd, typename V>
 void uninitialized_fill(input_sequence_range<Fwd> range, V val)
 {
+    WT_TRACE_ISEQ("uninitialized_fill", range);
     std::uninitialized_fill(range.first, range.second, val);
 }
 
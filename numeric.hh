@@ -9,11 +9,1106 @@
 /// Matan Nassau <matan.nassau@gmail.com>
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <numeric>
-#include <wtl/numeric_iseq.hh>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <wtl/iseq.hh>
+#include <wtl/parallel.hh>
+#include <wtl/simd.hh>
+#include <wtl/sketch.hh>
+#include <wtl/traits.hh>
 
 namespace wt {
 
+/// Count, mean, variance, skewness, kurtosis, minimum and maximum of a
+/// sequence of numbers, accumulated in a single pass.
+///
+/// The summary keeps the count, the mean and the second to fourth central
+/// moment sums, updated with Welford's method value by value and combined
+/// with Chan's formulas when summaries merge, which avoids the cancellation
+/// of textbook sum-of-squares formulas.  Merging makes the summary suitable
+/// for streams processed in chunks, and for parallel reductions.
+template<typename T>
+class summary {
+public:
+    typedef T value_type;
+
+    summary()
+        : n_(0), mean_(0), m2_(0), m3_(0), m4_(0), min_(T()), max_(T())
+    {
+    }
+
+    /// The number of values added.
+    std::size_t count() const { return n_; }
+
+    bool empty() const { return n_ == 0; }
+
+    /// The smallest value added.  The summary must not be empty.
+    const T& min() const { return min_; }
+
+    /// The greatest value added.  The summary must not be empty.
+    const T& max() const { return max_; }
+
+    double mean() const { return mean_; }
+
+    /// The unbiased sample variance, which needs at least two values.
+    double variance() const { return m2_ / (double(n_) - 1); }
+
+    /// The variance of the values as a population.
+    double population_variance() const { return m2_ / double(n_); }
+
+    /// The square root of the sample variance.
+    double stddev() const { return std::sqrt(variance()); }
+
+    /// The population skewness.
+    double skewness() const
+    {
+        return std::sqrt(double(n_)) * m3_ / std::pow(m2_, 1.5);
+    }
+
+    /// The population excess kurtosis:  zero for a normal distribution.
+    double kurtosis() const { return double(n_) * m4_ / (m2_ * m2_) - 3; }
+
+    void add(const T& v)
+    {
+        const double x = static_cast<double>(v);
+        const double n1 = double(n_);
+        track(v, v);
+        ++n_;
+        const double n = double(n_);
+        const double delta = x - mean_;
+        const double delta_n = delta / n;
+        const double delta_n2 = delta_n * delta_n;
+        const double term = delta * delta_n * n1;
+        mean_ += delta_n;
+        m4_ += term * delta_n2 * (n * n - 3 * n + 3) + 6 * delta_n2 * m2_
+             - 4 * delta_n * m3_;
+        m3_ += term * delta_n * (n - 2) - 3 * delta_n * m2_;
+        m2_ += term;
+    }
+
+    /// Add a sequence of values.  Contiguous arithmetic values are summarized
+    /// a block at a time, in loops the compiler can vectorize, and the block
+    /// summaries merged.
+    template<typename In>
+    void add(In first, In last)
+    {
+        add(first, last, detail::is_contiguous_arithmetic<In>());
+    }
+
+    /// Merge another summary into this one.  The result summarizes the values
+    /// added to either.
+    void merge(const summary& o)
+    {
+        if( o.n_ == 0 ) return;
+        if( n_ == 0 ) {
+            *this = o;
+            return;
+        }
+        const double na = double(n_);
+        const double nb = double(o.n_);
+        const double n = na + nb;
+        const double delta = o.mean_ - mean_;
+        const double delta_n = delta / n;
+        const double delta_n2 = delta_n * delta_n;
+        const double m2 = m2_ + o.m2_ + delta * delta_n * na * nb;
+        const double m3 = m3_ + o.m3_
+            + delta * delta_n2 * na * nb * (na - nb)
+            + 3 * delta_n * (na * o.m2_ - nb * m2_);
+        m4_ = m4_ + o.m4_
+            + delta * delta_n2 * delta_n * na * nb * (na * na - na * nb + nb * nb)
+            + 6 * delta_n2 * (na * na * o.m2_ + nb * nb * m2_)
+            + 4 * delta_n * (na * o.m3_ - nb * m3_);
+        m3_ = m3;
+        m2_ = m2;
+        mean_ += delta_n * nb;
+        track(o.min_, o.max_);
+        n_ += o.n_;
+    }
+
+private:
+    static const std::size_t lanes = 8;
+    static const std::size_t block = 2048;
+
+    void track(const T& lo, const T& hi)
+    {
+        if( n_ == 0 ) {
+            min_ = lo;
+            max_ = hi;
+            return;
+        }
+        if( lo < min_ ) min_ = lo;
+        if( max_ < hi ) max_ = hi;
+    }
+
+    template<typename In>
+    void add(In first, In last, std::false_type)
+    {
+        for( ; first != last; ++first ) add(*first);
+    }
+
+    template<typename In>
+    void add(In first, In last, std::true_type)
+    {
+        if( first == last ) return;
+        const T* p = detail::address_of(first);
+        for( std::size_t n = last - first; n != 0; ) {
+            const std::size_t b = std::min(n, block);
+            merge(summarize(p, b));
+            p += b;
+            n -= b;
+        }
+    }
+
+    /// Summarize a block that fits in cache in two passes:  the mean first,
+    /// then the moments about it.  Each pass keeps independent accumulators
+    /// per lane so that it vectorizes without reordering floating-point sums.
+    static summary summarize(const T* p, std::size_t n)
+    {
+        const std::size_t body = n / lanes * lanes;
+        double sum[lanes] = { };
+        T lo[lanes], hi[lanes];
+        for( std::size_t j = 0; j < lanes; ++j ) lo[j] = hi[j] = p[0];
+        for( std::size_t i = 0; i < body; i += lanes )
+            for( std::size_t j = 0; j < lanes; ++j ) {
+                const T x = p[i + j];
+                sum[j] += static_cast<double>(x);
+                lo[j] = x < lo[j] ? x : lo[j];
+                hi[j] = hi[j] < x ? x : hi[j];
+            }
+        for( std::size_t i = body; i < n; ++i ) {
+            sum[0] += static_cast<double>(p[i]);
+            lo[0] = p[i] < lo[0] ? p[i] : lo[0];
+            hi[0] = hi[0] < p[i] ? p[i] : hi[0];
+        }
+        summary s;
+        s.n_ = n;
+        s.min_ = lo[0];
+        s.max_ = hi[0];
+        double total = 0;
+        for( std::size_t j = 0; j < lanes; ++j ) {
+            total += sum[j];
+            if( lo[j] < s.min_ ) s.min_ = lo[j];
+            if( s.max_ < hi[j] ) s.max_ = hi[j];
+        }
+        s.mean_ = total / double(n);
+        double m2[lanes] = { }, m3[lanes] = { }, m4[lanes] = { };
+        for( std::size_t i = 0; i < body; i += lanes )
+            for( std::size_t j = 0; j < lanes; ++j ) {
+                const double d = static_cast<double>(p[i + j]) - s.mean_;
+                const double d2 = d * d;
+                m2[j] += d2;
+                m3[j] += d2 * d;
+                m4[j] += d2 * d2;
+            }
+        for( std::size_t i = body; i < n; ++i ) {
+            const double d = static_cast<double>(p[i]) - s.mean_;
+            const double d2 = d * d;
+            m2[0] += d2;
+            m3[0] += d2 * d;
+            m4[0] += d2 * d2;
+        }
+        for( std::size_t j = 0; j < lanes; ++j ) {
+            s.m2_ += m2[j];
+            s.m3_ += m3[j];
+            s.m4_ += m4[j];
+        }
+        return s;
+    }
+
+    std::size_t n_;
+    double mean_;
+    double m2_;
+    double m3_;
+    double m4_;
+    T min_;
+    T max_;
+};
+
+template<typename T>
+const std::size_t summary<T>::lanes;
+
+template<typename T>
+const std::size_t summary<T>::block;
+
+/// NOTE that none of the algorithms perform a range check;  the iterators
+/// given are all assumed to be valid.
+
+/// Estimate the number of distinct elements of a sequence, in a single pass
+/// and fixed memory.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param precision The precision of the hyperloglog sketch:  it takes
+/// 2^precision bytes, and has a standard error of about
+/// 1.04 / sqrt(2^precision).
+///
+/// \return The estimated number of distinct elements.
+///
+/// \see hyperloglog
+template<typename In>
+std::size_t approx_count_distinct(In first, In last, unsigned precision)
+{
+    hyperloglog sketch(precision);
+    sketch.add(first, last);
+    return static_cast<std::size_t>(std::llround(sketch.estimate()));
+}
+
+/// Estimate the number of distinct elements of a sequence, within about 1.6%.
+///
+/// \see approx_count_distinct(In, In, unsigned)
+template<typename In>
+std::size_t approx_count_distinct(In first, In last)
+{
+    return wt::approx_count_distinct(first, last, 12);
+}
+
+/// Describe a sequence of numbers:  count, mean, variance, skewness, kurtosis,
+/// minimum and maximum, in a single pass.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \return The summary of the sequence.  It can be merged with summaries of
+/// further chunks of the same stream.
+///
+/// \see summary
+template<typename In>
+summary<typename std::iterator_traits<In>::value_type>
+describe(In first, In last)
+{
+    summary<typename std::iterator_traits<In>::value_type> s;
+    s.add(first, last);
+    return s;
+}
+
+/// Summarize the distribution of a sequence in a single pass and fixed memory.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param k The accuracy parameter of the sketch:  quantiles are off by
+/// about 1.7 / k in rank.
+///
+/// \return A sketch to query for quantiles and ranks.
+///
+/// \see kll_sketch
+template<typename In>
+kll_sketch<typename std::iterator_traits<In>::value_type>
+quantile_sketch(In first, In last, std::size_t k)
+{
+    kll_sketch<typename std::iterator_traits<In>::value_type> sketch(k);
+    sketch.add(first, last);
+    return sketch;
+}
+
+/// Summarize the distribution of a sequence, with quantiles accurate to
+/// within about 1% in rank.
+///
+/// \see quantile_sketch(In, In, std::size_t)
+template<typename In>
+kll_sketch<typename std::iterator_traits<In>::value_type>
+quantile_sketch(In first, In last)
+{
+    return wt::quantile_sketch(first, last, 200);
+}
+
+namespace detail {
+
+/// Whether the dot product of two ranges can run on the vector kernels.
+template<typename In1, typename In2>
+struct is_dot_contiguous
+    : std::integral_constant<bool,
+        is_contiguous_iterator<In1>::value &&
+        is_contiguous_iterator<In2>::value &&
+        std::is_same<typename std::iterator_traits<In1>::value_type,
+                     typename std::iterator_traits<In2>::value_type>::value &&
+        (std::is_same<typename std::iterator_traits<In1>::value_type,
+                      float>::value ||
+         std::is_same<typename std::iterator_traits<In1>::value_type,
+                      double>::value ||
+         std::is_same<typename std::iterator_traits<In1>::value_type,
+                      std::int8_t>::value)> { };
+
+template<typename In1, typename In2, typename V>
+V inner_product(In1 first1, In1 last1, In2 first2, V init, std::true_type)
+{
+    if( first1 == last1 ) return init;
+    return init + detail::dot(detail::address_of(first1),
+                              detail::address_of(first2),
+                              last1 - first1);
+}
+
+template<typename In1, typename In2, typename V>
+V inner_product(In1 first1, In1 last1, In2 first2, V init, std::false_type)
+{
+    return std::inner_product(first1, last1, first2, init);
+}
+
+/// The dot product of the query [first, first + n) with count rows of n
+/// elements each, stored one after the other from rows.
+template<typename Fwd, typename Ran, typename Out>
+Out inner_products(Fwd first, std::size_t n, Ran rows, std::size_t count,
+                   Out res, std::true_type)
+{
+    typedef typename std::iterator_traits<Fwd>::value_type T;
+    typedef typename dot_result<T>::type R;
+    if( count == 0 ) return res;
+    const T* q = detail::address_of(first);
+    const T* r = detail::address_of(rows);
+    std::size_t i = 0;
+    for( ; i + 4 <= count; i += 4 ) {
+        R d[4];
+        detail::dot4(q, r + i * n, n, n, d);
+        res = std::copy(d, d + 4, res);
+    }
+    for( ; i < count; ++i ) *res++ = detail::dot1(q, r + i * n, n);
+    return res;
+}
+
+template<typename Fwd, typename Ran, typename Out>
+Out inner_products(Fwd first, std::size_t n, Ran rows, std::size_t count,
+                   Out res, std::false_type)
+{
+    typedef typename std::iterator_traits<Fwd>::value_type T;
+    typedef typename dot_result<T>::type R;
+    Fwd last = first;
+    std::advance(last, n);
+    for( std::size_t i = 0; i < count; ++i, rows += n )
+        *res++ = std::inner_product(first, last, rows, R());
+    return res;
+}
+
+} // namespace detail
+
+/// Compute the inner product of two sequences, allowing the products to be
+/// summed in any order.
+///
+/// Unlike std::inner_product, which must add the products one after another,
+/// this may keep several partial sums and add them up at the end.  For
+/// contiguous ranges of float, double or int8_t it runs on vector
+/// multiply-add kernels, summing in the element type, or in 32-bit integers
+/// for int8_t, before adding to init.  Other ranges run std::inner_product.
+///
+/// \param pol The unsequenced policy, wt::unseq.
+///
+/// \param first1 An _input iterator_ pointing to the first element of the
+/// first sequence.
+///
+/// \param last1 An _input iterator_ pointing to the last element of the first
+/// sequence.
+///
+/// \param first2 An _input iterator_ pointing to the first element of the
+/// second sequence.
+///
+/// \param init The initial value to which the products are added.
+///
+/// \return The inner product.
+template<typename In1, typename In2, typename V>
+V inner_product(const unsequenced_policy&,
+                In1 first1, In1 last1, In2 first2, V init)
+{
+    return detail::inner_product(first1, last1, first2, init,
+                                 detail::is_dot_contiguous<In1,In2>());
+}
+
+/// Compute the inner products of a query vector with every row of a matrix,
+/// allowing the products to be summed in any order.
+///
+/// The rows are stored one after another, each as long as the query.  For
+/// contiguous float, double or int8_t elements the query is multiplied with
+/// four rows at a time, so that each of its vectors is loaded once for the
+/// four.
+///
+/// \param first A _forward iterator_ pointing to the first element of the
+/// query.
+///
+/// \param last A _forward iterator_ pointing to the last element of the
+/// query.
+///
+/// \param rows_first A _random access iterator_ pointing to the first element
+/// of the first row.
+///
+/// \param rows_last A _random access iterator_ pointing past the last element
+/// of the last row.
+///
+/// \param res An _output iterator_ receiving one inner product per row, of
+/// the element type, or int32_t for int8_t elements.
+///
+/// \return The end of the output.
+template<typename Fwd, typename Ran, typename Out>
+Out inner_products(Fwd first, Fwd last, Ran rows_first, Ran rows_last, Out res)
+{
+    const std::size_t n = std::distance(first, last);
+    const std::size_t count = n == 0 ? 0 : (rows_last - rows_first) / n;
+    return detail::inner_products(first, n, rows_first, count, res,
+                                  detail::is_dot_contiguous<Fwd,Ran>());
+}
+
+/// Aggregates for sliding_window().  window_min and window_max order values
+/// with operator<.  window_sum adds integers as long long, or unsigned long
+/// long for unsigned types, and window_mean yields double for integers.
+struct window_min { };
+struct window_max { };
+struct window_sum { };
+struct window_mean { };
+
+namespace detail {
+
+struct window_before_min {
+    template<typename T>
+    bool operator()(const T& a, const T& b) const { return a < b; }
+};
+
+struct window_before_max {
+    template<typename T>
+    bool operator()(const T& a, const T& b) const { return b < a; }
+};
+
+/// The extreme of each window, kept by a monotonic queue:  a ring of the
+/// values that may yet be the extreme of this or a later window, each of
+/// them ahead of all values after it.  A new value evicts the values behind
+/// which it falls, so each value enters and leaves the queue once.
+template<typename In, typename Out, typename Before>
+Out sliding_extreme(In first, In last, std::size_t w, Out res, Before before)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    std::vector<std::pair<std::size_t,T> > ring;
+    ring.reserve(w);
+    std::size_t head = 0;
+    std::size_t size = 0;
+    for( std::size_t i = 0; first != last; ++first, ++i ) {
+        if( size != 0 && ring[head].first + w <= i ) {
+            if( ++head == w ) head = 0;
+            --size;
+        }
+        const T v = *first;
+        for( ; size != 0; --size ) {
+            const std::size_t back = head + size - 1;
+            if( before(ring[back < w ? back : back - w].second, v) ) break;
+        }
+        const std::size_t at = head + size < w ? head + size : head + size - w;
+        if( at == ring.size() ) ring.push_back(std::make_pair(i, v));
+        else ring[at] = std::make_pair(i, v);
+        ++size;
+        if( i + 1 >= w ) *res++ = ring[head].second;
+    }
+    return res;
+}
+
+/// The type a window's running sum is kept in:  long long or unsigned long
+/// long for integers, so that sums of small integers don't wrap, and T for
+/// other types.
+template<typename T, bool Integral = std::is_integral<T>::value>
+struct window_sum_type {
+    typedef T type;
+};
+
+template<typename T>
+struct window_sum_type<T, true> {
+    typedef typename std::conditional<std::is_signed<T>::value,
+                                      long long, unsigned long long>::type type;
+};
+
+/// The running sum, or mean, of each window.  Floating-point sums are
+/// recomputed from the window every w steps, so rounding errors from adding
+/// and subtracting values don't build up over a long stream.
+template<typename In, typename Out>
+Out sliding_sum(In first, In last, std::size_t w, Out res, bool mean)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    typedef typename window_sum_type<T>::type sum_t;
+    typedef typename std::conditional<std::is_floating_point<T>::value,
+                                      T, double>::type mean_t;
+    std::vector<T> ring;
+    ring.reserve(w);
+    sum_t sum = sum_t();
+    std::size_t at = 0;
+    for( std::size_t i = 0; first != last; ++first, ++i ) {
+        const T v = *first;
+        if( ring.size() < w ) {
+            ring.push_back(v);
+            sum = sum + v;
+        } else {
+            sum = sum - ring[at] + v;
+            ring[at] = v;
+            if( ++at == w ) {
+                at = 0;
+                if( std::is_floating_point<T>::value )
+                    sum = std::accumulate(ring.begin(), ring.end(), sum_t());
+            }
+        }
+        if( i + 1 < w ) continue;
+        if( mean ) *res++ = static_cast<mean_t>(sum) / static_cast<mean_t>(w);
+        else *res++ = sum;
+    }
+    return res;
+}
+
+/// The fold of each window with an associative operation, by two stacks.
+/// New values go on the back stack, which keeps the fold of its values.
+/// Old values come off the front stack, which keeps for each value the fold
+/// of it and the values above it;  when the front stack runs out, the back
+/// stack is folded over into it.  Each value is folded at most twice.
+template<typename In, typename Out, typename BinOp>
+Out sliding_fold(In first, In last, std::size_t w, Out res, BinOp op)
+{
+    typedef typename std::iterator_traits<In>::value_type T;
+    std::vector<T> front;
+    std::vector<T> back;
+    front.reserve(w);
+    back.reserve(w);
+    T back_fold = T();
+    for( std::size_t i = 0; first != last; ++first, ++i ) {
+        if( i >= w ) {
+            if( front.empty() ) {
+                T fold = back.back();
+                front.push_back(fold);
+                for( std::size_t j = back.size() - 1; j != 0; --j ) {
+                    fold = op(back[j - 1], fold);
+                    front.push_back(fold);
+                }
+                back.clear();
+            }
+            front.pop_back();
+        }
+        const T v = *first;
+        back_fold = back.empty() ? v : op(back_fold, v);
+        back.push_back(v);
+        if( i + 1 < w ) continue;
+        if( front.empty() ) *res++ = back_fold;
+        else *res++ = op(front.back(), back_fold);
+    }
+    return res;
+}
+
+} // namespace detail
+
+/// Compute the minimum of every window of w consecutive elements of a
+/// sequence, in amortized constant time per element.
+///
+/// \param first An _input iterator_ pointing to the first element of the input
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the input
+/// sequence.
+///
+/// \param w The window size.  It must not be zero.
+///
+/// \param agg The aggregate:  window_min, window_max, window_sum,
+/// window_mean, or an associative binary operation to fold each window with.
+///
+/// \param res An _output iterator_ receiving one aggregate for each window,
+/// from the window ending at the w-th element on:  nothing if the sequence
+/// is shorter than w.
+///
+/// \return The end of the output.
+///
+/// The algorithm takes a single pass over the sequence, and holds no more
+/// than w elements at a time.
+template<typename In, typename Out>
+Out sliding_window(In first, In last, std::size_t w, window_min, Out res)
+{
+    if( w == 0 ) throw std::invalid_argument("sliding_window");
+    return detail::sliding_extreme(first, last, w, res,
+                                   detail::window_before_min());
+}
+
+/// Compute the maximum of every window of w consecutive elements.
+///
+/// \see sliding_window(In, In, std::size_t, window_min, Out)
+template<typename In, typename Out>
+Out sliding_window(In first, In last, std::size_t w, window_max, Out res)
+{
+    if( w == 0 ) throw std::invalid_argument("sliding_window");
+    return detail::sliding_extreme(first, last, w, res,
+                                   detail::window_before_max());
+}
+
+/// Compute the sum of every window of w consecutive elements.
+///
+/// \see sliding_window(In, In, std::size_t, window_min, Out)
+template<typename In, typename Out>
+Out sliding_window(In first, In last, std::size_t w, window_sum, Out res)
+{
+    if( w == 0 ) throw std::invalid_argument("sliding_window");
+    return detail::sliding_sum(first, last, w, res, false);
+}
+
+/// Compute the mean of every window of w consecutive elements.
+///
+/// \see sliding_window(In, In, std::size_t, window_min, Out)
+template<typename In, typename Out>
+Out sliding_window(In first, In last, std::size_t w, window_mean, Out res)
+{
+    if( w == 0 ) throw std::invalid_argument("sliding_window");
+    return detail::sliding_sum(first, last, w, res, true);
+}
+
+/// Fold every window of w consecutive elements with an associative operation,
+/// such as multiplication, gcd or bitwise or.  The operation needn't be
+/// commutative or invertible;  it is applied in amortized constant time per
+/// element.
+///
+/// \see sliding_window(In, In, std::size_t, window_min, Out)
+template<typename In, typename Out, typename BinOp>
+Out sliding_window(In first, In last, std::size_t w, BinOp op, Out res)
+{
+    if( w == 0 ) throw std::invalid_argument("sliding_window");
+    return detail::sliding_fold(first, last, w, res, op);
 }
 
+/// Reduce each run of consecutive equal keys to one key and the fold of the
+/// values that go with the run, in a single pass.  Keys sorted with sort()
+/// come out with one entry per distinct key.
+///
+/// \param keys_first An _input iterator_ pointing to the first key.
+///
+/// \param keys_last An _input iterator_ pointing to the last key.
+///
+/// \param values_first An _input iterator_ pointing to the value of the first
+/// key.
+///
+/// \param keys_out An _output iterator_ receiving the first key of each run.
+///
+/// \param values_out An _output iterator_ receiving the fold of each run's
+/// values.
+///
+/// \param pred The predicate that tells whether adjacent keys are equal.
+///
+/// \param op The associative operation to fold values with.
+///
+/// \return The ends of the two outputs.
+template<typename In1, typename In2, typename Out1, typename Out2,
+         typename BinPred, typename BinOp>
+std::pair<Out1,Out2> reduce_by_key(In1 keys_first, In1 keys_last,
+                                   In2 values_first,
+                                   Out1 keys_out, Out2 values_out,
+                                   BinPred pred, BinOp op)
+{
+    typedef typename std::iterator_traits<In1>::value_type K;
+    typedef typename std::iterator_traits<In2>::value_type V;
+    if( keys_first == keys_last ) return std::make_pair(keys_out, values_out);
+    K head = *keys_first;
+    K prev = head;
+    V acc = *values_first;
+    for( ++keys_first, ++values_first; keys_first != keys_last;
+         ++keys_first, ++values_first ) {
+        K key = *keys_first;
+        if( pred(prev, key) ) {
+            acc = op(acc, *values_first);
+        } else {
+            *keys_out++ = head;
+            *values_out++ = acc;
+            head = key;
+            acc = *values_first;
+        }
+        prev = key;
+    }
+    *keys_out++ = head;
+    *values_out++ = acc;
+    return std::make_pair(keys_out, values_out);
+}
+
+/// \see reduce_by_key(In1, In1, In2, Out1, Out2, BinPred, BinOp)
+template<typename In1, typename In2, typename Out1, typename Out2,
+         typename BinOp>
+std::pair<Out1,Out2> reduce_by_key(In1 keys_first, In1 keys_last,
+                                   In2 values_first,
+                                   Out1 keys_out, Out2 values_out,
+                                   BinOp op)
+{
+    typedef typename std::iterator_traits<In1>::value_type K;
+    return wt::reduce_by_key(keys_first, keys_last, values_first,
+                             keys_out, values_out, std::equal_to<K>(), op);
+}
+
+/// Sum the values of each run of consecutive equal keys.
+///
+/// \see reduce_by_key(In1, In1, In2, Out1, Out2, BinPred, BinOp)
+template<typename In1, typename In2, typename Out1, typename Out2>
+std::pair<Out1,Out2> reduce_by_key(In1 keys_first, In1 keys_last,
+                                   In2 values_first,
+                                   Out1 keys_out, Out2 values_out)
+{
+    typedef typename std::iterator_traits<In2>::value_type V;
+    return wt::reduce_by_key(keys_first, keys_last, values_first,
+                             keys_out, values_out, std::plus<V>());
+}
+
+/// Compute the running fold of values within each run of consecutive equal
+/// keys, restarting with each run:  an inclusive scan segmented by key.
+///
+/// \param keys_first An _input iterator_ pointing to the first key.
+///
+/// \param keys_last An _input iterator_ pointing to the last key.
+///
+/// \param values_first An _input iterator_ pointing to the value of the first
+/// key.
+///
+/// \param res An _output iterator_ receiving the fold of the values of the
+/// run up to and including each key.
+///
+/// \param pred The predicate that tells whether adjacent keys are equal.
+///
+/// \param op The associative operation to fold values with.
+///
+/// \return The end of the output.
+template<typename In1, typename In2, typename Out,
+         typename BinPred, typename BinOp>
+Out scan_by_key(In1 keys_first, In1 keys_last, In2 values_first, Out res,
+                BinPred pred, BinOp op)
+{
+    typedef typename std::iterator_traits<In1>::value_type K;
+    typedef typename std::iterator_traits<In2>::value_type V;
+    if( keys_first == keys_last ) return res;
+    K prev = *keys_first;
+    V acc = *values_first;
+    *res++ = acc;
+    for( ++keys_first, ++values_first; keys_first != keys_last;
+         ++keys_first, ++values_first ) {
+        K key = *keys_first;
+        acc = pred(prev, key) ? op(acc, *values_first) : *values_first;
+        *res++ = acc;
+        prev = key;
+    }
+    return res;
+}
+
+/// \see scan_by_key(In1, In1, In2, Out, BinPred, BinOp)
+template<typename In1, typename In2, typename Out, typename BinOp>
+Out scan_by_key(In1 keys_first, In1 keys_last, In2 values_first, Out res,
+                BinOp op)
+{
+    typedef typename std::iterator_traits<In1>::value_type K;
+    return wt::scan_by_key(keys_first, keys_last, values_first, res,
+                           std::equal_to<K>(), op);
+}
+
+/// Compute running sums of values within each run of consecutive equal keys.
+///
+/// \see scan_by_key(In1, In1, In2, Out, BinPred, BinOp)
+template<typename In1, typename In2, typename Out>
+Out scan_by_key(In1 keys_first, In1 keys_last, In2 values_first, Out res)
+{
+    typedef typename std::iterator_traits<In2>::value_type V;
+    return wt::scan_by_key(keys_first, keys_last, values_first, res,
+                           std::plus<V>());
+}
+
+// PARALLEL ALGORITHMS
+
+namespace detail {
+
+/// Summarize each block of a range on its own thread, into a copy of an empty
+/// summary such as a sketch, and merge the results.
+template<typename Summary, typename Ran>
+Summary merge_blocks(const parallel_policy& pol, Ran first, Ran last,
+                     const Summary& empty)
+{
+    const std::size_t n = last - first;
+    const unsigned k = detail::thread_count(pol, n);
+    std::vector<Summary> part(k, empty);
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        part[b].add(first + detail::block_begin(n, k, b),
+                    first + detail::block_begin(n, k, b + 1));
+    });
+    for( std::size_t b = 1; b < k; ++b ) part[0].merge(part[b]);
+    return part[0];
+}
+
+} // namespace detail
+
+/// Describe a range of numbers, in parallel.  Each thread summarizes a block
+/// of the range, and the summaries are merged.
+///
+/// \see describe(In, In)
+template<typename Ran>
+summary<typename std::iterator_traits<Ran>::value_type>
+describe(const parallel_policy& pol, Ran first, Ran last)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    return detail::merge_blocks(pol, first, last, summary<value_t>());
+}
+
+/// Compute the inner product of two ranges, in parallel.  Each thread
+/// computes the inner product of a block of the ranges as with wt::unseq,
+/// and the partial results are added to init in block order.
+///
+/// \see inner_product(const unsequenced_policy&, In1, In1, In2, V)
+template<typename Ran1, typename Ran2, typename V>
+V inner_product(const parallel_policy& pol,
+                Ran1 first1, Ran1 last1, Ran2 first2, V init)
+{
+    const std::size_t n = last1 - first1;
+    const unsigned k = detail::thread_count(pol, n);
+    if( k == 1 ) return wt::inner_product(unseq, first1, last1, first2, init);
+    std::vector<V> part(k, V());
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = detail::block_begin(n, k, b);
+        const std::size_t hi = detail::block_begin(n, k, b + 1);
+        part[b] = wt::inner_product(unseq, first1 + lo, first1 + hi,
+                                    first2 + lo, V());
+    });
+    for( std::size_t b = 0; b < k; ++b ) init = init + part[b];
+    return init;
+}
+
+/// Compute the inner products of a query vector with every row of a matrix,
+/// in parallel.  Each thread takes a block of rows.
+///
+/// \see inner_products(Fwd, Fwd, Ran, Ran, Out)
+template<typename Ran1, typename Ran2, typename Ran3>
+Ran3 inner_products(const parallel_policy& pol,
+                    Ran1 first, Ran1 last,
+                    Ran2 rows_first, Ran2 rows_last,
+                    Ran3 res)
+{
+    const std::size_t n = last - first;
+    const std::size_t count = n == 0 ? 0 : (rows_last - rows_first) / n;
+    const unsigned k = detail::thread_count(pol, count * n,
+        std::max<std::size_t>(detail::parallel_grain, n));
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = detail::block_begin(count, k, b);
+        const std::size_t hi = detail::block_begin(count, k, b + 1);
+        detail::inner_products(first, n, rows_first + lo * n, hi - lo,
+                               res + lo, detail::is_dot_contiguous<Ran1,Ran2>());
+    });
+    return res + count;
+}
+
+/// Reduce each run of consecutive equal keys, in parallel.
+///
+/// Each thread takes a block of the keys.  A first pass counts the runs that
+/// start in each block, which places every block's output, and folds the
+/// values at the start of each block that continue a run from an earlier
+/// block.  A second pass reduces the runs that start in each block up to the
+/// block's end.  Last, the continuations carried out of each block are folded,
+/// in order, into the runs they belong to.
+///
+/// The outputs must be _random access iterators_ into storage that can be read
+/// back.
+///
+/// \see reduce_by_key(In1, In1, In2, Out1, Out2, BinPred, BinOp)
+template<typename Ran1, typename Ran2, typename Ran3, typename Ran4,
+         typename BinPred, typename BinOp>
+std::pair<Ran3,Ran4> reduce_by_key(const parallel_policy& pol,
+                                   Ran1 keys_first, Ran1 keys_last,
+                                   Ran2 values_first,
+                                   Ran3 keys_out, Ran4 values_out,
+                                   BinPred pred, BinOp op)
+{
+    typedef typename std::iterator_traits<Ran2>::value_type V;
+    const std::size_t n = keys_last - keys_first;
+    const unsigned k = detail::thread_count(pol, n);
+    if( k == 1 )
+        return wt::reduce_by_key(keys_first, keys_last, values_first,
+                                 keys_out, values_out, pred, op);
+    // Whether position i starts a run.
+    auto head = [&](std::size_t i) {
+        return i == 0 || !pred(keys_first[i - 1], keys_first[i]);
+    };
+    std::vector<std::size_t> runs(k + 1, 0);
+    std::vector<std::size_t> first_head(k);
+    std::vector<V> carry(k);
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = detail::block_begin(n, k, b);
+        const std::size_t hi = detail::block_begin(n, k, b + 1);
+        std::size_t i = lo;
+        for( ; i < hi && !head(i); ++i )
+            carry[b] = i == lo ? values_first[i] : op(carry[b], values_first[i]);
+        first_head[b] = i;
+        std::size_t c = 0;
+        for( ; i < hi; ++i ) c += head(i);
+        runs[b + 1] = c;
+    });
+    for( std::size_t b = 0; b < k; ++b ) runs[b + 1] += runs[b];
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t hi = detail::block_begin(n, k, b + 1);
+        std::size_t out = runs[b];
+        for( std::size_t i = first_head[b]; i < hi; ++out ) {
+            V acc = values_first[i];
+            keys_out[out] = keys_first[i];
+            for( ++i; i < hi && !head(i); ++i ) acc = op(acc, values_first[i]);
+            values_out[out] = acc;
+        }
+    });
+    for( std::size_t b = 1; b < k; ++b )
+        if( first_head[b] != detail::block_begin(n, k, b) )
+            values_out[runs[b] - 1] = op(values_out[runs[b] - 1], carry[b]);
+    return std::make_pair(keys_out + runs[k], values_out + runs[k]);
+}
+
+/// \see reduce_by_key(const parallel_policy&, Ran1, Ran1, Ran2, Ran3, Ran4, BinPred, BinOp)
+template<typename Ran1, typename Ran2, typename Ran3, typename Ran4,
+         typename BinOp>
+std::pair<Ran3,Ran4> reduce_by_key(const parallel_policy& pol,
+                                   Ran1 keys_first, Ran1 keys_last,
+                                   Ran2 values_first,
+                                   Ran3 keys_out, Ran4 values_out,
+                                   BinOp op)
+{
+    typedef typename std::iterator_traits<Ran1>::value_type K;
+    return wt::reduce_by_key(pol, keys_first, keys_last, values_first,
+                             keys_out, values_out, std::equal_to<K>(), op);
+}
+
+/// \see reduce_by_key(const parallel_policy&, Ran1, Ran1, Ran2, Ran3, Ran4, BinPred, BinOp)
+template<typename Ran1, typename Ran2, typename Ran3, typename Ran4>
+std::pair<Ran3,Ran4> reduce_by_key(const parallel_policy& pol,
+                                   Ran1 keys_first, Ran1 keys_last,
+                                   Ran2 values_first,
+                                   Ran3 keys_out, Ran4 values_out)
+{
+    typedef typename std::iterator_traits<Ran2>::value_type V;
+    return wt::reduce_by_key(pol, keys_first, keys_last, values_first,
+                             keys_out, values_out, std::plus<V>());
+}
+
+/// Compute the running fold of values within each run of equal keys, in
+/// parallel.
+///
+/// Each thread takes a block of the keys.  A first pass folds the values of
+/// the run that is still open at the end of each block;  chaining these
+/// carries in block order gives each block the fold it continues from.  A
+/// second pass scans every block starting from its carry.
+///
+/// \see scan_by_key(In1, In1, In2, Out, BinPred, BinOp)
+template<typename Ran1, typename Ran2, typename Ran3,
+         typename BinPred, typename BinOp>
+Ran3 scan_by_key(const parallel_policy& pol,
+                 Ran1 keys_first, Ran1 keys_last,
+                 Ran2 values_first,
+                 Ran3 res,
+                 BinPred pred, BinOp op)
+{
+    typedef typename std::iterator_traits<Ran2>::value_type V;
+    const std::size_t n = keys_last - keys_first;
+    const unsigned k = detail::thread_count(pol, n);
+    if( k == 1 )
+        return wt::scan_by_key(keys_first, keys_last, values_first, res,
+                               pred, op);
+    auto head = [&](std::size_t i) {
+        return i == 0 || !pred(keys_first[i - 1], keys_first[i]);
+    };
+    // The fold of the run open at the end of each block, from its head or
+    // the block's start, and whether its head lies in the block.
+    std::vector<V> tail(k);
+    std::vector<char> closed(k);
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = detail::block_begin(n, k, b);
+        std::size_t i = detail::block_begin(n, k, b + 1) - 1;
+        while( i > lo && !head(i) ) --i;
+        closed[b] = head(i);
+        V acc = values_first[i];
+        for( ++i; i < detail::block_begin(n, k, b + 1); ++i )
+            acc = op(acc, values_first[i]);
+        tail[b] = acc;
+    });
+    for( std::size_t b = 1; b < k; ++b )
+        if( !closed[b] ) tail[b] = op(tail[b - 1], tail[b]);
+    detail::parallel_for(k, k, [&](std::size_t b) {
+        const std::size_t lo = detail::block_begin(n, k, b);
+        const std::size_t hi = detail::block_begin(n, k, b + 1);
+        V acc = b != 0 && !head(lo) ? op(tail[b - 1], values_first[lo])
+                                     : V(values_first[lo]);
+        res[lo] = acc;
+        for( std::size_t i = lo + 1; i < hi; ++i ) {
+            acc = head(i) ? V(values_first[i]) : op(acc, values_first[i]);
+            res[i] = acc;
+        }
+    });
+    return res + n;
+}
+
+/// \see scan_by_key(const parallel_policy&, Ran1, Ran1, Ran2, Ran3, BinPred, BinOp)
+template<typename Ran1, typename Ran2, typename Ran3, typename BinOp>
+Ran3 scan_by_key(const parallel_policy& pol,
+                 Ran1 keys_first, Ran1 keys_last,
+                 Ran2 values_first,
+                 Ran3 res,
+                 BinOp op)
+{
+    typedef typename std::iterator_traits<Ran1>::value_type K;
+    return wt::scan_by_key(pol, keys_first, keys_last, values_first, res,
+                           std::equal_to<K>(), op);
+}
+
+/// \see scan_by_key(const parallel_policy&, Ran1, Ran1, Ran2, Ran3, BinPred, BinOp)
+template<typename Ran1, typename Ran2, typename Ran3>
+Ran3 scan_by_key(const parallel_policy& pol,
+                 Ran1 keys_first, Ran1 keys_last,
+                 Ran2 values_first,
+                 Ran3 res)
+{
+    typedef typename std::iterator_traits<Ran2>::value_type V;
+    return wt::scan_by_key(pol, keys_first, keys_last, values_first, res,
+                           std::plus<V>());
+}
+
+/// Estimate the number of distinct elements of a range, in parallel.  Each
+/// thread sketches a block of the range, and the sketches are merged.
+///
+/// \see approx_count_distinct(In, In, unsigned)
+template<typename Ran>
+std::size_t approx_count_distinct(const parallel_policy& pol,
+                                  Ran first, Ran last,
+                                  unsigned precision)
+{
+    const hyperloglog sketch =
+        detail::merge_blocks(pol, first, last, hyperloglog(precision));
+    return static_cast<std::size_t>(std::llround(sketch.estimate()));
+}
+
+/// \see approx_count_distinct(const parallel_policy&, Ran, Ran, unsigned)
+template<typename Ran>
+std::size_t approx_count_distinct(const parallel_policy& pol,
+                                  Ran first, Ran last)
+{
+    return wt::approx_count_distinct(pol, first, last, 12);
+}
+
+/// Summarize the distribution of a range, in parallel.  Each thread sketches
+/// a block of the range, and the sketches are merged.
+///
+/// \see quantile_sketch(In, In, std::size_t)
+template<typename Ran>
+kll_sketch<typename std::iterator_traits<Ran>::value_type>
+quantile_sketch(const parallel_policy& pol, Ran first, Ran last, std::size_t k)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    return detail::merge_blocks(pol, first, last, kll_sketch<value_t>(k));
+}
+
+/// \see quantile_sketch(const parallel_policy&, Ran, Ran, std::size_t)
+template<typename Ran>
+kll_sketch<typename std::iterator_traits<Ran>::value_type>
+quantile_sketch(const parallel_policy& pol, Ran first, Ran last)
+{
+    return wt::quantile_sketch(pol, first, last, 200);
+}
+
+} // namespace wt
+
+#include <wtl/numeric_iseq.hh>
+
 #endif // WTSTL_NUMERIC_HH_
@@ -9,7 +9,12 @@
 /// Matan Nassau <matan.nassau@gmail.com>
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <cstddef>
+#include <numeric>
+#include <utility>
 #include <wtl/iseq.hh>
+#include <wtl/numeric.hh>
+#include <wtl/parallel.hh>
 
 namespace wt {
 
@@ -26,6 +31,7 @@ namespace wt {
 template<typename In, typename V>
 V accumulate(input_sequence_range<In> range, V init)
 {
+    WT_TRACE_ISEQ("accumulate", range);
     return std::accumulate(range.first, range.second, init);
 }
 
@@ -45,24 +51,28 @@ V accumulate(input_sequence_range<In> range, V init)
 template<typename In, typename V, typename BinOp>
 V accumulate(input_sequence_range<In> range, V init, BinOp op)
 {
+    WT_TRACE_ISEQ("accumulate", range);
     return std::accumulate(range.first, range.second, init, op);
 }
 
 template<typename In, typename Out>
 Out adjacent_difference(input_sequence_range<In> range, Out res)
 {
+    WT_TRACE_ISEQ("adjacent_difference", range);
     return std::adjacent_difference(range.first, range.second, res);
 }
 
 template<typename In, typename Out, typename BinOp>
 Out adjacent_difference(input_sequence_range<In> range, Out res, BinOp op)
 {
+    WT_TRACE_ISEQ("adjacent_difference", range);
     return std::adjacent_difference(range.first, range.second, res, op);
 }
 
 template<typename In, typename In2, typename V>
 V inner_product(input_sequence_range<In> range, In2 first2, V init)
 {
+    WT_TRACE_ISEQ("inner_product", range);
     return std::inner_product(range.first, range.second, first2, init);
 }
 
@@ -76,6 +86,7 @@ V inner_product(input_sequence_range<In> range,
                 V init,
                 BinOp1 op1, BinOp2 op2)
 {
+    WT_TRACE_ISEQ("inner_product", range);
     return std::inner_product(range.first, range.second,
                               first2,
                               init,
@@ -85,15 +96,302 @@ V inner_product(input_sequence_range<In> range,
 template<typename In, typename Out>
 Out partial_sum(input_sequence_range<In> range, Out res)
 {
+    WT_TRACE_ISEQ("partial_sum", range);
     return std::partial_sum(range.first, range.second, res);
 }
 
 template<typename In, typename Out, typename BinOp>
 Out partial_sum(input_sequence_range<In> range, Out res, BinOp op)
 {
+    WT_TRACE_ISEQ("partial_sum", range);
     return std::partial_sum(range.first, range.second, res, op);
 }
 
+// WRAPPERS FOR EXTENSION ALGORITHMS
+
+template<typename In, typename In2, typename V>
+V inner_product(const unsequenced_policy& pol,
+                input_sequence_range<In> range,
+                In2 first2,
+                V init)
+{
+    WT_TRACE_ISEQ("inner_product", range);
+    return wt::inner_product(pol, range.first, range.second, first2, init);
+}
+
+template<typename Fwd, typename Ran, typename Out>
+Out inner_products(input_sequence_range<Fwd> query,
+                   input_sequence_range<Ran> rows,
+                   Out res)
+{
+    WT_TRACE_ISEQ("inner_products", query);
+    return wt::inner_products(query.first, query.second,
+                              rows.first, rows.second,
+                              res);
+}
+
+template<typename In>
+summary<typename std::iterator_traits<In>::value_type>
+describe(input_sequence_range<In> range)
+{
+    WT_TRACE_ISEQ("describe", range);
+    return wt::describe(range.first, range.second);
+}
+
+template<typename In>
+std::size_t approx_count_distinct(input_sequence_range<In> range)
+{
+    WT_TRACE_ISEQ("approx_count_distinct", range);
+    return wt::approx_count_distinct(range.first, range.second);
+}
+
+template<typename In>
+std::size_t approx_count_distinct(input_sequence_range<In> range,
+                                  unsigned precision)
+{
+    WT_TRACE_ISEQ("approx_count_distinct", range);
+    return wt::approx_count_distinct(range.first, range.second, precision);
+}
+
+template<typename In>
+kll_sketch<typename std::iterator_traits<In>::value_type>
+quantile_sketch(input_sequence_range<In> range)
+{
+    WT_TRACE_ISEQ("quantile_sketch", range);
+    return wt::quantile_sketch(range.first, range.second);
+}
+
+template<typename In>
+kll_sketch<typename std::iterator_traits<In>::value_type>
+quantile_sketch(input_sequence_range<In> range, std::size_t k)
+{
+    WT_TRACE_ISEQ("quantile_sketch", range);
+    return wt::quantile_sketch(range.first, range.second, k);
+}
+
+template<typename In, typename Agg, typename Out>
+Out sliding_window(input_sequence_range<In> range,
+                   std::size_t w,
+                   Agg agg,
+                   Out res)
+{
+    WT_TRACE_ISEQ("sliding_window", range);
+    return wt::sliding_window(range.first, range.second, w, agg, res);
+}
+
+template<typename In1, typename In2, typename Out1, typename Out2>
+std::pair<Out1,Out2> reduce_by_key(input_sequence_range<In1> keys,
+                                   In2 values_first,
+                                   Out1 keys_out,
+                                   Out2 values_out)
+{
+    WT_TRACE_ISEQ("reduce_by_key", keys);
+    return wt::reduce_by_key(keys.first, keys.second, values_first,
+                             keys_out, values_out);
+}
+
+template<typename In1, typename In2, typename Out1, typename Out2,
+         typename BinOp>
+std::pair<Out1,Out2> reduce_by_key(input_sequence_range<In1> keys,
+                                   In2 values_first,
+                                   Out1 keys_out,
+                                   Out2 values_out,
+                                   BinOp op)
+{
+    WT_TRACE_ISEQ("reduce_by_key", keys);
+    return wt::reduce_by_key(keys.first, keys.second, values_first,
+                             keys_out, values_out, op);
+}
+
+template<typename In1, typename In2, typename Out1, typename Out2,
+         typename BinPred, typename BinOp>
+std::pair<Out1,Out2> reduce_by_key(input_sequence_range<In1> keys,
+                                   In2 values_first,
+                                   Out1 keys_out,
+                                   Out2 values_out,
+                                   BinPred pred,
+                                   BinOp op)
+{
+    WT_TRACE_ISEQ("reduce_by_key", keys);
+    return wt::reduce_by_key(keys.first, keys.second, values_first,
+                             keys_out, values_out, pred, op);
+}
+
+template<typename In1, typename In2, typename Out>
+Out scan_by_key(input_sequence_range<In1> keys, In2 values_first, Out res)
+{
+    WT_TRACE_ISEQ("scan_by_key", keys);
+    return wt::scan_by_key(keys.first, keys.second, values_first, res);
+}
+
+template<typename In1, typename In2, typename Out, typename BinOp>
+Out scan_by_key(input_sequence_range<In1> keys,
+                In2 values_first,
+                Out res,
+                BinOp op)
+{
+    WT_TRACE_ISEQ("scan_by_key", keys);
+    return wt::scan_by_key(keys.first, keys.second, values_first, res, op);
+}
+
+template<typename In1, typename In2, typename Out,
+         typename BinPred, typename BinOp>
+Out scan_by_key(input_sequence_range<In1> keys,
+                In2 values_first,
+                Out res,
+                BinPred pred,
+                BinOp op)
+{
+    WT_TRACE_ISEQ("scan_by_key", keys);
+    return wt::scan_by_key(keys.first, keys.second, values_first, res,
+                           pred, op);
+}
+
+// WRAPPERS FOR PARALLEL ALGORITHMS
+
+template<typename Ran, typename Ran2, typename V>
+V inner_product(const parallel_policy& pol,
+                input_sequence_range<Ran> range,
+                Ran2 first2,
+                V init)
+{
+    WT_TRACE_ISEQ("inner_product", range);
+    return wt::inner_product(pol, range.first, range.second, first2, init);
+}
+
+template<typename Ran1, typename Ran2, typename Ran3>
+Ran3 inner_products(const parallel_policy& pol,
+                    input_sequence_range<Ran1> query,
+                    input_sequence_range<Ran2> rows,
+                    Ran3 res)
+{
+    WT_TRACE_ISEQ("inner_products", query);
+    return wt::inner_products(pol, query.first, query.second,
+                              rows.first, rows.second,
+                              res);
+}
+
+template<typename Ran>
+summary<typename std::iterator_traits<Ran>::value_type>
+describe(const parallel_policy& pol, input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("describe", range);
+    return wt::describe(pol, range.first, range.second);
+}
+
+template<typename Ran>
+std::size_t approx_count_distinct(const parallel_policy& pol,
+                                  input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("approx_count_distinct", range);
+    return wt::approx_count_distinct(pol, range.first, range.second);
+}
+
+template<typename Ran>
+std::size_t approx_count_distinct(const parallel_policy& pol,
+                                  input_sequence_range<Ran> range,
+                                  unsigned precision)
+{
+    WT_TRACE_ISEQ("approx_count_distinct", range);
+    return wt::approx_count_distinct(pol, range.first, range.second,
+                                     precision);
+}
+
+template<typename Ran>
+kll_sketch<typename std::iterator_traits<Ran>::value_type>
+quantile_sketch(const parallel_policy& pol, input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("quantile_sketch", range);
+    return wt::quantile_sketch(pol, range.first, range.second);
+}
+
+template<typename Ran>
+kll_sketch<typename std::iterator_traits<Ran>::value_type>
+quantile_sketch(const parallel_policy& pol,
+                input_sequence_range<Ran> range,
+                std::size_t k)
+{
+    WT_TRACE_ISEQ("quantile_sketch", range);
+    return wt::quantile_sketch(pol, range.first, range.second, k);
+}
+
+template<typename Ran1, typename Ran2, typename Ran3, typename Ran4>
+std::pair<Ran3,Ran4> reduce_by_key(const parallel_policy& pol,
+                                   input_sequence_range<Ran1> keys,
+                                   Ran2 values_first,
+                                   Ran3 keys_out,
+                                   Ran4 values_out)
+{
+    WT_TRACE_ISEQ("reduce_by_key", keys);
+    return wt::reduce_by_key(pol, keys.first, keys.second, values_first,
+                             keys_out, values_out);
+}
+
+template<typename Ran1, typename Ran2, typename Ran3, typename Ran4,
+         typename BinOp>
+std::pair<Ran3,Ran4> reduce_by_key(const parallel_policy& pol,
+                                   input_sequence_range<Ran1> keys,
+                                   Ran2 values_first,
+                                   Ran3 keys_out,
+                                   Ran4 values_out,
+                                   BinOp op)
+{
+    WT_TRACE_ISEQ("reduce_by_key", keys);
+    return wt::reduce_by_key(pol, keys.first, keys.second, values_first,
+                             keys_out, values_out, op);
+}
+
+template<typename Ran1, typename Ran2, typename Ran3, typename Ran4,
+         typename BinPred, typename BinOp>
+std::pair<Ran3,Ran4> reduce_by_key(const parallel_policy& pol,
+                                   input_sequence_range<Ran1> keys,
+                                   Ran2 values_first,
+                                   Ran3 keys_out,
+                                   Ran4 values_out,
+                                   BinPred pred,
+                                   BinOp op)
+{
+    WT_TRACE_ISEQ("reduce_by_key", keys);
+    return wt::reduce_by_key(pol, keys.first, keys.second, values_first,
+                             keys_out, values_out, pred, op);
+}
+
+template<typename Ran1, typename Ran2, typename Ran3>
+Ran3 scan_by_key(const parallel_policy& pol,
+                 input_sequence_range<Ran1> keys,
+                 Ran2 values_first,
+                 Ran3 res)
+{
+    WT_TRACE_ISEQ("scan_by_key", keys);
+    return wt::scan_by_key(pol, keys.first, keys.second, values_first, res);
+}
+
+template<typename Ran1, typename Ran2, typename Ran3, typename BinOp>
+Ran3 scan_by_key(const parallel_policy& pol,
+                 input_sequence_range<Ran1> keys,
+                 Ran2 values_first,
+                 Ran3 res,
+                 BinOp op)
+{
+    WT_TRACE_ISEQ("scan_by_key", keys);
+    return wt::scan_by_key(pol, keys.first, keys.second, values_first, res,
+                           op);
+}
+
+template<typename Ran1, typename Ran2, typename Ran3,
+         typename BinPred, typename BinOp>
+Ran3 scan_by_key(const parallel_policy& pol,
+                 input_sequence_range<Ran1> keys,
+                 Ran2 values_first,
+                 Ran3 res,
+                 BinPred pred,
+                 BinOp op)
+{
+    WT_TRACE_ISEQ("scan_by_key", keys);
+    return wt::scan_by_key(pol, keys.first, keys.second, values_first, res,
+                           pred, op);
+}
+
 } // namespace wt
 
 #endif // NUMERIC_ISEQ_HH_
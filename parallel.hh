@@ -0,0 +1,126 @@
+#ifndef PARALLEL_HH_
+#define PARALLEL_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Parallel algorithms take a parallel_policy as their first argument, in the
+/// spirit of the C++17 execution policies:
+///
+///  wt::remove_if(wt::par, wt::iseq(v), pred);
+///
+/// runs on as many threads as the hardware offers, and
+///
+///  wt::remove_if(wt::par(4), wt::iseq(v), pred);
+///
+/// on at most four.  Inputs too small to be worth splitting run serially on
+/// the calling thread.  Functors passed to a parallel algorithm are invoked
+/// concurrently from several threads and must be safe to call that way.
+///
+/// Algorithms that take an unsequenced_policy, wt::unseq, stay on the calling
+/// thread but may apply their operations in any order.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace wt {
+
+/// Request to run an algorithm on multiple threads.
+struct parallel_policy {
+    parallel_policy() : threads(0) { }
+    explicit parallel_policy(unsigned n) : threads(n) { }
+
+    /// A policy that uses at most n threads.
+    parallel_policy operator()(unsigned n) const { return parallel_policy(n); }
+
+    /// The maximum number of threads to use, or zero for as many as the
+    /// hardware supports.
+    unsigned threads;
+};
+
+/// The default parallel policy.
+const parallel_policy par;
+
+/// Permission for an algorithm to reorder its operations, where the standard
+/// algorithm is specified to apply them in sequence, in exchange for
+/// vectorizing them.  Results of floating-point arithmetic may then differ in
+/// rounding from the sequential algorithm.
+struct unsequenced_policy { };
+
+/// The unsequenced policy.
+const unsequenced_policy unseq = unsequenced_policy();
+
+namespace detail {
+
+/// The smallest number of elements worth handing to a thread of its own.
+const std::size_t parallel_grain = std::size_t(1) << 15;
+
+/// The number of threads to split n elements across, given at least grain
+/// elements per thread.
+inline unsigned thread_count(const parallel_policy& pol,
+                             std::size_t n,
+                             std::size_t grain = parallel_grain)
+{
+    unsigned hw = pol.threads;
+    if( hw == 0 ) hw = std::thread::hardware_concurrency();
+    if( hw == 0 ) hw = 1;
+    const std::size_t useful = grain ? n / grain : n;
+    return static_cast<unsigned>(std::max<std::size_t>(1,
+                                     std::min<std::size_t>(hw, useful)));
+}
+
+/// The offset at which block b of n elements split into k blocks begins.
+inline std::size_t block_begin(std::size_t n, std::size_t k, std::size_t b)
+{
+    return n / k * b + std::min(b, n % k);
+}
+
+/// Invoke f(i) for every i in [0, tasks) using up to threads threads, the
+/// calling thread included.  The first exception thrown by f is rethrown
+/// after all threads have finished.
+template<typename F>
+void parallel_for(std::size_t tasks, unsigned threads, F f)
+{
+    if( threads <= 1 || tasks <= 1 ) {
+        for( std::size_t i = 0; i < tasks; ++i ) f(i);
+        return;
+    }
+    std::atomic<std::size_t> next(0);
+    std::exception_ptr error;
+    std::mutex error_lock;
+    auto work = [&]() {
+        for( std::size_t i = next++; i < tasks; i = next++ ) {
+            try {
+                f(i);
+            } catch( ... ) {
+                std::lock_guard<std::mutex> guard(error_lock);
+                if( !error ) error = std::current_exception();
+                next = tasks;
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    const unsigned spawn = static_cast<unsigned>(
+        std::min<std::size_t>(threads, tasks)) - 1;
+    pool.reserve(spawn);
+    try {
+        for( unsigned t = 0; t < spawn; ++t ) pool.push_back(std::thread(work));
+    } catch( const std::system_error& ) {
+        // Out of threads;  make do with those already running.
+    }
+    work();
+    for( std::size_t t = 0; t < pool.size(); ++t ) pool[t].join();
+    if( error ) std::rethrow_exception(error);
+}
+
+} // namespace detail
+} // namespace wt
+
+#endif // PARALLEL_HH_
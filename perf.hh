@@ -0,0 +1,576 @@
+#ifndef PERF_HH_
+#define PERF_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Measuring why an algorithm call costs what it does.  perf_scope reads the
+/// hardware performance counters of the CPU around a region of code:
+///
+///  wt::perf_counts pc;
+///  {
+///      wt::perf_scope s(pc);
+///      wt::sort(wt::iseq(v));
+///  }
+///  double ipc = pc.ipc();
+///
+/// It uses Linux perf_event_open(2).  Counters the kernel or the CPU doesn't
+/// offer, or all of them where perf is unavailable or not permitted
+/// (perf_event_paranoid, seccomp, other systems), are reported unavailable,
+/// and the elapsed time is measured regardless.
+///
+/// The counting adaptors count the abstract operations of an algorithm
+/// instead:  counting_compare the calls of a comparator, instrumented_iterator
+/// the increments, jumps and dereferences of an iterator, and counted<T> the
+/// copies, moves and comparisons of an element type.  Wrapping iterators or
+/// elements hides them from the fast paths keyed on pointers to arithmetic
+/// types, so the counts describe the generic version of an algorithm.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <wtl/iseq.hh>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace wt {
+
+// HARDWARE COUNTERS
+
+/// The hardware events perf_scope counts.
+enum perf_event {
+    perf_cycles,
+    perf_instructions,
+    perf_branch_misses,
+    perf_l1d_misses,            // Level 1 data cache read misses.
+    perf_llc_misses,            // Last-level cache misses.
+    perf_events_n
+};
+
+inline const char* name_of(perf_event e)
+{
+    switch( e ) {
+    case perf_cycles: return "cycles";
+    case perf_instructions: return "instructions";
+    case perf_branch_misses: return "branch-misses";
+    case perf_l1d_misses: return "L1-dcache-load-misses";
+    case perf_llc_misses: return "LLC-misses";
+    case perf_events_n: break;
+    }
+    return "?";
+}
+
+/// Counts read by a perf_scope.
+struct perf_counts {
+    perf_counts() : ns(0)
+    {
+        for( int e = 0; e < perf_events_n; ++e ) {
+            value[e] = 0;
+            available[e] = false;
+        }
+    }
+
+    /// Whether event e was counted.
+    bool has(perf_event e) const { return available[e]; }
+
+    std::uint64_t operator[](perf_event e) const { return value[e]; }
+
+    /// Instructions per cycle, or zero if either wasn't counted.
+    double ipc() const
+    {
+        return has(perf_cycles) && has(perf_instructions) &&
+               value[perf_cycles] != 0
+             ? static_cast<double>(value[perf_instructions]) /
+               static_cast<double>(value[perf_cycles])
+             : 0.0;
+    }
+
+    std::uint64_t ns;                           // Elapsed time.
+    std::uint64_t value[perf_events_n];         // Zero if not available.
+    bool available[perf_events_n];
+};
+
+/// Counts hardware events from its construction to its destruction, in the
+/// calling thread and the threads it starts meanwhile, such as those of
+/// parallel algorithms.  Only user-space events are counted.  Where the
+/// kernel multiplexes more events than the CPU has counters, the counts are
+/// scaled up from the time each event was actually counted.
+class perf_scope {
+public:
+    /// Start counting;  read() returns the counts so far.
+    perf_scope() : out_(0) { start(); }
+
+    /// Start counting, and store the counts in out on destruction.
+    explicit perf_scope(perf_counts& out) : out_(&out) { start(); }
+
+    ~perf_scope()
+    {
+        if( out_ != 0 ) *out_ = read();
+#if defined(__linux__)
+        for( int e = 0; e < perf_events_n; ++e )
+            if( fd_[e] != -1 ) ::close(fd_[e]);
+#endif
+    }
+
+    /// Whether any hardware event is being counted.
+    bool available() const
+    {
+        for( int e = 0; e < perf_events_n; ++e )
+            if( fd_[e] != -1 ) return true;
+        return false;
+    }
+
+    /// Stop counting until resume().  A scope can be paused around the work
+    /// between the calls it measures, rather than opened anew for each call.
+    void pause()
+    {
+#if defined(__linux__)
+        control(PERF_EVENT_IOC_DISABLE);
+#endif
+    }
+
+    /// Count again after pause().
+    void resume()
+    {
+#if defined(__linux__)
+        control(PERF_EVENT_IOC_ENABLE);
+#endif
+    }
+
+    /// Zero the counts and the elapsed time, paused or not.
+    void reset()
+    {
+#if defined(__linux__)
+        control(PERF_EVENT_IOC_RESET);
+#endif
+        start_ = clock_type::now();
+    }
+
+    /// The counts since construction or reset(), while not paused.  The
+    /// elapsed time includes the pauses.
+    perf_counts read() const
+    {
+        perf_counts pc;
+#if defined(__linux__)
+        for( int e = 0; e < perf_events_n; ++e ) {
+            // The value, the time enabled and the time counting.
+            std::uint64_t v[3];
+            if( fd_[e] == -1 || ::read(fd_[e], v, sizeof(v)) != sizeof(v) ||
+                v[2] == 0 )
+                continue;
+            pc.value[e] = v[2] < v[1]
+                        ? static_cast<std::uint64_t>(
+                              static_cast<double>(v[0]) *
+                              static_cast<double>(v[1]) /
+                              static_cast<double>(v[2]))
+                        : v[0];
+            pc.available[e] = true;
+        }
+#endif
+        pc.ns = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock_type::now() - start_).count());
+        return pc;
+    }
+
+private:
+    typedef std::chrono::steady_clock clock_type;
+
+    perf_scope(const perf_scope&);
+    perf_scope& operator=(const perf_scope&);
+
+    void start()
+    {
+        for( int e = 0; e < perf_events_n; ++e )
+            fd_[e] = open_event(static_cast<perf_event>(e));
+        resume();
+        start_ = clock_type::now();
+    }
+
+#if defined(__linux__)
+    void control(unsigned long request)
+    {
+        for( int e = 0; e < perf_events_n; ++e )
+            if( fd_[e] != -1 ) ::ioctl(fd_[e], request, 0);
+    }
+#endif
+
+    static int open_event(perf_event e)
+    {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        switch( e ) {
+        case perf_cycles:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case perf_instructions:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case perf_branch_misses:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case perf_l1d_misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D |
+                          PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                          PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+            break;
+        case perf_llc_misses:
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case perf_events_n:
+            return -1;
+        }
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1,
+                                          -1, 0));
+#else
+        (void)e;
+        return -1;
+#endif
+    }
+
+    int fd_[perf_events_n];
+    clock_type::time_point start_;
+    perf_counts* out_;
+};
+
+// OPERATION COUNTS
+
+/// Counts of the operations an algorithm applied through the counting
+/// adaptors.  The adaptors are meant for serial calls:  counting_compare and
+/// instrumented_iterator update their counts without synchronization, and
+/// counted<T> counts in the thread that runs the operation.
+struct op_counts {
+    op_counts()
+        : comparisons(0), copies(0), moves(0),
+          increments(0), jumps(0), dereferences(0)
+    {
+    }
+
+    std::uint64_t comparisons;
+    std::uint64_t copies;       // Copy constructions and assignments.
+    std::uint64_t moves;        // Move constructions and assignments.
+    std::uint64_t increments;   // Iterator ++ and --.
+    std::uint64_t jumps;        // Iterator +=, -=, + and -.
+    std::uint64_t dereferences;
+};
+
+inline op_counts operator-(op_counts a, const op_counts& b)
+{
+    a.comparisons -= b.comparisons;
+    a.copies -= b.copies;
+    a.moves -= b.moves;
+    a.increments -= b.increments;
+    a.jumps -= b.jumps;
+    a.dereferences -= b.dereferences;
+    return a;
+}
+
+/// The operations counted<T> elements applied in the calling thread.  The
+/// difference of two readings counts the operations of a call between them.
+inline op_counts& thread_op_counts()
+{
+    static thread_local op_counts counts;
+    return counts;
+}
+
+/// A comparator that counts its calls.
+///
+/// \see count_comparisons()
+template<typename Cmp>
+class counting_compare {
+public:
+    counting_compare(Cmp c, op_counts& counts) : c_(c), counts_(&counts) { }
+
+    template<typename T, typename U>
+    bool operator()(const T& a, const U& b) const
+    {
+        ++counts_->comparisons;
+        return c_(a, b);
+    }
+
+private:
+    Cmp c_;
+    op_counts* counts_;
+};
+
+/// Wrap a comparator so that it counts its calls into counts.
+///
+/// \param c The comparator.
+///
+/// \param counts Where to count.  It must outlive the copies of the
+/// returned comparator the algorithm makes.
+///
+/// \return The counting comparator.
+template<typename Cmp>
+counting_compare<Cmp> count_comparisons(Cmp c, op_counts& counts)
+{
+    return counting_compare<Cmp>(c, counts);
+}
+
+/// An iterator that counts its increments, jumps and dereferences, and
+/// otherwise behaves as the iterator it wraps.
+///
+/// \see instrument()
+template<typename It>
+class instrumented_iterator {
+    typedef std::iterator_traits<It> traits;
+
+public:
+    typedef typename traits::iterator_category iterator_category;
+    typedef typename traits::value_type value_type;
+    typedef typename traits::difference_type difference_type;
+    typedef typename traits::pointer pointer;
+    typedef typename traits::reference reference;
+
+    instrumented_iterator() : it_(), counts_(0) { }
+
+    instrumented_iterator(It it, op_counts& counts)
+        : it_(it), counts_(&counts)
+    {
+    }
+
+    It base() const { return it_; }
+
+    reference operator*() const
+    {
+        ++counts_->dereferences;
+        return *it_;
+    }
+
+    pointer operator->() const
+    {
+        ++counts_->dereferences;
+        return &*it_;
+    }
+
+    reference operator[](difference_type n) const
+    {
+        ++counts_->dereferences;
+        return it_[n];
+    }
+
+    instrumented_iterator& operator++()
+    {
+        ++counts_->increments;
+        ++it_;
+        return *this;
+    }
+
+    instrumented_iterator operator++(int)
+    {
+        instrumented_iterator old(*this);
+        ++*this;
+        return old;
+    }
+
+    instrumented_iterator& operator--()
+    {
+        ++counts_->increments;
+        --it_;
+        return *this;
+    }
+
+    instrumented_iterator operator--(int)
+    {
+        instrumented_iterator old(*this);
+        --*this;
+        return old;
+    }
+
+    instrumented_iterator& operator+=(difference_type n)
+    {
+        ++counts_->jumps;
+        it_ += n;
+        return *this;
+    }
+
+    instrumented_iterator& operator-=(difference_type n)
+    {
+        ++counts_->jumps;
+        it_ -= n;
+        return *this;
+    }
+
+    instrumented_iterator operator+(difference_type n) const
+    {
+        instrumented_iterator res(*this);
+        return res += n;
+    }
+
+    instrumented_iterator operator-(difference_type n) const
+    {
+        instrumented_iterator res(*this);
+        return res -= n;
+    }
+
+    difference_type operator-(const instrumented_iterator& o) const
+    {
+        ++counts_->jumps;
+        return it_ - o.it_;
+    }
+
+    bool operator==(const instrumented_iterator& o) const
+    {
+        return it_ == o.it_;
+    }
+
+    bool operator!=(const instrumented_iterator& o) const
+    {
+        return it_ != o.it_;
+    }
+
+    bool operator<(const instrumented_iterator& o) const
+    {
+        return it_ < o.it_;
+    }
+
+    bool operator>(const instrumented_iterator& o) const
+    {
+        return it_ > o.it_;
+    }
+
+    bool operator<=(const instrumented_iterator& o) const
+    {
+        return it_ <= o.it_;
+    }
+
+    bool operator>=(const instrumented_iterator& o) const
+    {
+        return it_ >= o.it_;
+    }
+
+private:
+    It it_;
+    op_counts* counts_;
+};
+
+template<typename It>
+instrumented_iterator<It>
+operator+(typename instrumented_iterator<It>::difference_type n,
+          const instrumented_iterator<It>& it)
+{
+    return it + n;
+}
+
+/// Wrap an iterator so that it counts its operations into counts.
+///
+/// \param it The iterator.
+///
+/// \param counts Where to count.  It must outlive the iterator and its
+/// copies.
+///
+/// \return The instrumented iterator.
+template<typename It>
+instrumented_iterator<It> instrument(It it, op_counts& counts)
+{
+    return instrumented_iterator<It>(it, counts);
+}
+
+/// Wrap the iterators of a range so that they count their operations into
+/// counts:
+///
+///  wt::op_counts ops;
+///  wt::lower_bound(wt::instrument(wt::iseq(v), ops), 42);
+///
+/// \param range The range.
+///
+/// \param counts Where to count.
+///
+/// \return The range of instrumented iterators.
+template<typename It>
+input_sequence_range<instrumented_iterator<It> >
+instrument(input_sequence_range<It> range, op_counts& counts)
+{
+    return input_sequence_range<instrumented_iterator<It> >(
+        instrumented_iterator<It>(range.first, counts),
+        instrumented_iterator<It>(range.second, counts));
+}
+
+/// An element that counts its copies, moves and comparisons into
+/// thread_op_counts().  A container of counted<T> counts the element
+/// operations of an algorithm, including the ones it makes on the elements
+/// it holds aside, which comparator and iterator adaptors can't see.
+template<typename T>
+class counted {
+public:
+    counted() : v_() { }
+
+    explicit counted(const T& v) : v_(v) { }
+
+    counted(const counted& o) : v_(o.v_) { ++thread_op_counts().copies; }
+
+    counted(counted&& o) : v_(std::move(o.v_)) { ++thread_op_counts().moves; }
+
+    counted& operator=(const counted& o)
+    {
+        ++thread_op_counts().copies;
+        v_ = o.v_;
+        return *this;
+    }
+
+    counted& operator=(counted&& o)
+    {
+        ++thread_op_counts().moves;
+        v_ = std::move(o.v_);
+        return *this;
+    }
+
+    const T& value() const { return v_; }
+
+    friend bool operator<(const counted& a, const counted& b)
+    {
+        ++thread_op_counts().comparisons;
+        return a.v_ < b.v_;
+    }
+
+    friend bool operator>(const counted& a, const counted& b)
+    {
+        return b < a;
+    }
+
+    friend bool operator<=(const counted& a, const counted& b)
+    {
+        return !(b < a);
+    }
+
+    friend bool operator>=(const counted& a, const counted& b)
+    {
+        return !(a < b);
+    }
+
+    friend bool operator==(const counted& a, const counted& b)
+    {
+        ++thread_op_counts().comparisons;
+        return a.v_ == b.v_;
+    }
+
+    friend bool operator!=(const counted& a, const counted& b)
+    {
+        return !(a == b);
+    }
+
+private:
+    T v_;
+};
+
+} // namespace wt
+
+#endif // PERF_HH_
@@ -0,0 +1,359 @@
+#ifndef PIPELINE_HH_
+#define PIPELINE_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Asynchronous input pipelines.  iseq<T>(stream) reads and parses its
+/// values inside the algorithm it is handed to, so the algorithm waits on
+/// every read.  async_iseq<T>(stream) splits the work into stages on their
+/// own threads:  one reads the stream in large chunks, another parses the
+/// chunks into batches of values, and the algorithm consumes the batches on
+/// the calling thread.  Each stage hands its output over double-buffered,
+/// filling one buffer while the next stage works through the other, so
+/// that reading, parsing and computing overlap:
+///
+///  double sum = wt::accumulate(wt::async_iseq<double>(file), 0.0);
+///
+/// The stages are plain threads blocking on the stream.  async_stage is the
+/// building block, for pipelines of other shapes.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <locale>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+#include <wtl/iseq.hh>
+
+namespace wt {
+
+/// A stage of a pipeline:  a thread that fills batches with a producer
+/// function, handing them to the consumer through two buffers.  While the
+/// consumer works through one batch the thread fills the other.
+///
+/// Batch is a container.  The producer is called with an emptied-out batch
+/// to fill, and returns false at the end of its input, in which case the
+/// batch is dropped.  It runs on the stage's thread;  an exception it throws
+/// ends the stage and is rethrown by next() after the batches before it.
+template<typename Batch>
+class async_stage {
+public:
+    typedef std::function<bool(Batch&)> producer;
+
+    explicit async_stage(producer p)
+        : produce_(p), held_(-1), want_(0), done_(false), stop_(false)
+    {
+        full_[0] = full_[1] = false;
+        thread_ = std::thread(&async_stage::run, this);
+    }
+
+    /// Stop the thread, after the batch it is producing, if any.
+    ~async_stage()
+    {
+        cancel();
+        thread_.join();
+    }
+
+    /// Stop producing batches:  the thread ends after the batch it is
+    /// producing, if any, and next() returns null from now on.
+    void cancel()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    /// The next batch, or null at the end.  The batch stays valid until the
+    /// next call, and is then handed back to the producer.
+    Batch* next()
+    {
+        std::unique_lock<std::mutex> lock(m_);
+        if( held_ >= 0 ) {
+            full_[held_] = false;
+            held_ = -1;
+            cv_.notify_all();
+        }
+        while( !full_[want_] && !done_ && !stop_ ) cv_.wait(lock);
+        if( !full_[want_] ) {
+            if( error_ ) std::rethrow_exception(error_);
+            return 0;
+        }
+        held_ = want_;
+        want_ ^= 1;
+        return &buf_[held_];
+    }
+
+private:
+    async_stage(const async_stage&);
+    async_stage& operator=(const async_stage&);
+
+    void run()
+    {
+        for( int i = 0; ; i ^= 1 ) {
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                while( full_[i] && !stop_ ) cv_.wait(lock);
+                if( stop_ ) return;
+            }
+            bool more;
+            try {
+                buf_[i].clear();
+                more = produce_(buf_[i]);
+            } catch( ... ) {
+                std::lock_guard<std::mutex> lock(m_);
+                error_ = std::current_exception();
+                more = false;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_);
+                if( more )
+                    full_[i] = true;
+                else
+                    done_ = true;
+            }
+            cv_.notify_all();
+            if( !more ) return;
+        }
+    }
+
+    producer produce_;
+    Batch buf_[2];
+    bool full_[2];
+    int held_;                          // The batch the consumer has, or -1.
+    int want_;                          // The batch the consumer gets next.
+    bool done_;
+    bool stop_;
+    std::exception_ptr error_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::thread thread_;
+};
+
+namespace detail {
+
+/// A read-only stream buffer over a block of memory.
+template<typename Ch, typename Tr>
+class memory_streambuf : public std::basic_streambuf<Ch,Tr> {
+public:
+    void reset(const Ch* p, std::size_t n)
+    {
+        Ch* q = const_cast<Ch*>(p);
+        this->setg(q, q, q + n);
+    }
+};
+
+/// The stages of an async_iseq():  a reader of chunks of a stream, which end
+/// at whitespace so no value straddles two, and a parser of the chunks.
+template<typename T, typename Ch, typename Tr>
+class async_parse {
+public:
+    async_parse(std::basic_istream<Ch,Tr>& in, std::size_t chunk)
+        : in_(in), chunk_(std::max<std::size_t>(chunk, 1)), parser_(&buf_),
+          failed_(false)
+    {
+        parser_.flags(in.flags());
+        parser_.imbue(in.getloc());
+        reader_.reset(new async_stage<std::vector<Ch> >(
+            std::bind(&async_parse::read, this, std::placeholders::_1)));
+        batches_.reset(new async_stage<std::vector<T> >(
+            std::bind(&async_parse::parse, this, std::placeholders::_1)));
+    }
+
+    /// Cancel the reader first, which unblocks the parser waiting on it.
+    ~async_parse()
+    {
+        reader_->cancel();
+        batches_.reset();
+        reader_.reset();
+    }
+
+    /// The next batch of values, or null at the end.
+    std::vector<T>* next()
+    {
+        return batches_->next();
+    }
+
+private:
+    bool read(std::vector<Ch>& chunk)
+    {
+        chunk.resize(chunk_);
+        in_.read(&chunk[0], chunk_);
+        chunk.resize(in_.gcount());
+        if( chunk.empty() ) return false;
+        const std::ctype<Ch>& ct =
+            std::use_facet<std::ctype<Ch> >(in_.getloc());
+        for( typename Tr::int_type c = in_.rdbuf()->sgetc();
+             !Tr::eq_int_type(c, Tr::eof()) &&
+             !ct.is(std::ctype_base::space, Tr::to_char_type(c));
+             c = in_.rdbuf()->snextc() )
+            chunk.push_back(Tr::to_char_type(c));
+        return true;
+    }
+
+    bool parse(std::vector<T>& values)
+    {
+        if( failed_ ) return false;
+        const std::vector<Ch>* chunk = reader_->next();
+        if( chunk == 0 ) return false;
+        buf_.reset(chunk->data(), chunk->size());
+        parser_.clear();
+        T v;
+        while( parser_ >> v ) values.push_back(v);
+        // A value that fails to parse ends the sequence, as it ends an
+        // istream_iterator's.
+        failed_ = !parser_.eof();
+        return true;
+    }
+
+    std::basic_istream<Ch,Tr>& in_;
+    std::size_t chunk_;
+    memory_streambuf<Ch,Tr> buf_;
+    std::basic_istream<Ch,Tr> parser_;
+    bool failed_;
+    std::unique_ptr<async_stage<std::vector<Ch> > > reader_;
+    std::unique_ptr<async_stage<std::vector<T> > > batches_;
+};
+
+} // namespace detail
+
+/// An _input iterator_ over the values an async_iseq() parses.  Copies
+/// share their position, as copies of std::istream_iterator do;  the
+/// default-constructed iterator is the end.  it++ returns a proxy holding
+/// the value it was at, so *it++ reads that value.
+template<typename T, typename Ch = char, typename Tr = std::char_traits<Ch> >
+class async_istream_iterator {
+public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    async_istream_iterator() : batch_(0), i_(0) { }
+
+    async_istream_iterator(std::basic_istream<Ch,Tr>& in, std::size_t chunk)
+        : stages_(std::make_shared<detail::async_parse<T,Ch,Tr> >(in, chunk)),
+          batch_(0), i_(0)
+    {
+        advance();
+    }
+
+    reference operator*() const { return (*batch_)[i_]; }
+    pointer operator->() const { return &(*batch_)[i_]; }
+
+    async_istream_iterator& operator++()
+    {
+        ++i_;
+        advance();
+        return *this;
+    }
+
+    /// The value an iterator was at before a postfix increment.  The
+    /// increment may hand the value's batch back to the parser, so the value
+    /// is copied out first, as std::istream_iterator copies it.
+    class proxy {
+    public:
+        reference operator*() const { return v_; }
+        pointer operator->() const { return &v_; }
+
+    private:
+        friend class async_istream_iterator;
+
+        explicit proxy(const T& v) : v_(v) { }
+
+        T v_;
+    };
+
+    proxy operator++(int)
+    {
+        proxy old(**this);
+        ++*this;
+        return old;
+    }
+
+    friend bool operator==(const async_istream_iterator& a,
+                           const async_istream_iterator& b)
+    {
+        return a.stages_ == b.stages_;
+    }
+
+    friend bool operator!=(const async_istream_iterator& a,
+                           const async_istream_iterator& b)
+    {
+        return !(a == b);
+    }
+
+private:
+    void advance()
+    {
+        while( batch_ == 0 || i_ == batch_->size() ) {
+            batch_ = stages_->next();
+            i_ = 0;
+            if( batch_ == 0 ) {
+                stages_.reset();
+                return;
+            }
+        }
+    }
+
+    std::shared_ptr<detail::async_parse<T,Ch,Tr> > stages_;
+    const std::vector<T>* batch_;
+    std::size_t i_;
+};
+
+/// Helper function to generate an input_sequence_range over the values of a
+/// stream, read and parsed ahead on background threads.
+///
+/// This is iseq<T>(s) with the stream read in chunks on one thread and the
+/// chunks parsed with operator>> on another, each a chunk ahead of the
+/// algorithm consuming the values.  The range yields the values iseq<T>(s)
+/// would, ending at the end of the stream or at the first value that fails
+/// to parse.  The stream is read to the whitespace after each chunk, so
+/// that no value straddles two.
+///
+/// The stream must outlive the range and its iterators, and must not be
+/// used while they exist.  The threads stop when the last iterator is
+/// destroyed, after the read in progress.
+///
+/// \param s An input stream.
+///
+/// \param T The type of values expected from the input stream s.
+///
+/// \param chunk_bytes The size of the chunks read at a time.
+///
+/// \return A range over the values of the stream.
+///
+/// \see iseq(std::basic_istream<Ch,Tr>&)
+template<typename T, typename Ch, typename Tr>
+input_sequence_range<async_istream_iterator<T,Ch,Tr> >
+async_iseq(std::basic_istream<Ch,Tr>& s, std::size_t chunk_bytes)
+{
+    typedef async_istream_iterator<T,Ch,Tr> iter;
+    return input_sequence_range<iter>(iter(s, chunk_bytes), iter());
+}
+
+/// Helper function to generate an input_sequence_range over the values of a
+/// stream, read and parsed ahead on background threads in chunks of 1 MB.
+///
+/// \see async_iseq(std::basic_istream<Ch,Tr>&, std::size_t)
+template<typename T, typename Ch, typename Tr>
+input_sequence_range<async_istream_iterator<T,Ch,Tr> >
+async_iseq(std::basic_istream<Ch,Tr>& s)
+{
+    return wt::async_iseq<T>(s, std::size_t(1) << 20);
+}
+
+} // namespace wt
+
+#endif // PIPELINE_HH_
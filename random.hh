@@ -0,0 +1,277 @@
+#ifndef RANDOM_HH_
+#define RANDOM_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Random number engines for shuffling and filling sequences.  wyrand and
+/// xoshiro256ss are small, fast engines with 64-bit outputs, good enough for
+/// shuffles and simulations but not for cryptography.  philox4x32 is a
+/// counter-based engine:  its output is a keyed hash of a counter, so any
+/// stretch of the stream can be computed on its own, in any order, which is
+/// what makes parallel fills reproducible.
+///
+/// All three meet the requirements of a uniform random bit generator, and so
+/// work with the distributions of <random>.  bounded() draws an unbiased
+/// integer below a bound with Lemire's multiply-and-reject method, which
+/// avoids the division of the usual modulo-and-reject method in all but a
+/// vanishing fraction of draws.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+namespace wt {
+namespace detail {
+
+/// A bijective 64-bit mix with good avalanche, from splitmix64.
+inline std::uint64_t splitmix64(std::uint64_t& state)
+{
+    std::uint64_t z = state += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/// The high and low halves of the 128-bit product of a and b.
+inline std::uint64_t mul128(std::uint64_t a, std::uint64_t b,
+                            std::uint64_t& lo)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128_t;
+    const uint128_t p = static_cast<uint128_t>(a) * b;
+    lo = static_cast<std::uint64_t>(p);
+    return static_cast<std::uint64_t>(p >> 64);
+#else
+    const std::uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+    const std::uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+    const std::uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi;
+    const std::uint64_t hl = a_hi * b_lo, hh = a_hi * b_hi;
+    const std::uint64_t mid = (ll >> 32) + (lh & 0xffffffff) +
+                              (hl & 0xffffffff);
+    lo = (mid << 32) | (ll & 0xffffffff);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+/// Whether an engine's outputs are uniform over all 64-bit values.
+template<typename Gen>
+struct is_full_64bit
+    : std::integral_constant<bool,
+          Gen::min() == 0 &&
+          Gen::max() == std::numeric_limits<std::uint64_t>::max()> { };
+
+template<typename Gen>
+std::uint64_t bounded(Gen& g, std::uint64_t n, std::true_type)
+{
+    std::uint64_t lo;
+    std::uint64_t hi = detail::mul128(g(), n, lo);
+    if( lo < n ) {
+        const std::uint64_t threshold = (0 - n) % n;
+        while( lo < threshold ) hi = detail::mul128(g(), n, lo);
+    }
+    return hi;
+}
+
+template<typename Gen>
+std::uint64_t bounded(Gen& g, std::uint64_t n, std::false_type)
+{
+    return std::uniform_int_distribution<std::uint64_t>(0, n - 1)(g);
+}
+
+} // namespace detail
+
+/// A uniformly random integer in [0, n), for n > 0.
+///
+/// With an engine whose outputs cover all 64-bit values, such as wyrand,
+/// xoshiro256ss or std::mt19937_64, this is Lemire's method:  the high half
+/// of the 128-bit product of a random word and n is the result, unless the
+/// low half falls in the small biased range, which is then rejected.  Other
+/// engines go through std::uniform_int_distribution.
+///
+/// \param g A uniform random bit generator.
+///
+/// \param n The bound.
+///
+/// \return A random integer less than n.
+template<typename Gen>
+std::uint64_t bounded(Gen& g, std::uint64_t n)
+{
+    return detail::bounded(g, n, detail::is_full_64bit<Gen>());
+}
+
+/// Wang Yi's wyrand:  a 64-bit state stepped by a constant and mixed by a
+/// 128-bit multiply.  Passes BigCrush and PractRand;  its period is 2^64.
+class wyrand {
+public:
+    typedef std::uint64_t result_type;
+
+    explicit wyrand(std::uint64_t seed = 0) : s_(seed) { }
+
+    void seed(std::uint64_t seed) { s_ = seed; }
+
+    static constexpr result_type min() { return 0; }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()()
+    {
+        s_ += 0xa0761d6478bd642full;
+        std::uint64_t lo;
+        const std::uint64_t hi = detail::mul128(s_, s_ ^ 0xe7037ed1a0b428dbull,
+                                                lo);
+        return hi ^ lo;
+    }
+
+    void discard(unsigned long long z)
+    {
+        s_ += 0xa0761d6478bd642full * z;
+    }
+
+private:
+    std::uint64_t s_;
+};
+
+/// Blackman and Vigna's xoshiro256**:  256 bits of state, period 2^256 - 1.
+/// Seeded through splitmix64, as its authors recommend.
+class xoshiro256ss {
+public:
+    typedef std::uint64_t result_type;
+
+    explicit xoshiro256ss(std::uint64_t seed = 0) { this->seed(seed); }
+
+    void seed(std::uint64_t seed)
+    {
+        for( int i = 0; i < 4; ++i ) s_[i] = detail::splitmix64(seed);
+    }
+
+    static constexpr result_type min() { return 0; }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()()
+    {
+        const std::uint64_t res = rotl(s_[1] * 5, 7) * 9;
+        const std::uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rotl(s_[3], 45);
+        return res;
+    }
+
+    void discard(unsigned long long z)
+    {
+        for( ; z != 0; --z ) (*this)();
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t s_[4];
+};
+
+/// Salmon et al.'s Philox4x32-10 counter-based engine.
+///
+/// The engine is a key, the seed, and a stream number.  Word i of a stream is
+/// word i % 4 of the ten-round Philox block of the counter (i / 4, stream),
+/// so that discard() takes constant time, and streams of different numbers
+/// are independent:  generate_random() gives every element its own stream.
+class philox4x32 {
+public:
+    typedef std::uint32_t result_type;
+
+    explicit philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0)
+    {
+        this->seed(seed, stream);
+    }
+
+    void seed(std::uint64_t seed, std::uint64_t stream = 0)
+    {
+        key_[0] = static_cast<std::uint32_t>(seed);
+        key_[1] = static_cast<std::uint32_t>(seed >> 32);
+        stream_ = stream;
+        index_ = 0;
+    }
+
+    static constexpr result_type min() { return 0; }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()()
+    {
+        if( (index_ & 3) == 0 ) refill();
+        return block_[index_++ & 3];
+    }
+
+    void discard(unsigned long long z)
+    {
+        index_ += z;
+        if( (index_ & 3) != 0 ) refill();
+    }
+
+    /// The Philox4x32-10 block of a 128-bit counter under a 64-bit key.
+    static void block(const std::uint32_t ctr[4], const std::uint32_t key[2],
+                      std::uint32_t out[4])
+    {
+        std::uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+        std::uint32_t k0 = key[0], k1 = key[1];
+        for( int round = 0; round < 10; ++round ) {
+            const std::uint64_t p0 = std::uint64_t(0xd2511f53) * c0;
+            const std::uint64_t p1 = std::uint64_t(0xcd9e8d57) * c2;
+            const std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^
+                                     c1 ^ k0;
+            const std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^
+                                     c3 ^ k1;
+            c1 = static_cast<std::uint32_t>(p1);
+            c3 = static_cast<std::uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += 0x9e3779b9;
+            k1 += 0xbb67ae85;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+private:
+    void refill()
+    {
+        const std::uint64_t b = index_ >> 2;
+        const std::uint32_t ctr[4] = {
+            static_cast<std::uint32_t>(b),
+            static_cast<std::uint32_t>(b >> 32),
+            static_cast<std::uint32_t>(stream_),
+            static_cast<std::uint32_t>(stream_ >> 32)
+        };
+        block(ctr, key_, block_);
+    }
+
+    std::uint32_t key_[2];
+    std::uint64_t stream_;
+    std::uint64_t index_;               // Of the next word of the stream.
+    std::uint32_t block_[4];
+};
+
+} // namespace wt
+
+#endif // RANDOM_HH_
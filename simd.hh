@@ -0,0 +1,1256 @@
+#ifndef SIMD_HH_
+#define SIMD_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Vectorized kernels behind the algorithms.  The instruction set is chosen at
+/// compile time from the target flags (-mavx2, -mavx512f, -march=native, ...);
+/// every kernel has a portable scalar fallback, which is also what runs when
+/// WT_NO_SIMD is defined.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if !defined(WT_NO_SIMD)
+#  if defined(__AVX512F__)
+#    define WT_SIMD_AVX512 1
+#  endif
+#  if defined(__AVX512BW__) && defined(__AVX512VBMI2__)
+#    define WT_SIMD_AVX512_VBMI2 1
+#  endif
+#  if defined(__AVX2__)
+#    define WT_SIMD_AVX2 1
+#  endif
+#  if defined(__SSSE3__)
+#    define WT_SIMD_SSSE3 1
+#  endif
+#  if defined(__SSE2__) || defined(_M_X64)
+#    define WT_SIMD_SSE2 1
+#  endif
+#endif
+
+#if defined(WT_SIMD_AVX512) || defined(WT_SIMD_AVX2)
+#  include <immintrin.h>
+#elif defined(WT_SIMD_SSSE3)
+#  include <tmmintrin.h>
+#elif defined(WT_SIMD_SSE2)
+#  include <emmintrin.h>
+#endif
+
+namespace wt {
+namespace detail {
+
+inline unsigned popcount64(std::uint64_t x)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+    unsigned n = 0;
+    for( ; x; x &= x - 1 ) ++n;
+    return n;
+#endif
+}
+
+inline unsigned count_trailing_zeros64(std::uint64_t x)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned n = 0;
+    for( ; !(x & 1); x >>= 1 ) ++n;
+    return n;
+#endif
+}
+
+inline unsigned count_leading_zeros64(std::uint64_t x)
+{
+#if defined(__GNUC__)
+    return x == 0 ? 64 : static_cast<unsigned>(__builtin_clzll(x));
+#else
+    unsigned n = 0;
+    for( std::uint64_t bit = std::uint64_t(1) << 63; bit && !(x & bit);
+         bit >>= 1 )
+        ++n;
+    return n;
+#endif
+}
+
+/// Hint that the cache line holding p will be read soon.
+inline void prefetch_read(const void* p)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(p, 0, 3);
+#elif defined(WT_SIMD_SSE2)
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+/// Hint that the cache line holding p will be written soon.
+inline void prefetch_write(const void* p)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(p, 1, 3);
+#elif defined(WT_SIMD_SSE2)
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+// BYTE GROUP MATCHING
+//
+// The control bytes of flat_hash_set and flat_hash_map are scanned sixteen
+// at a time:  match_byte16() yields a bit for each of the sixteen bytes equal
+// to a given byte, and match_empty16() a bit for each byte with its high bit
+// set.
+
+#if defined(WT_SIMD_SSE2)
+inline unsigned match_byte16(const std::int8_t* group, std::int8_t b)
+{
+    const __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(b))));
+}
+
+inline unsigned match_empty16(const std::int8_t* group)
+{
+    return static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+}
+#else
+inline unsigned match_byte16(const std::int8_t* group, std::int8_t b)
+{
+    unsigned m = 0;
+    for( unsigned i = 0; i < 16; ++i )
+        m |= unsigned(group[i] == b) << i;
+    return m;
+}
+
+inline unsigned match_empty16(const std::int8_t* group)
+{
+    unsigned m = 0;
+    for( unsigned i = 0; i < 16; ++i )
+        m |= unsigned(group[i] < 0) << i;
+    return m;
+}
+#endif
+
+// STREAM COMPACTION
+//
+// compact() copies the elements of a block whose bit is set in a mask to the
+// front of an output block.  Stores are masked to exactly the elements kept,
+// so the output may alias the input (at or before it) and may end exactly
+// where the kept elements end.
+
+/// Vector compress-store for elements of a given byte size.  lanes is zero
+/// when the target has no suitable instructions.
+template<std::size_t Size>
+struct compress_kernel {
+    static const std::size_t lanes = 0;
+    static char* store(const char*, char* dst, std::uint64_t) { return dst; }
+};
+
+#if defined(WT_SIMD_AVX512)
+template<>
+struct compress_kernel<4> {
+    static const std::size_t lanes = 16;
+    static char* store(const char* src, char* dst, std::uint64_t mask)
+    {
+        const __m512i v = _mm512_maskz_compress_epi32(
+            static_cast<__mmask16>(mask), _mm512_loadu_si512(src));
+        const unsigned n = popcount64(mask);
+        _mm512_mask_storeu_epi32(dst, static_cast<__mmask16>((1u << n) - 1), v);
+        return dst + n * 4;
+    }
+};
+
+template<>
+struct compress_kernel<8> {
+    static const std::size_t lanes = 8;
+    static char* store(const char* src, char* dst, std::uint64_t mask)
+    {
+        const __m512i v = _mm512_maskz_compress_epi64(
+            static_cast<__mmask8>(mask), _mm512_loadu_si512(src));
+        const unsigned n = popcount64(mask);
+        _mm512_mask_storeu_epi64(dst, static_cast<__mmask8>((1u << n) - 1), v);
+        return dst + n * 8;
+    }
+};
+#elif defined(WT_SIMD_AVX2)
+/// Lane permutations that move the lanes selected by a mask to the front,
+/// for vectors of 32-bit lanes and of 64-bit lanes (as pairs of 32-bit
+/// lanes).
+struct compress_tables {
+    std::int32_t lanes32[256][8];
+    std::int32_t lanes64[16][8];
+
+    compress_tables()
+    {
+        for( int m = 0; m < 256; ++m ) {
+            int k = 0;
+            for( int i = 0; i < 8; ++i )
+                if( m & (1 << i) ) lanes32[m][k++] = i;
+            for( ; k < 8; ++k ) lanes32[m][k] = 0;
+        }
+        for( int m = 0; m < 16; ++m ) {
+            int k = 0;
+            for( int i = 0; i < 4; ++i )
+                if( m & (1 << i) ) {
+                    lanes64[m][k++] = 2 * i;
+                    lanes64[m][k++] = 2 * i + 1;
+                }
+            for( ; k < 8; ++k ) lanes64[m][k] = 0;
+        }
+    }
+
+    static const compress_tables& get()
+    {
+        static const compress_tables tables;
+        return tables;
+    }
+};
+
+template<>
+struct compress_kernel<4> {
+    static const std::size_t lanes = 8;
+    static char* store(const char* src, char* dst, std::uint64_t mask)
+    {
+        const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+            compress_tables::get().lanes32[mask]));
+        const __m256i v = _mm256_permutevar8x32_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), idx);
+        const unsigned n = popcount64(mask);
+        const __m256i keep = _mm256_cmpgt_epi32(
+            _mm256_set1_epi32(static_cast<int>(n)),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        _mm256_maskstore_epi32(reinterpret_cast<int*>(dst), keep, v);
+        return dst + n * 4;
+    }
+};
+
+template<>
+struct compress_kernel<8> {
+    static const std::size_t lanes = 4;
+    static char* store(const char* src, char* dst, std::uint64_t mask)
+    {
+        const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+            compress_tables::get().lanes64[mask]));
+        const __m256i v = _mm256_permutevar8x32_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), idx);
+        const unsigned n = popcount64(mask);
+        const __m256i keep = _mm256_cmpgt_epi64(
+            _mm256_set1_epi64x(n), _mm256_setr_epi64x(0, 1, 2, 3));
+        _mm256_maskstore_epi64(reinterpret_cast<long long*>(dst), keep, v);
+        return dst + n * 8;
+    }
+};
+#endif
+
+#if defined(WT_SIMD_AVX512_VBMI2)
+template<>
+struct compress_kernel<1> {
+    static const std::size_t lanes = 64;
+    static char* store(const char* src, char* dst, std::uint64_t mask)
+    {
+        const __m512i v = _mm512_maskz_compress_epi8(mask,
+                                                     _mm512_loadu_si512(src));
+        const unsigned n = popcount64(mask);
+        const std::uint64_t out = n == 64 ? ~std::uint64_t(0)
+                                          : (std::uint64_t(1) << n) - 1;
+        _mm512_mask_storeu_epi8(dst, out, v);
+        return dst + n;
+    }
+};
+
+template<>
+struct compress_kernel<2> {
+    static const std::size_t lanes = 32;
+    static char* store(const char* src, char* dst, std::uint64_t mask)
+    {
+        const __m512i v = _mm512_maskz_compress_epi16(
+            static_cast<__mmask32>(mask), _mm512_loadu_si512(src));
+        const unsigned n = popcount64(mask);
+        _mm512_mask_storeu_epi16(dst,
+            static_cast<__mmask32>((std::uint64_t(1) << n) - 1), v);
+        return dst + n * 2;
+    }
+};
+#endif
+
+/// Copy src[i] for every i in [0, n) for which keep(i) holds to consecutive
+/// positions starting at dst, preserving their order.  keep is called exactly
+/// once for each index, in increasing order.  dst may equal src, or precede
+/// it.
+///
+/// \return One past the last element written.
+template<typename T, typename Keep>
+T* compact(const T* src, std::size_t n, T* dst, Keep keep)
+{
+    typedef compress_kernel<sizeof(T)> kernel;
+    const bool in_place = dst == src;
+    std::size_t i = 0;
+    if( kernel::lanes != 0 ) {
+        for( ; i + kernel::lanes <= n; i += kernel::lanes ) {
+            std::uint64_t mask = 0;
+            for( std::size_t j = 0; j < kernel::lanes; ++j )
+                mask |= std::uint64_t(keep(i + j) ? 1 : 0) << j;
+            dst = reinterpret_cast<T*>(kernel::store(
+                reinterpret_cast<const char*>(src + i),
+                reinterpret_cast<char*>(dst), mask));
+        }
+    }
+    if( !in_place ) {
+        for( ; i < n; ++i )
+            if( keep(i) ) *dst++ = src[i];
+        return dst;
+    }
+    // In place, so the output has room for every element:  write each one
+    // without a branch, advancing the output only past those kept.
+    for( ; i < n; ++i ) {
+        const T v = src[i];
+        const bool k = keep(i);
+        *dst = v;
+        dst += k;
+    }
+    return dst;
+}
+
+/// Like compact(), but with the elements to keep given as a bit mask:  bit
+/// i % 64 of bits[i / 64], XORed with flip, selects src[i].  flip is zero to
+/// keep the elements whose bits are set, or all ones to keep the others.
+template<typename T>
+T* compact_bits(const T* src, std::size_t n, T* dst,
+                const std::uint64_t* bits, std::uint64_t flip)
+{
+    typedef compress_kernel<sizeof(T)> kernel;
+    std::size_t i = 0;
+    if( kernel::lanes != 0 ) {
+        const std::uint64_t lanes = kernel::lanes == 64
+                                  ? ~std::uint64_t(0)
+                                  : (std::uint64_t(1) << kernel::lanes) - 1;
+        for( ; i + kernel::lanes <= n; i += kernel::lanes ) {
+            const std::uint64_t mask = (bits[i / 64] ^ flip) >> (i % 64);
+            dst = reinterpret_cast<T*>(kernel::store(
+                reinterpret_cast<const char*>(src + i),
+                reinterpret_cast<char*>(dst), mask & lanes));
+        }
+    }
+    for( ; i < n; ++i )
+        if( ((bits[i / 64] ^ flip) >> (i % 64)) & 1 ) *dst++ = src[i];
+    return dst;
+}
+
+// ELEMENT-WISE COMPARISON
+//
+// find_equality() scans two arrays in lockstep for the first position at
+// which the elements compare equal, or unequal.  Comparisons are by value, as
+// with operator==, so 0.0 equals -0.0 and NaN equals nothing.
+
+/// Vector equality comparison of elements of a given byte size, integral or
+/// floating point.  mask() yields stride bits for each of lanes lanes, set
+/// where the elements compare equal.  lanes is zero when the target has no
+/// suitable instructions.
+template<std::size_t Size, bool Float>
+struct equal_kernel {
+    static const std::size_t lanes = 0;
+    static const std::size_t stride = 1;
+    static std::uint64_t mask(const char*, const char*) { return 0; }
+};
+
+#if defined(WT_SIMD_AVX512)
+#define WT_EQUAL_KERNEL(Size, Float, Lanes, Cmp)                            \
+template<>                                                                  \
+struct equal_kernel<Size,Float> {                                           \
+    static const std::size_t lanes = Lanes;                                 \
+    static const std::size_t stride = 1;                                    \
+    static std::uint64_t mask(const char* a, const char* b)                 \
+    {                                                                       \
+        return Cmp;                                                         \
+    }                                                                       \
+}
+
+#if defined(__AVX512BW__)
+WT_EQUAL_KERNEL(1, false, 64, _mm512_cmpeq_epi8_mask(
+    _mm512_loadu_si512(a), _mm512_loadu_si512(b)));
+WT_EQUAL_KERNEL(2, false, 32, _mm512_cmpeq_epi16_mask(
+    _mm512_loadu_si512(a), _mm512_loadu_si512(b)));
+#endif
+WT_EQUAL_KERNEL(4, false, 16, _mm512_cmpeq_epi32_mask(
+    _mm512_loadu_si512(a), _mm512_loadu_si512(b)));
+WT_EQUAL_KERNEL(8, false, 8, _mm512_cmpeq_epi64_mask(
+    _mm512_loadu_si512(a), _mm512_loadu_si512(b)));
+WT_EQUAL_KERNEL(4, true, 16, _mm512_cmp_ps_mask(
+    _mm512_loadu_ps(a), _mm512_loadu_ps(b), _CMP_EQ_OQ));
+WT_EQUAL_KERNEL(8, true, 8, _mm512_cmp_pd_mask(
+    _mm512_loadu_pd(a), _mm512_loadu_pd(b), _CMP_EQ_OQ));
+
+#undef WT_EQUAL_KERNEL
+#endif
+
+#if defined(WT_SIMD_AVX2)
+#define WT_EQUAL_KERNEL(Size, Float, Lanes, Stride, Cmp)                    \
+template<>                                                                  \
+struct equal_kernel<Size,Float> {                                           \
+    static const std::size_t lanes = Lanes;                                 \
+    static const std::size_t stride = Stride;                               \
+    static std::uint64_t mask(const char* a, const char* b)                 \
+    {                                                                       \
+        const __m256i x = _mm256_loadu_si256(                               \
+            reinterpret_cast<const __m256i*>(a));                           \
+        const __m256i y = _mm256_loadu_si256(                               \
+            reinterpret_cast<const __m256i*>(b));                           \
+        return static_cast<std::uint32_t>(Cmp);                             \
+    }                                                                       \
+}
+
+#if !defined(WT_SIMD_AVX512) || !defined(__AVX512BW__)
+WT_EQUAL_KERNEL(1, false, 32, 1,
+    _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+WT_EQUAL_KERNEL(2, false, 16, 2,
+    _mm256_movemask_epi8(_mm256_cmpeq_epi16(x, y)));
+#endif
+#if !defined(WT_SIMD_AVX512)
+WT_EQUAL_KERNEL(4, false, 8, 1, _mm256_movemask_ps(
+    _mm256_castsi256_ps(_mm256_cmpeq_epi32(x, y))));
+WT_EQUAL_KERNEL(8, false, 4, 1, _mm256_movemask_pd(
+    _mm256_castsi256_pd(_mm256_cmpeq_epi64(x, y))));
+WT_EQUAL_KERNEL(4, true, 8, 1, _mm256_movemask_ps(_mm256_cmp_ps(
+    _mm256_castsi256_ps(x), _mm256_castsi256_ps(y), _CMP_EQ_OQ)));
+WT_EQUAL_KERNEL(8, true, 4, 1, _mm256_movemask_pd(_mm256_cmp_pd(
+    _mm256_castsi256_pd(x), _mm256_castsi256_pd(y), _CMP_EQ_OQ)));
+#endif
+
+#undef WT_EQUAL_KERNEL
+#endif
+
+/// The first index i in [0, n) for which (a[i] == b[i]) == equal, or n if
+/// there is none.
+template<typename T>
+std::size_t find_equality(const T* a, const T* b, std::size_t n, bool equal)
+{
+    typedef equal_kernel<sizeof(T), std::is_floating_point<T>::value> kernel;
+    std::size_t i = 0;
+    if( kernel::lanes != 0 ) {
+        const std::size_t bits = kernel::lanes * kernel::stride;
+        const std::uint64_t all = bits == 64 ? ~std::uint64_t(0)
+                                             : (std::uint64_t(1) << bits) - 1;
+        for( ; i + kernel::lanes <= n; i += kernel::lanes ) {
+            std::uint64_t m = kernel::mask(reinterpret_cast<const char*>(a + i),
+                                           reinterpret_cast<const char*>(b + i));
+            if( !equal ) m = ~m & all;
+            if( m != 0 ) return i + count_trailing_zeros64(m) / kernel::stride;
+        }
+    }
+    for( ; i < n; ++i )
+        if( (a[i] == b[i]) == equal ) return i;
+    return n;
+}
+
+// DOT PRODUCTS
+//
+// dot(), dot1() and dot4() sum the products of arrays in whatever order is fastest:
+// several vector accumulators hide the latency of the multiply-adds, and are
+// added up at the end.  Floating-point results may differ from a sequential
+// loop in the last bits.  Products of int8 elements are summed exactly, in
+// 32-bit integers.
+
+template<typename T>
+struct dot_result { typedef T type; };
+
+template<>
+struct dot_result<std::int8_t> { typedef std::int32_t type; };
+
+/// Vector multiply-accumulate of elements of type T.  step() adds the
+/// products of lanes elements of a and b to an accumulator, and sum() adds up
+/// the accumulator's lanes.  lanes is zero when the target has no suitable
+/// instructions.
+template<typename T>
+struct dot_kernel {
+    typedef typename dot_result<T>::type acc;
+    static const std::size_t lanes = 0;
+    static acc zero() { return acc(); }
+    static acc step(acc s, const T*, const T*) { return s; }
+    static acc add(acc x, acc y) { return x + y; }
+    static acc sum(acc s) { return s; }
+};
+
+#if defined(WT_SIMD_AVX512)
+template<>
+struct dot_kernel<float> {
+    typedef __m512 acc;
+    static const std::size_t lanes = 16;
+    static acc zero() { return _mm512_setzero_ps(); }
+    static acc step(acc s, const float* a, const float* b)
+    {
+        return _mm512_fmadd_ps(_mm512_loadu_ps(a), _mm512_loadu_ps(b), s);
+    }
+    static acc add(acc x, acc y) { return _mm512_add_ps(x, y); }
+    static float sum(acc s)
+    {
+        // Fold the halves, then the quarters.  The masked shuffles spare
+        // GCC's false uninitialized warnings for the unmasked ones.
+        s = _mm512_add_ps(s, _mm512_mask_shuffle_f32x4(s, 0xffff, s, s,
+            _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm512_add_ps(s, _mm512_mask_shuffle_f32x4(s, 0xffff, s, s,
+            _MM_SHUFFLE(2, 3, 0, 1)));
+        float t[16];
+        _mm512_storeu_ps(t, s);
+        return (t[0] + t[1]) + (t[2] + t[3]);
+    }
+};
+
+template<>
+struct dot_kernel<double> {
+    typedef __m512d acc;
+    static const std::size_t lanes = 8;
+    static acc zero() { return _mm512_setzero_pd(); }
+    static acc step(acc s, const double* a, const double* b)
+    {
+        return _mm512_fmadd_pd(_mm512_loadu_pd(a), _mm512_loadu_pd(b), s);
+    }
+    static acc add(acc x, acc y) { return _mm512_add_pd(x, y); }
+    static double sum(acc s)
+    {
+        s = _mm512_add_pd(s, _mm512_mask_shuffle_f64x2(s, 0xff, s, s,
+            _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm512_add_pd(s, _mm512_mask_shuffle_f64x2(s, 0xff, s, s,
+            _MM_SHUFFLE(2, 3, 0, 1)));
+        double t[8];
+        _mm512_storeu_pd(t, s);
+        return t[0] + t[1];
+    }
+};
+#elif defined(WT_SIMD_AVX2)
+template<>
+struct dot_kernel<float> {
+    typedef __m256 acc;
+    static const std::size_t lanes = 8;
+    static acc zero() { return _mm256_setzero_ps(); }
+    static acc step(acc s, const float* a, const float* b)
+    {
+#if defined(__FMA__)
+        return _mm256_fmadd_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b), s);
+#else
+        return _mm256_add_ps(s,
+            _mm256_mul_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b)));
+#endif
+    }
+    static acc add(acc x, acc y) { return _mm256_add_ps(x, y); }
+    static float sum(acc s)
+    {
+        float t[8];
+        _mm256_storeu_ps(t, s);
+        return ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7]));
+    }
+};
+
+template<>
+struct dot_kernel<double> {
+    typedef __m256d acc;
+    static const std::size_t lanes = 4;
+    static acc zero() { return _mm256_setzero_pd(); }
+    static acc step(acc s, const double* a, const double* b)
+    {
+#if defined(__FMA__)
+        return _mm256_fmadd_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b), s);
+#else
+        return _mm256_add_pd(s,
+            _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+#endif
+    }
+    static acc add(acc x, acc y) { return _mm256_add_pd(x, y); }
+    static double sum(acc s)
+    {
+        double t[4];
+        _mm256_storeu_pd(t, s);
+        return (t[0] + t[1]) + (t[2] + t[3]);
+    }
+};
+#elif defined(WT_SIMD_SSE2)
+template<>
+struct dot_kernel<float> {
+    typedef __m128 acc;
+    static const std::size_t lanes = 4;
+    static acc zero() { return _mm_setzero_ps(); }
+    static acc step(acc s, const float* a, const float* b)
+    {
+        return _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+    }
+    static acc add(acc x, acc y) { return _mm_add_ps(x, y); }
+    static float sum(acc s)
+    {
+        float t[4];
+        _mm_storeu_ps(t, s);
+        return (t[0] + t[1]) + (t[2] + t[3]);
+    }
+};
+
+template<>
+struct dot_kernel<double> {
+    typedef __m128d acc;
+    static const std::size_t lanes = 2;
+    static acc zero() { return _mm_setzero_pd(); }
+    static acc step(acc s, const double* a, const double* b)
+    {
+        return _mm_add_pd(s, _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+    }
+    static acc add(acc x, acc y) { return _mm_add_pd(x, y); }
+    static double sum(acc s)
+    {
+        double t[2];
+        _mm_storeu_pd(t, s);
+        return t[0] + t[1];
+    }
+};
+#endif
+
+#if defined(WT_SIMD_AVX512) && defined(__AVX512BW__)
+template<>
+struct dot_kernel<std::int8_t> {
+    typedef __m512i acc;
+    static const std::size_t lanes = 32;
+    static acc zero() { return _mm512_setzero_si512(); }
+    static acc step(acc s, const std::int8_t* a, const std::int8_t* b)
+    {
+        const __m512i x = _mm512_cvtepi8_epi16(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)));
+        const __m512i y = _mm512_cvtepi8_epi16(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+        return _mm512_add_epi32(s, _mm512_madd_epi16(x, y));
+    }
+    static acc add(acc x, acc y) { return _mm512_add_epi32(x, y); }
+    static std::int32_t sum(acc s)
+    {
+        s = _mm512_add_epi32(s, _mm512_mask_shuffle_i32x4(s, 0xffff, s, s,
+            _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm512_add_epi32(s, _mm512_mask_shuffle_i32x4(s, 0xffff, s, s,
+            _MM_SHUFFLE(2, 3, 0, 1)));
+        std::int32_t t[16];
+        _mm512_storeu_si512(t, s);
+        return t[0] + t[1] + t[2] + t[3];
+    }
+};
+#elif defined(WT_SIMD_AVX2)
+template<>
+struct dot_kernel<std::int8_t> {
+    typedef __m256i acc;
+    static const std::size_t lanes = 16;
+    static acc zero() { return _mm256_setzero_si256(); }
+    static acc step(acc s, const std::int8_t* a, const std::int8_t* b)
+    {
+        const __m256i x = _mm256_cvtepi8_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a)));
+        const __m256i y = _mm256_cvtepi8_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+        return _mm256_add_epi32(s, _mm256_madd_epi16(x, y));
+    }
+    static acc add(acc x, acc y) { return _mm256_add_epi32(x, y); }
+    static std::int32_t sum(acc s)
+    {
+        std::int32_t t[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(t), s);
+        return t[0] + t[1] + t[2] + t[3] + t[4] + t[5] + t[6] + t[7];
+    }
+};
+#elif defined(WT_SIMD_SSE2)
+template<>
+struct dot_kernel<std::int8_t> {
+    typedef __m128i acc;
+    static const std::size_t lanes = 8;
+    static acc zero() { return _mm_setzero_si128(); }
+    static acc step(acc s, const std::int8_t* a, const std::int8_t* b)
+    {
+        // Sign-extend eight bytes to 16 bits by unpacking each byte into
+        // the high half of a lane and shifting it down arithmetically.
+        __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a));
+        __m128i y = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b));
+        x = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+        y = _mm_srai_epi16(_mm_unpacklo_epi8(y, y), 8);
+        return _mm_add_epi32(s, _mm_madd_epi16(x, y));
+    }
+    static acc add(acc x, acc y) { return _mm_add_epi32(x, y); }
+    static std::int32_t sum(acc s)
+    {
+        std::int32_t t[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(t), s);
+        return t[0] + t[1] + t[2] + t[3];
+    }
+};
+#endif
+
+/// The sum of a[i] * b[i] for i in [0, n), in any order.
+template<typename T>
+typename dot_result<T>::type dot(const T* a, const T* b, std::size_t n)
+{
+    typedef dot_kernel<T> kernel;
+    typedef typename dot_result<T>::type R;
+    const std::size_t w = kernel::lanes;
+    std::size_t i = 0;
+    R r = R();
+    if( w != 0 ) {
+        typename kernel::acc s0 = kernel::zero(), s1 = s0, s2 = s0, s3 = s0;
+        for( ; i + 4 * w <= n; i += 4 * w ) {
+            s0 = kernel::step(s0, a + i, b + i);
+            s1 = kernel::step(s1, a + i + w, b + i + w);
+            s2 = kernel::step(s2, a + i + 2 * w, b + i + 2 * w);
+            s3 = kernel::step(s3, a + i + 3 * w, b + i + 3 * w);
+        }
+        for( ; i + w <= n; i += w ) s0 = kernel::step(s0, a + i, b + i);
+        r = kernel::sum(kernel::add(kernel::add(s0, s1), kernel::add(s2, s3)));
+    }
+    R t[4] = { };
+    for( ; i + 4 <= n; i += 4 )
+        for( std::size_t j = 0; j < 4; ++j ) t[j] += R(a[i + j]) * R(b[i + j]);
+    for( ; i < n; ++i ) t[0] += R(a[i]) * R(b[i]);
+    return r + ((t[0] + t[1]) + (t[2] + t[3]));
+}
+
+/// The dot product of q with the row of n elements at r, with a single
+/// accumulator.  Agrees exactly with each result of dot4().
+template<typename T>
+typename dot_result<T>::type dot1(const T* q, const T* r, std::size_t n)
+{
+    typedef dot_kernel<T> kernel;
+    typedef typename dot_result<T>::type R;
+    const std::size_t w = kernel::lanes;
+    std::size_t i = 0;
+    R t = R();
+    if( w != 0 ) {
+        typename kernel::acc s = kernel::zero();
+        for( ; i + w <= n; i += w ) s = kernel::step(s, q + i, r + i);
+        t = kernel::sum(s);
+    }
+    for( ; i < n; ++i ) t += R(q[i]) * R(r[i]);
+    return t;
+}
+
+/// The dot products of q with the four rows of n elements at r, r + stride,
+/// r + 2 * stride and r + 3 * stride.  Each vector of q is loaded once for
+/// all four rows.
+template<typename T>
+void dot4(const T* q, const T* r, std::size_t stride, std::size_t n,
+          typename dot_result<T>::type* out)
+{
+    typedef dot_kernel<T> kernel;
+    typedef typename dot_result<T>::type R;
+    const T* r0 = r;
+    const T* r1 = r + stride;
+    const T* r2 = r + 2 * stride;
+    const T* r3 = r + 3 * stride;
+    const std::size_t w = kernel::lanes;
+    std::size_t i = 0;
+    R t0 = R(), t1 = R(), t2 = R(), t3 = R();
+    if( w != 0 ) {
+        typename kernel::acc s0 = kernel::zero(), s1 = s0, s2 = s0, s3 = s0;
+        for( ; i + w <= n; i += w ) {
+            s0 = kernel::step(s0, q + i, r0 + i);
+            s1 = kernel::step(s1, q + i, r1 + i);
+            s2 = kernel::step(s2, q + i, r2 + i);
+            s3 = kernel::step(s3, q + i, r3 + i);
+        }
+        t0 = kernel::sum(s0);
+        t1 = kernel::sum(s1);
+        t2 = kernel::sum(s2);
+        t3 = kernel::sum(s3);
+    }
+    for( ; i < n; ++i ) {
+        t0 += R(q[i]) * R(r0[i]);
+        t1 += R(q[i]) * R(r1[i]);
+        t2 += R(q[i]) * R(r2[i]);
+        t3 += R(q[i]) * R(r3[i]);
+    }
+    out[0] = t0;
+    out[1] = t1;
+    out[2] = t2;
+    out[3] = t3;
+}
+
+// PREFIX SUMS
+//
+// prefix_sum() adds up a running total of 4- or 8-byte integers a vector at a
+// time:  each vector is summed in place in log2(lanes) shift-and-add steps,
+// and the total so far is broadcast into the next.
+
+/// Write carry + src[0] + ... + src[i] to dst[i] for every i in [0, n), with
+/// wrap-around arithmetic.  dst may equal src.
+///
+/// \return The last sum written, or carry if n is zero.
+template<typename T>
+T prefix_sum(const T* src, std::size_t n, T* dst, T carry)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    std::size_t i = 0;
+#if defined(WT_SIMD_SSE2)
+    if( sizeof(T) == 4 || sizeof(T) == 8 ) {
+        const std::size_t lanes = 16 / sizeof(T);
+        __m128i c = sizeof(T) == 4
+            ? _mm_set1_epi32(static_cast<int>(carry))
+            : _mm_set1_epi64x(static_cast<long long>(carry));
+        for( ; i + lanes <= n; i += lanes ) {
+            __m128i x = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(src + i));
+            if( sizeof(T) == 4 ) {
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+                x = _mm_add_epi32(x, c);
+                c = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+            } else {
+                x = _mm_add_epi64(x, _mm_slli_si128(x, 8));
+                x = _mm_add_epi64(x, c);
+                c = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 2, 3, 2));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), x);
+        }
+        if( i != 0 ) carry = dst[i - 1];
+    }
+#endif
+    U sum = static_cast<U>(carry);
+    for( ; i < n; ++i ) {
+        sum += static_cast<U>(src[i]);
+        dst[i] = static_cast<T>(sum);
+    }
+    return static_cast<T>(sum);
+}
+
+// STREAM VBYTE
+//
+// Stream VByte stores each 32-bit integer in one to four bytes, and the byte
+// counts of four integers in a control byte kept apart from the data.  A
+// control byte selects a shuffle that spreads the next data bytes over four
+// 32-bit lanes, which decodes four integers with one shuffle instruction.
+
+#if defined(WT_SIMD_SSSE3)
+/// Shuffle masks and data lengths for every control byte.
+struct stream_vbyte_tables {
+    std::uint8_t shuffle[256][16];
+    std::uint8_t length[256];
+
+    stream_vbyte_tables()
+    {
+        for( int c = 0; c < 256; ++c ) {
+            int at = 0;
+            for( int i = 0; i < 4; ++i ) {
+                const int len = ((c >> (2 * i)) & 3) + 1;
+                for( int j = 0; j < 4; ++j )
+                    shuffle[c][4 * i + j] = static_cast<std::uint8_t>(
+                        j < len ? at + j : 0x80);
+                at += len;
+            }
+            length[c] = static_cast<std::uint8_t>(at);
+        }
+    }
+
+    static const stream_vbyte_tables& get()
+    {
+        static const stream_vbyte_tables tables;
+        return tables;
+    }
+};
+#endif
+
+/// Decode the four integers described by control byte ctrl from data into
+/// out.  Reads 16 bytes from data, whatever their lengths, when vectorized.
+///
+/// \return The data following the four integers.
+inline const std::uint8_t* stream_vbyte_decode4(std::uint8_t ctrl,
+                                                const std::uint8_t* data,
+                                                std::uint32_t* out)
+{
+#if defined(WT_SIMD_SSSE3)
+    const stream_vbyte_tables& t = stream_vbyte_tables::get();
+    const __m128i v = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(t.shuffle[ctrl])));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+    return data + t.length[ctrl];
+#else
+    for( int i = 0; i < 4; ++i ) {
+        const int len = ((ctrl >> (2 * i)) & 3) + 1;
+        std::uint32_t v = 0;
+        for( int j = 0; j < len; ++j )
+            v |= static_cast<std::uint32_t>(data[j]) << (8 * j);
+        out[i] = v;
+        data += len;
+    }
+    return data;
+#endif
+}
+
+// REVERSAL AND BULK MOVES
+//
+// reverse_elements() and reverse_copy_elements() reverse arrays a vector at
+// a time, reversing the lanes of each vector with a permutation.
+// swap_bytes() swaps blocks two vectors at a time.  stream_copy() writes with non-temporal
+// stores, which bypass the cache:  for copies larger than the cache they
+// save reading the destination lines in first, and leave the cache to the
+// data around the copy.
+
+/// Lane reversal for vectors of elements of a given byte size.  lanes is
+/// zero when the target has no suitable instructions.  swap() exchanges the
+/// vectors at a and b, reversing both;  reverse() copies the vector at src
+/// to dst, reversed.
+template<std::size_t Size>
+struct reverse_kernel {
+    static const std::size_t lanes = 0;
+    static void swap(void*, void*) { }
+    static void reverse(void*, const void*) { }
+};
+
+#if defined(WT_SIMD_SSE2)
+inline void load_vector(__m128i& v, const void* p)
+{
+    v = _mm_loadu_si128(static_cast<const __m128i*>(p));
+}
+
+inline void store_vector(void* p, __m128i v)
+{
+    _mm_storeu_si128(static_cast<__m128i*>(p), v);
+}
+#endif
+
+#if defined(WT_SIMD_AVX2)
+inline void load_vector(__m256i& v, const void* p)
+{
+    v = _mm256_loadu_si256(static_cast<const __m256i*>(p));
+}
+
+inline void store_vector(void* p, __m256i v)
+{
+    _mm256_storeu_si256(static_cast<__m256i*>(p), v);
+}
+#endif
+
+#if defined(WT_SIMD_AVX512)
+inline void load_vector(__m512i& v, const void* p)
+{
+    v = _mm512_loadu_si512(p);
+}
+
+inline void store_vector(void* p, __m512i v)
+{
+    _mm512_storeu_si512(p, v);
+}
+#endif
+
+/// The moves of a reverse_kernel, given its vector type and its rev().
+template<typename Kernel>
+struct reverse_moves {
+    static void swap(void* a, void* b)
+    {
+        typename Kernel::vector x, y;
+        load_vector(x, a);
+        load_vector(y, b);
+        store_vector(a, Kernel::rev(y));
+        store_vector(b, Kernel::rev(x));
+    }
+
+    static void reverse(void* dst, const void* src)
+    {
+        typename Kernel::vector x;
+        load_vector(x, src);
+        store_vector(dst, Kernel::rev(x));
+    }
+};
+
+// The masked permutations spare GCC's unmasked ones a spurious warning about
+// their undefined pass-through operand.
+#if defined(WT_SIMD_AVX512)
+template<>
+struct reverse_kernel<4> : reverse_moves<reverse_kernel<4> > {
+    typedef __m512i vector;
+    static const std::size_t lanes = 16;
+    static vector rev(vector x)
+    {
+        return _mm512_maskz_permutexvar_epi32(0xffff,
+            _mm512_set_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                             8, 9, 10, 11, 12, 13, 14, 15), x);
+    }
+};
+
+template<>
+struct reverse_kernel<8> : reverse_moves<reverse_kernel<8> > {
+    typedef __m512i vector;
+    static const std::size_t lanes = 8;
+    static vector rev(vector x)
+    {
+        return _mm512_maskz_permutexvar_epi64(0xff,
+            _mm512_set_epi64(0, 1, 2, 3, 4, 5, 6, 7), x);
+    }
+};
+
+#if defined(__AVX512BW__)
+// Bytes and words are reversed within each 128-bit lane, then the lanes are,
+// as pairs of 64-bit elements.
+template<>
+struct reverse_kernel<1> : reverse_moves<reverse_kernel<1> > {
+    typedef __m512i vector;
+    static const std::size_t lanes = 64;
+    static vector rev(vector x)
+    {
+        const __m512i bytes = _mm512_set_epi64(
+            0x0001020304050607, 0x08090a0b0c0d0e0f,
+            0x0001020304050607, 0x08090a0b0c0d0e0f,
+            0x0001020304050607, 0x08090a0b0c0d0e0f,
+            0x0001020304050607, 0x08090a0b0c0d0e0f);
+        return _mm512_maskz_permutexvar_epi64(0xff,
+            _mm512_set_epi64(1, 0, 3, 2, 5, 4, 7, 6),
+            _mm512_shuffle_epi8(x, bytes));
+    }
+};
+
+template<>
+struct reverse_kernel<2> : reverse_moves<reverse_kernel<2> > {
+    typedef __m512i vector;
+    static const std::size_t lanes = 32;
+    static vector rev(vector x)
+    {
+        const __m512i words = _mm512_set_epi64(
+            0x0100030205040706, 0x09080b0a0d0c0f0e,
+            0x0100030205040706, 0x09080b0a0d0c0f0e,
+            0x0100030205040706, 0x09080b0a0d0c0f0e,
+            0x0100030205040706, 0x09080b0a0d0c0f0e);
+        return _mm512_maskz_permutexvar_epi64(0xff,
+            _mm512_set_epi64(1, 0, 3, 2, 5, 4, 7, 6),
+            _mm512_shuffle_epi8(x, words));
+    }
+};
+#endif
+#endif
+
+#if defined(WT_SIMD_AVX2) && \
+    !(defined(WT_SIMD_AVX512) && defined(__AVX512BW__))
+template<>
+struct reverse_kernel<1> : reverse_moves<reverse_kernel<1> > {
+    typedef __m256i vector;
+    static const std::size_t lanes = 32;
+    static vector rev(vector x)
+    {
+        x = _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+                15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+        return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 3, 2));
+    }
+};
+
+template<>
+struct reverse_kernel<2> : reverse_moves<reverse_kernel<2> > {
+    typedef __m256i vector;
+    static const std::size_t lanes = 16;
+    static vector rev(vector x)
+    {
+        x = _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+                14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+                14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1));
+        return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 3, 2));
+    }
+};
+#endif
+
+#if defined(WT_SIMD_AVX2) && !defined(WT_SIMD_AVX512)
+template<>
+struct reverse_kernel<4> : reverse_moves<reverse_kernel<4> > {
+    typedef __m256i vector;
+    static const std::size_t lanes = 8;
+    static vector rev(vector x)
+    {
+        return _mm256_permutevar8x32_epi32(
+            x, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    }
+};
+
+template<>
+struct reverse_kernel<8> : reverse_moves<reverse_kernel<8> > {
+    typedef __m256i vector;
+    static const std::size_t lanes = 4;
+    static vector rev(vector x)
+    {
+        return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(0, 1, 2, 3));
+    }
+};
+#endif
+
+#if defined(WT_SIMD_SSSE3) && !defined(WT_SIMD_AVX2)
+template<>
+struct reverse_kernel<1> : reverse_moves<reverse_kernel<1> > {
+    typedef __m128i vector;
+    static const std::size_t lanes = 16;
+    static vector rev(vector x)
+    {
+        return _mm_shuffle_epi8(x, _mm_setr_epi8(
+            15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+    }
+};
+
+template<>
+struct reverse_kernel<2> : reverse_moves<reverse_kernel<2> > {
+    typedef __m128i vector;
+    static const std::size_t lanes = 8;
+    static vector rev(vector x)
+    {
+        return _mm_shuffle_epi8(x, _mm_setr_epi8(
+            14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1));
+    }
+};
+#endif
+
+#if defined(WT_SIMD_SSE2) && !defined(WT_SIMD_AVX2)
+template<>
+struct reverse_kernel<4> : reverse_moves<reverse_kernel<4> > {
+    typedef __m128i vector;
+    static const std::size_t lanes = 4;
+    static vector rev(vector x)
+    {
+        return _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3));
+    }
+};
+
+template<>
+struct reverse_kernel<8> : reverse_moves<reverse_kernel<8> > {
+    typedef __m128i vector;
+    static const std::size_t lanes = 2;
+    static vector rev(vector x)
+    {
+        return _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+    }
+};
+#endif
+
+/// Swap the n elements from first with the n elements before last, each
+/// with its mirror image:  the outer 2n elements of a reversal of
+/// [first, last).  The elements are of a trivially copyable type, and 2n is
+/// at most last - first.
+template<typename T>
+void reverse_swap_elements(T* first, T* last, std::size_t n)
+{
+    typedef reverse_kernel<sizeof(T)> kernel;
+    const std::size_t lanes = kernel::lanes;
+    if( lanes != 0 ) {
+        for( ; n >= lanes; n -= lanes, first += lanes ) {
+            last -= lanes;
+            kernel::swap(first, last);
+        }
+    }
+    for( ; n != 0; --n, ++first ) {
+        --last;
+        const T t = *first;
+        *first = *last;
+        *last = t;
+    }
+}
+
+/// Reverse the elements of [first, last), a trivially copyable type.
+template<typename T>
+void reverse_elements(T* first, T* last)
+{
+    reverse_swap_elements(first, last, (last - first) / 2);
+}
+
+/// Copy the elements of [first, last), a trivially copyable type, to dst in
+/// reverse order.  The ranges must not overlap.
+///
+/// \return The end of the output.
+template<typename T>
+T* reverse_copy_elements(const T* first, const T* last, T* dst)
+{
+    typedef reverse_kernel<sizeof(T)> kernel;
+    const std::size_t lanes = kernel::lanes;
+    if( lanes != 0 ) {
+        for( ; static_cast<std::size_t>(last - first) >= lanes;
+               dst += lanes ) {
+            last -= lanes;
+            kernel::reverse(dst, last);
+        }
+    }
+    while( last != first ) *dst++ = *--last;
+    return dst;
+}
+
+/// Swap the n bytes at a with the n bytes at b.  The blocks must not
+/// overlap.
+inline void swap_bytes(void* a, void* b, std::size_t n)
+{
+    unsigned char* p = static_cast<unsigned char*>(a);
+    unsigned char* q = static_cast<unsigned char*>(b);
+#if defined(WT_SIMD_AVX512)
+    typedef __m512i vector;
+#elif defined(WT_SIMD_AVX2)
+    typedef __m256i vector;
+#elif defined(WT_SIMD_SSE2)
+    typedef __m128i vector;
+#endif
+#if defined(WT_SIMD_SSE2)
+    const std::size_t v = sizeof(vector);
+    for( ; n >= 2 * v; n -= 2 * v, p += 2 * v, q += 2 * v ) {
+        vector x0, x1, y0, y1;
+        load_vector(x0, p);
+        load_vector(x1, p + v);
+        load_vector(y0, q);
+        load_vector(y1, q + v);
+        store_vector(p, y0);
+        store_vector(p + v, y1);
+        store_vector(q, x0);
+        store_vector(q + v, x1);
+    }
+#endif
+    unsigned char t[256];
+    for( ; n >= sizeof(t); n -= sizeof(t), p += sizeof(t), q += sizeof(t) ) {
+        std::memcpy(t, p, sizeof(t));
+        std::memcpy(p, q, sizeof(t));
+        std::memcpy(q, t, sizeof(t));
+    }
+    std::memcpy(t, p, n);
+    std::memcpy(p, q, n);
+    std::memcpy(q, t, n);
+}
+
+/// Copy n bytes from src to dst, with non-temporal stores where the target
+/// has them.  dst may overlap src if it starts before it, as with a forward
+/// memmove().
+inline void stream_copy(void* dst, const void* src, std::size_t n)
+{
+    unsigned char* d = static_cast<unsigned char*>(dst);
+    const unsigned char* s = static_cast<const unsigned char*>(src);
+#if defined(WT_SIMD_AVX512)
+    typedef __m512i vector;
+#elif defined(WT_SIMD_AVX2)
+    typedef __m256i vector;
+#elif defined(WT_SIMD_SSE2)
+    typedef __m128i vector;
+#endif
+#if defined(WT_SIMD_SSE2)
+    const std::size_t v = sizeof(vector);
+    // Non-temporal stores must be aligned.
+    const std::size_t head = std::min(n,
+        (v - reinterpret_cast<std::uintptr_t>(d) % v) % v);
+    std::memmove(d, s, head);
+    d += head;
+    s += head;
+    n -= head;
+    for( ; n >= 4 * v; n -= 4 * v, d += 4 * v, s += 4 * v ) {
+        vector x[4];
+        for( int i = 0; i < 4; ++i ) load_vector(x[i], s + i * v);
+        for( int i = 0; i < 4; ++i )
+#  if defined(WT_SIMD_AVX512)
+            _mm512_stream_si512(reinterpret_cast<vector*>(d) + i, x[i]);
+#  elif defined(WT_SIMD_AVX2)
+            _mm256_stream_si256(reinterpret_cast<vector*>(d) + i, x[i]);
+#  else
+            _mm_stream_si128(reinterpret_cast<vector*>(d) + i, x[i]);
+#  endif
+    }
+    _mm_sfence();
+#endif
+    std::memmove(d, s, n);
+}
+
+} // namespace detail
+} // namespace wt
+
+#endif // SIMD_HH_
@@ -0,0 +1,235 @@
+#ifndef SINK_HH_
+#define SINK_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Output sinks that know their container.  into(c) is an output iterator
+/// appending to c, as std::back_inserter(c) is, but the iseq wrappers of the
+/// copying algorithms recognize it:  instead of growing the container one
+/// push_back() at a time, they reserve room for the whole output when the
+/// input's size is known, insert whole ranges at once, and let filtering
+/// algorithms on arithmetic values compact straight into the container's
+/// storage.
+///
+///  std::vector<std::string> names;
+///  wt::copy_if(wt::iseq(records), wt::into(names), is_valid);
+///  wt::move(wt::iseq(scratch), wt::into(names));
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace wt {
+
+/// An output iterator that appends to a sequence container with push_back().
+///
+/// \see into()
+template<typename Container>
+class into_iterator {
+public:
+    typedef std::output_iterator_tag iterator_category;
+    typedef void value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef void pointer;
+    typedef void reference;
+    typedef Container container_type;
+
+    explicit into_iterator(Container& c) : c_(&c) { }
+
+    into_iterator& operator=(const typename Container::value_type& v)
+    {
+        c_->push_back(v);
+        return *this;
+    }
+
+    into_iterator& operator=(typename Container::value_type&& v)
+    {
+        c_->push_back(std::move(v));
+        return *this;
+    }
+
+    into_iterator& operator*() { return *this; }
+    into_iterator& operator++() { return *this; }
+    into_iterator operator++(int) { return *this; }
+
+    /// The container appended to.
+    Container& container() const { return *c_; }
+
+private:
+    Container* c_;
+};
+
+/// An output sink appending to a container.
+///
+/// Any algorithm accepts the sink as it would a std::back_insert_iterator.
+/// The iseq wrappers of copy(), move(), transform(), copy_if(), move_if(),
+/// remove_copy(), remove_copy_if(), unique_copy(), copy_until(),
+/// copy_while(), move_until() and move_while() take it specially.  Those
+/// that write one element per input element, or a prefix of the input,
+/// reserve exactly the room they need.  The filtering ones reserve for the
+/// whole input, an upper bound of their output;  on contiguous ranges of
+/// arithmetic values they then compact into the container's storage and
+/// trim it.
+///
+/// \param c A sequence container with push_back() and insert(), such as
+/// std::vector, std::deque or std::string.
+///
+/// \return An output iterator appending to c.
+template<typename Container>
+into_iterator<Container> into(Container& c)
+{
+    return into_iterator<Container>(c);
+}
+
+namespace detail {
+
+template<typename C>
+auto reserve_more(C& c, std::size_t n, int)
+    -> decltype(c.reserve(c.capacity()), void())
+{
+    // Grow geometrically, so that many small appends stay amortized.
+    const std::size_t need = c.size() + n;
+    if( need > c.capacity() )
+        c.reserve(std::max(need, 2 * c.capacity()));
+}
+
+template<typename C>
+void reserve_more(C&, std::size_t, long)
+{
+}
+
+/// Make room in c for n more elements without reallocating, if c has
+/// reserve().
+template<typename C>
+void reserve_more(C& c, std::size_t n)
+{
+    detail::reserve_more(c, n, 0);
+}
+
+/// The number of elements of [first, last) if it takes constant time to
+/// find, otherwise zero.
+template<typename In>
+std::size_t size_hint(In first, In last, std::random_access_iterator_tag)
+{
+    return last - first;
+}
+
+template<typename In>
+std::size_t size_hint(In, In, std::input_iterator_tag)
+{
+    return 0;
+}
+
+template<typename In>
+std::size_t size_hint(In first, In last)
+{
+    return detail::size_hint(first, last,
+        typename std::iterator_traits<In>::iterator_category());
+}
+
+/// The iterator to read from [first, last) through:  a std::move_iterator
+/// when the elements are to be moved.
+template<typename In>
+In transfer_from(In it, std::false_type)
+{
+    return it;
+}
+
+template<typename In>
+std::move_iterator<In> transfer_from(In it, std::true_type)
+{
+    return std::make_move_iterator(it);
+}
+
+/// Append [first, last) to c.  Ranges of forward iterators are inserted at
+/// once, which counts them first.
+template<typename C, typename In>
+void append(C& c, In first, In last, std::input_iterator_tag)
+{
+    for( ; first != last; ++first ) c.push_back(*first);
+}
+
+template<typename C, typename Fwd>
+void append(C& c, Fwd first, Fwd last, std::forward_iterator_tag)
+{
+    c.insert(c.end(), first, last);
+}
+
+template<typename C, typename In>
+void append(C& c, In first, In last)
+{
+    detail::append(c, first, last,
+        typename std::iterator_traits<In>::iterator_category());
+}
+
+/// Append to c the elements of [first, last) up to the first for which
+/// cond() is until, copied, or moved if Move is true.  Forward ranges are
+/// searched first, so that the prefix is inserted at once;  cond() is called
+/// on the same elements either way.
+template<typename C, typename In, typename Pred, typename Move>
+void append_until(C& c, In first, In last, Pred cond, bool until, Move m,
+                  std::input_iterator_tag)
+{
+    for( ; first != last && bool(cond(*first)) != until; ++first )
+        c.push_back(*detail::transfer_from(first, m));
+}
+
+template<typename C, typename Fwd, typename Pred, typename Move>
+void append_until(C& c, Fwd first, Fwd last, Pred cond, bool until, Move m,
+                  std::forward_iterator_tag)
+{
+    const Fwd stop = until ? std::find_if(first, last, cond)
+                           : std::find_if_not(first, last, cond);
+    detail::append(c, detail::transfer_from(first, m),
+                   detail::transfer_from(stop, m));
+}
+
+template<typename C, typename In, typename Pred, typename Move>
+void append_until(C& c, In first, In last, Pred cond, bool until, Move m)
+{
+    detail::append_until(c, first, last, cond, until, m,
+        typename std::iterator_traits<In>::iterator_category());
+}
+
+/// The number of bytes of elements append_at_most() grows a contiguous
+/// container by at a time.
+const std::size_t append_block_bytes = std::size_t(1) << 16;
+
+/// Append to c the output of write(first, last, res), a filtering copy of
+/// [first, last) writing at most last - first elements through the output
+/// iterator res.  When Raw is true, c is contiguous and so is the input,
+/// which is copied a block at a time:  c grows by a block's length, write()
+/// writes over it, and the unwritten rest is erased.  c thus never holds
+/// more than a block of elements beyond the output, and each block is
+/// value-initialized while it is in the cache.  Otherwise write() appends
+/// through into(c), with room reserved for the whole input when its size is
+/// known.
+template<typename C, typename Ran, typename Write>
+void append_at_most(C& c, Ran first, Ran last, Write write, std::true_type)
+{
+    const std::size_t block = std::max<std::size_t>(1,
+        append_block_bytes / sizeof(typename C::value_type));
+    while( first != last ) {
+        const std::size_t n = std::min<std::size_t>(last - first, block);
+        const std::size_t old = c.size();
+        c.resize(old + n);
+        c.erase(write(first, first + n, c.begin() + old), c.end());
+        first += n;
+    }
+}
+
+template<typename C, typename In, typename Write>
+void append_at_most(C& c, In first, In last, Write write, std::false_type)
+{
+    detail::reserve_more(c, detail::size_hint(first, last));
+    write(first, last, wt::into(c));
+}
+
+} // namespace detail
+} // namespace wt
+
+#endif // SINK_HH_
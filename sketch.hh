@@ -0,0 +1,501 @@
+#ifndef SKETCH_HH_
+#define SKETCH_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Approximate summaries of sequences too long to hold or sort:  hyperloglog
+/// estimates the number of distinct elements, and kll_sketch the quantiles.
+/// Both take a single pass, hold a few kilobytes whatever the input size, and
+/// can be merged, so that partial sketches built per thread or per chunk of a
+/// stream combine into a sketch of the whole.
+///
+/// approx_count_distinct() and quantile_sketch() in numeric.hh build them
+/// over a sequence.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <wtl/flat_hash.hh>
+#include <wtl/simd.hh>
+#include <wtl/traits.hh>
+
+namespace wt {
+namespace detail {
+
+/// The bits identifying an arithmetic value, equal for equal values:  -0.0
+/// and 0.0 share theirs.
+template<typename T>
+std::uint64_t value_bits(T v, std::true_type)
+{
+    return static_cast<std::uint64_t>(v);
+}
+
+template<typename T>
+std::uint64_t value_bits(T v, std::false_type)
+{
+    const double d = v == 0 ? 0.0 : static_cast<double>(v);
+    std::uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+/// A well-mixed 64-bit hash of a value.
+template<typename T>
+std::uint64_t sketch_hash(const T& v, std::true_type)
+{
+    return hash_mix(value_bits(v, std::is_integral<T>()));
+}
+
+template<typename T>
+std::uint64_t sketch_hash(const T& v, std::false_type)
+{
+    return hash_mix(std::hash<T>()(v));
+}
+
+template<typename T>
+std::uint64_t sketch_hash(const T& v)
+{
+    return sketch_hash(v, std::integral_constant<bool,
+        std::is_arithmetic<T>::value && !std::is_same<T,bool>::value>());
+}
+
+} // namespace detail
+
+/// HyperLogLog distinct-count estimator.
+///
+/// With precision p the sketch keeps 2^p one-byte registers, and the standard
+/// error of its estimate is about 1.04 / sqrt(2^p):  1.6% at the default
+/// p = 12, in 4 KB.  As in HyperLogLog++ the sketch uses 64-bit hashes and
+/// starts out sparse, as a sorted list of (index, rank) pairs at precision
+/// 25, which gives near-exact counts for small cardinalities;  it switches to
+/// the dense registers once the list would outgrow them.  Instead of
+/// HyperLogLog++'s empirical bias tables, the dense estimate uses Ertl's
+/// improved estimator, which is unbiased across the whole range.
+class hyperloglog {
+public:
+    /// \param precision The number of index bits, from 4 to 18.
+    explicit hyperloglog(unsigned precision = 12) : p_(precision)
+    {
+        if( precision < 4 || precision > 18 )
+            throw std::invalid_argument("hyperloglog precision");
+    }
+
+    unsigned precision() const { return p_; }
+
+    /// Whether the sketch still uses its sparse representation.
+    bool sparse() const { return registers_.empty(); }
+
+    /// Add a value to the sketch.
+    template<typename T>
+    void add(const T& v)
+    {
+        add_hash(detail::sketch_hash(v));
+    }
+
+    /// Add a sequence of values to the sketch.  Contiguous arithmetic values
+    /// are hashed a block at a time, in a loop the compiler can vectorize.
+    template<typename In>
+    void add(In first, In last)
+    {
+        add(first, last, detail::is_contiguous_arithmetic<In>());
+    }
+
+    /// Add a value by its hash, which must be well mixed across all 64 bits.
+    void add_hash(std::uint64_t h)
+    {
+        if( !sparse() ) {
+            add_dense(h);
+            return;
+        }
+        const std::uint64_t w = h << sparse_p;
+        const unsigned rank = w == 0 ? 64 - sparse_p + 1
+                                     : detail::count_leading_zeros64(w) + 1;
+        buffer_.push_back(static_cast<std::uint32_t>(h >> (64 - sparse_p)) << 6
+                          | rank);
+        if( buffer_.size() >= buffer_limit() ) flush();
+    }
+
+    /// Merge another sketch of the same precision into this one.  The result
+    /// estimates the number of distinct values added to either.
+    void merge(const hyperloglog& o)
+    {
+        if( &o == this ) return;        // Each value is in both already.
+        if( o.p_ != p_ )
+            throw std::invalid_argument("hyperloglog precision mismatch");
+        if( sparse() && o.sparse() ) {
+            buffer_.insert(buffer_.end(), o.sparse_.begin(), o.sparse_.end());
+            buffer_.insert(buffer_.end(), o.buffer_.begin(), o.buffer_.end());
+            flush();
+            return;
+        }
+        if( sparse() ) densify();
+        if( o.sparse() ) {
+            hyperloglog dense(o);
+            dense.densify();
+            merge_registers(dense);
+        } else {
+            merge_registers(o);
+        }
+    }
+
+    /// The estimated number of distinct values added.
+    double estimate() const
+    {
+        if( sparse() ) {
+            // Linear counting over the 2^25 sparse indices.
+            std::vector<std::uint32_t> entries(sparse_);
+            merge_sorted(entries, buffer_);
+            const double m = double(std::uint64_t(1) << sparse_p);
+            return m * std::log(m / (m - double(entries.size())));
+        }
+        const unsigned q = 64 - p_;
+        std::vector<double> c(q + 2, 0.0);
+        for( std::size_t j = 0; j < registers_.size(); ++j )
+            c[registers_[j]] += 1;
+        const double m = double(registers_.size());
+        double z = m * tau(1 - c[q + 1] / m);
+        for( unsigned k = q; k >= 1; --k ) z = 0.5 * (z + c[k]);
+        z += m * sigma(c[0] / m);
+        return m * m / (2 * std::log(2.0)) / z;
+    }
+
+private:
+    static const unsigned sparse_p = 25;
+
+    std::size_t buffer_limit() const
+    {
+        return std::max<std::size_t>(64, (std::size_t(1) << p_) / 16);
+    }
+
+    void add_dense(std::uint64_t h)
+    {
+        const std::uint64_t w = h << p_;
+        const std::uint8_t rank = static_cast<std::uint8_t>(
+            w == 0 ? 64 - p_ + 1 : detail::count_leading_zeros64(w) + 1);
+        std::uint8_t& r = registers_[static_cast<std::size_t>(h >> (64 - p_))];
+        if( r < rank ) r = rank;
+    }
+
+    template<typename In>
+    void add(In first, In last, std::false_type)
+    {
+        for( ; first != last; ++first ) add(*first);
+    }
+
+    template<typename In>
+    void add(In first, In last, std::true_type)
+    {
+        if( first == last ) return;
+        typedef typename std::iterator_traits<In>::value_type T;
+        const T* p = detail::address_of(first);
+        std::size_t n = last - first;
+        std::uint64_t h[256];
+        while( n != 0 ) {
+            const std::size_t b = std::min<std::size_t>(n, 256);
+            for( std::size_t i = 0; i < b; ++i )
+                h[i] = detail::hash_mix(detail::value_bits(p[i],
+                                            std::is_integral<T>()));
+            for( std::size_t i = 0; i < b; ++i ) add_hash(h[i]);
+            p += b;
+            n -= b;
+        }
+    }
+
+    /// Merge a sorted list of sparse entries with an unsorted one, keeping
+    /// the highest rank per index.
+    static void merge_sorted(std::vector<std::uint32_t>& sorted,
+                             std::vector<std::uint32_t> more)
+    {
+        std::sort(more.begin(), more.end());
+        const std::size_t mid = sorted.size();
+        sorted.insert(sorted.end(), more.begin(), more.end());
+        std::inplace_merge(sorted.begin(), sorted.begin() + mid, sorted.end());
+        // Entries sort by index, then rank;  keep the last of each index.
+        std::size_t out = 0;
+        for( std::size_t i = 0; i < sorted.size(); ++i ) {
+            if( i + 1 < sorted.size() && sorted[i] >> 6 == sorted[i + 1] >> 6 )
+                continue;
+            sorted[out++] = sorted[i];
+        }
+        sorted.resize(out);
+    }
+
+    void flush()
+    {
+        merge_sorted(sparse_, buffer_);
+        buffer_.clear();
+        // Four bytes per sparse entry against one per register.
+        if( sparse_.size() > (std::size_t(1) << p_) / 4 ) densify();
+    }
+
+    void densify()
+    {
+        registers_.assign(std::size_t(1) << p_, 0);
+        merge_sorted(sparse_, buffer_);
+        const unsigned extra = sparse_p - p_;
+        for( std::size_t i = 0; i < sparse_.size(); ++i ) {
+            const std::uint32_t index = sparse_[i] >> 6;
+            const std::uint32_t low = index & ((1u << extra) - 1);
+            // The rank at precision p counts the leading zeros of the index
+            // bits beyond p first.
+            const unsigned rank = low != 0
+                ? extra - (64 - detail::count_leading_zeros64(low)) + 1
+                : extra + (sparse_[i] & 63);
+            std::uint8_t& r = registers_[index >> extra];
+            if( r < rank ) r = static_cast<std::uint8_t>(rank);
+        }
+        std::vector<std::uint32_t>().swap(sparse_);
+        std::vector<std::uint32_t>().swap(buffer_);
+    }
+
+    void merge_registers(const hyperloglog& o)
+    {
+        for( std::size_t j = 0; j < registers_.size(); ++j )
+            registers_[j] = std::max(registers_[j], o.registers_[j]);
+    }
+
+    static double sigma(double x)
+    {
+        if( x == 1 ) return HUGE_VAL;
+        double y = 1, z = x, prev;
+        do {
+            x *= x;
+            prev = z;
+            z += x * y;
+            y += y;
+        } while( z != prev );
+        return z;
+    }
+
+    static double tau(double x)
+    {
+        if( x == 0 || x == 1 ) return 0;
+        double y = 1, z = 1 - x, prev;
+        do {
+            x = std::sqrt(x);
+            prev = z;
+            y *= 0.5;
+            z -= (1 - x) * (1 - x) * y;
+        } while( z != prev );
+        return z / 3;
+    }
+
+    unsigned p_;
+    std::vector<std::uint8_t> registers_;
+    std::vector<std::uint32_t> sparse_;
+    std::vector<std::uint32_t> buffer_;
+};
+
+/// KLL quantile sketch.
+///
+/// The sketch keeps a hierarchy of compactors:  level h holds a sample of
+/// the input in which each item stands for 2^h inputs.  When a level fills
+/// up it is sorted and every other item, from a random offset, is promoted
+/// to the level above.  Capacities shrink geometrically down the levels, so
+/// the sketch retains O(k) items, and a quantile query is off by about
+/// 1.7 / k in rank:  under 1% at the default k = 200.
+///
+/// T must be default-constructible and copyable.
+template<typename T, typename Cmp = std::less<T> >
+class kll_sketch {
+public:
+    typedef T value_type;
+
+    /// \param k The capacity of the top compactor, trading memory for
+    /// accuracy.
+    explicit kll_sketch(std::size_t k = 200, Cmp c = Cmp())
+        : k_(std::max<std::size_t>(k, 8)), n_(0), size_(0), min_(), max_(),
+          rng_(0x9e3779b97f4a7c15ULL), cmp_(c)
+    {
+    }
+
+    /// The number of values added.
+    std::size_t count() const { return n_; }
+
+    bool empty() const { return n_ == 0; }
+
+    /// The number of items the sketch holds.
+    std::size_t retained() const { return size_; }
+
+    /// The smallest value added.  The sketch must not be empty.
+    const T& min() const
+    {
+        assert(!empty());
+        return min_;
+    }
+
+    /// The greatest value added.  The sketch must not be empty.
+    const T& max() const
+    {
+        assert(!empty());
+        return max_;
+    }
+
+    void add(const T& v)
+    {
+        if( levels_.empty() ) levels_.resize(1);
+        track(v);
+        levels_[0].push_back(v);
+        ++size_;
+        ++n_;
+        if( size_ >= total_capacity() ) compress();
+    }
+
+    template<typename In>
+    void add(In first, In last)
+    {
+        for( ; first != last; ++first ) add(*first);
+    }
+
+    /// Merge another sketch into this one.  The result summarizes the values
+    /// added to either;  merging a sketch into itself counts its values
+    /// twice.
+    void merge(const kll_sketch& o)
+    {
+        if( &o == this ) {
+            const kll_sketch copy(o);
+            merge(copy);
+            return;
+        }
+        if( o.empty() ) return;
+        if( levels_.size() < o.levels_.size() ) levels_.resize(o.levels_.size());
+        for( std::size_t h = 0; h < o.levels_.size(); ++h )
+            levels_[h].insert(levels_[h].end(),
+                              o.levels_[h].begin(), o.levels_[h].end());
+        if( n_ == 0 ) {
+            min_ = o.min_;
+            max_ = o.max_;
+        } else {
+            track(o.min_);
+            track(o.max_);
+        }
+        n_ += o.n_;
+        size_ += o.size_;
+        while( size_ >= total_capacity() ) compress();
+    }
+
+    /// The approximate q-quantile of the values added:  a value such that
+    /// about a fraction q of them are no greater.  The sketch must not be
+    /// empty.
+    T quantile(double q) const
+    {
+        assert(!empty());
+        if( q <= 0 ) return min_;
+        if( q >= 1 ) return max_;
+        const std::vector<std::pair<T,std::uint64_t> > items = weighted();
+        const double target = q * double(n_);
+        std::uint64_t seen = 0;
+        for( std::size_t i = 0; i < items.size(); ++i ) {
+            seen += items[i].second;
+            if( double(seen) >= target ) return items[i].first;
+        }
+        return max_;
+    }
+
+    /// The approximate fraction of the values added that are no greater than
+    /// v.
+    double rank(const T& v) const
+    {
+        if( n_ == 0 ) return 0;
+        std::uint64_t below = 0;
+        for( std::size_t h = 0; h < levels_.size(); ++h )
+            for( std::size_t i = 0; i < levels_[h].size(); ++i )
+                if( !cmp_(v, levels_[h][i]) ) below += std::uint64_t(1) << h;
+        return double(below) / double(n_);
+    }
+
+private:
+    void track(const T& v)
+    {
+        if( n_ == 0 ) {
+            min_ = v;
+            max_ = v;
+            return;
+        }
+        if( cmp_(v, min_) ) min_ = v;
+        if( cmp_(max_, v) ) max_ = v;
+    }
+
+    std::size_t capacity(std::size_t h) const
+    {
+        const double c = std::pow(2.0 / 3.0, double(levels_.size() - h - 1));
+        return std::max<std::size_t>(2,
+            static_cast<std::size_t>(std::ceil(double(k_) * c)));
+    }
+
+    std::size_t total_capacity() const
+    {
+        std::size_t total = 0;
+        for( std::size_t h = 0; h < levels_.size(); ++h ) total += capacity(h);
+        return total;
+    }
+
+    bool random_bit()
+    {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 7;
+        rng_ ^= rng_ << 17;
+        return (rng_ >> 32) & 1;
+    }
+
+    /// Compact the lowest level that is over capacity.
+    void compress()
+    {
+        for( std::size_t h = 0; h < levels_.size(); ++h ) {
+            if( levels_[h].size() < capacity(h) ) continue;
+            if( h + 1 == levels_.size() ) levels_.resize(h + 2);
+            std::vector<T>& level = levels_[h];
+            std::sort(level.begin(), level.end(), cmp_);
+            // An odd item out stays behind.
+            const std::size_t odd = level.size() % 2;
+            std::vector<T>& up = levels_[h + 1];
+            for( std::size_t i = odd + (random_bit() ? 1 : 0); i < level.size();
+                 i += 2 )
+                up.push_back(level[i]);
+            size_ -= (level.size() - odd) / 2;
+            level.resize(odd);
+            return;
+        }
+    }
+
+    std::vector<std::pair<T,std::uint64_t> > weighted() const
+    {
+        std::vector<std::pair<T,std::uint64_t> > items;
+        items.reserve(size_);
+        for( std::size_t h = 0; h < levels_.size(); ++h )
+            for( std::size_t i = 0; i < levels_[h].size(); ++i )
+                items.push_back(std::make_pair(levels_[h][i],
+                                               std::uint64_t(1) << h));
+        const Cmp& c = cmp_;
+        std::sort(items.begin(), items.end(),
+            [&c](const std::pair<T,std::uint64_t>& a,
+                 const std::pair<T,std::uint64_t>& b) {
+                return c(a.first, b.first);
+            });
+        return items;
+    }
+
+    std::vector<std::vector<T> > levels_;
+    std::size_t k_;
+    std::size_t n_;
+    std::size_t size_;
+    T min_;
+    T max_;
+    std::uint64_t rng_;
+    Cmp cmp_;
+};
+
+} // namespace wt
+
+#endif // SKETCH_HH_
@@ -0,0 +1,394 @@
+#ifndef SOA_VECTOR_HH_
+#define SOA_VECTOR_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// A vector of records stored as a structure of arrays:  each field of the
+/// records lives in a std::vector of its own.  An algorithm that reads one
+/// field then streams only that field's bytes, and contiguous columns of
+/// numbers take the vectorized paths of the algorithms:
+///
+///  wt::soa_vector<std::uint32_t, double, std::string> trades;
+///  trades.push_back(7, 99.5, "ACME");
+///  double total = wt::accumulate(wt::iseq<1>(trades), 0.0);
+///
+/// The records are also available whole, through iterators whose references
+/// are proxies:  tuples of references to the fields.  Those iterators are
+/// random access, so wt::sort(), wt::partition() and the like reorder every
+/// column together:
+///
+///  wt::sort(wt::iseq(trades),
+///           [](std::tuple<const std::uint32_t&, const double&,
+///                         const std::string&> a,
+///              std::tuple<const std::uint32_t&, const double&,
+///                         const std::string&> b) {
+///               return std::get<1>(a) < std::get<1>(b);
+///           });
+///
+/// Moving whole records through proxies copies the fields into temporaries
+/// and back.  For wide records, it is usually faster to argsort() one column
+/// and permute() all of them, which touches each column in turn.
+///
+/// A column of bool is a std::vector<bool>, whose elements can't be
+/// referenced;  store flags as char instead.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <wtl/iseq.hh>
+#include <wtl/sort.hh>
+
+namespace wt {
+namespace detail {
+
+template<std::size_t... Is>
+struct index_sequence { };
+
+/// index_sequence<0, 1, ..., N - 1>, through its base class.
+template<std::size_t N, std::size_t... Is>
+struct make_index_sequence : make_index_sequence<N - 1, N - 1, Is...> { };
+
+template<std::size_t... Is>
+struct make_index_sequence<0, Is...> : index_sequence<Is...> { };
+
+/// Evaluate a pack expansion for its side effects, in order.
+inline void expand(std::initializer_list<int>) { }
+
+} // namespace detail
+
+template<typename... Ts>
+class soa_vector;
+
+/// The reference to a record of a soa_vector:  a tuple of references to its
+/// fields.  Assigning to it assigns the fields, and swapping two of them
+/// swaps the fields, so algorithms that permute elements reorder the
+/// columns.
+template<typename... Ts>
+class soa_reference : public std::tuple<Ts&...> {
+    typedef std::tuple<Ts&...> base;
+    typedef detail::make_index_sequence<sizeof...(Ts)> indices;
+public:
+    explicit soa_reference(Ts&... fields) : base(fields...) { }
+
+    soa_reference(const soa_reference&) = default;
+
+    soa_reference& operator=(const soa_reference& r)
+    {
+        copy(r, indices());
+        return *this;
+    }
+
+    soa_reference& operator=(soa_reference&& r)
+    {
+        move(r, indices());
+        return *this;
+    }
+
+    soa_reference& operator=(const std::tuple<Ts...>& v)
+    {
+        copy(v, indices());
+        return *this;
+    }
+
+    soa_reference& operator=(std::tuple<Ts...>&& v)
+    {
+        move(v, indices());
+        return *this;
+    }
+
+    friend void swap(soa_reference a, soa_reference b)
+    {
+        a.swap_fields(b, indices());
+    }
+
+private:
+    template<typename Tuple, std::size_t... Is>
+    void copy(const Tuple& v, detail::index_sequence<Is...>)
+    {
+        detail::expand({(std::get<Is>(*this) = std::get<Is>(v), 0)...});
+    }
+
+    template<typename Tuple, std::size_t... Is>
+    void move(Tuple& v, detail::index_sequence<Is...>)
+    {
+        detail::expand({(std::get<Is>(*this) = std::move(std::get<Is>(v)),
+                         0)...});
+    }
+
+    template<std::size_t... Is>
+    void swap_fields(soa_reference& r, detail::index_sequence<Is...>)
+    {
+        using std::swap;
+        detail::expand({(swap(std::get<Is>(*this), std::get<Is>(r)), 0)...});
+    }
+};
+
+/// Random access iterator over the records of a soa_vector.  Dereferencing
+/// it yields a soa_reference, or for a const iterator a tuple of const
+/// references.
+template<bool Const, typename... Ts>
+class soa_iterator {
+    typedef typename std::conditional<Const,
+                                      const soa_vector<Ts...>,
+                                      soa_vector<Ts...> >::type container;
+    typedef detail::make_index_sequence<sizeof...(Ts)> indices;
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef std::tuple<Ts...> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef void pointer;
+    typedef typename std::conditional<Const,
+                                      std::tuple<const Ts&...>,
+                                      soa_reference<Ts...> >::type reference;
+
+    soa_iterator() : v_(0), i_(0) { }
+    soa_iterator(container* v, difference_type i) : v_(v), i_(i) { }
+
+    /// A mutable iterator converts to a const one.
+    template<bool C>
+    soa_iterator(const soa_iterator<C, Ts...>& it,
+                 typename std::enable_if<Const && !C>::type* = 0)
+        : v_(it.v_), i_(it.i_)
+    {
+    }
+
+    reference operator*() const { return at(i_, indices()); }
+    reference operator[](difference_type n) const
+    {
+        return at(i_ + n, indices());
+    }
+
+    soa_iterator& operator++() { ++i_; return *this; }
+    soa_iterator& operator--() { --i_; return *this; }
+    soa_iterator operator++(int) { soa_iterator t(*this); ++i_; return t; }
+    soa_iterator operator--(int) { soa_iterator t(*this); --i_; return t; }
+    soa_iterator& operator+=(difference_type n) { i_ += n; return *this; }
+    soa_iterator& operator-=(difference_type n) { i_ -= n; return *this; }
+
+    friend soa_iterator operator+(soa_iterator it, difference_type n)
+    {
+        return it += n;
+    }
+
+    friend soa_iterator operator+(difference_type n, soa_iterator it)
+    {
+        return it += n;
+    }
+
+    friend soa_iterator operator-(soa_iterator it, difference_type n)
+    {
+        return it -= n;
+    }
+
+    friend difference_type operator-(const soa_iterator& a,
+                                     const soa_iterator& b)
+    {
+        return a.i_ - b.i_;
+    }
+
+    friend bool operator==(const soa_iterator& a, const soa_iterator& b)
+    {
+        return a.i_ == b.i_;
+    }
+
+    friend bool operator!=(const soa_iterator& a, const soa_iterator& b)
+    {
+        return a.i_ != b.i_;
+    }
+
+    friend bool operator<(const soa_iterator& a, const soa_iterator& b)
+    {
+        return a.i_ < b.i_;
+    }
+
+    friend bool operator>(const soa_iterator& a, const soa_iterator& b)
+    {
+        return a.i_ > b.i_;
+    }
+
+    friend bool operator<=(const soa_iterator& a, const soa_iterator& b)
+    {
+        return a.i_ <= b.i_;
+    }
+
+    friend bool operator>=(const soa_iterator& a, const soa_iterator& b)
+    {
+        return a.i_ >= b.i_;
+    }
+
+private:
+    template<bool C, typename... Us>
+    friend class soa_iterator;
+
+    template<std::size_t... Is>
+    reference at(difference_type i, detail::index_sequence<Is...>) const
+    {
+        return reference(v_->template column<Is>()[i]...);
+    }
+
+    container* v_;
+    difference_type i_;
+};
+
+/// Vector of records whose fields are stored in separate, contiguous columns.
+///
+/// \see soa_vector.hh
+template<typename... Ts>
+class soa_vector {
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+    typedef detail::make_index_sequence<sizeof...(Ts)> indices;
+public:
+    typedef std::tuple<Ts...> value_type;
+    typedef soa_reference<Ts...> reference;
+    typedef std::tuple<const Ts&...> const_reference;
+    typedef soa_iterator<false, Ts...> iterator;
+    typedef soa_iterator<true, Ts...> const_iterator;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    /// The type of the fields in column I.
+    template<std::size_t I>
+    struct column_type {
+        typedef typename std::tuple_element<I, value_type>::type type;
+    };
+
+    soa_vector() { }
+
+    /// \param n The number of value-initialized records to start with.
+    explicit soa_vector(size_type n) { resize(n); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    size_type size() const { return std::get<0>(columns_).size(); }
+    bool empty() const { return size() == 0; }
+
+    reference operator[](size_type i) { return begin()[i]; }
+    const_reference operator[](size_type i) const { return begin()[i]; }
+
+    /// The column of field I.  Its size must not be changed directly.
+    template<std::size_t I>
+    std::vector<typename column_type<I>::type>& column()
+    {
+        return std::get<I>(columns_);
+    }
+
+    template<std::size_t I>
+    const std::vector<typename column_type<I>::type>& column() const
+    {
+        return std::get<I>(columns_);
+    }
+
+    void reserve(size_type n) { reserve(n, indices()); }
+    void resize(size_type n) { resize(n, indices()); }
+    void clear() { resize(0); }
+
+    void push_back(const Ts&... fields)
+    {
+        push_back(indices(), fields...);
+    }
+
+    void push_back(Ts&&... fields)
+    {
+        push_back(indices(), std::move(fields)...);
+    }
+
+    void push_back(const value_type& v) { push_record(v, indices()); }
+
+    void pop_back() { resize(size() - 1); }
+
+    /// Reorder the records in place by a permutation, so that record i
+    /// becomes the record that was at perm[i].  The columns are permuted one
+    /// after the other.
+    ///
+    /// \see apply_permutation()
+    template<typename Ran>
+    void permute(Ran perm) { permute(perm, indices()); }
+
+private:
+    template<std::size_t... Is>
+    void reserve(size_type n, detail::index_sequence<Is...>)
+    {
+        detail::expand({(std::get<Is>(columns_).reserve(n), 0)...});
+    }
+
+    template<std::size_t... Is>
+    void resize(size_type n, detail::index_sequence<Is...>)
+    {
+        detail::expand({(std::get<Is>(columns_).resize(n), 0)...});
+    }
+
+    /// Push a field onto each column in turn.  If one of the pushes throws,
+    /// the columns already pushed onto are popped, so that a record is added
+    /// whole or not at all.
+    template<std::size_t... Is, typename... Us>
+    void push_back(detail::index_sequence<Is...>, Us&&... fields)
+    {
+        std::size_t pushed = 0;
+        try {
+            detail::expand({(std::get<Is>(columns_).push_back(
+                                 std::forward<Us>(fields)), ++pushed, 0)...});
+        } catch( ... ) {
+            unpush(pushed, indices());
+            throw;
+        }
+    }
+
+    template<std::size_t... Is>
+    void push_record(const value_type& v, detail::index_sequence<Is...>)
+    {
+        push_back(indices(), std::get<Is>(v)...);
+    }
+
+    /// Pop the last field of the first n columns.
+    template<std::size_t... Is>
+    void unpush(std::size_t n, detail::index_sequence<Is...>)
+    {
+        detail::expand({(Is < n ? std::get<Is>(columns_).pop_back()
+                                : void(), 0)...});
+    }
+
+    template<typename Ran, std::size_t... Is>
+    void permute(Ran perm, detail::index_sequence<Is...>)
+    {
+        detail::expand({(wt::apply_permutation(std::get<Is>(columns_).begin(),
+                                               std::get<Is>(columns_).end(),
+                                               perm), 0)...});
+    }
+
+    std::tuple<std::vector<Ts>...> columns_;
+};
+
+/// The range of column I of a soa_vector.
+///
+///  double total = wt::accumulate(wt::iseq<1>(trades), 0.0);
+template<std::size_t I, typename... Ts>
+input_sequence_range<
+    typename std::vector<
+        typename soa_vector<Ts...>::template column_type<I>::type>::iterator>
+iseq(soa_vector<Ts...>& v)
+{
+    return wt::iseq(v.template column<I>());
+}
+
+/// The range of column I of a const soa_vector.
+template<std::size_t I, typename... Ts>
+input_sequence_range<
+    typename std::vector<
+        typename soa_vector<Ts...>::template column_type<I>::type>::const_iterator>
+iseq(const soa_vector<Ts...>& v)
+{
+    return wt::iseq(v.template column<I>());
+}
+
+} // namespace wt
+
+#endif // SOA_VECTOR_HH_
@@ -0,0 +1,833 @@
+#ifndef SORT_HH_
+#define SORT_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Indirect sorting and permutations.  Sorting a range of wide records moves
+/// every record several times, and sorting several parallel arrays by one key
+/// can't be done with std::sort() at all.  argsort() sorts the keys once and
+/// returns the order as a permutation of indices, which gather(),
+/// apply_permutation() and scatter() then apply to any number of columns:
+///
+///  std::vector<std::size_t> order(keys.size());
+///  wt::argsort(wt::iseq(keys), order.begin());
+///  wt::apply_permutation(wt::iseq(names), order.begin());
+///  wt::apply_permutation(wt::iseq(prices), order.begin());
+///
+/// A permutation maps positions of the output to positions of the input:
+/// after applying it, element i is the element that was at perm[i].
+///
+/// sort_by_key() builds on these to sort by a derived key, such as a
+/// lowercased name, computing each element's key only once, and
+/// string_sort() to sort strings without comparing their shared prefixes
+/// over and over.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <wtl/iseq.hh>
+#include <wtl/simd.hh>
+#include <wtl/traits.hh>
+
+namespace wt {
+namespace detail {
+
+/// Whether values of type T sort by radix:  integers other than bool.
+template<typename T>
+struct is_radix_key
+    : std::integral_constant<bool,
+        std::is_integral<T>::value && !std::is_same<T, bool>::value> { };
+
+/// The bits of an integer as an unsigned integer that orders the same way.
+template<typename T>
+typename std::make_unsigned<T>::type radix_bits(T v)
+{
+    typedef typename std::make_unsigned<T>::type bits_t;
+    const bits_t sign = std::is_signed<T>::value
+                      ? bits_t(bits_t(1) << (sizeof(T) * 8 - 1))
+                      : bits_t(0);
+    return static_cast<bits_t>(static_cast<bits_t>(v) ^ sign);
+}
+
+/// Ranges shorter than this are argsorted by comparison even when their keys
+/// sort by radix.
+const std::size_t radix_sort_threshold = 256;
+
+/// How many elements ahead gather() and scatter() prefetch.
+const std::size_t prefetch_distance = 16;
+
+/// Elements narrower than this are gathered and scattered without
+/// prefetching:  the processor keeps enough of their loads in flight by
+/// itself, and the hints only cost instructions.
+const std::size_t prefetch_min_size = 32;
+
+/// Whether gather() and scatter() prefetch the elements It points at.
+template<typename It>
+struct is_prefetchable
+    : std::integral_constant<bool,
+        is_contiguous_iterator<It>::value &&
+        sizeof(typename std::iterator_traits<It>::value_type) >=
+            prefetch_min_size> { };
+
+/// Prefetch every cache line of the element at p.
+template<typename T>
+void prefetch_element(const T* p, bool write)
+{
+    const char* const c = reinterpret_cast<const char*>(p);
+    for( std::size_t at = 0; at < sizeof(T); at += 64 )
+        if( write ) prefetch_write(c + at);
+        else prefetch_read(c + at);
+}
+
+/// Sort the indices of [first, first + n) by the integer keys they point at,
+/// with a least-significant-digit radix sort of (key, index) pairs.  Digits
+/// are bytes;  all digit histograms are counted in one pass, and passes over
+/// digits every key shares are skipped.
+template<typename Index, typename Ran>
+std::vector<Index> radix_argsort(Ran first, std::size_t n)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    typedef typename std::make_unsigned<value_t>::type bits_t;
+    const unsigned digits = sizeof(bits_t);
+    std::vector<bits_t> keys(n), keys2(n);
+    std::vector<Index> idx(n), idx2(n);
+    std::vector<std::size_t> counts(digits * 256, 0);
+    for( std::size_t i = 0; i < n; ++i ) {
+        const bits_t k = radix_bits(static_cast<value_t>(first[i]));
+        keys[i] = k;
+        idx[i] = static_cast<Index>(i);
+        for( unsigned d = 0; d < digits; ++d )
+            ++counts[d * 256 + ((k >> (8 * d)) & 0xff)];
+    }
+    for( unsigned d = 0; d < digits; ++d ) {
+        std::size_t* const c = &counts[d * 256];
+        if( c[(keys[0] >> (8 * d)) & 0xff] == n ) continue;
+        std::size_t sum = 0;
+        for( unsigned b = 0; b < 256; ++b ) {
+            const std::size_t t = c[b];
+            c[b] = sum;
+            sum += t;
+        }
+        for( std::size_t i = 0; i < n; ++i ) {
+            const std::size_t at = c[(keys[i] >> (8 * d)) & 0xff]++;
+            keys2[at] = keys[i];
+            idx2[at] = idx[i];
+        }
+        keys.swap(keys2);
+        idx.swap(idx2);
+    }
+    return idx;
+}
+
+template<typename Ran, typename Out, typename Cmp>
+Out argsort_compare(Ran first, Ran last, Out res, Cmp c)
+{
+    std::vector<std::size_t> idx(last - first);
+    std::iota(idx.begin(), idx.end(), std::size_t(0));
+    std::stable_sort(idx.begin(), idx.end(),
+                     [&](std::size_t a, std::size_t b) {
+                         return c(first[a], first[b]);
+                     });
+    return std::copy(idx.begin(), idx.end(), res);
+}
+
+template<typename Ran, typename Out>
+Out argsort(Ran first, Ran last, Out res, std::false_type)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    return argsort_compare(first, last, res, std::less<value_t>());
+}
+
+template<typename Ran, typename Out>
+Out argsort(Ran first, Ran last, Out res, std::true_type)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    const std::size_t n = last - first;
+    if( n < radix_sort_threshold )
+        return argsort_compare(first, last, res, std::less<value_t>());
+    if( n <= std::numeric_limits<std::uint32_t>::max() ) {
+        const std::vector<std::uint32_t> idx =
+            radix_argsort<std::uint32_t>(first, n);
+        return std::copy(idx.begin(), idx.end(), res);
+    }
+    const std::vector<std::size_t> idx = radix_argsort<std::size_t>(first, n);
+    return std::copy(idx.begin(), idx.end(), res);
+}
+
+template<typename Ran1, typename Ran2, typename Out>
+Out gather(Ran1 map_first, Ran1 map_last, Ran2 src, Out res, std::false_type)
+{
+    for( ; map_first != map_last; ++map_first ) *res++ = src[*map_first];
+    return res;
+}
+
+template<typename Ran1, typename Ran2, typename Out>
+Out gather(Ran1 map_first, Ran1 map_last, Ran2 src, Out res, std::true_type)
+{
+    const std::size_t n = map_last - map_first;
+    if( n == 0 ) return res;
+    const typename std::iterator_traits<Ran2>::value_type* const p =
+        address_of(src);
+    std::size_t i = 0;
+    for( ; i + prefetch_distance < n; ++i ) {
+        prefetch_element(p + map_first[i + prefetch_distance], false);
+        *res++ = p[map_first[i]];
+    }
+    for( ; i < n; ++i ) *res++ = p[map_first[i]];
+    return res;
+}
+
+template<typename In, typename Ran1, typename Ran2>
+Ran2 scatter(In first, In last, Ran1 map, Ran2 dst, std::false_type)
+{
+    for( ; first != last; ++first, ++map ) dst[*map] = *first;
+    return dst;
+}
+
+template<typename Ran1, typename Ran2, typename Ran3>
+Ran3 scatter(Ran1 first, Ran1 last, Ran2 map, Ran3 dst, std::true_type)
+{
+    const std::size_t n = last - first;
+    if( n == 0 ) return dst;
+    typename std::iterator_traits<Ran3>::value_type* const p = address_of(dst);
+    std::size_t i = 0;
+    for( ; i + prefetch_distance < n; ++i ) {
+        prefetch_element(p + map[i + prefetch_distance], true);
+        p[map[i]] = first[i];
+    }
+    for( ; i < n; ++i ) p[map[i]] = first[i];
+    return dst;
+}
+
+/// Whether scatter() from In to Out can prefetch:  the length of the input
+/// must be known, and the output's elements prefetchable.
+template<typename In, typename Out>
+struct is_scatter_prefetchable
+    : std::integral_constant<bool,
+        std::is_base_of<std::random_access_iterator_tag,
+            typename std::iterator_traits<In>::iterator_category>::value &&
+        is_prefetchable<Out>::value> { };
+
+} // namespace detail
+
+/// Sort the indices of a range by the elements they point at, leaving the
+/// range itself alone.  The sort is stable:  the indices of equal elements
+/// stay in increasing order.
+///
+/// Integer elements are sorted with a radix sort of (key, index) pairs, which
+/// takes one pass per byte of the key that varies;  other elements are sorted
+/// by comparison.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param res An _output iterator_ receiving last - first indices, the index
+/// of the smallest element first.
+///
+/// \return The end of the output.
+template<typename Ran, typename Out>
+Out argsort(Ran first, Ran last, Out res)
+{
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    return detail::argsort(first, last, res,
+                           detail::is_radix_key<value_t>());
+}
+
+/// Sort the indices of a range by the elements they point at, in the order
+/// of a comparator.
+///
+/// \see argsort(Ran, Ran, Out)
+template<typename Ran, typename Out, typename Cmp>
+Out argsort(Ran first, Ran last, Out res, Cmp c)
+{
+    return detail::argsort_compare(first, last, res, c);
+}
+
+/// Reorder a range in place by a permutation, so that element i becomes the
+/// element that was at perm[i].
+///
+/// The permutation is applied cycle by cycle:  each element moves once,
+/// straight to its place, and a bitset marks the positions already placed.
+/// This takes one temporary element and n bits of memory, but the moves hop
+/// around the range;  where memory allows, gather() into a new range streams
+/// its writes and is faster for large ranges.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param perm A _random access iterator_ pointing to the first of last -
+/// first indices, which must be a permutation of [0, last - first).  It is
+/// not modified.
+///
+/// \throw std::invalid_argument if the indices aren't a permutation.  The
+/// order of the range is then unspecified.
+template<typename Ran1, typename Ran2>
+void apply_permutation(Ran1 first, Ran1 last, Ran2 perm)
+{
+    typedef typename std::iterator_traits<Ran1>::value_type value_t;
+    const std::size_t n = last - first;
+    std::vector<std::uint64_t> done((n + 63) / 64, 0);
+    for( std::size_t i = 0; i < n; ++i ) {
+        if( done[i / 64] >> (i % 64) & 1 ) continue;
+        done[i / 64] |= std::uint64_t(1) << (i % 64);
+        std::size_t k = static_cast<std::size_t>(perm[i]);
+        if( k == i ) continue;
+        value_t tmp = std::move(first[i]);
+        std::size_t j = i;
+        for( ; k != i; j = k, k = static_cast<std::size_t>(perm[k]) ) {
+            if( k >= n || done[k / 64] >> (k % 64) & 1 ) {
+                first[j] = std::move(tmp);
+                throw std::invalid_argument("apply_permutation");
+            }
+            done[k / 64] |= std::uint64_t(1) << (k % 64);
+            first[j] = std::move(first[k]);
+        }
+        first[j] = std::move(tmp);
+    }
+}
+
+/// Copy the elements of a range at a sequence of indices:  res[i] =
+/// src[map[i]].
+///
+/// Random reads of wide records miss the cache, so for contiguous sources of
+/// records of 32 bytes or more, the element a few indices ahead is prefetched
+/// while the current one is copied.
+///
+/// \param map_first A _random access iterator_ pointing to the first index.
+///
+/// \param map_last A _random access iterator_ pointing to the last index.
+///
+/// \param src A _random access iterator_ pointing to the first element of the
+/// source range.
+///
+/// \param res An _output iterator_ receiving the elements.
+///
+/// \return The end of the output.
+template<typename Ran1, typename Ran2, typename Out>
+Out gather(Ran1 map_first, Ran1 map_last, Ran2 src, Out res)
+{
+    return detail::gather(map_first, map_last, src, res,
+                          detail::is_prefetchable<Ran2>());
+}
+
+/// Copy the elements of a sequence to a sequence of indices:  dst[map[i]] =
+/// element i.
+///
+/// For contiguous destinations of records of 32 bytes or more, the slot a few
+/// indices ahead is prefetched for writing while the current element is
+/// copied.
+///
+/// \param first An _input iterator_ pointing to the first element of the
+/// sequence.
+///
+/// \param last An _input iterator_ pointing to the last element of the
+/// sequence.
+///
+/// \param map A _random access iterator_ pointing to the first of as many
+/// indices as there are elements.
+///
+/// \param dst A _random access iterator_ pointing to the first element of the
+/// destination range.
+///
+/// \return dst.
+template<typename In, typename Ran1, typename Ran2>
+Ran2 scatter(In first, In last, Ran1 map, Ran2 dst)
+{
+    return detail::scatter(first, last, map, dst,
+                           detail::is_scatter_prefetchable<In,Ran2>());
+}
+
+namespace detail {
+
+/// How sort_by_key() sorts keys of type K by std::less:  by radix, by
+/// abbreviated string prefix, or by comparison.
+template<typename K>
+struct key_engine : std::integral_constant<int, is_radix_key<K>::value> { };
+
+template<typename Ch, typename Tr, typename A>
+struct key_engine<std::basic_string<Ch,Tr,A> >
+    : std::integral_constant<int,
+        std::is_same<std::basic_string<Ch,Tr,A>, std::string>::value * 2> { };
+
+typedef std::integral_constant<int, 0> compare_keys;
+typedef std::integral_constant<int, 1> radix_keys;
+typedef std::integral_constant<int, 2> string_keys;
+
+/// The first eight bytes of a string as a big-endian integer, padded with
+/// zeros:  strings whose prefixes differ order as the prefixes do.
+inline std::uint64_t string_prefix(const std::string& s)
+{
+    const std::size_t n = std::min<std::size_t>(s.size(), 8);
+    std::uint64_t p = 0;
+    for( std::size_t i = 0; i < n; ++i )
+        p |= std::uint64_t(static_cast<unsigned char>(s[i])) << (56 - 8 * i);
+    return p;
+}
+
+/// Order (key, index) pairs by key.
+template<typename Cmp>
+struct first_less {
+    explicit first_less(Cmp c) : cmp(c) { }
+    template<typename P>
+    bool operator()(const P& a, const P& b) const
+    {
+        return cmp(a.first, b.first);
+    }
+    Cmp cmp;
+};
+
+/// Order (prefix, index) pairs of string keys by prefix, and by the whole
+/// strings when the prefixes tie.
+template<typename Index>
+struct abbreviated_less {
+    explicit abbreviated_less(const std::vector<std::string>& k) : keys(&k) { }
+    bool operator()(const std::pair<std::uint64_t,Index>& a,
+                    const std::pair<std::uint64_t,Index>& b) const
+    {
+        if( a.first != b.first ) return a.first < b.first;
+        return (*keys)[a.second] < (*keys)[b.second];
+    }
+    const std::vector<std::string>* keys;
+};
+
+template<typename Index, typename Ran, typename KeyFn, typename Cmp>
+void sort_by_cached_key(Ran first, Ran last, KeyFn key, Cmp c, bool stable,
+                        compare_keys)
+{
+    typedef typename key_of<Ran,KeyFn>::type key_t;
+    const std::size_t n = last - first;
+    std::vector<std::pair<key_t,Index> > keyed;
+    keyed.reserve(n);
+    for( std::size_t i = 0; i < n; ++i )
+        keyed.push_back(std::make_pair(key(first[i]), static_cast<Index>(i)));
+    if( stable )
+        std::stable_sort(keyed.begin(), keyed.end(), first_less<Cmp>(c));
+    else
+        std::sort(keyed.begin(), keyed.end(), first_less<Cmp>(c));
+    std::vector<Index> order(n);
+    for( std::size_t i = 0; i < n; ++i ) order[i] = keyed[i].second;
+    wt::apply_permutation(first, last, order.begin());
+}
+
+template<typename Index, typename Ran, typename KeyFn, typename Cmp>
+void sort_by_cached_key(Ran first, Ran last, KeyFn key, Cmp, bool,
+                        radix_keys)
+{
+    typedef typename key_of<Ran,KeyFn>::type key_t;
+    const std::size_t n = last - first;
+    std::vector<key_t> keys(n);
+    for( std::size_t i = 0; i < n; ++i ) keys[i] = key(first[i]);
+    const std::vector<Index> order = radix_argsort<Index>(keys.begin(), n);
+    wt::apply_permutation(first, last, order.begin());
+}
+
+template<typename Index, typename Ran, typename KeyFn, typename Cmp>
+void sort_by_cached_key(Ran first, Ran last, KeyFn key, Cmp, bool stable,
+                        string_keys)
+{
+    const std::size_t n = last - first;
+    std::vector<std::string> keys(n);
+    std::vector<std::pair<std::uint64_t,Index> > abbreviated(n);
+    for( std::size_t i = 0; i < n; ++i ) {
+        keys[i] = key(first[i]);
+        abbreviated[i] = std::make_pair(string_prefix(keys[i]),
+                                        static_cast<Index>(i));
+    }
+    const abbreviated_less<Index> less(keys);
+    if( stable )
+        std::stable_sort(abbreviated.begin(), abbreviated.end(), less);
+    else
+        std::sort(abbreviated.begin(), abbreviated.end(), less);
+    std::vector<Index> order(n);
+    for( std::size_t i = 0; i < n; ++i ) order[i] = abbreviated[i].second;
+    wt::apply_permutation(first, last, order.begin());
+}
+
+template<typename Ran, typename KeyFn, typename Cmp, typename Engine>
+void sort_by_key(Ran first, Ran last, KeyFn key, Cmp c, bool stable,
+                 Engine e)
+{
+    if( last - first < 2 ) return;
+    if( std::size_t(last - first) <= std::numeric_limits<std::uint32_t>::max() )
+        detail::sort_by_cached_key<std::uint32_t>(first, last, key, c,
+                                                  stable, e);
+    else
+        detail::sort_by_cached_key<std::size_t>(first, last, key, c,
+                                                stable, e);
+}
+
+} // namespace detail
+
+/// Sort a range by a key computed from each element, computing every key
+/// only once.
+///
+/// std::sort() with a comparator that derives keys, such as lowercased
+/// names or hashes, derives O(n log n) of them.  This computes the n keys
+/// into a buffer of (key, index) pairs, sorts the buffer, and then moves
+/// every element once, straight to its place, with apply_permutation().
+/// Integer keys are sorted by radix.  std::string keys are abbreviated to
+/// their first eight bytes as an integer, so most comparisons compare two
+/// integers and don't touch the strings.
+///
+/// \param first A _random access iterator_ pointing to the first element of
+/// the range.
+///
+/// \param last A _random access iterator_ pointing to the last element of the
+/// range.
+///
+/// \param key A function computing the key of an element.  The keys are
+/// ordered by operator<.
+template<typename Ran, typename KeyFn>
+void sort_by_key(Ran first, Ran last, KeyFn key)
+{
+    typedef typename detail::key_of<Ran,KeyFn>::type key_t;
+    detail::sort_by_key(first, last, key, std::less<key_t>(), false,
+                        detail::key_engine<key_t>());
+}
+
+/// Sort a range by a key computed once from each element, ordering the keys
+/// with a comparator.
+///
+/// \see sort_by_key(Ran, Ran, KeyFn)
+template<typename Ran, typename KeyFn, typename Cmp>
+void sort_by_key(Ran first, Ran last, KeyFn key, Cmp c)
+{
+    detail::sort_by_key(first, last, key, c, false, detail::compare_keys());
+}
+
+/// Sort a range by a key computed once from each element, keeping elements
+/// with equal keys in their original order.
+///
+/// \see sort_by_key(Ran, Ran, KeyFn)
+template<typename Ran, typename KeyFn>
+void stable_sort_by_key(Ran first, Ran last, KeyFn key)
+{
+    typedef typename detail::key_of<Ran,KeyFn>::type key_t;
+    detail::sort_by_key(first, last, key, std::less<key_t>(), true,
+                        detail::key_engine<key_t>());
+}
+
+/// Sort a range by a key computed once from each element, ordering the keys
+/// with a comparator and keeping elements with equal keys in their original
+/// order.
+///
+/// \see sort_by_key(Ran, Ran, KeyFn)
+template<typename Ran, typename KeyFn, typename Cmp>
+void stable_sort_by_key(Ran first, Ran last, KeyFn key, Cmp c)
+{
+    detail::sort_by_key(first, last, key, c, true, detail::compare_keys());
+}
+
+namespace detail {
+
+/// Whether T is a string string_sort() can sort:  std::string, a C string,
+/// or in C++17 std::string_view.
+template<typename T>
+struct is_string_like
+    : std::integral_constant<bool,
+        std::is_same<T, std::string>::value ||
+        std::is_same<T, const char*>::value ||
+        std::is_same<T, char*>::value
+#if __cplusplus >= 201703L
+        || std::is_same<T, std::string_view>::value
+#endif
+        > { };
+
+inline std::pair<const char*,std::size_t> string_bytes(const std::string& s)
+{
+    return std::make_pair(s.data(), s.size());
+}
+
+/// A null pointer is read as the empty string.
+inline std::pair<const char*,std::size_t> string_bytes(const char* s)
+{
+    if( s == 0 ) return std::make_pair("", std::size_t(0));
+    return std::make_pair(s, std::strlen(s));
+}
+
+#if __cplusplus >= 201703L
+inline std::pair<const char*,std::size_t> string_bytes(std::string_view s)
+{
+    return std::make_pair(s.data(), s.size());
+}
+#endif
+
+/// A string being sorted:  the eight bytes at the current depth as a
+/// big-endian integer, and the string's position in the input.  Most
+/// comparisons compare the cached integers and don't touch the string.
+struct string_entry {
+    std::uint64_t cache;
+    std::size_t index;
+};
+
+/// The bytes of a string being sorted.
+struct string_ref {
+    const unsigned char* p;
+    std::size_t n;
+};
+
+struct string_entry_cache_less {
+    bool operator()(const string_entry& a, const string_entry& b) const
+    {
+        return a.cache < b.cache;
+    }
+};
+
+/// Groups of strings up to this size are sorted by insertion.
+const std::size_t string_insertion_threshold = 16;
+
+/// Groups of strings from this size on are sorted on their cached bytes by
+/// radix, and smaller groups by comparison.
+const std::size_t string_radix_threshold = 512;
+
+/// MSD radix sort of strings on eight-byte characters.  A group of strings
+/// that agree on their first depth bytes is sorted on the eight bytes cached
+/// at depth;  then each run of equal caches moves on to the next eight
+/// bytes, except for the strings that end within the run, which are equal up
+/// to their lengths.  The largest run continues in the loop and the others
+/// recurse, so the recursion depth is logarithmic.
+class string_sorter {
+public:
+    string_sorter(const string_ref* strs, string_entry* scratch)
+        : strs_(strs), scratch_(scratch)
+    {
+    }
+
+    /// The eight bytes of string s from depth on, as a big-endian integer
+    /// padded with zeros.
+    std::uint64_t chunk(std::size_t s, std::size_t depth) const
+    {
+        const string_ref& r = strs_[s];
+        if( r.n <= depth ) return 0;
+        const std::size_t left = r.n - depth;
+        std::uint64_t c = 0;
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        if( left >= 8 ) {
+            std::memcpy(&c, r.p + depth, 8);
+            return __builtin_bswap64(c);
+        }
+#endif
+        for( std::size_t i = 0; i < 8 && i < left; ++i )
+            c |= std::uint64_t(r.p[depth + i]) << (56 - 8 * i);
+        return c;
+    }
+
+    void sort(string_entry* a, std::size_t n, std::size_t depth) const
+    {
+        while( n > 1 ) {
+            if( n <= string_insertion_threshold ) {
+                insertion_sort(a, n, depth);
+                return;
+            }
+            sort_caches(a, n);
+            string_entry* next = 0;
+            std::size_t next_n = 0;
+            for( std::size_t i = 0; i < n; ) {
+                std::size_t j = i + 1;
+                while( j < n && a[j].cache == a[i].cache ) ++j;
+                if( j - i > 1 ) {
+                    string_entry* const rest = settle_ended(a + i, j - i, depth);
+                    const std::size_t m = a + j - rest;
+                    for( std::size_t k = 0; k < m; ++k )
+                        rest[k].cache = chunk(rest[k].index, depth + 8);
+                    if( m > next_n ) {
+                        if( next_n > 1 ) sort(next, next_n, depth + 8);
+                        next = rest;
+                        next_n = m;
+                    } else if( m > 1 ) {
+                        sort(rest, m, depth + 8);
+                    }
+                }
+                i = j;
+            }
+            a = next;
+            n = next_n;
+            depth += 8;
+        }
+    }
+
+private:
+    /// Whether string a orders before string b, given that they agree on
+    /// their first depth bytes and that their caches hold the bytes at depth.
+    bool less(const string_entry& a, const string_entry& b,
+              std::size_t depth) const
+    {
+        if( a.cache != b.cache ) return a.cache < b.cache;
+        const string_ref& x = strs_[a.index];
+        const string_ref& y = strs_[b.index];
+        const std::size_t lx = x.n > depth ? x.n - depth : 0;
+        const std::size_t ly = y.n > depth ? y.n - depth : 0;
+        // Equal caches past the end of either string make it a prefix of
+        // the other.
+        if( lx <= 8 || ly <= 8 ) return lx < ly;
+        const int c = std::memcmp(x.p + depth + 8, y.p + depth + 8,
+                                  std::min(lx, ly) - 8);
+        return c != 0 ? c < 0 : lx < ly;
+    }
+
+    void insertion_sort(string_entry* a, std::size_t n,
+                        std::size_t depth) const
+    {
+        for( std::size_t i = 1; i < n; ++i ) {
+            const string_entry s = a[i];
+            std::size_t j = i;
+            for( ; j > 0 && less(s, a[j - 1], depth); --j ) a[j] = a[j - 1];
+            a[j] = s;
+        }
+    }
+
+    /// Sort entries by their caches:  by least-significant-digit radix on
+    /// the bytes in which the caches differ, or for small groups by
+    /// comparison.
+    void sort_caches(string_entry* a, std::size_t n) const
+    {
+        std::uint64_t differ = 0;
+        for( std::size_t i = 1; i < n; ++i ) differ |= a[i].cache ^ a[0].cache;
+        if( differ == 0 ) return;
+        if( n < string_radix_threshold ) {
+            std::sort(a, a + n, string_entry_cache_less());
+            return;
+        }
+        unsigned digits[8];
+        unsigned passes = 0;
+        for( unsigned d = 0; d < 8; ++d )
+            if( (differ >> (8 * d)) & 0xff ) digits[passes++] = d;
+        std::size_t counts[8][256] = { };
+        for( std::size_t i = 0; i < n; ++i )
+            for( unsigned k = 0; k < passes; ++k )
+                ++counts[k][(a[i].cache >> (8 * digits[k])) & 0xff];
+        string_entry* from = a;
+        string_entry* to = scratch_;
+        for( unsigned k = 0; k < passes; ++k ) {
+            const unsigned d = digits[k];
+            std::size_t* const c = counts[k];
+            std::size_t sum = 0;
+            for( unsigned b = 0; b < 256; ++b ) {
+                const std::size_t t = c[b];
+                c[b] = sum;
+                sum += t;
+            }
+            for( std::size_t i = 0; i < n; ++i )
+                to[c[(from[i].cache >> (8 * d)) & 0xff]++] = from[i];
+            std::swap(from, to);
+        }
+        if( from != a ) std::copy(from, from + n, a);
+    }
+
+    /// Move the strings of a run of equal caches that end within the cached
+    /// bytes to the front of the run, shortest first, and return the rest.
+    string_entry* settle_ended(string_entry* a, std::size_t n,
+                               std::size_t depth) const
+    {
+        string_entry* e = a;
+        for( std::size_t i = 0; i < n; ++i )
+            if( strs_[a[i].index].n <= depth + 8 ) std::swap(*e++, a[i]);
+        std::sort(a, e, shorter(strs_));
+        return e;
+    }
+
+    struct shorter {
+        explicit shorter(const string_ref* s) : strs(s) { }
+        bool operator()(const string_entry& a, const string_entry& b) const
+        {
+            return strs[a.index].n < strs[b.index].n;
+        }
+        const string_ref* strs;
+    };
+
+    const string_ref* strs_;
+    string_entry* scratch_;
+};
+
+} // namespace detail
+
+/// Sort a range of strings.
+///
+/// Comparison sorts compare long shared prefixes over and over, and chase a
+/// pointer to the characters on every comparison.  This sorts an array of
+/// small string descriptors instead, by MSD radix on eight-byte characters:
+/// each descriptor caches the eight bytes at the depth being sorted as an
+/// integer, a group of descriptors is sorted on its caches by byte radix, and
+/// each run of equal caches moves on to the next eight bytes.  A string is
+/// read once per eight bytes of the prefix it shares with others, and a
+/// prefix every string shares costs one pass over the descriptors.  The
+/// strings themselves are then moved twice each, through a buffer in sorted
+/// order.
+///
+/// Bytes compare as unsigned, as with std::string's operator<.
+///
+/// \param first A _random access iterator_ pointing to the first string of
+/// the range.  The strings may be std::string, std::string_view, or
+/// null-terminated const char*;  a null pointer sorts as the empty string.
+///
+/// \param last A _random access iterator_ pointing to the last string of the
+/// range.
+template<typename Ran>
+void string_sort(Ran first, Ran last)
+{
+    const std::size_t n = last - first;
+    if( n < 2 ) return;
+    std::vector<detail::string_ref> strs(n);
+    std::vector<detail::string_entry> entries(n), scratch(n);
+    for( std::size_t i = 0; i < n; ++i ) {
+        const std::pair<const char*,std::size_t> s =
+            detail::string_bytes(first[i]);
+        strs[i].p = reinterpret_cast<const unsigned char*>(s.first);
+        strs[i].n = s.second;
+    }
+    const detail::string_sorter sorter(&strs[0], &scratch[0]);
+    for( std::size_t i = 0; i < n; ++i ) {
+        entries[i].index = i;
+        entries[i].cache = sorter.chunk(i, 0);
+    }
+    sorter.sort(&entries[0], n, 0);
+    typedef typename std::iterator_traits<Ran>::value_type value_t;
+    std::vector<value_t> sorted;
+    sorted.reserve(n);
+    for( std::size_t i = 0; i < n; ++i )
+        sorted.push_back(std::move(first[entries[i].index]));
+    std::move(sorted.begin(), sorted.end(), first);
+}
+
+namespace detail {
+
+template<typename Ran>
+void sort(Ran first, Ran last, std::false_type)
+{
+    std::sort(first, last);
+}
+
+template<typename Ran>
+void sort(Ran first, Ran last, std::true_type)
+{
+    wt::string_sort(first, last);
+}
+
+} // namespace detail
+
+} // namespace wt
+
+#include <wtl/sort_iseq.hh>
+
+#endif // SORT_HH_
@@ -0,0 +1,81 @@
+#ifndef SORT_ISEQ_HH_
+#define SORT_ISEQ_HH_
+
+#include <wtl/iseq.hh>
+#include <wtl/sort.hh>
+
+namespace wt {
+
+template<typename Ran, typename Out>
+Out argsort(input_sequence_range<Ran> range, Out res)
+{
+    WT_TRACE_ISEQ("argsort", range);
+    return wt::argsort(range.first, range.second, res);
+}
+
+template<typename Ran, typename Out, typename Cmp>
+Out argsort(input_sequence_range<Ran> range, Out res, Cmp c)
+{
+    WT_TRACE_ISEQ("argsort", range);
+    return wt::argsort(range.first, range.second, res, c);
+}
+
+template<typename Ran1, typename Ran2>
+void apply_permutation(input_sequence_range<Ran1> range, Ran2 perm)
+{
+    WT_TRACE_ISEQ("apply_permutation", range);
+    wt::apply_permutation(range.first, range.second, perm);
+}
+
+template<typename Ran1, typename Ran2, typename Out>
+Out gather(input_sequence_range<Ran1> map, Ran2 src, Out res)
+{
+    WT_TRACE_ISEQ("gather", map);
+    return wt::gather(map.first, map.second, src, res);
+}
+
+template<typename In, typename Ran1, typename Ran2>
+Ran2 scatter(input_sequence_range<In> range, Ran1 map, Ran2 dst)
+{
+    WT_TRACE_ISEQ("scatter", range);
+    return wt::scatter(range.first, range.second, map, dst);
+}
+
+template<typename Ran, typename KeyFn>
+void sort_by_key(input_sequence_range<Ran> range, KeyFn key)
+{
+    WT_TRACE_ISEQ("sort_by_key", range);
+    wt::sort_by_key(range.first, range.second, key);
+}
+
+template<typename Ran, typename KeyFn, typename Cmp>
+void sort_by_key(input_sequence_range<Ran> range, KeyFn key, Cmp c)
+{
+    WT_TRACE_ISEQ("sort_by_key", range);
+    wt::sort_by_key(range.first, range.second, key, c);
+}
+
+template<typename Ran, typename KeyFn>
+void stable_sort_by_key(input_sequence_range<Ran> range, KeyFn key)
+{
+    WT_TRACE_ISEQ("stable_sort_by_key", range);
+    wt::stable_sort_by_key(range.first, range.second, key);
+}
+
+template<typename Ran, typename KeyFn, typename Cmp>
+void stable_sort_by_key(input_sequence_range<Ran> range, KeyFn key, Cmp c)
+{
+    WT_TRACE_ISEQ("stable_sort_by_key", range);
+    wt::stable_sort_by_key(range.first, range.second, key, c);
+}
+
+template<typename Ran>
+void string_sort(input_sequence_range<Ran> range)
+{
+    WT_TRACE_ISEQ("string_sort", range);
+    wt::string_sort(range.first, range.second);
+}
+
+} // namespace wt
+
+#endif // SORT_ISEQ_HH_
@@ -0,0 +1,478 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include <wtl/algorithm.hh>
+#include <wtl/random.hh>
+#include "check.hh"
+
+namespace {
+
+// Large enough that the parallel algorithms split the work among threads.
+const std::size_t big = 300000;
+
+bool even(int x) { return x % 2 == 0; }
+
+// An input iterator whose postfix increment returns nothing, as C++20
+// allows:  algorithms over input sequences must not read through *it++.
+struct single_pass {
+    typedef std::input_iterator_tag iterator_category;
+    typedef int value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const int* pointer;
+    typedef const int& reference;
+
+    const int* p;
+
+    reference operator*() const { return *p; }
+    single_pass& operator++() { ++p; return *this; }
+    void operator++(int) { ++p; }
+    bool operator==(const single_pass& o) const { return p == o.p; }
+    bool operator!=(const single_pass& o) const { return p != o.p; }
+};
+
+void copy_until_while()
+{
+    const std::vector<int> v = { 1, 3, 5, 6, 7, 8 };
+    std::vector<int> out;
+    wt::copy_until(v.begin(), v.end(), std::back_inserter(out), even);
+    CHECK((out == std::vector<int>{ 1, 3, 5 }));
+    out.clear();
+    wt::copy_while(v.begin(), v.end(), std::back_inserter(out),
+                   [](int x) { return x < 6; });
+    CHECK((out == std::vector<int>{ 1, 3, 5 }));
+    out.clear();
+    wt::copy_until(v.begin(), v.begin(), std::back_inserter(out), even);
+    CHECK(out.empty());
+
+    const single_pass first = { v.data() }, last = { v.data() + v.size() };
+    wt::copy_until(first, last, std::back_inserter(out), even);
+    CHECK((out == std::vector<int>{ 1, 3, 5 }));
+    out.clear();
+    wt::copy_while(first, last, std::back_inserter(out),
+                   [](int x) { return x != 7; });
+    CHECK((out == std::vector<int>{ 1, 3, 5, 6 }));
+}
+
+void top_k_sample()
+{
+    const std::vector<int> v = test::random_ints<int>(10000, 0, 500);
+    for( std::size_t k : { 0u, 1u, 7u, 10000u, 20000u } ) {
+        std::vector<int> expect(v);
+        std::sort(expect.begin(), expect.end(), std::greater<int>());
+        expect.resize(std::min(k, v.size()));
+        std::vector<int> out;
+        wt::top_k(v.begin(), v.end(), k, std::back_inserter(out));
+        CHECK(out == expect);
+    }
+
+    std::mt19937 g(7);
+    std::vector<int> ids(1000);
+    for( int i = 0; i < 1000; ++i ) ids[i] = i;
+    std::vector<int> s;
+    wt::sample(ids.begin(), ids.end(), 50, std::back_inserter(s), g);
+    CHECK(s.size() == 50);
+    std::sort(s.begin(), s.end());
+    CHECK(std::adjacent_find(s.begin(), s.end()) == s.end());
+    CHECK(s.back() < 1000);
+    s.clear();
+    wt::sample(ids.begin(), ids.begin() + 10, 50, std::back_inserter(s), g);
+    CHECK(s.size() == 10);
+}
+
+// Lengths around the vector widths, and a difference at each end and in the
+// middle, so that both the vector loop and its tail find it.
+template<typename T>
+void comparisons()
+{
+    for( std::size_t n : { 0u, 1u, 15u, 16u, 17u, 63u, 64u, 65u, 1000u } ) {
+        std::vector<T> a(n);
+        for( std::size_t i = 0; i < n; ++i ) a[i] = T(i % 100);
+        std::vector<T> b(a);
+        CHECK(wt::equal(wt::iseq(a), wt::iseq(b)));
+        CHECK(wt::mismatch(wt::iseq(a), b.begin()).first == a.end());
+        CHECK(wt::match(wt::iseq(a), wt::iseq(b)).first == a.begin());
+        CHECK(!wt::lexicographical_compare(wt::iseq(a), wt::iseq(b)));
+        if( n == 0 ) continue;
+        CHECK(!wt::equal(wt::iseq(a), wt::iseq(b.begin(), b.end() - 1)));
+        CHECK(wt::lexicographical_compare(wt::iseq(a.begin(), a.end() - 1),
+                                          wt::iseq(b)));
+        for( std::size_t at : { std::size_t(0), n / 2, n - 1 } ) {
+            b = a;
+            b[at] = T(b[at] + 1);
+            CHECK(!wt::equal(wt::iseq(a), wt::iseq(b)));
+            CHECK(wt::mismatch(wt::iseq(a), b.begin()).first - a.begin() ==
+                  std::ptrdiff_t(at));
+            CHECK(wt::lexicographical_compare(wt::iseq(a), wt::iseq(b)));
+            CHECK(!wt::lexicographical_compare(wt::iseq(b), wt::iseq(a)));
+
+            // Unequal everywhere but at.
+            std::vector<T> c(a);
+            for( std::size_t i = 0; i < n; ++i )
+                if( i != at ) c[i] = T(c[i] + 1);
+            CHECK(wt::match(wt::iseq(a), wt::iseq(c)).first - a.begin() ==
+                  std::ptrdiff_t(at));
+        }
+    }
+}
+
+void nan_comparisons()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> a(40, 1.0), b(a);
+    a[20] = b[20] = nan;
+    CHECK(!wt::equal(wt::iseq(a), wt::iseq(b)));
+    CHECK(wt::mismatch(wt::iseq(a), b.begin()).first - a.begin() == 20);
+    b[30] = 2.0;
+    CHECK(wt::lexicographical_compare(wt::iseq(a), wt::iseq(b)) ==
+          std::lexicographical_compare(a.begin(), a.end(),
+                                       b.begin(), b.end()));
+}
+
+void distinct_count_by()
+{
+    const std::vector<int> v = test::random_ints<int>(5000, -300, 300);
+    std::vector<int> expect;
+    std::set<int> seen;
+    for( int x : v )
+        if( seen.insert(x).second ) expect.push_back(x);
+    std::vector<int> out;
+    wt::distinct(v.begin(), v.end(), std::back_inserter(out));
+    CHECK(out == expect);
+    CHECK(wt::count_distinct(v.begin(), v.end()) == seen.size());
+
+    std::map<int,std::size_t> counts;
+    for( int x : v ) ++counts[x % 7];
+    const auto by = wt::count_by(v.begin(), v.end(),
+                                 [](int x) { return x % 7; });
+    CHECK(by.size() == counts.size());
+    for( const auto& kv : counts ) {
+        const auto it = by.find(kv.first);
+        CHECK(it != by.end() && it->second == kv.second);
+    }
+
+    const std::vector<int> w = test::random_ints<int>(big, 0, 100000);
+    CHECK(wt::count_distinct(wt::par(4), w.begin(), w.end()) ==
+          std::set<int>(w.begin(), w.end()).size());
+    std::vector<int> pout;
+    wt::distinct(wt::par(4), w.begin(), w.end(), std::back_inserter(pout));
+    std::vector<int> sout;
+    wt::distinct(w.begin(), w.end(), std::back_inserter(sout));
+    CHECK(pout == sout);
+}
+
+void histograms()
+{
+    const std::vector<int> v = test::random_ints<int>(big, -5, 260);
+    std::vector<std::size_t> expect(256);
+    for( int x : v )
+        if( x >= 0 && x < 256 ) ++expect[x];
+    CHECK(wt::histogram(v.begin(), v.end(), 256) == expect);
+    CHECK(wt::histogram(wt::par(4), v.begin(), v.end(), 256) == expect);
+
+    const std::vector<double> d = { -1.0, 0.0, 0.5, 2.5, 9.99, 10.0, 11.0 };
+    const std::vector<std::size_t> bins =
+        wt::histogram(d.begin(), d.end(), 0.0, 10.0, 4);
+    CHECK((bins == std::vector<std::size_t>{ 2, 1, 0, 2 }));
+
+    // An empty interval keeps only the values at its point, in the first bin.
+    const std::vector<std::size_t> point =
+        wt::histogram(d.begin(), d.end(), 10.0, 10.0, 3);
+    CHECK((point == std::vector<std::size_t>{ 1, 0, 0 }));
+    CHECK((wt::histogram(wt::par(4), d.begin(), d.end(), 0.0, 0.0, 2) ==
+           std::vector<std::size_t>{ 1, 0 }));
+}
+
+void counting_sorts()
+{
+    std::vector<int> v = test::random_ints<int>(big, 0, 999);
+    std::vector<int> expect(v);
+    std::sort(expect.begin(), expect.end());
+    std::vector<int> a(v);
+    wt::counting_sort(a.begin(), a.end(), 1000);
+    CHECK(a == expect);
+    a = v;
+    wt::counting_sort(wt::par(4), a.begin(), a.end(), 1000);
+    CHECK(a == expect);
+
+    // By key, the sort is stable.
+    const auto key = [](int x) { return x % 10; };
+    const auto by_key = [&](int x, int y) { return key(x) < key(y); };
+    expect = v;
+    std::stable_sort(expect.begin(), expect.end(), by_key);
+    a = v;
+    wt::counting_sort(a.begin(), a.end(), 10, key);
+    CHECK(a == expect);
+    a = v;
+    wt::counting_sort(wt::par(4), a.begin(), a.end(), 10, key);
+    CHECK(a == expect);
+}
+
+void compaction()
+{
+    const std::vector<int> v = test::random_ints<int>(big, 0, 50);
+    std::vector<int> expect, out;
+    std::copy_if(v.begin(), v.end(), std::back_inserter(expect), even);
+    wt::copy_if(v.begin(), v.end(), std::back_inserter(out), even);
+    CHECK(out == expect);
+    out.assign(v.size(), -1);
+    out.erase(wt::copy_if(wt::par(4), v.begin(), v.end(), out.begin(), even),
+              out.end());
+    CHECK(out == expect);
+
+    std::vector<int> a(v), b(v);
+    a.erase(std::remove_if(a.begin(), a.end(), even), a.end());
+    b.erase(wt::remove_if(wt::par(4), b.begin(), b.end(), even), b.end());
+    CHECK(a == b);
+
+    std::vector<int> s(v);
+    std::sort(s.begin(), s.end());
+    a = s;
+    b = s;
+    a.erase(std::unique(a.begin(), a.end()), a.end());
+    b.erase(wt::unique(wt::par(4), b.begin(), b.end()), b.end());
+    CHECK(a == b);
+    a = v;
+    b = v;
+    a.erase(std::unique(a.begin(), a.end()), a.end());
+    b.erase(wt::unique(wt::par(4), b.begin(), b.end()), b.end());
+    CHECK(a == b);
+    out.assign(v.size(), -1);
+    out.erase(wt::unique_copy(wt::par(4), v.begin(), v.end(), out.begin()),
+              out.end());
+    CHECK(out == a);
+}
+
+void merges()
+{
+    for( std::size_t split : { std::size_t(0), std::size_t(1), big / 3,
+                               big } ) {
+        std::vector<int> v = test::random_ints<int>(big, 0, 1000, split);
+        std::sort(v.begin(), v.begin() + split);
+        std::sort(v.begin() + split, v.end());
+        std::vector<int> expect(v.size()), out(v.size());
+        std::merge(v.begin(), v.begin() + split, v.begin() + split, v.end(),
+                   expect.begin());
+        wt::merge(wt::par(4), v.begin(), v.begin() + split,
+                  v.begin() + split, v.end(), out.begin());
+        CHECK(out == expect);
+        wt::inplace_merge(wt::par(4), v.begin(), v.begin() + split, v.end());
+        CHECK(v == expect);
+    }
+
+    // Stability:  equal keys keep the first range's elements first.
+    std::vector<std::pair<int,int> > p(big);
+    for( std::size_t i = 0; i < big; ++i )
+        p[i] = std::make_pair(int(i % (big / 2)) / 4, int(i));
+    const auto by_first = [](const std::pair<int,int>& x,
+                             const std::pair<int,int>& y) {
+        return x.first < y.first;
+    };
+    std::vector<std::pair<int,int> > q(p);
+    std::inplace_merge(p.begin(), p.begin() + big / 2, p.end(), by_first);
+    wt::inplace_merge(wt::par(4), q.begin(), q.begin() + big / 2, q.end(),
+                      by_first);
+    CHECK(p == q);
+}
+
+void partitions()
+{
+    const std::vector<int> v = test::random_ints<int>(big, 0, 1000);
+    std::vector<int> a(v), b(v);
+    const auto mid = wt::partition(wt::par(4), a.begin(), a.end(), even);
+    CHECK(std::is_partitioned(a.begin(), a.end(), even));
+    CHECK(mid - a.begin() == std::count_if(v.begin(), v.end(), even));
+    CHECK(test::same_elements(a, v));
+
+    a = v;
+    std::stable_partition(b.begin(), b.end(), even);
+    wt::stable_partition(wt::par(4), a.begin(), a.end(), even);
+    CHECK(a == b);
+
+    // Each key's elements form one group, in key order.
+    const auto key = [](int x) { return x % 10; };
+    a = v;
+    const std::vector<std::size_t> r =
+        wt::multiway_partition(a.begin(), a.end(), 10, key);
+    CHECK(r.size() == 11 && r.front() == 0 && r.back() == a.size());
+    for( std::size_t b = 0; b < 10; ++b )
+        for( std::size_t i = r[b]; i < r[b + 1]; ++i )
+            CHECK(std::size_t(key(a[i])) == b);
+    CHECK(test::same_elements(a, v));
+}
+
+void random_fills()
+{
+    std::vector<int> v(big);
+    for( std::size_t i = 0; i < big; ++i ) v[i] = int(i);
+    wt::wyrand g(3);
+    std::vector<int> a(v);
+    wt::shuffle(a.begin(), a.end(), g);
+    CHECK(a != v);
+    CHECK(test::same_elements(a, v));
+    a = v;
+    wt::shuffle(wt::par(4), a.begin(), a.end(), g);
+    CHECK(a != v);
+    CHECK(test::same_elements(a, v));
+    std::vector<int> none;
+    wt::shuffle(none.begin(), none.end(), g);
+
+    // The same generator state gives the same parallel shuffle.
+    wt::wyrand g1(5), g2(5);
+    a = v;
+    std::vector<int> b(v);
+    wt::shuffle(wt::par(4), a.begin(), a.end(), g1);
+    wt::shuffle(wt::par(4), b.begin(), b.end(), g2);
+    CHECK(a == b);
+
+    // random_shuffle() draws n - 1 positions, each from at least two.
+    std::size_t draws = 0, smallest = big;
+    const auto pick = [&](std::size_t k) {
+        ++draws;
+        smallest = std::min(smallest, k);
+        return k - 1;
+    };
+    a = v;
+    wt::random_shuffle(wt::iseq(a), pick);
+    CHECK(draws == big - 1 && smallest == 2);
+    CHECK(test::same_elements(a, v));
+    draws = 0;
+    wt::random_shuffle(wt::iseq(none), pick);
+    CHECK(draws == 0);
+
+    const std::uniform_int_distribution<int> dist(0, 1 << 20);
+    std::vector<int> s(big), p(big);
+    wt::generate_random(s.begin(), s.end(), 42, dist);
+    wt::generate_random(wt::par(4), p.begin(), p.end(), 42, dist);
+    CHECK(s == p);
+    std::vector<int> tail(big / 2);
+    wt::generate_random(tail.begin(), tail.end(), 43, dist);
+    CHECK(!std::equal(tail.begin(), tail.end(), s.begin()));
+}
+
+// A 16-byte trivially copyable element, for the widest reverse kernel.
+struct wide {
+    std::uint64_t lo, hi;
+    bool operator==(const wide& o) const { return lo == o.lo && hi == o.hi; }
+};
+
+template<typename T>
+std::vector<T> sequence(std::size_t n)
+{
+    std::vector<T> v(n);
+    for( std::size_t i = 0; i < n; ++i ) v[i] = T(i * 2654435761u);
+    return v;
+}
+
+template<>
+std::vector<wide> sequence<wide>(std::size_t n)
+{
+    std::vector<wide> v(n);
+    for( std::size_t i = 0; i < n; ++i ) {
+        v[i].lo = i;
+        v[i].hi = ~std::uint64_t(i);
+    }
+    return v;
+}
+
+// Lengths off the vector widths of each element size, so that the kernels'
+// tails and the meeting of the two ends in the middle are reached.
+template<typename T>
+void reverses()
+{
+    for( std::size_t n : { 0u, 1u, 2u, 3u, 7u, 15u, 17u, 31u, 33u, 63u, 65u,
+                           127u, 129u, 1001u } ) {
+        const std::vector<T> v = sequence<T>(n);
+        std::vector<T> a(v), b(v);
+        std::reverse(a.begin(), a.end());
+        wt::reverse(wt::iseq(b));
+        CHECK(a == b);
+        std::vector<T> out(n);
+        wt::reverse_copy(wt::iseq(v), out.begin());
+        CHECK(out == a);
+    }
+}
+
+// Where the shorter side fits the rotation buffer it goes through it;
+// otherwise blocks are swapped first.  Middles from first to last are tried.
+template<typename T>
+void rotations()
+{
+    const std::size_t fits = wt::detail::rotate_buffer_bytes / sizeof(T);
+    for( std::size_t n : { std::size_t(0), std::size_t(1), std::size_t(2),
+                           std::size_t(100), 2 * fits, 2 * fits + 3,
+                           std::size_t(20000) } ) {
+        const std::vector<T> v = sequence<T>(n);
+        for( std::size_t m : { std::size_t(0), std::size_t(1), n / 3, n / 2,
+                               n - n / 3, n - 1, n } ) {
+            if( m > n ) continue;
+            std::vector<T> a(v), b(v);
+            std::rotate(a.begin(), a.begin() + m, a.end());
+            wt::rotate(wt::iseq(b), b.begin() + m);
+            CHECK(a == b);
+            std::vector<T> out(n);
+            wt::rotate_copy(wt::iseq(v), v.begin() + m, out.begin());
+            CHECK(out == a);
+        }
+    }
+}
+
+void bulk_moves()
+{
+    const std::vector<int> v = test::random_ints<int>(big + 13, 0, 1 << 30);
+    std::vector<int> a(v), b(v);
+    std::reverse(a.begin(), a.end());
+    wt::reverse(wt::par(4), b.begin(), b.end());
+    CHECK(a == b);
+
+    std::vector<int> out(v.size());
+    wt::reverse_copy(wt::par(4), v.begin(), v.end(), out.begin());
+    CHECK(out == a);
+    wt::copy(wt::par(4), v.begin(), v.end(), out.begin());
+    CHECK(out == v);
+
+    a = v;
+    b = v;
+    std::reverse(b.begin(), b.end());
+    std::vector<int> c(b);
+    wt::swap_ranges(wt::par(4), a.begin(), a.end(), c.begin());
+    CHECK(a == b && c == v);
+}
+
+} // namespace
+
+int main()
+{
+    copy_until_while();
+    top_k_sample();
+    comparisons<std::uint8_t>();
+    comparisons<std::int16_t>();
+    comparisons<int>();
+    comparisons<std::int64_t>();
+    comparisons<float>();
+    comparisons<double>();
+    nan_comparisons();
+    distinct_count_by();
+    histograms();
+    counting_sorts();
+    compaction();
+    merges();
+    partitions();
+    random_fills();
+    bulk_moves();
+    reverses<std::uint8_t>();
+    reverses<std::uint16_t>();
+    reverses<int>();
+    reverses<std::uint64_t>();
+    reverses<wide>();
+    rotations<std::uint8_t>();
+    rotations<int>();
+    rotations<wide>();
+    return test::result();
+}
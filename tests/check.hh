@@ -0,0 +1,87 @@
+#ifndef TESTS_CHECK_HH_
+#define TESTS_CHECK_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// Unit test checks
+///
+/// Each test program checks the wt:: algorithms of one header against the
+/// std:: algorithms, or the naive loops, that compute the same result, over
+/// the edge cases the benchmark grid doesn't reach:  empty and tiny inputs,
+/// ties, malformed encodings, and sizes just past each vectorized block.  A
+/// failed check prints its file, line and expression and the program carries
+/// on, so one run reports every failure;  it then exits with a failure code.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace test {
+
+inline int& failures()
+{
+    static int n = 0;
+    return n;
+}
+
+inline void fail(const char* file, int line, const char* expr)
+{
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+    ++failures();
+}
+
+/// The exit status of a test program.
+inline int result()
+{
+    if( failures() != 0 )
+        std::fprintf(stderr, "%d check(s) failed\n", failures());
+    return failures() == 0 ? 0 : 1;
+}
+
+/// n random integers in [lo, hi], the same ones for the same seed.
+template<typename T>
+std::vector<T> random_ints(std::size_t n, T lo, T hi, std::uint64_t seed = 1)
+{
+    std::mt19937_64 g(seed);
+    std::uniform_int_distribution<T> d(lo, hi);
+    std::vector<T> v(n);
+    for( std::size_t i = 0; i < n; ++i ) v[i] = d(g);
+    return v;
+}
+
+/// Whether two ranges hold the same elements, in any order.
+template<typename It1, typename It2>
+bool same_elements(It1 first1, It1 last1, It2 first2, It2 last2)
+{
+    std::vector<typename std::iterator_traits<It1>::value_type>
+        a(first1, last1), b(first2, last2);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+template<typename C1, typename C2>
+bool same_elements(const C1& a, const C2& b)
+{
+    return same_elements(a.begin(), a.end(), b.begin(), b.end());
+}
+
+} // namespace test
+
+#define CHECK(expr)                                                         \
+    do {                                                                    \
+        if( !(expr) ) test::fail(__FILE__, __LINE__, #expr);                \
+    } while( false )
+
+/// Check that a statement throws an exception of type E.
+#define CHECK_THROWS(E, stmt)                                               \
+    do {                                                                    \
+        bool thrown_ = false;                                               \
+        try { stmt; } catch( const E& ) { thrown_ = true; }                 \
+        if( !thrown_ ) test::fail(__FILE__, __LINE__, #stmt " throws " #E); \
+    } while( false )
+
+#endif // TESTS_CHECK_HH_
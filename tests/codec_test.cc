@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <wtl/codec.hh>
+#include <wtl/iseq.hh>
+#include "check.hh"
+
+namespace {
+
+void zigzag_delta()
+{
+    const std::vector<std::int64_t> v = {
+        0, -1, 1, std::numeric_limits<std::int64_t>::min(),
+        std::numeric_limits<std::int64_t>::max(), -123456789 };
+    std::vector<std::uint64_t> z;
+    wt::zigzag_encode(v.begin(), v.end(), std::back_inserter(z));
+    CHECK((std::vector<std::uint64_t>(z.begin(), z.begin() + 3) ==
+           std::vector<std::uint64_t>{ 0, 1, 2 }));
+    std::vector<std::int64_t> back;
+    wt::zigzag_decode(z.begin(), z.end(), std::back_inserter(back));
+    CHECK(back == v);
+
+    const std::vector<int> s = test::random_ints<int>(10001, -1000, 1000);
+    std::vector<int> expect(s.size()), d(s.size()), r(s.size());
+    std::adjacent_difference(s.begin(), s.end(), expect.begin());
+    wt::delta_encode(s.begin(), s.end(), d.begin());
+    CHECK(d == expect);
+    wt::delta_decode(d.begin(), d.end(), r.begin());
+    CHECK(r == s);
+    std::deque<int> dq(d.begin(), d.end());
+    std::vector<int> r2;
+    wt::delta_decode(dq.begin(), dq.end(), std::back_inserter(r2));
+    CHECK(r2 == s);
+}
+
+void varints()
+{
+    std::vector<std::uint64_t> v = test::random_ints<std::uint64_t>(
+        5000, 0, std::numeric_limits<std::uint64_t>::max());
+    v.push_back(0);
+    v.push_back(127);
+    v.push_back(128);
+    v.push_back(std::numeric_limits<std::uint64_t>::max());
+    std::vector<std::uint8_t> bytes;
+    wt::varint_encode(v.begin(), v.end(), std::back_inserter(bytes));
+    std::vector<std::uint64_t> back;
+    wt::varint_decode(bytes.begin(), bytes.end(), std::back_inserter(back));
+    CHECK(back == v);
+
+    // A truncated varint, one of 65 bits, and one longer than ten bytes.
+    const std::vector<std::uint8_t> cut = { 0x81, 0x80 };
+    CHECK_THROWS(std::invalid_argument,
+                 wt::varint_decode(cut.begin(), cut.end(),
+                                   std::back_inserter(back)));
+    std::vector<std::uint8_t> ten(9, 0xff);
+    ten.push_back(0x01);
+    back.clear();
+    wt::varint_decode(ten.begin(), ten.end(), std::back_inserter(back));
+    CHECK(back.size() == 1 &&
+          back[0] == std::numeric_limits<std::uint64_t>::max());
+    ten.back() = 0x02;
+    CHECK_THROWS(std::invalid_argument,
+                 wt::varint_decode(ten.begin(), ten.end(),
+                                   std::back_inserter(back)));
+    const std::vector<std::uint8_t> eleven(11, 0x80);
+    CHECK_THROWS(std::invalid_argument,
+                 wt::varint_decode(eleven.begin(), eleven.end(),
+                                   std::back_inserter(back)));
+}
+
+void stream_vbyte()
+{
+    // Lengths of every width, and counts around the vector loop's blocks.
+    std::vector<std::uint32_t> all;
+    const std::vector<std::uint32_t> r = test::random_ints<std::uint32_t>(
+        2000, 0, std::numeric_limits<std::uint32_t>::max());
+    for( std::size_t i = 0; i < r.size(); ++i )
+        all.push_back(r[i] >> (8 * (i % 4)));
+    for( std::size_t n : { 0u, 1u, 3u, 4u, 15u, 16u, 17u, 1023u, 2000u } ) {
+        const std::vector<std::uint32_t> v(all.begin(), all.begin() + n);
+        std::vector<std::uint8_t> bytes;
+        wt::stream_vbyte_encode(v.begin(), v.end(), std::back_inserter(bytes));
+        std::vector<std::uint32_t> back(n);
+        wt::stream_vbyte_decode(bytes.begin(), bytes.end(), n, back.begin());
+        CHECK(back == v);
+        const std::deque<std::uint8_t> dq(bytes.begin(), bytes.end());
+        std::fill(back.begin(), back.end(), 0);
+        wt::stream_vbyte_decode(wt::iseq(dq), n, back.begin());
+        CHECK(back == v);
+
+        // Cut short anywhere, in the control bytes or in the data, the
+        // input is rejected, without reading past its end.
+        if( n == 0 ) continue;
+        for( std::size_t cut = 1; cut <= 17 && cut <= bytes.size(); ++cut ) {
+            const std::vector<std::uint8_t> part(bytes.begin(),
+                                                 bytes.end() - cut);
+            CHECK_THROWS(std::invalid_argument,
+                         wt::stream_vbyte_decode(part.begin(), part.end(), n,
+                                                 back.begin()));
+            const std::deque<std::uint8_t> dpart(part.begin(), part.end());
+            CHECK_THROWS(std::invalid_argument,
+                         wt::stream_vbyte_decode(dpart.begin(), dpart.end(),
+                                                 n, back.begin()));
+        }
+    }
+}
+
+void bitpacking()
+{
+    for( std::size_t n : { 0u, 1u, 127u, 128u, 129u, 1000u } ) {
+        std::vector<std::int64_t> v = test::random_ints<std::int64_t>(
+            n, -(std::int64_t(1) << 40), std::int64_t(1) << 40);
+        std::vector<std::uint8_t> bytes;
+        wt::bitpack_encode(v.begin(), v.end(), std::back_inserter(bytes));
+        std::vector<std::int64_t> back;
+        wt::bitpack_decode(bytes.begin(), bytes.end(),
+                           std::back_inserter(back));
+        CHECK(back == v);
+        const std::deque<std::uint8_t> dq(bytes.begin(), bytes.end());
+        back.clear();
+        wt::bitpack_decode(dq.begin(), dq.end(), std::back_inserter(back));
+        CHECK(back == v);
+        if( !bytes.empty() ) {
+            bytes.pop_back();
+            CHECK_THROWS(std::invalid_argument,
+                         wt::bitpack_decode(bytes.begin(), bytes.end(),
+                                            std::back_inserter(back)));
+        }
+    }
+}
+
+void run_lengths()
+{
+    std::vector<int> v = test::random_ints<int>(10000, 0, 2);
+    std::vector<int> values, expect_values;
+    std::vector<std::size_t> lengths, expect_lengths;
+    for( std::size_t i = 0; i < v.size(); ++i ) {
+        if( i == 0 || v[i] != v[i - 1] ) {
+            expect_values.push_back(v[i]);
+            expect_lengths.push_back(0);
+        }
+        ++expect_lengths.back();
+    }
+    wt::run_length_encode(v.begin(), v.end(), std::back_inserter(values),
+                          std::back_inserter(lengths));
+    CHECK(values == expect_values && lengths == expect_lengths);
+    std::vector<int> back;
+    wt::run_length_decode(values.begin(), values.end(), lengths.begin(),
+                          std::back_inserter(back));
+    CHECK(back == v);
+}
+
+} // namespace
+
+int main()
+{
+    zigzag_delta();
+    varints();
+    stream_vbyte();
+    bitpacking();
+    run_lengths();
+    return test::result();
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include <wtl/algorithm.hh>
+#include <wtl/flat_hash.hh>
+#include <wtl/numeric.hh>
+#include <wtl/sink.hh>
+#include <wtl/soa_vector.hh>
+#include <wtl/sort.hh>
+#include "check.hh"
+
+namespace {
+
+bool odd(int x) { return x % 2 != 0; }
+
+// A field whose copies throw once armed.
+struct fragile {
+    static bool armed;
+    int v;
+    explicit fragile(int x = 0) : v(x) { }
+    fragile(const fragile& o) : v(o.v)
+    {
+        if( armed ) throw std::runtime_error("fragile");
+    }
+    fragile& operator=(const fragile&) = default;
+};
+
+bool fragile::armed = false;
+
+void soa()
+{
+    const std::vector<int> ids = test::random_ints<int>(1000, 0, 1 << 20);
+    wt::soa_vector<int, double, std::string> v;
+    for( std::size_t i = 0; i < ids.size(); ++i )
+        v.push_back(ids[i], ids[i] * 0.5, std::to_string(ids[i]));
+    CHECK(v.size() == ids.size());
+    CHECK(wt::accumulate(wt::iseq<0>(v), 0LL) ==
+          std::accumulate(ids.begin(), ids.end(), 0LL));
+
+    // Sorting the records keeps every row's fields together.
+    typedef std::tuple<const int&, const double&, const std::string&> row;
+    wt::sort(wt::iseq(v), [](row a, row b) {
+        return std::get<0>(a) < std::get<0>(b);
+    });
+    std::vector<int> sorted(ids);
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(v.column<0>() == sorted);
+    for( std::size_t i = 0; i < v.size(); ++i ) {
+        CHECK(std::get<1>(v[i]) == std::get<0>(v[i]) * 0.5);
+        CHECK(std::get<2>(v[i]) == std::to_string(std::get<0>(v[i])));
+    }
+
+    // permute() by an argsort of one column is the same reordering.
+    std::vector<std::size_t> perm(v.size());
+    wt::argsort(v.column<2>().begin(), v.column<2>().end(), perm.begin());
+    v.permute(perm.begin());
+    CHECK(std::is_sorted(v.column<2>().begin(), v.column<2>().end()));
+    CHECK(std::get<2>(v[0]) == std::to_string(std::get<0>(v[0])));
+
+    v.pop_back();
+    CHECK(v.size() == ids.size() - 1 && v.column<1>().size() == v.size());
+    v.clear();
+    CHECK(v.empty());
+
+    // A record whose last field fails to copy isn't added in part.
+    wt::soa_vector<int, std::string, fragile> f;
+    f.push_back(1, "one", fragile(1));
+    const fragile two(2);
+    const std::tuple<int, std::string, fragile> three(3, "three", two);
+    fragile::armed = true;
+    CHECK_THROWS(std::runtime_error, f.push_back(2, "two", two));
+    CHECK_THROWS(std::runtime_error, f.push_back(three));
+    fragile::armed = false;
+    CHECK(f.size() == 1 && f.column<0>().size() == 1 &&
+          f.column<1>().size() == 1 && f.column<2>().size() == 1);
+    f.push_back(4, "four", two);
+    CHECK(f.size() == 2 && std::get<1>(f[1]) == "four" &&
+          std::get<2>(f[1]).v == 2);
+}
+
+void hashes()
+{
+    const std::vector<int> v = test::random_ints<int>(50000, -20000, 20000);
+    wt::flat_hash_set<int> s(v.begin(), v.end());
+    const std::set<int> expect(v.begin(), v.end());
+    CHECK(s.size() == expect.size());
+    for( int x = -20010; x <= 20010; ++x )
+        CHECK(s.count(x) == expect.count(x));
+    CHECK(!s.insert(v[0]).second);
+
+    wt::flat_hash_map<int,int> m;
+    std::unordered_map<int,int> um;
+    for( int x : v ) {
+        ++m[x / 3];
+        ++um[x / 3];
+    }
+    CHECK(m.size() == um.size());
+    for( const auto& kv : um ) {
+        const auto it = m.find(kv.first);
+        CHECK(it != m.end() && it->second == kv.second);
+    }
+    CHECK(m.find(1 << 30) == m.end());
+}
+
+void sinks()
+{
+    const std::vector<int> v = test::random_ints<int>(10000, 0, 1000);
+    std::vector<int> expect, out;
+    std::copy_if(v.begin(), v.end(), std::back_inserter(expect), odd);
+    wt::copy_if(wt::iseq(v), wt::into(out), odd);
+    CHECK(out == expect);
+    std::deque<int> dq;
+    wt::copy_if(wt::iseq(v), wt::into(dq), odd);
+    CHECK(std::equal(dq.begin(), dq.end(), expect.begin()) &&
+          dq.size() == expect.size());
+
+    // Appending keeps what the container already holds.
+    out.assign(3, -1);
+    wt::copy(wt::iseq(v), wt::into(out));
+    CHECK(out.size() == v.size() + 3 &&
+          std::equal(v.begin(), v.end(), out.begin() + 3));
+
+    const std::list<int> l(v.begin(), v.end());
+    out.clear();
+    wt::copy_until(wt::iseq(l), wt::into(out),
+                   [](int x) { return x > 990; });
+    expect.assign(v.begin(), std::find_if(v.begin(), v.end(),
+                                          [](int x) { return x > 990; }));
+    CHECK(out == expect);
+
+    // Runs of duplicates straddle the blocks the compaction appends by.
+    std::vector<int> runs(1 << 20);
+    for( std::size_t i = 0; i < runs.size(); ++i ) runs[i] = int(i / 1000);
+    expect.clear();
+    std::unique_copy(runs.begin(), runs.end(), std::back_inserter(expect));
+    out.assign(1, -1);
+    wt::unique_copy(wt::iseq(runs), wt::into(out));
+    CHECK(out.size() == expect.size() + 1 &&
+          std::equal(expect.begin(), expect.end(), out.begin() + 1));
+    out.clear();
+    wt::unique_copy(wt::iseq(runs), wt::into(out),
+                    [](int a, int b) { return a / 2 == b / 2; });
+    CHECK(out.size() == std::size_t(runs.back() + 2) / 2 && out[1] == 2);
+
+    // A filter that keeps little of a large input doesn't grow the
+    // container to the input's size.
+    out = std::vector<int>();
+    wt::remove_copy_if(wt::iseq(runs), wt::into(out),
+                       [](int x) { return x != 7; });
+    CHECK(out == std::vector<int>(1000, 7));
+    CHECK(out.capacity() < runs.size() / 8);
+
+    std::vector<std::string> strs(100, std::string(40, 'x')), moved;
+    wt::move_if(wt::iseq(strs), wt::into(moved),
+                [](const std::string& s) { return !s.empty(); });
+    CHECK(moved.size() == 100 && moved[99] == std::string(40, 'x'));
+}
+
+} // namespace
+
+int main()
+{
+    soa();
+    hashes();
+    sinks();
+    return test::result();
+}
@@ -0,0 +1,95 @@
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <wtl/algorithm.hh>
+#include <wtl/generator.hh>
+#include <wtl/numeric.hh>
+#include <wtl/sink.hh>
+#include "check.hh"
+
+namespace {
+
+wt::generator<int> naturals()
+{
+    for( int i = 0; ; ++i ) co_yield i;
+}
+
+wt::generator<int> below(int n)
+{
+    for( int i = 0; i < n; ++i ) co_yield i;
+}
+
+wt::generator<std::string> words()
+{
+    co_yield "a";
+    co_yield std::string("bb");
+    const std::string s = "ccc";
+    co_yield s;
+}
+
+wt::generator<int> failing()
+{
+    co_yield 1;
+    throw std::runtime_error("failing");
+}
+
+void algorithms()
+{
+    wt::generator<int> g = naturals();
+    const auto it = wt::find_if(wt::iseq(g),
+                                [](int x) { return x * x > 1000; });
+    CHECK(*it == 32);
+    wt::generator<int> moved = std::move(g);
+    CHECK(*moved.begin() == 32);
+
+    CHECK(wt::accumulate(wt::iseq(below(101)), 0) == 5050);
+    CHECK(wt::count_if(wt::iseq(below(50)),
+                       [](int x) { return x % 5 == 0; }) == 10);
+
+    std::vector<int> v;
+    wt::copy_if(wt::iseq(below(10)), wt::into(v),
+                [](int x) { return x % 2 != 0; });
+    CHECK((v == std::vector<int>{ 1, 3, 5, 7, 9 }));
+
+    std::vector<std::size_t> lens;
+    wt::transform(wt::iseq(words()), wt::into(lens),
+                  [](const std::string& s) { return s.size(); });
+    CHECK((lens == std::vector<std::size_t>{ 1, 2, 3 }));
+
+    std::vector<int> until;
+    std::vector<std::string> during;
+    wt::copy_until(wt::iseq(naturals()), std::back_inserter(until),
+                   [](int x) { return x == 4; });
+    CHECK((until == std::vector<int>{ 0, 1, 2, 3 }));
+    wt::copy_while(wt::iseq(words()), std::back_inserter(during),
+                   [](const std::string& s) { return s.size() < 3; });
+    CHECK(during.size() == 2);
+
+    // *it++ reads the value before the increment resumes the coroutine.
+    wt::generator<std::string> w = words();
+    std::vector<std::string> read;
+    for( wt::generator<std::string>::iterator it = w.begin(); it != w.end(); )
+        read.push_back(*it++);
+    CHECK((read == std::vector<std::string>{ "a", "bb", "ccc" }));
+
+    wt::generator<int> none;
+    CHECK(none.begin() == none.end());
+
+    bool thrown = false;
+    try {
+        for( int x : failing() ) (void)x;
+    } catch( const std::runtime_error& ) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+} // namespace
+
+int main()
+{
+    algorithms();
+    return test::result();
+}
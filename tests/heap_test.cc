@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <string>
+#include <vector>
+#include <wtl/algorithm.hh>
+#include <wtl/heap.hh>
+#include "check.hh"
+
+namespace {
+
+template<std::size_t D>
+void dary_heaps()
+{
+    for( int n : { 0, 1, 2, 3, 5, 9, 17, 100, 1000, 300000 } ) {
+        std::vector<int> v = test::random_ints<int>(n, 0, n);
+        std::vector<int> sorted(v);
+        std::sort(sorted.begin(), sorted.end());
+        wt::make_dary_heap<D>(v.begin(), v.end());
+        CHECK(wt::is_dary_heap<D>(v.begin(), v.end()));
+        for( std::vector<int>::iterator e = v.end(); e != v.begin(); --e ) {
+            wt::pop_dary_heap<D>(v.begin(), e);
+            if( n <= 1000 )
+                CHECK(wt::is_dary_heap<D>(v.begin(), e - 1));
+        }
+        CHECK(v == sorted);
+
+        std::vector<int> h;
+        const std::vector<int> more = test::random_ints<int>(
+            std::min(n, 1000), 0, 99);
+        for( int x : more ) {
+            h.push_back(x);
+            wt::push_dary_heap<D>(h.begin(), h.end());
+            CHECK(wt::is_dary_heap<D>(h.begin(), h.end()));
+        }
+    }
+    std::vector<int> v = test::random_ints<int>(10000, 0, 100);
+    wt::make_dary_heap<D>(wt::iseq(v), std::greater<int>());
+    CHECK(wt::is_dary_heap<D>(wt::iseq(v), std::greater<int>()));
+}
+
+void binary_heaps()
+{
+    // Many ties, so the heap differs from std::make_heap()'s, but it must be
+    // one that the std:: heap algorithms accept.
+    for( int n : { 0, 1, 2, 100, 1 << 20 } ) {
+        std::vector<int> v = test::random_ints<int>(n, 0, 50);
+        std::vector<int> w(v);
+        wt::make_heap(wt::iseq(v));
+        CHECK(std::is_heap(v.begin(), v.end()));
+        std::sort_heap(v.begin(), v.end());
+        std::sort(w.begin(), w.end());
+        CHECK(v == w);
+    }
+}
+
+template<std::size_t D>
+void priority_queues()
+{
+    for( int n : { 0, 1, 7, 100, 5000, 200000 } ) {
+        const std::vector<long> in = test::random_ints<long>(n, 0, 999);
+        wt::priority_queue<long, std::less<long>, D> q(in.begin(), in.end());
+        std::priority_queue<long> s(in.begin(), in.end());
+        std::uint64_t seed = 1;
+        for( int k : { 0, 1, 3, 50, 70, 1000, 30000 } ) {
+            const std::vector<long> more =
+                test::random_ints<long>(k, 0, 999, ++seed);
+            q.push(more.begin(), more.end());
+            for( long x : more ) s.push(x);
+            CHECK(q.size() == s.size());
+            std::vector<long> popped;
+            q.pop(k / 2 + 1, std::back_inserter(popped));
+            for( std::size_t i = 0; i < popped.size(); ++i ) {
+                CHECK(popped[i] == s.top());
+                s.pop();
+            }
+        }
+        while( !q.empty() ) {
+            CHECK(q.top() == s.top());
+            q.pop();
+            s.pop();
+        }
+        CHECK(s.empty());
+    }
+
+    wt::priority_queue<std::string, std::greater<std::string>, D> q;
+    q.emplace("b");
+    q.push(std::string("c"));
+    q.push("a");
+    CHECK(q.top() == "a");
+    q.pop();
+    CHECK(q.top() == "b" && q.size() == 2);
+    q.clear();
+    CHECK(q.empty());
+}
+
+template<std::size_t D>
+void indexed_priority_queues()
+{
+    const std::size_t cap = 3000;
+    wt::indexed_priority_queue<int, std::greater<int>, D> q(cap);
+    std::vector<int> pr(cap, -1);       // -1 for an id not in the queue.
+    const std::vector<int> ops = test::random_ints<int>(60000, 0, 1 << 30);
+    for( std::size_t it = 0; it + 3 <= ops.size(); it += 3 ) {
+        const std::size_t id = ops[it] % cap;
+        const int p = ops[it + 1] % 500;
+        switch( ops[it + 2] % 5 ) {
+        case 0: case 1:
+            q.push_or_update(id, p);
+            pr[id] = p;
+            break;
+        case 2:
+            if( q.contains(id) ) {
+                q.update(id, p);
+                pr[id] = p;
+            }
+            break;
+        case 3:
+            if( q.contains(id) ) {
+                q.erase(id);
+                pr[id] = -1;
+            }
+            break;
+        case 4:
+            if( !q.empty() ) {
+                pr[q.top()] = -1;
+                q.pop();
+            }
+            break;
+        }
+    }
+    std::size_t count = 0;
+    int best = 1 << 30;
+    for( std::size_t i = 0; i < cap; ++i ) {
+        CHECK(q.contains(i) == (pr[i] >= 0));
+        if( pr[i] < 0 ) continue;
+        CHECK(q.priority(i) == pr[i]);
+        ++count;
+        best = std::min(best, pr[i]);
+    }
+    CHECK(q.size() == count);
+    if( count != 0 ) CHECK(q.top_priority() == best && pr[q.top()] == best);
+    q.clear();
+    CHECK(q.empty() && !q.contains(0));
+}
+
+} // namespace
+
+int main()
+{
+    dary_heaps<2>();
+    dary_heaps<3>();
+    dary_heaps<4>();
+    dary_heaps<8>();
+    binary_heaps();
+    priority_queues<2>();
+    priority_queues<4>();
+    priority_queues<8>();
+    indexed_priority_queues<2>();
+    indexed_priority_queues<4>();
+    indexed_priority_queues<8>();
+    return test::result();
+}
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <vector>
+#include <wtl/numeric.hh>
+#include "check.hh"
+
+namespace {
+
+const std::size_t big = 300000;
+
+bool near(double a, double b, double tol)
+{
+    return std::fabs(a - b) <= tol * std::max(1.0, std::fabs(b));
+}
+
+void statistics()
+{
+    const std::vector<int> v = test::random_ints<int>(big, -1000, 1000);
+    double mean = 0;
+    for( int x : v ) mean += x;
+    mean /= double(v.size());
+    double m2 = 0;
+    for( int x : v ) m2 += (x - mean) * (x - mean);
+
+    const wt::summary<int> s = wt::describe(v.begin(), v.end());
+    CHECK(s.count() == v.size());
+    CHECK(s.min() == *std::min_element(v.begin(), v.end()));
+    CHECK(s.max() == *std::max_element(v.begin(), v.end()));
+    CHECK(near(s.mean(), mean, 1e-9));
+    CHECK(near(s.variance(), m2 / double(v.size() - 1), 1e-9));
+
+    const wt::summary<int> p = wt::describe(wt::par(4), v.begin(), v.end());
+    CHECK(p.count() == s.count() && p.min() == s.min() && p.max() == s.max());
+    CHECK(near(p.mean(), s.mean(), 1e-9));
+    CHECK(near(p.variance(), s.variance(), 1e-9));
+
+    wt::summary<int> halves = wt::describe(v.begin(), v.begin() + 1000);
+    halves.merge(wt::describe(v.begin() + 1000, v.end()));
+    CHECK(near(halves.variance(), s.variance(), 1e-9));
+    CHECK(near(halves.skewness(), s.skewness(), 1e-6));
+    CHECK(near(halves.kurtosis(), s.kurtosis(), 1e-6));
+}
+
+void sketches()
+{
+    const std::vector<int> v = test::random_ints<int>(big, 0, 49999);
+    const double exact = double(std::set<int>(v.begin(), v.end()).size());
+    CHECK(near(double(wt::approx_count_distinct(v.begin(), v.end())),
+               exact, 0.05));
+    CHECK(near(double(wt::approx_count_distinct(wt::par(4),
+                                                v.begin(), v.end())),
+               exact, 0.05));
+    const std::vector<int> few = { 3, 1, 3, 3, 2, 1 };
+    CHECK(wt::approx_count_distinct(few.begin(), few.end()) == 3);
+    wt::hyperloglog h;
+    h.add(few.begin(), few.end());
+    h.merge(h);
+    CHECK(std::llround(h.estimate()) == 3);
+
+    std::vector<int> sorted(v);
+    std::sort(sorted.begin(), sorted.end());
+    const wt::kll_sketch<int> q = wt::quantile_sketch(v.begin(), v.end());
+    CHECK(q.count() == v.size());
+    CHECK(q.quantile(0) == sorted.front() && q.quantile(1) == sorted.back());
+    for( double r : { 0.1, 0.5, 0.9 } ) {
+        const int x = q.quantile(r);
+        const double rank = double(std::upper_bound(sorted.begin(),
+                                                    sorted.end(), x)
+                                   - sorted.begin()) / double(v.size());
+        CHECK(std::fabs(rank - r) < 0.02);
+    }
+    const wt::kll_sketch<int> pq =
+        wt::quantile_sketch(wt::par(4), v.begin(), v.end());
+    CHECK(pq.count() == v.size());
+    CHECK(std::fabs(pq.rank(25000) - 0.5) < 0.02);
+
+    // Merged into itself, a sketch counts its values twice, in the same
+    // proportions.
+    wt::kll_sketch<int> twice = pq;
+    twice.merge(twice);
+    CHECK(twice.count() == 2 * v.size());
+    CHECK(twice.min() == sorted.front() && twice.max() == sorted.back());
+    CHECK(std::fabs(twice.rank(25000) - 0.5) < 0.02);
+}
+
+void inner_products()
+{
+    const std::vector<float> a(1027, 0.5f), b(1027, 2.0f);
+    CHECK(wt::inner_product(wt::unseq, a.begin(), a.end(), b.begin(), 0.0f)
+          == 1027.0f);
+    const std::vector<int> x = test::random_ints<int>(big, -100, 100);
+    const std::vector<int> y = test::random_ints<int>(big, -100, 100, 2);
+    const long long expect = std::inner_product(x.begin(), x.end(), y.begin(),
+                                                0LL);
+    CHECK(wt::inner_product(wt::unseq, x.begin(), x.end(), y.begin(), 0LL)
+          == expect);
+    CHECK(wt::inner_product(wt::par(4), x.begin(), x.end(), y.begin(), 0LL)
+          == expect);
+
+    // A 7-element query against 13 rows, so the four-row kernel has a tail.
+    std::vector<double> query(7), rows(7 * 13);
+    for( std::size_t i = 0; i < query.size(); ++i ) query[i] = double(i) - 3;
+    for( std::size_t i = 0; i < rows.size(); ++i ) rows[i] = double(i % 11);
+    std::vector<double> out(13);
+    wt::inner_products(query.begin(), query.end(), rows.begin(), rows.end(),
+                       out.begin());
+    for( std::size_t r = 0; r < 13; ++r )
+        CHECK(out[r] == std::inner_product(query.begin(), query.end(),
+                                           rows.begin() + r * 7, 0.0));
+}
+
+void sliding_windows()
+{
+    const std::vector<int> v = test::random_ints<int>(1000, -50, 50);
+    for( std::size_t w : { 1u, 2u, 17u, 1000u } ) {
+        std::vector<int> mins, maxs, sums, prods;
+        for( std::size_t i = 0; i + w <= v.size(); ++i ) {
+            mins.push_back(*std::min_element(v.begin() + i,
+                                             v.begin() + i + w));
+            maxs.push_back(*std::max_element(v.begin() + i,
+                                             v.begin() + i + w));
+            sums.push_back(std::accumulate(v.begin() + i, v.begin() + i + w,
+                                           0));
+        }
+        std::vector<int> out(v.size());
+        out.erase(wt::sliding_window(v.begin(), v.end(), w, wt::window_min(),
+                                     out.begin()), out.end());
+        CHECK(out == mins);
+        out.resize(v.size());
+        out.erase(wt::sliding_window(v.begin(), v.end(), w, wt::window_max(),
+                                     out.begin()), out.end());
+        CHECK(out == maxs);
+        out.resize(v.size());
+        out.erase(wt::sliding_window(v.begin(), v.end(), w, wt::window_sum(),
+                                     out.begin()), out.end());
+        CHECK(out == sums);
+        out.resize(v.size());
+        out.erase(wt::sliding_window(v.begin(), v.end(), w,
+                                     [](int a, int b) { return a + b; },
+                                     out.begin()), out.end());
+        CHECK(out == sums);
+    }
+
+    // Sums are kept wider than small or large-valued elements.
+    const std::vector<std::uint8_t> bytes = { 200, 200, 200, 10 };
+    std::vector<double> means;
+    wt::sliding_window(bytes.begin(), bytes.end(), 2, wt::window_mean(),
+                       std::back_inserter(means));
+    CHECK((means == std::vector<double>{ 200, 200, 105 }));
+    std::vector<unsigned> usums;
+    wt::sliding_window(bytes.begin(), bytes.end(), 3, wt::window_sum(),
+                       std::back_inserter(usums));
+    CHECK((usums == std::vector<unsigned>{ 600, 410 }));
+    const int top = std::numeric_limits<int>::max();
+    const std::vector<int> large = { top, top, -5, top };
+    std::vector<long long> lsums;
+    wt::sliding_window(large.begin(), large.end(), 2, wt::window_sum(),
+                       std::back_inserter(lsums));
+    CHECK((lsums == std::vector<long long>{ 2LL * top, top - 5LL, top - 5LL }));
+}
+
+void segmented()
+{
+    std::vector<int> keys = test::random_ints<int>(big, 0, 3);
+    const std::vector<int> vals = test::random_ints<int>(big, -10, 10, 5);
+    std::vector<int> rk, rv, scan;
+    for( std::size_t i = 0; i < keys.size(); ++i ) {
+        if( i == 0 || keys[i] != keys[i - 1] ) {
+            rk.push_back(keys[i]);
+            rv.push_back(vals[i]);
+            scan.push_back(vals[i]);
+        } else {
+            rv.back() += vals[i];
+            scan.push_back(scan.back() + vals[i]);
+        }
+    }
+
+    std::vector<int> ok(big), ov(big);
+    std::pair<std::vector<int>::iterator,std::vector<int>::iterator> e =
+        wt::reduce_by_key(keys.begin(), keys.end(), vals.begin(),
+                          ok.begin(), ov.begin());
+    CHECK(std::vector<int>(ok.begin(), e.first) == rk);
+    CHECK(std::vector<int>(ov.begin(), e.second) == rv);
+    e = wt::reduce_by_key(wt::par(4), keys.begin(), keys.end(), vals.begin(),
+                          ok.begin(), ov.begin());
+    CHECK(std::vector<int>(ok.begin(), e.first) == rk);
+    CHECK(std::vector<int>(ov.begin(), e.second) == rv);
+
+    std::vector<int> out(big);
+    wt::scan_by_key(keys.begin(), keys.end(), vals.begin(), out.begin());
+    CHECK(out == scan);
+    std::fill(out.begin(), out.end(), 0);
+    wt::scan_by_key(wt::par(4), keys.begin(), keys.end(), vals.begin(),
+                    out.begin());
+    CHECK(out == scan);
+
+    // A single run spanning every block of the parallel scan.
+    std::fill(keys.begin(), keys.end(), 7);
+    wt::scan_by_key(wt::par(4), keys.begin(), keys.end(), vals.begin(),
+                    out.begin());
+    std::vector<int> sums(big);
+    std::partial_sum(vals.begin(), vals.end(), sums.begin());
+    CHECK(out == sums);
+}
+
+} // namespace
+
+int main()
+{
+    statistics();
+    sketches();
+    inner_products();
+    sliding_windows();
+    segmented();
+    return test::result();
+}
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <wtl/iseq.hh>
+#include <wtl/perf.hh>
+#include "check.hh"
+
+namespace {
+
+void scopes()
+{
+    std::vector<int> v = test::random_ints<int>(100000, 0, 1000);
+    wt::perf_scope s;
+    s.pause();
+    s.reset();
+    wt::perf_counts c = s.read();
+    for( int e = 0; e < wt::perf_events_n; ++e )
+        CHECK(c.value[e] == 0);
+
+    s.resume();
+    std::sort(v.begin(), v.end());
+    s.pause();
+    c = s.read();
+    std::reverse(v.begin(), v.end());
+    const wt::perf_counts later = s.read();
+    CHECK(later.ns >= c.ns);
+    // Without perf, as in most containers, nothing is counted at all.
+    if( !s.available() ) {
+        CHECK(!c.has(wt::perf_instructions) && c.ipc() == 0);
+        return;
+    }
+    if( c.has(wt::perf_instructions) ) {
+        CHECK(c[wt::perf_instructions] > 100000);
+        // Paused, the counts don't move.
+        CHECK(later[wt::perf_instructions] == c[wt::perf_instructions]);
+    }
+}
+
+void comparators()
+{
+    const std::vector<int> v = { 3, 1, 4, 1, 5, 9, 2, 6 };
+    wt::op_counts ops;
+    // The standard fixes max_element() at n - 1 comparisons.  The copies of
+    // the comparator std:: makes all count into ops.
+    CHECK(*std::max_element(v.begin(), v.end(),
+                            wt::count_comparisons(std::less<int>(), ops))
+          == 9);
+    CHECK(ops.comparisons == 7);
+
+    std::vector<int> s(1024);
+    std::iota(s.begin(), s.end(), 0);
+    ops = wt::op_counts();
+    CHECK(*std::lower_bound(s.begin(), s.end(), 700,
+                            wt::count_comparisons(std::less<int>(), ops))
+          == 700);
+    CHECK(ops.comparisons >= 10 && ops.comparisons <= 11);
+    CHECK(ops.copies == 0 && ops.dereferences == 0);
+}
+
+void iterators()
+{
+    std::vector<int> v(10);
+    std::iota(v.begin(), v.end(), 0);
+    typedef wt::instrumented_iterator<std::vector<int>::iterator> iter;
+    wt::op_counts ops;
+    const iter end = wt::instrument(v.end(), ops);
+    int sum = 0;
+    for( iter it = wt::instrument(v.begin(), ops); it != end; ++it )
+        sum += *it;
+    CHECK(sum == 45);
+    CHECK(ops.increments == 10 && ops.dereferences == 10 && ops.jumps == 0);
+
+    iter it = wt::instrument(v.begin(), ops);
+    it += 4;
+    it = it - 1;
+    CHECK(it[2] == 5 && *it.base() == 3);
+    CHECK(end - it == 7);
+    it++;
+    --it;
+    CHECK(ops.jumps == 3 && ops.dereferences == 11 && ops.increments == 12);
+
+    // Instrumenting a range counts an algorithm's own operations.
+    ops = wt::op_counts();
+    const wt::input_sequence_range<iter> r =
+        wt::instrument(wt::iseq(v), ops);
+    CHECK(std::count(r.first, r.second, 3) == 1);
+    CHECK(ops.increments == 10 && ops.dereferences == 10);
+}
+
+void elements()
+{
+    typedef wt::counted<int> elem;
+    wt::op_counts before = wt::thread_op_counts();
+    std::vector<elem> v;
+    v.reserve(4);
+    for( int x : { 4, 2, 3, 1 } ) v.push_back(elem(x));
+    std::vector<elem> w(v);
+    std::swap(w[0], w[3]);
+    CHECK(w[0] < w[3] && w[1] != w[2] && !(w[1] == w[2]));
+    w[1] = v[3];
+    wt::op_counts d = wt::thread_op_counts() - before;
+    CHECK(d.moves == 4 + 3 && d.copies == 4 + 1 && d.comparisons == 3);
+    CHECK(w[1].value() == 1 && w[0].value() == 1 && w[3].value() == 4);
+
+    before = wt::thread_op_counts();
+    CHECK(std::max_element(v.begin(), v.end())->value() == 4);
+    d = wt::thread_op_counts() - before;
+    CHECK(d.comparisons == 3 && d.copies == 0 && d.moves == 0);
+
+    // Sorting moves elements, and never needs to copy them.
+    before = wt::thread_op_counts();
+    std::sort(v.begin(), v.end());
+    d = wt::thread_op_counts() - before;
+    CHECK(v.front().value() == 1 && v.back().value() == 4);
+    CHECK(d.copies == 0 && d.moves != 0 && d.comparisons >= 3);
+}
+
+} // namespace
+
+int main()
+{
+    scopes();
+    comparators();
+    iterators();
+    elements();
+    return test::result();
+}
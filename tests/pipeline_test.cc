@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <wtl/algorithm.hh>
+#include <wtl/numeric.hh>
+#include <wtl/pipeline.hh>
+#include "check.hh"
+
+namespace {
+
+std::string to_text(const std::vector<int>& v)
+{
+    std::ostringstream os;
+    for( std::size_t i = 0; i < v.size(); ++i )
+        os << v[i] << (i % 10 == 9 ? '\n' : ' ');
+    return os.str();
+}
+
+std::vector<int> read_all(std::istream& in, std::size_t chunk)
+{
+    std::vector<int> out;
+    const wt::input_sequence_range<wt::async_istream_iterator<int> > r =
+        wt::async_iseq<int>(in, chunk);
+    for( wt::async_istream_iterator<int> it = r.first; it != r.second; ++it )
+        out.push_back(*it);
+    return out;
+}
+
+void async_streams()
+{
+    const std::vector<int> v = test::random_ints<int>(100000, -1000000,
+                                                      1000000);
+    const std::string text = to_text(v);
+    // Chunks smaller than a value, about a value, and larger than the text.
+    for( std::size_t chunk : { 1u, 16u, 4096u, 1u << 24 } ) {
+        std::istringstream in(text);
+        CHECK(read_all(in, chunk) == v);
+    }
+    std::istringstream in(text);
+    CHECK(wt::accumulate(wt::async_iseq<int>(in), 0LL) ==
+          std::accumulate(v.begin(), v.end(), 0LL));
+
+    // *it++ reads the value before the increment, even when the increment
+    // hands its batch back to the parser.
+    for( std::size_t chunk : { 1u, 16u } ) {
+        std::istringstream in(text);
+        wt::input_sequence_range<wt::async_istream_iterator<int> > r =
+            wt::async_iseq<int>(in, chunk);
+        std::vector<int> out;
+        while( r.first != r.second ) out.push_back(*r.first++);
+        CHECK(out == v);
+    }
+    {
+        std::istringstream in(text);
+        std::vector<int> out;
+        wt::copy_until(wt::async_iseq<int>(in, 16), std::back_inserter(out),
+                       [](int x) { return x > 999000; });
+        const std::vector<int>::const_iterator stop =
+            std::find_if(v.begin(), v.end(), [](int x) { return x > 999000; });
+        CHECK(out == std::vector<int>(v.begin(), stop));
+    }
+
+    std::istringstream empty("");
+    CHECK(read_all(empty, 16).empty());
+    std::istringstream blank("   \n\t ");
+    CHECK(read_all(blank, 2).empty());
+
+    // A value that fails to parse ends the sequence, as with iseq<int>().
+    std::istringstream bad("1 2 3 x 4 5");
+    CHECK((read_all(bad, 4) == std::vector<int>{ 1, 2, 3 }));
+
+    // Abandoning the range early stops the stages.
+    std::istringstream part(text);
+    wt::async_istream_iterator<int> it = wt::async_iseq<int>(part, 64).first;
+    CHECK(*it == v[0]);
+    ++it;
+    CHECK(*it == v[1]);
+}
+
+void stages()
+{
+    int produced = 0;
+    wt::async_stage<std::vector<int> > stage([&produced](std::vector<int>& b) {
+        if( produced == 5 ) throw std::runtime_error("stage");
+        b.assign(3, produced++);
+        return true;
+    });
+    int batches = 0;
+    bool thrown = false;
+    try {
+        while( std::vector<int>* b = stage.next() ) {
+            CHECK((*b == std::vector<int>(3, batches)));
+            ++batches;
+        }
+    } catch( const std::runtime_error& ) {
+        thrown = true;
+    }
+    CHECK(thrown && batches == 5);
+}
+
+} // namespace
+
+int main()
+{
+    async_streams();
+    stages();
+    return test::result();
+}
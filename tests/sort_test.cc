@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <wtl/algorithm.hh>
+#include <wtl/sort.hh>
+#include "check.hh"
+
+namespace {
+
+std::vector<std::size_t> stable_order(const std::vector<int>& v)
+{
+    std::vector<std::size_t> idx(v.size());
+    for( std::size_t i = 0; i < idx.size(); ++i ) idx[i] = i;
+    std::stable_sort(idx.begin(), idx.end(),
+                     [&v](std::size_t a, std::size_t b) { return v[a] < v[b]; });
+    return idx;
+}
+
+void permutations()
+{
+    const std::vector<int> v = test::random_ints<int>(100000, -500, 500);
+    const std::vector<std::size_t> expect = stable_order(v);
+    std::vector<std::size_t> idx(v.size());
+    wt::argsort(v.begin(), v.end(), idx.begin());
+    CHECK(idx == expect);
+    wt::argsort(v.begin(), v.end(), idx.begin(), std::less<int>());
+    CHECK(std::is_sorted(idx.begin(), idx.end(),
+                         [&v](std::size_t a, std::size_t b) {
+                             return v[a] < v[b];
+                         }));
+
+    std::vector<int> sorted(v);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> out(v.size());
+    wt::gather(expect.begin(), expect.end(), v.begin(), out.begin());
+    CHECK(out == sorted);
+    std::vector<int> back(v.size());
+    wt::scatter(sorted.begin(), sorted.end(), expect.begin(), back.begin());
+    CHECK(back == v);
+    std::vector<int> a(v);
+    wt::apply_permutation(a.begin(), a.end(), expect.begin());
+    CHECK(a == sorted);
+
+    std::vector<int> s = { 1, 2, 3 };
+    const std::vector<int> bad = { 1, 1, 0 };
+    CHECK_THROWS(std::invalid_argument,
+                 wt::apply_permutation(s.begin(), s.end(), bad.begin()));
+    const std::vector<int> out_of_range = { 0, 3, 1 };
+    CHECK_THROWS(std::invalid_argument,
+                 wt::apply_permutation(s.begin(), s.end(),
+                                       out_of_range.begin()));
+}
+
+void key_sorts()
+{
+    const std::vector<int> v = test::random_ints<int>(50000, -100000, 100000);
+    const auto key = [](int x) { return x / 100; };
+    const auto by_key = [&key](int a, int b) { return key(a) < key(b); };
+
+    std::vector<int> expect(v), a(v);
+    std::stable_sort(expect.begin(), expect.end(), by_key);
+    wt::stable_sort_by_key(a.begin(), a.end(), key);
+    CHECK(a == expect);
+    a = v;
+    wt::sort_by_key(a.begin(), a.end(), key);
+    CHECK(std::is_sorted(a.begin(), a.end(), by_key));
+    CHECK(test::same_elements(a, v));
+
+    const auto name = [](int x) { return std::to_string(x); };
+    std::vector<int> b(v);
+    expect = v;
+    std::stable_sort(expect.begin(), expect.end(), [&](int x, int y) {
+        return name(x) > name(y);
+    });
+    wt::stable_sort_by_key(b.begin(), b.end(), name, std::greater<std::string>());
+    CHECK(b == expect);
+}
+
+void string_sorts()
+{
+    std::vector<std::string> v;
+    const std::vector<int> r = test::random_ints<int>(20000, 0, 1 << 30);
+    for( std::size_t i = 0; i < r.size(); ++i ) {
+        // Long shared prefixes, empty strings and high bytes.
+        std::string s(r[i] % 40, 'a');
+        s += std::to_string(r[i]);
+        if( r[i] % 7 == 0 ) s.clear();
+        if( r[i] % 5 == 0 ) s += "\xff\x80";
+        v.push_back(s);
+    }
+    std::vector<std::string> expect(v), a(v);
+    std::sort(expect.begin(), expect.end());
+    wt::string_sort(a.begin(), a.end());
+    CHECK(a == expect);
+    a = v;
+    wt::sort(wt::iseq(a));
+    CHECK(a == expect);
+
+    std::vector<const char*> p;
+    for( std::size_t i = 0; i < v.size(); ++i ) p.push_back(v[i].c_str());
+    wt::string_sort(p.begin(), p.end());
+    for( std::size_t i = 0; i < p.size(); ++i )
+        CHECK(p[i] == expect[i]);
+
+    // wt::sort orders C strings by content, and a null one as empty.
+    const char b[] = "b";
+    std::vector<const char*> c = { "c", b, 0, "a", "" };
+    wt::sort(wt::iseq(c));
+    CHECK(std::string(c[2]) == "a" && c[3] == b && std::string(c[4]) == "c");
+    const char* empty = c[0] != 0 ? c[0] : c[1];
+    CHECK((c[0] == 0) != (c[1] == 0) && *empty == 0);
+}
+
+} // namespace
+
+int main()
+{
+    permutations();
+    key_sorts();
+    string_sorts();
+    return test::result();
+}
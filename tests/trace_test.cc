@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <wtl/algorithm.hh>
+#include <wtl/trace.hh>
+#include "check.hh"
+
+namespace {
+
+std::size_t calls_of(const std::vector<wt::trace::event>& ev,
+                     const std::string& name)
+{
+    std::size_t n = 0;
+    for( std::size_t i = 0; i < ev.size(); ++i )
+        if( ev[i].name == name ) ++n;
+    return n;
+}
+
+void recording()
+{
+    wt::trace::clear();
+    std::vector<int> v = test::random_ints<int>(1000, 0, 100);
+    const std::list<int> l(v.begin(), v.end());
+    for( int i = 0; i < 5; ++i ) (void)wt::count(wt::iseq(v), 7);
+    (void)wt::count(wt::iseq(l), 7);
+    wt::sort(wt::iseq(v));
+
+    std::vector<wt::trace::event> ev = wt::trace::events();
+    CHECK(ev.size() == 7);
+    CHECK(calls_of(ev, "count") == 6 && calls_of(ev, "sort") == 1);
+    for( std::size_t i = 0; i < ev.size(); ++i ) {
+        const bool list = ev[i].iterator != wt::trace::random_access_iterator;
+        CHECK(list ? ev[i].iterator == wt::trace::bidirectional_iterator &&
+                     ev[i].n == -1
+                   : ev[i].n == 1000);
+        if( i != 0 ) CHECK(ev[i - 1].start_ns <= ev[i].start_ns);
+    }
+
+    const std::vector<wt::trace::site_summary> sites =
+        wt::trace::summaries();
+    std::uint64_t calls = 0, elements = 0;
+    for( std::size_t i = 0; i < sites.size(); ++i ) {
+        calls += sites[i].calls;
+        elements += sites[i].elements;
+        CHECK(sites[i].min_ns <= sites[i].max_ns);
+    }
+    CHECK(calls == 7 && elements == 6000);
+
+    std::ostringstream json;
+    wt::trace::write_chrome_trace(json);
+    CHECK(json.str().find("\"traceEvents\"") != std::string::npos);
+    CHECK(json.str().find("\"name\":\"sort\"") != std::string::npos);
+
+    // Cleared, the buffers start over as if nothing had been recorded.
+    wt::trace::clear();
+    CHECK(wt::trace::events().empty() && wt::trace::summaries().empty());
+    (void)wt::count(wt::iseq(v), 7);
+    ev = wt::trace::events();
+    CHECK(ev.size() == 1 && ev[0].n == 1000);
+    CHECK(wt::trace::summaries().size() == 1 &&
+          wt::trace::summaries()[0].calls == 1);
+}
+
+void sampling()
+{
+    wt::trace::clear();
+    const std::vector<int> v(100, 1);
+    wt::trace::set_sampling(4);
+    for( int i = 0; i < 40; ++i ) (void)wt::count(wt::iseq(v), 1);
+    CHECK(wt::trace::events().size() == 10);
+    wt::trace::set_sampling(0);
+    for( int i = 0; i < 40; ++i ) (void)wt::count(wt::iseq(v), 1);
+    CHECK(wt::trace::events().size() == 10);
+    wt::trace::set_sampling(1);
+    wt::trace::clear();
+}
+
+// Reading the buffers while another thread wraps around its ring must only
+// ever see whole calls.
+void concurrent_reads()
+{
+    std::atomic<bool> done(false);
+    std::thread writer([&done] {
+        const std::vector<int> a(10, 0), b(20, 0);
+        for( int i = 0; i < 200000; ++i ) {
+            (void)wt::count(wt::iseq(a), 1);
+            (void)wt::find(wt::iseq(b), 1);
+        }
+        done = true;
+    });
+    std::size_t reads = 0;
+    while( !done || reads == 0 ) {
+        const std::vector<wt::trace::event> ev = wt::trace::events();
+        for( std::size_t i = 0; i < ev.size(); ++i ) {
+            const std::string name = ev[i].name;
+            CHECK((name == "count" && ev[i].n == 10) ||
+                  (name == "find" && ev[i].n == 20));
+        }
+        ++reads;
+    }
+    writer.join();
+    // The ring is full, less the slot a writer could be overwriting.
+    CHECK(wt::trace::events().size() == WT_TRACE_BUFFER - 1);
+    wt::trace::clear();
+}
+
+} // namespace
+
+int main()
+{
+    recording();
+    sampling();
+    concurrent_reads();
+    return test::result();
+}
@@ -0,0 +1,618 @@
+#ifndef TRACE_HH_
+#define TRACE_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Tracing of iseq algorithm calls.  Compiled with WT_TRACE defined, every
+/// iseq wrapper records its calls:  the algorithm, the call site, the number
+/// of elements, the category of the iterators and the time the call took.
+/// Without WT_TRACE, the default, the wrappers compile to exactly what they
+/// were without tracing.
+///
+/// Calls are recorded by the thread that makes them, into a ring buffer and a
+/// table of per-site histograms that belong to that thread, without locks or
+/// read-modify-write atomics.  The ring buffer keeps the latest
+/// WT_TRACE_BUFFER calls of each thread, and the histograms count every
+/// recorded call, for up to WT_TRACE_SITES call sites per thread.  Under
+/// production load, set_sampling(n) records only one call in n per thread;
+/// the calls skipped cost a thread-local countdown.
+///
+/// write_chrome_trace() writes the calls in the ring buffers as JSON for
+/// chrome://tracing or Perfetto, and write_histograms() the per-site
+/// summaries:
+///
+///  wt::trace::set_sampling(64);
+///  serve();
+///  std::ofstream out("trace.json");
+///  wt::trace::write_chrome_trace(out);
+///
+/// A call site is the address of the code that made the call.  With the
+/// wrappers inlined, which they are in optimized builds, that is the address
+/// of the call in the caller;  otherwise it is an address in the wrapper, the
+/// same for all the calls of one instantiation.  Sites are written as the
+/// module and offset, which addr2line -i -f resolves to the file and line.
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(WT_TRACE)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__GNUC__) && defined(__unix__)
+#include <dlfcn.h>
+#endif
+
+#if !defined(WT_TRACE_BUFFER)
+#define WT_TRACE_BUFFER 16384   // Calls kept per thread;  a power of two.
+#endif
+#if !defined(WT_TRACE_SITES)
+#define WT_TRACE_SITES 256      // Call sites summarized per thread.
+#endif
+
+namespace wt {
+namespace trace {
+
+/// The category of the iterators of a traced call.
+enum iterator_kind {
+    input_iterator,
+    forward_iterator,
+    bidirectional_iterator,
+    random_access_iterator
+};
+
+inline const char* name_of(iterator_kind k)
+{
+    switch( k ) {
+    case input_iterator: return "input";
+    case forward_iterator: return "forward";
+    case bidirectional_iterator: return "bidirectional";
+    case random_access_iterator: return "random_access";
+    }
+    return "?";
+}
+
+/// A recorded call.
+struct event {
+    const char* name;           // The algorithm.
+    const void* site;
+    unsigned thread;            // Numbered from 0 in order of first call.
+    iterator_kind iterator;
+    std::int64_t n;             // Elements, or -1 if not random access.
+    std::uint64_t start_ns;     // Since the first traced call.
+    std::uint64_t duration_ns;
+};
+
+/// The calls of one algorithm from one call site, over all threads.
+struct site_summary {
+    /// The number of buckets of the histogram.  Bucket 0 counts calls that
+    /// took less than 2 ns, and bucket i > 0 those that took from 2^i to
+    /// 2^(i+1) ns;  the last bucket counts all the longer calls.
+    static const unsigned buckets_n = 48;
+
+    const char* name;
+    const void* site;
+    std::uint64_t calls;
+    std::uint64_t elements;     // Of the random-access calls.
+    std::uint64_t total_ns;
+    std::uint64_t min_ns;
+    std::uint64_t max_ns;
+    std::vector<std::uint64_t> buckets;
+
+    /// An estimate of the time under which a fraction p of the calls took,
+    /// from the histogram:  the geometric middle of the bucket where that
+    /// fraction is reached.
+    double percentile_ns(double p) const
+    {
+        const double target = p * static_cast<double>(calls);
+        double seen = 0;
+        for( std::size_t i = 0; i < buckets.size(); ++i ) {
+            seen += static_cast<double>(buckets[i]);
+            if( seen >= target && buckets[i] != 0 )
+                return i == 0 ? 1.0
+                              : static_cast<double>(std::uint64_t(1) << i) *
+                                1.41421356237;
+        }
+        return static_cast<double>(max_ns);
+    }
+};
+
+namespace detail {
+
+struct slot {
+    std::atomic<const char*> name;
+    std::atomic<const void*> site;
+    std::atomic<std::int64_t> n;
+    std::atomic<std::uint64_t> start;
+    std::atomic<std::uint64_t> duration;
+    std::atomic<unsigned> kind;
+};
+
+struct site_stats {
+    std::atomic<const void*> key;
+    std::atomic<const char*> name;
+    std::atomic<const void*> site;
+    std::atomic<std::uint64_t> calls;
+    std::atomic<std::uint64_t> elements;
+    std::atomic<std::uint64_t> total;
+    std::atomic<std::uint64_t> min;
+    std::atomic<std::uint64_t> max;
+    std::atomic<std::uint64_t> buckets[site_summary::buckets_n];
+};
+
+/// What one thread records.  Only its thread writes to it, so updates are
+/// plain relaxed loads and stores;  they are atomic so that readers on other
+/// threads see whole values.
+struct buffer {
+    explicit buffer(unsigned t)
+        : thread(t),
+          ring(new slot[WT_TRACE_BUFFER]()),
+          head(0),
+          sites(new site_stats[WT_TRACE_SITES]()),
+          untracked_sites(0)
+    {
+    }
+
+    const unsigned thread;
+    const std::unique_ptr<slot[]> ring;
+    std::atomic<std::uint64_t> head;        // Calls ever written to ring.
+    const std::unique_ptr<site_stats[]> sites;
+    std::atomic<std::uint64_t> untracked_sites;
+};
+
+/// The buffers of all threads that have recorded a call, including threads
+/// that have since exited.
+struct registry {
+    std::mutex m;
+    std::vector<std::shared_ptr<buffer> > buffers;
+};
+
+inline registry& buffers()
+{
+    static registry r;
+    return r;
+}
+
+inline std::atomic<unsigned>& sampling_rate()
+{
+    static std::atomic<unsigned> every(1);
+    return every;
+}
+
+typedef std::chrono::steady_clock clock_type;
+
+inline clock_type::time_point epoch()
+{
+    static const clock_type::time_point t0 = clock_type::now();
+    return t0;
+}
+
+inline std::uint64_t now_ns()
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock_type::now() - epoch()).count());
+}
+
+struct thread_state {
+    thread_state() : countdown(1) { }
+
+    unsigned countdown;                     // Calls until the next sample.
+    std::shared_ptr<buffer> buf;
+};
+
+inline thread_state& local()
+{
+    static thread_local thread_state t;
+    return t;
+}
+
+inline buffer& local_buffer()
+{
+    thread_state& t = local();
+    if( !t.buf ) {
+        registry& r = buffers();
+        std::lock_guard<std::mutex> lock(r.m);
+        t.buf = std::make_shared<buffer>(
+            static_cast<unsigned>(r.buffers.size()));
+        r.buffers.push_back(t.buf);
+    }
+    return *t.buf;
+}
+
+/// The address this function returns to:  when called from code inlined
+/// into a caller, an address in the caller.
+#if defined(__GNUC__)
+__attribute__((noinline))
+inline const void* call_site()
+{
+    return __builtin_extract_return_addr(__builtin_return_address(0));
+}
+#else
+inline const void* call_site() { return 0; }
+#endif
+
+inline unsigned bucket_of(std::uint64_t ns)
+{
+    unsigned b = 0;
+    while( ns > 1 && b + 1 < site_summary::buckets_n ) {
+        ns >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+template<typename T>
+void add(std::atomic<T>& a, T v)
+{
+    a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+inline void record(const char* name, const void* site, iterator_kind kind,
+                   std::int64_t n, std::uint64_t start, std::uint64_t duration)
+{
+    const std::memory_order relaxed = std::memory_order_relaxed;
+    buffer& b = local_buffer();
+
+    const std::uint64_t i = b.head.load(relaxed);
+    // Pairs with the acquire fence in events():  a reader that sees any of
+    // the stores below then sees head at least at i, and so knows the slot
+    // may be torn.
+    std::atomic_thread_fence(std::memory_order_release);
+    slot& s = b.ring[i & (WT_TRACE_BUFFER - 1)];
+    s.name.store(name, relaxed);
+    s.site.store(site, relaxed);
+    s.n.store(n, relaxed);
+    s.start.store(start, relaxed);
+    s.duration.store(duration, relaxed);
+    s.kind.store(kind, relaxed);
+    b.head.store(i + 1, std::memory_order_release);
+
+    // Sites are keyed by address, or by algorithm where there is none.
+    const void* key = site != 0 ? site : static_cast<const void*>(name);
+    std::size_t h = (reinterpret_cast<std::uintptr_t>(key) >> 2) *
+                    0x9e3779b97f4a7c15ull >> 40;
+    for( std::size_t probe = 0; probe < WT_TRACE_SITES; ++probe, ++h ) {
+        site_stats& st = b.sites[h % WT_TRACE_SITES];
+        const void* k = st.key.load(relaxed);
+        if( k == 0 ) {
+            st.name.store(name, relaxed);
+            st.site.store(site, relaxed);
+            st.min.store(duration, relaxed);
+            st.key.store(key, std::memory_order_release);
+        } else if( k != key || st.name.load(relaxed) != name ) {
+            continue;
+        }
+        add(st.calls, std::uint64_t(1));
+        if( kind == random_access_iterator )
+            add(st.elements, static_cast<std::uint64_t>(n));
+        add(st.total, duration);
+        if( duration < st.min.load(relaxed) ) st.min.store(duration, relaxed);
+        if( duration > st.max.load(relaxed) ) st.max.store(duration, relaxed);
+        add(st.buckets[bucket_of(duration)], std::uint64_t(1));
+        return;
+    }
+    add(b.untracked_sites, std::uint64_t(1));
+}
+
+inline iterator_kind kind_of(std::input_iterator_tag)
+{
+    return input_iterator;
+}
+
+inline iterator_kind kind_of(std::forward_iterator_tag)
+{
+    return forward_iterator;
+}
+
+inline iterator_kind kind_of(std::bidirectional_iterator_tag)
+{
+    return bidirectional_iterator;
+}
+
+inline iterator_kind kind_of(std::random_access_iterator_tag)
+{
+    return random_access_iterator;
+}
+
+/// The length of a range, where that takes constant time.  Other ranges
+/// can't be counted without walking them, which single-pass ranges don't
+/// allow.
+template<typename It>
+std::int64_t length(It first, It last, std::random_access_iterator_tag)
+{
+    return static_cast<std::int64_t>(last - first);
+}
+
+template<typename It>
+std::int64_t length(It, It, std::input_iterator_tag)
+{
+    return -1;
+}
+
+inline std::string site_name(const void* site)
+{
+    char s[64];
+#if defined(__GNUC__) && defined(__unix__)
+    Dl_info info;
+    if( site != 0 && dladdr(site, &info) != 0 && info.dli_fname != 0 ) {
+        const char* base = std::strrchr(info.dli_fname, '/');
+        std::snprintf(s, sizeof(s), "+0x%llx",
+                      static_cast<unsigned long long>(
+                          static_cast<const char*>(site) -
+                          static_cast<const char*>(info.dli_fbase)));
+        return std::string(base != 0 ? base + 1 : info.dli_fname) + s;
+    }
+#endif
+    std::snprintf(s, sizeof(s), "%p", site);
+    return s;
+}
+
+inline std::string json_string(const std::string& s)
+{
+    std::string out = "\"";
+    for( std::size_t i = 0; i < s.size(); ++i ) {
+        if( s[i] == '"' || s[i] == '\\' ) out += '\\';
+        out += s[i];
+    }
+    return out + "\"";
+}
+
+} // namespace detail
+
+/// Record one call in every n of each thread, or none if n is zero.  The
+/// default is to record every call.
+inline void set_sampling(unsigned n)
+{
+    detail::sampling_rate().store(n, std::memory_order_relaxed);
+}
+
+inline unsigned sampling()
+{
+    return detail::sampling_rate().load(std::memory_order_relaxed);
+}
+
+/// The calls held in the ring buffers of all threads, in order of start.
+/// May be called while other threads record calls;  calls overwritten while
+/// they are read are left out.
+inline std::vector<event> events()
+{
+    const std::memory_order relaxed = std::memory_order_relaxed;
+    const std::uint64_t cap = WT_TRACE_BUFFER;
+    std::vector<event> res;
+    detail::registry& r = detail::buffers();
+    std::lock_guard<std::mutex> lock(r.m);
+    for( std::size_t t = 0; t < r.buffers.size(); ++t ) {
+        const detail::buffer& b = *r.buffers[t];
+        const std::uint64_t head = b.head.load(std::memory_order_acquire);
+        const std::size_t first = res.size();
+        for( std::uint64_t i = head > cap ? head - cap : 0; i < head; ++i ) {
+            const detail::slot& s = b.ring[i & (cap - 1)];
+            event e;
+            e.name = s.name.load(relaxed);
+            e.site = s.site.load(relaxed);
+            e.thread = b.thread;
+            e.iterator = static_cast<iterator_kind>(s.kind.load(relaxed));
+            e.n = s.n.load(relaxed);
+            e.start_ns = s.start.load(relaxed);
+            e.duration_ns = s.duration.load(relaxed);
+            res.push_back(e);
+        }
+        // The slot the writer may be in the middle of is the one after the
+        // last it published.  The fence keeps the slot loads above from
+        // moving past the load of head, so that a slot the writer began to
+        // overwrite while it was read is seen to have been.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t now = b.head.load(relaxed) + 1;
+        const std::uint64_t from = head > cap ? head - cap : 0;
+        if( now > from + cap )
+            res.erase(res.begin() + first,
+                      res.begin() + first +
+                      static_cast<std::size_t>(
+                          std::min(now - cap - from, head - from)));
+    }
+    std::sort(res.begin(), res.end(),
+              [](const event& a, const event& b) -> bool {
+                  return a.start_ns < b.start_ns;
+              });
+    return res;
+}
+
+/// The per-site summaries of all the recorded calls of all threads, the
+/// sites that took the most time first.
+inline std::vector<site_summary> summaries()
+{
+    const std::memory_order relaxed = std::memory_order_relaxed;
+    typedef std::pair<const void*, const char*> key_type;
+    std::map<key_type, site_summary> sites;
+    detail::registry& r = detail::buffers();
+    std::lock_guard<std::mutex> lock(r.m);
+    for( std::size_t t = 0; t < r.buffers.size(); ++t ) {
+        const detail::buffer& b = *r.buffers[t];
+        for( std::size_t i = 0; i < WT_TRACE_SITES; ++i ) {
+            const detail::site_stats& st = b.sites[i];
+            if( st.key.load(std::memory_order_acquire) == 0 ) continue;
+            const key_type k(st.site.load(relaxed), st.name.load(relaxed));
+            std::map<key_type, site_summary>::iterator it = sites.find(k);
+            if( it == sites.end() ) {
+                site_summary s;
+                s.name = k.second;
+                s.site = k.first;
+                s.calls = s.elements = s.total_ns = s.max_ns = 0;
+                s.min_ns = ~std::uint64_t(0);
+                s.buckets.assign(site_summary::buckets_n, 0);
+                it = sites.insert(std::make_pair(k, s)).first;
+            }
+            site_summary& s = it->second;
+            s.calls += st.calls.load(relaxed);
+            s.elements += st.elements.load(relaxed);
+            s.total_ns += st.total.load(relaxed);
+            s.min_ns = std::min(s.min_ns, st.min.load(relaxed));
+            s.max_ns = std::max(s.max_ns, st.max.load(relaxed));
+            for( unsigned j = 0; j < site_summary::buckets_n; ++j )
+                s.buckets[j] += st.buckets[j].load(relaxed);
+        }
+    }
+    std::vector<site_summary> res;
+    for( std::map<key_type, site_summary>::const_iterator it = sites.begin();
+         it != sites.end(); ++it )
+        if( it->second.calls != 0 ) res.push_back(it->second);
+    std::sort(res.begin(), res.end(),
+              [](const site_summary& a, const site_summary& b) -> bool {
+                  return a.total_ns > b.total_ns;
+              });
+    return res;
+}
+
+/// Write the calls in the ring buffers in the Chrome trace event format, as
+/// complete events with the element count, iterator category and call site
+/// as arguments.
+inline void write_chrome_trace(std::ostream& os)
+{
+    const std::vector<event> ev = events();
+    char num[96];
+    os << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"sampling\":"
+       << sampling() << "},\"traceEvents\":[";
+    for( std::size_t i = 0; i < ev.size(); ++i ) {
+        const event& e = ev[i];
+        std::snprintf(num, sizeof(num), "\"ts\":%.3f,\"dur\":%.3f",
+                      static_cast<double>(e.start_ns) / 1000,
+                      static_cast<double>(e.duration_ns) / 1000);
+        os << (i == 0 ? "\n" : ",\n")
+           << "{\"name\":" << detail::json_string(e.name)
+           << ",\"cat\":\"wt\",\"ph\":\"X\"," << num
+           << ",\"pid\":0,\"tid\":" << e.thread
+           << ",\"args\":{\"n\":" << e.n
+           << ",\"iterator\":\"" << name_of(e.iterator)
+           << "\",\"site\":" << detail::json_string(detail::site_name(e.site))
+           << "}}";
+    }
+    os << "\n]}\n";
+}
+
+/// Write the per-site summaries as a table, each site followed by its
+/// histogram of call times.
+inline void write_histograms(std::ostream& os)
+{
+    const std::vector<site_summary> sites = summaries();
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-24s %-32s %10s %12s %10s %10s %10s\n",
+                  "algorithm", "site", "calls", "total ms", "mean us",
+                  "p50 us", "p99 us");
+    os << line;
+    for( std::size_t i = 0; i < sites.size(); ++i ) {
+        const site_summary& s = sites[i];
+        std::snprintf(line, sizeof(line),
+                      "%-24s %-32s %10llu %12.3f %10.3f %10.3f %10.3f\n",
+                      s.name, detail::site_name(s.site).c_str(),
+                      static_cast<unsigned long long>(s.calls),
+                      static_cast<double>(s.total_ns) / 1e6,
+                      static_cast<double>(s.total_ns) / 1e3 /
+                      static_cast<double>(s.calls),
+                      s.percentile_ns(0.5) / 1e3, s.percentile_ns(0.99) / 1e3);
+        os << line << "   ";
+        for( unsigned j = 0; j < site_summary::buckets_n; ++j ) {
+            if( s.buckets[j] == 0 ) continue;
+            std::snprintf(line, sizeof(line), " <2^%u ns: %llu", j + 1,
+                          static_cast<unsigned long long>(s.buckets[j]));
+            os << line;
+        }
+        os << '\n';
+    }
+    if( sampling() > 1 )
+        os << "sampled one call in " << sampling() << '\n';
+}
+
+/// Forget all recorded calls.  Must not run concurrently with traced calls.
+inline void clear()
+{
+    detail::registry& r = detail::buffers();
+    std::lock_guard<std::mutex> lock(r.m);
+    for( std::size_t t = 0; t < r.buffers.size(); ++t ) {
+        detail::buffer& b = *r.buffers[t];
+        b.head.store(0, std::memory_order_relaxed);
+        for( std::size_t i = 0; i < WT_TRACE_SITES; ++i ) {
+            detail::site_stats& st = b.sites[i];
+            st.key.store(0, std::memory_order_relaxed);
+            st.name.store(0, std::memory_order_relaxed);
+            st.site.store(0, std::memory_order_relaxed);
+            st.calls.store(0, std::memory_order_relaxed);
+            st.elements.store(0, std::memory_order_relaxed);
+            st.total.store(0, std::memory_order_relaxed);
+            st.min.store(0, std::memory_order_relaxed);
+            st.max.store(0, std::memory_order_relaxed);
+            for( unsigned j = 0; j < site_summary::buckets_n; ++j )
+                st.buckets[j].store(0, std::memory_order_relaxed);
+        }
+        b.untracked_sites.store(0, std::memory_order_relaxed);
+    }
+}
+
+/// Records the call of the iseq wrapper it is declared in, if the call is
+/// sampled, when it goes out of scope.
+class scope {
+public:
+    template<typename It>
+#if defined(__GNUC__)
+    __attribute__((always_inline))
+#endif
+    scope(const char* name, It first, It last) : name_(0)
+    {
+        const unsigned every = sampling();
+        if( every == 0 ) return;
+        detail::thread_state& t = detail::local();
+        if( t.countdown > every ) t.countdown = every;
+        if( --t.countdown != 0 ) return;
+        t.countdown = every;
+
+        typedef typename std::iterator_traits<It>::iterator_category cat;
+        name_ = name;
+        site_ = detail::call_site();
+        kind_ = detail::kind_of(cat());
+        n_ = detail::length(first, last, cat());
+        start_ = detail::now_ns();
+    }
+
+    ~scope()
+    {
+        if( name_ != 0 )
+            detail::record(name_, site_, kind_, n_, start_,
+                           detail::now_ns() - start_);
+    }
+
+private:
+    scope(const scope&);
+    scope& operator=(const scope&);
+
+    const char* name_;
+    const void* site_;
+    iterator_kind kind_;
+    std::int64_t n_;
+    std::uint64_t start_;
+};
+
+} // namespace trace
+} // namespace wt
+
+#define WT_TRACE_ISEQ(name, range)                                          \
+    ::wt::trace::scope wt_trace_scope_((name), (range).first, (range).second)
+
+#else
+
+#define WT_TRACE_ISEQ(name, range) ((void)0)
+
+#endif // WT_TRACE
+
+#endif // TRACE_HH_
@@ -0,0 +1,109 @@
+#ifndef TRAITS_HH_
+#define TRAITS_HH_
+
+///////////////////////////////////////////////////////////////////////////////
+/// STL extensions
+///
+/// Iterator traits used by the algorithms to pick faster implementations for
+/// ranges that are laid out contiguously in memory.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace wt {
+namespace detail {
+
+template<typename It, typename V>
+struct is_string_iterator : std::false_type { };
+
+#define WT_STRING_ITERATOR(Ch)                                              \
+template<typename It>                                                       \
+struct is_string_iterator<It,Ch>                                            \
+    : std::integral_constant<bool,                                          \
+        std::is_same<It, typename std::basic_string<Ch>::iterator>::value ||\
+        std::is_same<It, typename std::basic_string<Ch>::const_iterator>::value> { }
+
+WT_STRING_ITERATOR(char);
+WT_STRING_ITERATOR(wchar_t);
+WT_STRING_ITERATOR(char16_t);
+WT_STRING_ITERATOR(char32_t);
+
+#undef WT_STRING_ITERATOR
+
+template<typename It, typename V>
+struct is_vector_iterator
+    : std::integral_constant<bool,
+        std::is_same<It, typename std::vector<V>::iterator>::value ||
+        std::is_same<It, typename std::vector<V>::const_iterator>::value> { };
+
+template<typename It>
+struct is_vector_iterator<It,bool> : std::false_type { };
+
+template<typename It>
+struct is_vector_iterator<It,void> : std::false_type { };
+
+/// Whether It is known to point into contiguous storage:  a plain pointer, or
+/// an iterator of std::vector or std::basic_string.  Such ranges can be
+/// handed to memcmp(), memmove() and the vectorized kernels.
+template<typename It>
+struct is_contiguous_iterator
+    : std::integral_constant<bool,
+        is_vector_iterator<It,
+            typename std::iterator_traits<It>::value_type>::value ||
+        is_string_iterator<It,
+            typename std::iterator_traits<It>::value_type>::value> { };
+
+template<typename T>
+struct is_contiguous_iterator<T*> : std::true_type { };
+
+/// Whether the range [It, It) is contiguous storage of a plain arithmetic
+/// type, so it may be processed as raw memory.
+template<typename It>
+struct is_contiguous_arithmetic
+    : std::integral_constant<bool,
+        is_contiguous_iterator<It>::value &&
+        std::is_arithmetic<
+            typename std::iterator_traits<It>::value_type>::value &&
+        !std::is_same<
+            typename std::iterator_traits<It>::value_type, bool>::value> { };
+
+/// Whether the range [It, It) is contiguous storage of a trivially copyable
+/// type, so its elements may be copied, moved and swapped as raw memory.
+template<typename It>
+struct is_contiguous_trivial
+    : std::integral_constant<bool,
+        is_contiguous_iterator<It>::value &&
+        std::is_trivially_copyable<
+            typename std::iterator_traits<It>::value_type>::value> { };
+
+/// The type of the key a function computes from the elements of In.
+template<typename In, typename KeyFn>
+struct key_of {
+    typedef typename std::decay<
+        decltype(std::declval<KeyFn&>()(*std::declval<In&>()))>::type type;
+};
+
+/// The address of the element an iterator of contiguous storage points to.
+///
+/// The iterator must be dereferenceable;  use it on the begin iterator of a
+/// non-empty range and offset from there.
+template<typename It>
+typename std::iterator_traits<It>::pointer address_of(It it)
+{
+    return &*it;
+}
+
+template<typename T>
+T* address_of(T* p)
+{
+    return p;
+}
+
+} // namespace detail
+} // namespace wt
+
+#endif // TRAITS_HH_